@@ -5,16 +5,19 @@
 
 
 #include "layers_Inference.h"
-#include "activate.h"
+#include "fused.h"
+#include "threadpool.h"
 #include <algorithm>
 #include <stdexcept>
-#include <numeric>
+#include <limits>
 
 //Layer class implementation
 Layer::Layer(uint32_t input_size, uint32_t output_size)
     : input_size(input_size), output_size(output_size) {
     weights.resize(input_size * output_size);
     biases.resize(output_size);
+    kernel = autotune::Kernel::Packed8;
+    pack_weights();
 }
 
 //Method Allows to set weights in Inference
@@ -23,6 +26,7 @@ void Layer::set_weights(const std::vector<float>& new_weights) {
         throw std::invalid_argument("Weights size mismatch");
     }
     weights = new_weights;
+    pack_weights();
 }
 
 void Layer::set_biases(const std::vector<float>& new_biases) {
@@ -32,6 +36,51 @@ void Layer::set_biases(const std::vector<float>& new_biases) {
     biases = new_biases;
 }
 
+void Layer::forward_batch(const float* inputs, float* outputs, uint32_t batch) const {
+    const uint64_t work = static_cast<uint64_t>(input_size) * output_size;
+    auto run = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; ++b) {
+            forward(inputs + static_cast<size_t>(b) * input_size, outputs + static_cast<size_t>(b) * output_size);
+        }
+    };
+    //A layer that already splits its neurons keeps the samples in order, otherwise the samples are split
+    if (parallel::plan_threads(work, output_size) > 1) {
+        run(0, batch);
+    }
+    else {
+        parallel::parallel_for(batch, work, 1, run);
+    }
+}
+
+void Layer::set_kernel(autotune::Kernel new_kernel) {
+    kernel = new_kernel;
+    pack_weights();
+}
+
+void Layer::pack_weights() {
+    if (kernel == autotune::Kernel::RowMajor) {
+        packed_weights = packed::PackedMatrix();
+    }
+    else {
+        packed_weights.pack(weights.data(), output_size, input_size, autotune::row_tile(kernel));
+    }
+}
+
+void tune_layers(const std::vector<Layer*>& layers, uint32_t batch, const std::string& cache_path) {
+    std::vector<autotune::Shape> shapes;
+    for (const Layer* layer : layers) {
+        autotune::Shape shape;
+        shape.inputs = layer->get_input_size();
+        shape.outputs = layer->get_output_size();
+        shape.batch = batch;
+        shapes.push_back(shape);
+    }
+    std::vector<autotune::Choice> choices = autotune::tune_model(shapes, cache_path);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        layers[i]->set_kernel(choices[i].kernel);
+    }
+}
+
 //InputLayer implementation
 InputLayer::InputLayer(uint32_t input_size, uint32_t output_size)
     : Layer(input_size, output_size) {}
@@ -45,9 +94,13 @@ HiddenLayer::HiddenLayer(uint32_t input_size, uint32_t output_size)
     : Layer(input_size, output_size) {}
 
 void HiddenLayer::forward(const float* input, float* output) const {
-    for (uint32_t i = 0; i < output_size; ++i) {
-        float sum = std::inner_product(input, input + input_size, weights.begin() + i * input_size, biases[i]);
-        output[i] = activate::relu(sum);
+    const float lowest = std::numeric_limits<float>::lowest();
+    const float highest = std::numeric_limits<float>::max();
+    if (kernel == autotune::Kernel::RowMajor) {
+        fused::dense_relu(input, weights.data(), biases.data(), output, input_size, output_size, lowest, highest);
+    }
+    else {
+        fused::dense_relu(input, packed_weights, biases.data(), output, lowest, highest);
     }
 }
 
@@ -56,8 +109,10 @@ OutputLayer::OutputLayer()
     : Layer(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE) {}
 
 void OutputLayer::forward(const float* input, float* output) const {
-    for (uint32_t i = 0; i < output_size; ++i) {
-        float sum = std::inner_product(input, input + input_size, weights.begin() + i * input_size, biases[i]);
-        output[i] = activate::sigmoid(sum);
+    if (kernel == autotune::Kernel::RowMajor) {
+        fused::dense_sigmoid(input, weights.data(), biases.data(), output, input_size, output_size);
+    }
+    else {
+        fused::dense_sigmoid(input, packed_weights, biases.data(), output);
     }
 }
\ No newline at end of file
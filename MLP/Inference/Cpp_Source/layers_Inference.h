@@ -6,7 +6,10 @@
 #ifndef LAYERS_INFERENCE_H
 #define LAYERS_INFERENCE_H
 
+#include "autotune.h"
+#include "packed.h"
 #include <cstdint>
+#include <string>
 #include <vector>
 
 //Constants for layer parameters
@@ -20,17 +23,31 @@ public:
     virtual ~Layer() = default;
 
     virtual void forward(const float* input, float* output) const = 0;
+    //Runs forward on batch samples stored back to back (input_size floats in, output_size floats out each).
+    //Large batches of small layers split the samples across the thread pool, wide layers split inside forward.
+    void forward_batch(const float* inputs, float* outputs, uint32_t batch) const;
     const std::vector<float>& get_weights() const { return weights; }
     const std::vector<float>& get_biases() const { return biases; }
 
     void set_weights(const std::vector<float>& new_weights);
     void set_biases(const std::vector<float>& new_biases);
 
+    uint32_t get_input_size() const { return input_size; }
+    uint32_t get_output_size() const { return output_size; }
+    //Selects the dense kernel forward runs, repacking the weights for it
+    void set_kernel(autotune::Kernel new_kernel);
+    autotune::Kernel get_kernel() const { return kernel; }
+
 protected:
+    void pack_weights();
+
     uint32_t input_size;
     uint32_t output_size;
     std::vector<float> weights;
     std::vector<float> biases;
+    autotune::Kernel kernel;
+    //Copy of weights reordered for the packed kernels, rebuilt whenever the weights or the kernel change
+    packed::PackedMatrix packed_weights;
 };
 
 class InputLayer : public Layer {
@@ -51,4 +68,9 @@ public:
     void forward(const float* input, float* output) const override;
 };
 
+//Picks the fastest kernel for each dense layer at the given batch size, reusing the tuning file at cache_path
+//when it was written on this cpu for the same layer shapes (pass "" to always tune). Only pass layers whose
+//forward is a dense kernel, the InputLayer is a copy.
+void tune_layers(const std::vector<Layer*>& layers, uint32_t batch, const std::string& cache_path);
+
 #endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "layers_Inference.h"
 #include <iostream>
 #include <vector>
+#include <cmath>
+#include <cstdio>
 #include <cassert>
 
 //Method to test the Input Layer and ensure proper data flow
@@ -62,12 +64,50 @@ void test_output_layer() {
     std::cout << "OutputLayer test passed." << std::endl;
 }
 
+//Method to test every kernel gives the same layer output and that tuning picks one of them
+void test_kernels() {
+    std::cout << "Testing layer kernels..." << std::endl;
+    HiddenLayer hidden_layer(HIDDEN_LAYER1_SIZE, HIDDEN_LAYER1_SIZE);
+    std::vector<float> weights(HIDDEN_LAYER1_SIZE * HIDDEN_LAYER1_SIZE);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.01f;
+    }
+    hidden_layer.set_weights(weights);
+
+    std::vector<float> input(HIDDEN_LAYER1_SIZE, 0.5f);
+    std::vector<float> expected(HIDDEN_LAYER1_SIZE), output(HIDDEN_LAYER1_SIZE);
+    hidden_layer.set_kernel(autotune::Kernel::RowMajor);
+    hidden_layer.forward(input.data(), expected.data());
+    const autotune::Kernel kernels[] = {
+        autotune::Kernel::Packed1, autotune::Kernel::Packed2, autotune::Kernel::Packed4, autotune::Kernel::Packed8
+    };
+    for (autotune::Kernel kernel : kernels) {
+        hidden_layer.set_kernel(kernel);
+        hidden_layer.forward(input.data(), output.data());
+        for (uint32_t i = 0; i < HIDDEN_LAYER1_SIZE; ++i) {
+            assert(std::abs(output[i] - expected[i]) < 1e-5f);
+        }
+    }
+
+    OutputLayer output_layer;
+    std::vector<Layer*> dense = { &hidden_layer, &output_layer };
+    tune_layers(dense, 1, "layers_tuning_test.txt");
+    hidden_layer.forward(input.data(), output.data());
+    for (uint32_t i = 0; i < HIDDEN_LAYER1_SIZE; ++i) {
+        assert(std::abs(output[i] - expected[i]) < 1e-5f);
+    }
+    std::remove("layers_tuning_test.txt");
+
+    std::cout << "Layer kernels test passed." << std::endl;
+}
+
 //Main Test Statement, feel free to adjust and add more
 int main() {
     try {
         test_input_layer();
         test_hidden_layer();
         test_output_layer();
+        test_kernels();
 
         std::cout << "All tests passed successfully!" << std::endl;
     }
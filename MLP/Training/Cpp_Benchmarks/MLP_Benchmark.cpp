@@ -0,0 +1,763 @@
+// MLP_Benchmark.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This is the micro and end-to-end benchmark suite, it times the activation functions, each layer's forward and update, packed against row-major dense kernels, wide layers on one thread against the pool, MLP::predict latency, the static layer pipeline against virtual dispatch, the fused optimizers against per-layer SGD, stacked sweep training against separate models, the evaluation engine against per-sample scoring, integer range scoring against per-number predict, the digit embedding table against normalize_input plus predict, incremental sensor updates against full predicts, sliding windows scored in place against copied windows, cascade inference with a linear gate against the full network, the prediction cache on repeated inputs against uncached predicts, the ring all-reduce per transport, dataset parsing, weight loading and full training epochs.
+// Usage: MLP_Benchmark [--out results.json] [--cpu N] [--quick]
+//        MLP_Benchmark --compare baseline.json candidate.json [--threshold 0.10]
+
+#include "benchmark.h"
+#include "MLP.h"
+#include "layers.h"
+#include "activate.h"
+#include "cascade.h"
+#include "fused.h"
+#include "distributed.h"
+#include "embedding.h"
+#include "evaluation.h"
+#include "incremental.h"
+#include "optimizer.h"
+#include "packed.h"
+#include "prediction_cache.h"
+#include "range_scorer.h"
+#include "series.h"
+#include "sweep.h"
+#include "pipeline.h"
+#include "threadpool.h"
+#include "utilities.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Silences std::cout/std::cerr for loaders that print per line
+class ScopedSilence {
+public:
+    ScopedSilence() : out(std::cout.rdbuf(nullptr)), err(std::cerr.rdbuf(nullptr)) {}
+    ~ScopedSilence() {
+        std::cout.rdbuf(out);
+        std::cerr.rdbuf(err);
+    }
+private:
+    std::streambuf* out;
+    std::streambuf* err;
+};
+
+static std::vector<float> random_floats(size_t count, float low, float high, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(low, high);
+    std::vector<float> values(count);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+static void bench_activations(BenchRunner& runner) {
+    const size_t count = 4096;
+    std::vector<float> input = random_floats(count, -8.0f, 8.0f, 1);
+    std::vector<float> output(count);
+    std::string params = "n=" + std::to_string(count);
+
+    runner.run("activate::relu", params, count, [&]() {
+        for (size_t i = 0; i < count; ++i) output[i] = activate::relu(input[i]);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::leaky_relu", params, count, [&]() {
+        for (size_t i = 0; i < count; ++i) output[i] = activate::leaky_relu(input[i]);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::sigmoid", params, count, [&]() {
+        for (size_t i = 0; i < count; ++i) output[i] = activate::sigmoid(input[i]);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::tanh", params, count, [&]() {
+        for (size_t i = 0; i < count; ++i) output[i] = activate::tanh(input[i]);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::clip", params, count, [&]() {
+        for (size_t i = 0; i < count; ++i) output[i] = activate::clip(input[i], -88.0f, 88.0f);
+        do_not_optimize(output[count - 1]);
+    });
+
+    runner.run("activate::relu_n", params, count, [&]() {
+        activate::relu_n(input.data(), output.data(), count);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::sigmoid_n", params + ",mode=exact", count, [&]() {
+        activate::sigmoid_n(input.data(), output.data(), count, activate::Mode::Exact);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::sigmoid_n", params + ",mode=fast", count, [&]() {
+        activate::sigmoid_n(input.data(), output.data(), count, activate::Mode::Fast);
+        do_not_optimize(output[count - 1]);
+    });
+    runner.run("activate::tanh_n", params + ",mode=fast", count, [&]() {
+        activate::tanh_n(input.data(), output.data(), count, activate::Mode::Fast);
+        do_not_optimize(output[count - 1]);
+    });
+
+    const int softmax_sizes[] = { 8, 64, 1024 };
+    for (int size : softmax_sizes) {
+        runner.run("activate::softmax", "n=" + std::to_string(size), size, [&]() {
+            activate::softmax(input.data(), output.data(), size);
+            do_not_optimize(output[0]);
+        });
+        runner.run("activate::softmax_n", "n=" + std::to_string(size) + ",mode=fast", size, [&]() {
+            activate::softmax_n(input.data(), output.data(), size, activate::Mode::Fast);
+            do_not_optimize(output[0]);
+        });
+    }
+}
+
+//Forward over a batch of distinct inputs, reported per sample
+static void bench_layer_forward(BenchRunner& runner, const std::string& name, const Layer& layer,
+    uint32_t input_size, uint32_t output_size, uint32_t batch) {
+    std::vector<float> inputs = random_floats(static_cast<size_t>(input_size) * batch, 0.0f, 1.0f, 2);
+    std::vector<float> output(std::max(input_size, output_size));
+    std::string params = std::to_string(input_size) + "x" + std::to_string(output_size) + " b=" + std::to_string(batch);
+    runner.run(name, params, batch, [&]() {
+        for (uint32_t b = 0; b < batch; ++b) {
+            layer.forward(inputs.data() + static_cast<size_t>(b) * input_size, output.data());
+        }
+        do_not_optimize(output[0]);
+    });
+}
+
+static void bench_layers(BenchRunner& runner) {
+    const uint32_t batches[] = { 1, 8, 64 };
+    InputLayer input_layer(INPUT_SIZE, HIDDEN_LAYER1_SIZE);
+    OutputLayer output_layer;
+    for (uint32_t batch : batches) {
+        bench_layer_forward(runner, "InputLayer::forward", input_layer, INPUT_SIZE, HIDDEN_LAYER1_SIZE, batch);
+        bench_layer_forward(runner, "OutputLayer::forward", output_layer, HIDDEN_LAYER1_SIZE, OUTPUT_SIZE, batch);
+    }
+
+    //Hidden sizes: the shape MLP uses today plus square layers for wider variants
+    const uint32_t hidden_sizes[] = { 16, 64, 256, 1024 };
+    for (uint32_t batch : batches) {
+        HiddenLayer mlp_hidden(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE);
+        bench_layer_forward(runner, "HiddenLayer::forward", mlp_hidden, HIDDEN_LAYER1_SIZE, OUTPUT_SIZE, batch);
+        for (uint32_t width : hidden_sizes) {
+            if (width >= 1024 && batch > 8) continue;
+            HiddenLayer hidden(width, width);
+            bench_layer_forward(runner, "HiddenLayer::forward", hidden, width, width, batch);
+        }
+    }
+
+    //update_weights uses the input cache filled by the last forward
+    std::vector<float> input = random_floats(HIDDEN_LAYER1_SIZE, 0.0f, 1.0f, 3);
+    std::vector<float> output(HIDDEN_LAYER1_SIZE);
+    output_layer.forward(input.data(), output.data());
+    runner.run("OutputLayer::update_weights", "64x1", 1, [&]() {
+        output_layer.update_weights(1e-6f, 1e-6f);
+    });
+    for (uint32_t width : hidden_sizes) {
+        HiddenLayer hidden(width, width);
+        std::vector<float> wide_input = random_floats(width, 0.0f, 1.0f, 4);
+        std::vector<float> wide_output(width);
+        hidden.forward(wide_input.data(), wide_output.data());
+        runner.run("HiddenLayer::update_weights", std::to_string(width) + "x" + std::to_string(width), 1, [&]() {
+            hidden.update_weights(1e-6f, 1e-6f);
+        });
+    }
+}
+
+//Row-major weights against the same weights prepacked into panels, one row tile per run
+static void bench_packed(BenchRunner& runner) {
+    const uint32_t widths[] = { 64, 256, 1024 };
+    const uint32_t tiles[] = { 1, 4, 8 };
+    for (uint32_t width : widths) {
+        std::vector<float> input = random_floats(width, 0.0f, 1.0f, 20);
+        std::vector<float> weights = random_floats(static_cast<size_t>(width) * width, -1.0f, 1.0f, 21);
+        std::vector<float> biases(width, 0.0f);
+        std::vector<float> output(width);
+        std::string params = std::to_string(width) + "x" + std::to_string(width);
+        runner.run("fused::dense_relu", params + ",row-major", 1, [&]() {
+            fused::dense_relu(input.data(), weights.data(), biases.data(), output.data(), width, width, -88.0f, 88.0f);
+            do_not_optimize(output[0]);
+        });
+        for (uint32_t tile : tiles) {
+            packed::PackedMatrix matrix;
+            matrix.pack(weights.data(), width, width, tile);
+            runner.run("fused::dense_relu", params + ",packed tile=" + std::to_string(tile), 1, [&]() {
+                fused::dense_relu(input.data(), matrix, biases.data(), output.data(), -88.0f, 88.0f);
+                do_not_optimize(output[0]);
+            });
+        }
+    }
+}
+
+//Wide hidden layers on one thread against the whole pool, the cost model keeps 64 wide layers serial either way
+static void bench_threads(BenchRunner& runner) {
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t widths[] = { 64, 256, 1024, 2048 };
+    for (uint32_t width : widths) {
+        std::vector<float> input = random_floats(width, 0.0f, 1.0f, 30);
+        std::vector<float> weights = random_floats(static_cast<size_t>(width) * width, -1.0f, 1.0f, 31);
+        std::vector<float> biases(width, 0.0f);
+        std::vector<float> output(width);
+        for (unsigned threads : { 1u, hardware }) {
+            parallel::set_threads(threads);
+            runner.run("fused::dense_relu", std::to_string(width) + "x" + std::to_string(width) + ",threads=" + std::to_string(threads), 1, [&]() {
+                fused::dense_relu(input.data(), weights.data(), biases.data(), output.data(), width, width, -88.0f, 88.0f);
+                do_not_optimize(output[0]);
+            });
+            if (hardware == 1) break;
+        }
+    }
+    parallel::set_threads(0);
+}
+
+static void bench_predict(BenchRunner& runner) {
+    MLP mlp(INPUT_SIZE);
+    std::vector<float> input = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f };
+    runner.run_latency("MLP::predict latency", "b=1", 2000, 20000, [&]() {
+        do_not_optimize(mlp.predict(input));
+    });
+    //The layered path predict used before the fused kernel, kept for comparison
+    runner.run_latency("MLP::forward latency", "b=1", 2000, 20000, [&]() {
+        mlp.forward(input);
+        do_not_optimize(mlp.get_output()[0]);
+    });
+
+    const uint32_t batches[] = { 1, 8, 64, 512 };
+    for (uint32_t batch : batches) {
+        std::vector<std::vector<float>> samples;
+        for (uint32_t b = 0; b < batch; ++b) {
+            samples.push_back(random_floats(INPUT_SIZE, 0.0f, 1.0f, 10 + b));
+        }
+        runner.run("MLP::predict", "b=" + std::to_string(batch), batch, [&]() {
+            float sum = 0.0f;
+            for (const auto& sample : samples) sum += mlp.predict(sample);
+            do_not_optimize(sum);
+        });
+    }
+}
+
+//The same three layers run through Layer pointers (one indirect call per layer) and through a static pipeline
+static void bench_dispatch(BenchRunner& runner) {
+    InputLayer input_layer(INPUT_SIZE, HIDDEN_LAYER1_SIZE);
+    HiddenLayer hidden_layer(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE);
+    OutputLayer output_layer;
+    Layer* chain[] = { &input_layer, &hidden_layer, &output_layer };
+    pipeline::StaticPipeline<InputLayer, HiddenLayer, OutputLayer> layers(input_layer, hidden_layer, output_layer);
+    std::vector<float> input = random_floats(INPUT_SIZE, 0.0f, 1.0f, 12);
+    std::vector<float> scratch(HIDDEN_LAYER1_SIZE);
+    float output = 0.0f;
+    runner.run("forward dispatch", "virtual", 1, [&]() {
+        chain[0]->forward(input.data(), scratch.data());
+        chain[1]->forward(scratch.data(), scratch.data());
+        chain[2]->forward(scratch.data(), &output);
+        do_not_optimize(output);
+    });
+    runner.run("forward dispatch", "static", 1, [&]() {
+        layers.forward(input.data(), scratch.data(), &output);
+        do_not_optimize(output);
+    });
+    runner.run("train step dispatch", "virtual", 1, [&]() {
+        chain[0]->forward(input.data(), scratch.data());
+        chain[1]->forward(scratch.data(), scratch.data());
+        chain[2]->forward(scratch.data(), &output);
+        for (int l = 2; l >= 0; --l) {
+            chain[l]->update_weights(output - 1.0f, 1e-6f);
+        }
+    });
+    runner.run("train step dispatch", "static", 1, [&]() {
+        layers.forward(input.data(), scratch.data(), &output);
+        layers.update_weights(output - 1.0f, 1e-6f);
+    });
+}
+
+//One training step (forward plus update) with today's per-layer SGD and with each fused optimizer over the arena
+static void bench_optimizers(BenchRunner& runner) {
+    std::vector<float> input = random_floats(INPUT_SIZE, 0.0f, 1.0f, 13);
+    MLP baseline(INPUT_SIZE);
+    runner.run("train step", "layer sgd", 1, [&]() {
+        baseline.forward(input);
+        baseline.update_weights(baseline.get_output()[0] - 1.0f, 1e-6f);
+    });
+    const optim::Method methods[] = { optim::Method::Sgd, optim::Method::Momentum, optim::Method::Adam, optim::Method::AdamW };
+    for (optim::Method method : methods) {
+        MLP mlp(INPUT_SIZE);
+        optim::Config config;
+        config.method = method;
+        config.learning_rate = 1e-6f;
+        config.clip = 1.0f;
+        optim::Optimizer optimizer(config, mlp.get_trainable_parameters().size());
+        runner.run("train step", std::string("fused ") + optim::method_name(method), 1, [&]() {
+            mlp.forward(input);
+            mlp.update_weights(mlp.get_output()[0] - 1.0f, optimizer);
+        });
+    }
+}
+
+//K models of one sweep trained one after another per sample (what K separate runs do) and stacked in one batched trainer
+static void bench_sweep(BenchRunner& runner) {
+    const uint32_t samples = 1000;
+    sweep::Dataset data;
+    for (uint32_t i = 0; i < samples; ++i) {
+        std::vector<float> x = random_floats(2, -1.0f, 1.0f, 100 + i);
+        data.emplace_back(x, x[0] * x[1] > 0.0f ? 1 : 0);
+    }
+    std::vector<uint32_t> order(samples);
+    for (uint32_t i = 0; i < samples; ++i) order[i] = i;
+
+    const uint32_t model_counts[] = { 1, 8, 32 };
+    for (uint32_t models : model_counts) {
+        std::vector<sweep::ModelSpec> specs = sweep::parse_grid("hidden=64 seeds=" + std::to_string(models));
+        sweep::StackedTrainer stacked(2, specs);
+        std::vector<sequential::Sequential> separate;
+        for (size_t k = 0; k < specs.size(); ++k) {
+            separate.push_back(stacked.to_sequential(k));
+        }
+        const std::string params = "K=" + std::to_string(models);
+        runner.run("sweep epoch separate", params, static_cast<double>(samples) * models, [&]() {
+            for (auto& network : separate) {
+                for (const auto& sample : data) {
+                    float target = static_cast<float>(sample.second);
+                    network.train_step(sample.first.data(), &target, 1e-4f);
+                }
+            }
+        }, 1.0, "model-samples/s");
+        const uint32_t batches[] = { 1, 16, 64 };
+        for (uint32_t batch : batches) {
+            runner.run("sweep epoch stacked", params + " b=" + std::to_string(batch), static_cast<double>(samples) * models, [&]() {
+                do_not_optimize(stacked.train_epoch(data, order, batch));
+            }, 1.0, "model-samples/s");
+        }
+    }
+}
+
+//A large holdout scored the old way (one predict per sample, accuracy only) and through the one pass evaluation engine
+static void bench_evaluation(BenchRunner& runner) {
+    const uint32_t rows = 1000000;
+    MLP mlp(INPUT_SIZE);
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    evaluation::Dataset data(rows);
+    for (uint32_t i = 0; i < rows; ++i) {
+        data[i].first.resize(INPUT_SIZE);
+        for (float& v : data[i].first) v = dist(rng);
+        data[i].second = static_cast<int>(i & 1);
+    }
+    std::string params = "rows=" + std::to_string(rows);
+    runner.run("evaluate per-sample accuracy", params, rows, [&]() {
+        uint64_t correct = 0;
+        for (const auto& sample : data) {
+            correct += (mlp.predict(sample.first) > 0.5f) == (sample.second != 0) ? 1 : 0;
+        }
+        do_not_optimize(correct);
+    }, 1.0, "samples/s");
+    runner.run("evaluate full report", params + " threads=" + std::to_string(parallel::default_pool().size()), rows, [&]() {
+        do_not_optimize(evaluation::evaluate(mlp, data).roc_auc);
+    }, 1.0, "samples/s");
+}
+
+//Digit vectors like read_data's, scored through normalize_input and the dense first layers against the embedding table
+static void bench_digit_table(BenchRunner& runner) {
+    const uint32_t rows = 200000;
+    MLP mlp(INPUT_SIZE);
+    std::mt19937 rng(14);
+    std::uniform_int_distribution<size_t> length(1, 9);
+    std::uniform_int_distribution<int> digit(1, 9);
+    std::vector<std::pair<std::vector<int>, int>> samples(rows);
+    for (auto& sample : samples) {
+        sample.first.resize(length(rng));
+        for (int& d : sample.first) d = digit(rng);
+    }
+    embedding::DigitTable table(mlp);
+    std::string params = "rows=" + std::to_string(rows);
+    runner.run("digits normalize_input+predict", params, rows, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += mlp.predict(MLP::normalize_input(sample.first));
+        }
+        do_not_optimize(sum);
+    }, 1.0, "samples/s");
+    runner.run("digits embedding table", params, rows, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += table.predict(sample.first);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "samples/s");
+    runner.run("digits embedding table batch", params + " threads=" + std::to_string(parallel::default_pool().size()), rows, [&]() {
+        do_not_optimize(table.predict_batch(samples).back());
+    }, 1.0, "samples/s");
+}
+
+//A sensor stream where one feature moves per reading, full predicts against the incremental predictor fed the whole
+//reading and fed just the change
+static void bench_incremental(BenchRunner& runner) {
+    const uint32_t readings = 100000;
+    MLP mlp(INPUT_SIZE);
+    std::mt19937 rng(15);
+    std::uniform_int_distribution<uint32_t> feature(0, INPUT_SIZE - 1);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<std::pair<uint32_t, float>> changes(readings);
+    for (auto& change : changes) {
+        change = { feature(rng), value(rng) };
+    }
+    std::string params = "readings=" + std::to_string(readings) + " changed=1";
+    runner.run("sensor full predict", params, readings, [&]() {
+        std::vector<float> input(INPUT_SIZE, 0.0f);
+        float sum = 0.0f;
+        for (const auto& change : changes) {
+            input[change.first] = change.second;
+            sum += mlp.predict(input);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "readings/s");
+    runner.run("sensor delta update reading", params, readings, [&]() {
+        incremental::DeltaPredictor predictor(mlp);
+        std::vector<float> input(INPUT_SIZE, 0.0f);
+        float sum = 0.0f;
+        for (const auto& change : changes) {
+            input[change.first] = change.second;
+            sum += predictor.update(input);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "readings/s");
+    runner.run("sensor delta update feature", params, readings, [&]() {
+        incremental::DeltaPredictor predictor(mlp);
+        float sum = 0.0f;
+        for (const auto& change : changes) {
+            sum += predictor.update(change.first, change.second);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "readings/s");
+}
+
+//A sensor series pushed a value at a time, each window copied into a vector for predict against the whole buffer
+//scored in place, and the running window statistics on their own
+static void bench_windows(BenchRunner& runner) {
+    const uint32_t capacity = 4096;
+    MLP mlp(INPUT_SIZE);
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<float> stream(capacity);
+    for (auto& v : stream) v = value(rng);
+    series::RingSeries ring(capacity);
+    ring.push(stream.data(), stream.size());
+    series::WindowScorer scorer(mlp);
+    const uint32_t windows = ring.window_count();
+    std::string params = "windows=" + std::to_string(windows) + " window=" + std::to_string(INPUT_SIZE);
+    runner.run("series copied windows predict", params, windows, [&]() {
+        float sum = 0.0f;
+        for (uint32_t k = 0; k < windows; ++k) {
+            const float* w = ring.window_values(k);
+            sum += mlp.predict(std::vector<float>(w, w + INPUT_SIZE));
+        }
+        do_not_optimize(sum);
+    }, 1.0, "windows/s");
+    std::vector<float> scores(windows);
+    runner.run("series windows in place", params, windows, [&]() {
+        scorer.score(ring, 0, windows, scores.data());
+        do_not_optimize(scores.back());
+    }, 1.0, "windows/s");
+    runner.run("series push with stats", "values=" + std::to_string(capacity), capacity, [&]() {
+        float sum = 0.0f;
+        for (float v : stream) {
+            ring.push(v);
+            const series::WindowStats& stats = ring.stats();
+            sum += stats.mean + stats.min + stats.max + stats.delta;
+        }
+        do_not_optimize(sum);
+    }, 1.0, "values/s");
+}
+
+//read_data style samples (number, even flag), the full network for every sample against the cascade one at a time and
+//batched, the exit rate is in the params since the savings scale with it
+static void bench_cascade(BenchRunner& runner) {
+    const uint32_t rows = 200000;
+    MLP mlp(INPUT_SIZE);
+    cascade::Dataset samples(rows);
+    for (uint32_t i = 0; i < rows; ++i) {
+        samples[i] = { { static_cast<float>(i + 1), (i + 1) % 2 == 0 ? 1.0f : 0.0f }, static_cast<int>((i + 1) % 2) };
+    }
+    cascade::Cascade model(mlp, cascade::Dataset(samples.begin(), samples.begin() + rows / 10));
+    cascade::Report report = model.evaluate(samples);
+    char rate[64];
+    std::snprintf(rate, sizeof(rate), " exit=%.3f acc_delta=%+.4f", report.exit_rate, report.accuracy_delta);
+    std::string params = "rows=" + std::to_string(rows) + rate;
+    runner.run("cascade full predict", params, rows, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += mlp.predict(sample.first);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "samples/s");
+    runner.run("cascade predict", params, rows, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += model.predict(sample.first);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "samples/s");
+    runner.run("cascade predict batch", params, rows, [&]() {
+        do_not_optimize(model.predict_batch(samples).back());
+    }, 1.0, "samples/s");
+}
+
+//Integer traffic that repeats, a million lookups over 10000 distinct numbers with a skew toward the small ones, uncached
+//predicts against the cache one at a time and batched, the hit rate is in the params
+static void bench_prediction_cache(BenchRunner& runner) {
+    const uint32_t lookups = 1000000;
+    MLP mlp(INPUT_SIZE);
+    std::mt19937 rng(17);
+    std::exponential_distribution<double> skew(1.0 / 1500.0);
+    std::vector<std::pair<std::vector<float>, int>> samples(lookups);
+    for (auto& sample : samples) {
+        const int n = 1 + static_cast<int>(skew(rng)) % 10000;
+        sample.first = { static_cast<float>(n), n % 2 == 0 ? 1.0f : 0.0f };
+    }
+    std::string params = "lookups=" + std::to_string(lookups) + " distinct=10000";
+    runner.run("cache off predict", params, lookups, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += mlp.predict(sample.first);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "lookups/s");
+    //Warm for the reported hit rate, each timed run below keeps the same warm cache
+    cache::PredictionCache cache(mlp);
+    for (const auto& sample : samples) {
+        cache.predict(sample.first);
+    }
+    char rate[32];
+    std::snprintf(rate, sizeof(rate), " hit=%.3f", cache.get_stats().hit_rate);
+    runner.run("cache predict", params + rate, lookups, [&]() {
+        float sum = 0.0f;
+        for (const auto& sample : samples) {
+            sum += cache.predict(sample.first);
+        }
+        do_not_optimize(sum);
+    }, 1.0, "lookups/s");
+    runner.run("cache predict batch", params + rate, lookups, [&]() {
+        do_not_optimize(cache.predict_batch(samples).back());
+    }, 1.0, "lookups/s");
+}
+
+//Scores a million consecutive integers, one feature vector and predict call per number against the batched range engine
+static void bench_score_range(BenchRunner& runner) {
+    const uint64_t begin = 1000000;
+    const uint64_t count = 1000000;
+    MLP mlp(2);
+    range::RangeScorer scorer(mlp);
+    std::string params = "n=" + std::to_string(count);
+    runner.run("score range per-number predict", params, count, [&]() {
+        uint64_t positive = 0;
+        std::vector<float> features(2);
+        for (uint64_t n = begin; n < begin + count; ++n) {
+            features[0] = static_cast<float>(n);
+            features[1] = n % 2 == 0 ? 1.0f : 0.0f;
+            positive += mlp.predict(features) > 0.5f ? 1 : 0;
+        }
+        do_not_optimize(positive);
+    }, 1.0, "numbers/s");
+    params += " threads=" + std::to_string(parallel::default_pool().size());
+    runner.run("score range stream", params, count, [&]() {
+        std::atomic<uint64_t> positive(0);
+        scorer.score_range(begin, begin + count, [&](uint64_t, const float* scores, uint32_t n) {
+            uint64_t local = 0;
+            for (uint32_t i = 0; i < n; ++i) local += scores[i] > 0.5f ? 1 : 0;
+            positive += local;
+        });
+        do_not_optimize(positive.load());
+    }, 1.0, "numbers/s");
+    runner.run("score range bitmap", params, count, [&]() {
+        do_not_optimize(scorer.positives(begin, begin + count).count());
+    }, 1.0, "numbers/s");
+}
+
+//One all-reduce across 4 ranks (threads standing in for worker processes) per call, the MLP's gradient size and a
+//large buffer, plain and fp16. The last slot tells the helper ranks to stop.
+static void bench_all_reduce(BenchRunner& runner) {
+    const uint32_t ranks = 4;
+    const size_t counts[] = { 130, 65536 };
+    for (distributed::Backend backend : { distributed::Backend::SharedMemory, distributed::Backend::Socket }) {
+        for (size_t count : counts) {
+            for (bool compress : { false, true }) {
+                distributed::Endpoint endpoint;
+                endpoint.backend = backend;
+                endpoint.name = "edgemlp_bench_" + std::to_string(count) + (compress ? "_fp16" : "") + "_" + distributed::backend_name(backend);
+                endpoint.size = ranks;
+                distributed::Session session(endpoint);
+                std::vector<std::thread> helpers;
+                for (uint32_t r = 1; r < ranks; ++r) {
+                    helpers.emplace_back([&, r]() {
+                        distributed::Endpoint mine = endpoint;
+                        mine.rank = r;
+                        std::unique_ptr<distributed::Transport> transport = distributed::connect(mine);
+                        std::vector<float> values(count + 1);
+                        do {
+                            std::fill(values.begin(), values.end(), 0.0f);
+                            distributed::all_reduce(*transport, Span<float>(values.data(), values.size()), compress);
+                        } while (values[count] == 0.0f);
+                    });
+                }
+                std::unique_ptr<distributed::Transport> transport = distributed::connect(endpoint);
+                std::vector<float> values = random_floats(count + 1, -1.0f, 1.0f, 20);
+                std::string params = std::string(distributed::backend_name(backend)) + " ranks=4 n=" + std::to_string(count)
+                    + (compress ? " fp16" : "");
+                runner.run("ring all_reduce", params, 1, [&]() {
+                    values[count] = 0.0f;
+                    distributed::all_reduce(*transport, Span<float>(values.data(), values.size()), compress);
+                });
+                values[count] = 1.0f;
+                distributed::all_reduce(*transport, Span<float>(values.data(), values.size()), compress);
+                for (auto& helper : helpers) helper.join();
+            }
+        }
+    }
+}
+
+//Writes synthetic datasets the size of a real run and measures each parser in MB/s
+static void bench_parsing(BenchRunner& runner) {
+    const int rows = 20000;
+    const std::string number_file = "bench_numbers.txt";
+    const std::string float_file = "bench_floats.txt";
+    {
+        std::ofstream numbers(number_file);
+        std::ofstream floats(float_file);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (int i = 0; i < rows; ++i) {
+            numbers << (i * 7919 % 1000000) << ", " << (i & 1) << "\n";
+            for (uint32_t j = 0; j < INPUT_SIZE; ++j) floats << dist(rng) << ",";
+            floats << (i & 1) << "\n";
+        }
+    }
+    auto file_mb = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return static_cast<double>(file.tellg()) / (1024.0 * 1024.0);
+    };
+    std::string params = "rows=" + std::to_string(rows);
+
+    double mb = file_mb(number_file);
+    runner.run("read_data_from_file", params, 1, [&]() {
+        ScopedSilence quiet;
+        do_not_optimize(read_data_from_file(number_file).size());
+    }, mb, "MB/s");
+    runner.run("read_data", params, 1, [&]() {
+        ScopedSilence quiet;
+        do_not_optimize(read_data(number_file).size());
+    }, mb, "MB/s");
+    mb = file_mb(float_file);
+    runner.run("read_float_data", params, 1, [&]() {
+        ScopedSilence quiet;
+        do_not_optimize(read_float_data(float_file).size());
+    }, mb, "MB/s");
+
+    std::remove(number_file.c_str());
+    std::remove(float_file.c_str());
+}
+
+static void bench_weight_io(BenchRunner& runner) {
+    const size_t counts[] = { 2464, 65536 };
+    for (size_t count : counts) {
+        const std::string path = "bench_weights.txt";
+        std::vector<float> weights = random_floats(count, -1.0f, 1.0f, 6);
+        std::string params = "n=" + std::to_string(count);
+        runner.run("save_weights", params, 1, [&]() {
+            save_weights(weights, path);
+        });
+        runner.run("load_weights", params, 1, [&]() {
+            do_not_optimize(load_weights(path).size());
+        });
+        std::remove(path.c_str());
+    }
+}
+
+//Same per-sample step as the training loop in main.cpp, reported as epochs per second
+static void bench_training(BenchRunner& runner) {
+    const size_t dataset_sizes[] = { 79, 1000, 10000 };
+    const float learning_rate = 0.1f;
+    for (size_t size : dataset_sizes) {
+        std::vector<std::pair<std::vector<float>, int>> data;
+        for (size_t i = 0; i < size; ++i) {
+            int number = static_cast<int>(i + 1);
+            data.emplace_back(std::vector<float>{ static_cast<float>(number), number % 2 == 0 ? 1.0f : 0.0f }, number % 2);
+        }
+        MLP mlp(2);
+        runner.run("train_epoch", "samples=" + std::to_string(size), 1, [&]() {
+            for (const auto& sample : data) {
+                mlp.forward(sample.first);
+                float error = mlp.get_output()[0] - sample.second;
+                mlp.update_weights(error, learning_rate);
+            }
+        }, 1.0, "epochs/s");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string out_path = "bench_results.json";
+    int cpu = 0;
+    bool quick = false;
+    double threshold = 0.10;
+    std::string compare_base, compare_candidate;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (arg == "--cpu" && i + 1 < argc) cpu = std::atoi(argv[++i]);
+        else if (arg == "--quick") quick = true;
+        else if (arg == "--threshold" && i + 1 < argc) threshold = std::atof(argv[++i]);
+        else if (arg == "--compare" && i + 2 < argc) {
+            compare_base = argv[++i];
+            compare_candidate = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: MLP_Benchmark [--out results.json] [--cpu N] [--quick]\n"
+                << "       MLP_Benchmark --compare baseline.json candidate.json [--threshold 0.10]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!compare_base.empty()) {
+        int regressions = compare_bench_json(compare_base, compare_candidate, threshold);
+        return regressions == 0 ? 0 : 1;
+    }
+
+    try {
+        if (cpu >= 0 && !pin_to_cpu(cpu)) {
+            std::cerr << "Warning: Unable to pin to CPU " << cpu << ", results may be noisier" << std::endl;
+            cpu = -1;
+        }
+
+        BenchRunner runner(quick);
+        bench_activations(runner);
+        bench_layers(runner);
+        bench_packed(runner);
+        bench_threads(runner);
+        bench_predict(runner);
+        bench_dispatch(runner);
+        bench_optimizers(runner);
+        bench_sweep(runner);
+        bench_evaluation(runner);
+        bench_score_range(runner);
+        bench_digit_table(runner);
+        bench_incremental(runner);
+        bench_windows(runner);
+        bench_cascade(runner);
+        bench_prediction_cache(runner);
+        bench_all_reduce(runner);
+        bench_parsing(runner);
+        bench_weight_io(runner);
+        bench_training(runner);
+
+        if (!write_bench_json(out_path, "MLP_Benchmark", cpu, runner.get_results())) {
+            return 1;
+        }
+        std::cout << "Results written to " << out_path << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,273 @@
+#pragma once
+// benchmark.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header holds the small timing harness shared by the benchmarks, it handles warmup, iteration calibration, CPU pinning, JSON output and comparing two JSON runs for regressions.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+//One benchmark case, ns_per_op is the median over the measured batches. Latency cases time every call and fill p99_ns,
+//throughput cases only have a handful of batch means and fill max_batch_ns (the slowest batch) instead.
+struct BenchResult {
+    std::string name;
+    std::string params;
+    double ns_per_op = 0.0;
+    double p50_ns = 0.0;
+    double p99_ns = 0.0;
+    double max_batch_ns = 0.0;
+    double throughput = 0.0;
+    std::string unit;
+    uint64_t iterations = 0;
+};
+
+//Keeps the optimizer from removing benchmarked work
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline int64_t bench_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Pins the calling thread to one CPU so latency numbers are not smeared by migrations
+inline bool pin_to_cpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+class BenchRunner {
+public:
+    explicit BenchRunner(bool quick = false)
+        : batches(quick ? 5 : 15), min_batch_ns(quick ? 200000 : 2000000) {}
+
+    //Throughput benchmark: fn runs ops_per_call operations, the iteration count is calibrated to min_batch_ns
+    template <typename Fn>
+    BenchResult& run(const std::string& name, const std::string& params, double ops_per_call, Fn&& fn,
+        double units_per_op = 0.0, const std::string& unit = "ops/s") {
+        uint64_t iterations = 1;
+        for (;;) {
+            int64_t start = bench_now_ns();
+            for (uint64_t i = 0; i < iterations; ++i) fn();
+            int64_t elapsed = bench_now_ns() - start;
+            if (elapsed >= min_batch_ns || iterations >= (1ull << 30)) break;
+            iterations *= 2;
+        }
+
+        std::vector<double> per_op;
+        for (uint32_t b = 0; b < batches; ++b) {
+            int64_t start = bench_now_ns();
+            for (uint64_t i = 0; i < iterations; ++i) fn();
+            int64_t elapsed = bench_now_ns() - start;
+            per_op.push_back(static_cast<double>(elapsed) / (iterations * ops_per_call));
+        }
+        std::sort(per_op.begin(), per_op.end());
+
+        BenchResult result;
+        result.name = name;
+        result.params = params;
+        result.ns_per_op = per_op[per_op.size() / 2];
+        result.p50_ns = result.ns_per_op;
+        result.max_batch_ns = per_op.back();
+        double ops_per_sec = result.ns_per_op > 0.0 ? 1e9 / result.ns_per_op : 0.0;
+        result.throughput = (units_per_op > 0.0) ? ops_per_sec * units_per_op : ops_per_sec;
+        result.unit = unit;
+        result.iterations = iterations * batches;
+        return record(result);
+    }
+
+    //Latency benchmark: every call is timed on its own so tail percentiles are visible
+    template <typename Fn>
+    BenchResult& run_latency(const std::string& name, const std::string& params, uint32_t warmup, uint32_t samples, Fn&& fn) {
+        for (uint32_t i = 0; i < warmup; ++i) fn();
+
+        std::vector<double> latencies(samples);
+        int64_t total_start = bench_now_ns();
+        for (uint32_t i = 0; i < samples; ++i) {
+            int64_t start = bench_now_ns();
+            fn();
+            latencies[i] = static_cast<double>(bench_now_ns() - start);
+        }
+        int64_t total = bench_now_ns() - total_start;
+        std::sort(latencies.begin(), latencies.end());
+
+        BenchResult result;
+        result.name = name;
+        result.params = params;
+        result.ns_per_op = static_cast<double>(total) / samples;
+        result.p50_ns = latencies[samples / 2];
+        result.p99_ns = latencies[std::min<size_t>(samples - 1, static_cast<size_t>(samples * 0.99))];
+        result.throughput = result.ns_per_op > 0.0 ? 1e9 / result.ns_per_op : 0.0;
+        result.unit = "calls/s";
+        result.iterations = samples;
+        return record(result);
+    }
+
+    BenchResult& record(const BenchResult& result) {
+        results.push_back(result);
+        std::cout << std::left << std::setw(34) << result.name << std::setw(22) << result.params << std::right
+            << std::fixed << std::setprecision(2) << std::setw(14) << result.ns_per_op << " ns/op"
+            << std::setw(16) << std::setprecision(1) << result.throughput << " " << result.unit << std::endl;
+        return results.back();
+    }
+
+    const std::vector<BenchResult>& get_results() const { return results; }
+
+private:
+    uint32_t batches;
+    int64_t min_batch_ns;
+    std::vector<BenchResult> results;
+};
+
+//Writes one result object per line so the file stays easy to diff and to read back
+inline bool write_bench_json(const std::string& path, const std::string& suite, int cpu, const std::vector<BenchResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << path << std::endl;
+        return false;
+    }
+    file << "{\n  \"suite\": \"" << suite << "\",\n  \"cpu\": " << cpu << ",\n  \"results\": [\n";
+    file << std::setprecision(6) << std::fixed;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        file << "    {\"name\": \"" << r.name << "\", \"params\": \"" << r.params << "\", \"ns_per_op\": " << r.ns_per_op
+            << ", \"p50_ns\": " << r.p50_ns;
+        if (r.max_batch_ns > 0.0) {
+            file << ", \"max_batch_ns\": " << r.max_batch_ns;
+        }
+        else {
+            file << ", \"p99_ns\": " << r.p99_ns;
+        }
+        file << ", \"throughput\": " << r.throughput
+            << ", \"unit\": \"" << r.unit << "\", \"iterations\": " << r.iterations << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return true;
+}
+
+//Pulls a string or number field out of one of our result lines
+inline std::string bench_json_field(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) return "";
+    pos += pattern.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+}
+
+inline std::vector<BenchResult> read_bench_json(const std::string& path) {
+    std::vector<BenchResult> results;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << path << std::endl;
+        return results;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find("\"name\": ") == std::string::npos) continue;
+        BenchResult r;
+        r.name = bench_json_field(line, "name");
+        r.params = bench_json_field(line, "params");
+        r.ns_per_op = std::atof(bench_json_field(line, "ns_per_op").c_str());
+        r.p50_ns = std::atof(bench_json_field(line, "p50_ns").c_str());
+        r.p99_ns = std::atof(bench_json_field(line, "p99_ns").c_str());
+        r.max_batch_ns = std::atof(bench_json_field(line, "max_batch_ns").c_str());
+        r.throughput = std::atof(bench_json_field(line, "throughput").c_str());
+        r.unit = bench_json_field(line, "unit");
+        results.push_back(r);
+    }
+    return results;
+}
+
+//Prints the change of every case present in both runs, then the cases only one run has. Returns how many slowed down by
+//more than threshold (0.10 = 10%) plus how many baseline cases the candidate is missing, a case that stopped running is
+//a failure too. Cases new in the candidate are listed but do not fail.
+inline int compare_bench_json(const std::string& baseline_path, const std::string& candidate_path, double threshold) {
+    std::vector<BenchResult> baseline = read_bench_json(baseline_path);
+    std::vector<BenchResult> candidate = read_bench_json(candidate_path);
+    if (baseline.empty() || candidate.empty()) {
+        std::cerr << "Error: Nothing to compare" << std::endl;
+        return -1;
+    }
+
+    std::map<std::string, const BenchResult*> by_key;
+    for (const BenchResult& r : baseline) by_key[r.name + "|" + r.params] = &r;
+
+    int regressions = 0;
+    std::vector<const BenchResult*> added;
+    for (const BenchResult& r : candidate) {
+        auto it = by_key.find(r.name + "|" + r.params);
+        if (it == by_key.end()) {
+            added.push_back(&r);
+            continue;
+        }
+        const BenchResult& base = *it->second;
+        by_key.erase(it);
+        if (base.ns_per_op <= 0.0) continue;
+        double change = r.ns_per_op / base.ns_per_op - 1.0;
+        const char* verdict = "";
+        if (change > threshold) {
+            verdict = "  REGRESSION";
+            ++regressions;
+        }
+        else if (change < -threshold) {
+            verdict = "  improved";
+        }
+        std::cout << std::left << std::setw(34) << r.name << std::setw(22) << r.params << std::right << std::fixed
+            << std::setprecision(2) << std::setw(12) << base.ns_per_op << " -> " << std::setw(12) << r.ns_per_op
+            << " ns/op " << std::showpos << std::setw(8) << change * 100.0 << "%" << std::noshowpos << verdict << std::endl;
+    }
+
+    //Whatever is left in by_key never showed up in the candidate, listed in baseline order
+    int missing = 0;
+    for (const BenchResult& r : baseline) {
+        if (by_key.erase(r.name + "|" + r.params) == 0) continue;
+        std::cout << std::left << std::setw(34) << r.name << std::setw(22) << r.params << std::right
+            << "  MISSING from the candidate" << std::endl;
+        ++missing;
+    }
+    for (const BenchResult* r : added) {
+        std::cout << std::left << std::setw(34) << r->name << std::setw(22) << r->params << std::right
+            << "  new in the candidate" << std::endl;
+    }
+    std::cout << regressions << " regression(s) above " << threshold * 100.0 << "%, " << missing << " missing case(s), "
+        << added.size() << " new case(s)" << std::endl;
+    return regressions + missing;
+}
+
+#endif
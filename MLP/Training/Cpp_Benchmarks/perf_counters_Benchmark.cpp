@@ -0,0 +1,135 @@
+// perf_counters_Benchmark.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This benchmark wraps HiddenLayer::forward, OutputLayer::forward and MLP::predict in perf_event_open counter groups and prints per-call counter deltas along with a roofline style FLOPs per byte estimate for each layer shape.
+// Like the testbenches this has its own main, so build it alongside the Training sources without main.cpp.
+
+#include "MLP.h"
+#include "layers.h"
+#include "perf_counters.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+//Shape description used for the roofline estimate
+struct LayerShape {
+    std::string name;
+    uint32_t input_size;
+    uint32_t output_size;
+};
+
+//Compulsory FLOPs for a dense layer: a multiply and add per weight, plus the bias add and activation per output
+static double layer_flops(const LayerShape& shape) {
+    return 2.0 * shape.input_size * shape.output_size + 2.0 * shape.output_size;
+}
+
+//Compulsory bytes moved: weights, biases, the input vector read and the output vector written
+static double layer_bytes(const LayerShape& shape) {
+    return sizeof(float) * (static_cast<double>(shape.input_size) * shape.output_size +
+        2.0 * shape.output_size + shape.input_size);
+}
+
+static void print_header(const PerfCounterGroup& group) {
+    std::cout << group.status() << "\n\n";
+    std::cout << std::left << std::setw(26) << "kernel"
+        << std::right << std::setw(12) << "ns/call"
+        << std::setw(12) << "cycles"
+        << std::setw(12) << "instr"
+        << std::setw(8) << "IPC"
+        << std::setw(10) << "L1D miss"
+        << std::setw(10) << "LLC miss"
+        << std::setw(10) << "br miss"
+        << std::setw(10) << "FLOP/B"
+        << std::setw(10) << "GFLOP/s" << std::endl;
+}
+
+//Prints one row, counters that are unavailable show as "-"
+static void print_row(const std::string& name, const PerfSample& sample, double flops, double bytes) {
+    std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(12) << sample.wall_ns;
+    const uint32_t columns[] = { PERF_CYCLES, PERF_INSTRUCTIONS };
+    for (uint32_t e : columns) {
+        if (sample.valid[e]) std::cout << std::setw(12) << sample.values[e];
+        else std::cout << std::setw(12) << "-";
+    }
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS]) std::cout << std::setw(8) << std::setprecision(2) << sample.ipc();
+    else std::cout << std::setw(8) << "-";
+    const uint32_t misses[] = { PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_BRANCH_MISSES };
+    for (uint32_t e : misses) {
+        if (sample.valid[e]) std::cout << std::setw(10) << std::setprecision(2) << sample.values[e];
+        else std::cout << std::setw(10) << "-";
+    }
+    double gflops = sample.wall_ns > 0.0 ? flops / sample.wall_ns : 0.0;
+    std::cout << std::setw(10) << std::setprecision(3) << flops / bytes
+        << std::setw(10) << std::setprecision(3) << gflops << std::endl;
+}
+
+//Runs a warmup, then reports the per-call counter deltas of a layer forward
+static void bench_layer(PerfCounterGroup& group, const Layer& layer, const LayerShape& shape, uint32_t repetitions) {
+    std::vector<float> input(shape.input_size);
+    std::vector<float> output(shape.output_size);
+    for (uint32_t i = 0; i < shape.input_size; ++i) {
+        input[i] = static_cast<float>(i % 7) * 0.1f;
+    }
+    for (uint32_t r = 0; r < repetitions / 10 + 1; ++r) {
+        layer.forward(input.data(), output.data());
+    }
+    PerfSample sample = measure_per_call(group, repetitions, [&]() {
+        layer.forward(input.data(), output.data());
+    });
+    print_row(shape.name, sample, layer_flops(shape), layer_bytes(shape));
+}
+
+int main(int argc, char** argv) {
+    uint32_t repetitions = (argc > 1) ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    if (repetitions == 0) {
+        std::cerr << "Usage: perf_counters_Benchmark [repetitions]" << std::endl;
+        return 1;
+    }
+
+    try {
+        PerfCounterGroup group;
+        print_header(group);
+
+        //Shapes used by the MLP today
+        LayerShape hidden_shape{ "HiddenLayer::forward", HIDDEN_LAYER1_SIZE, OUTPUT_SIZE };
+        HiddenLayer hidden_layer(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE);
+        bench_layer(group, hidden_layer, hidden_shape, repetitions);
+
+        LayerShape output_shape{ "OutputLayer::forward", HIDDEN_LAYER1_SIZE, OUTPUT_SIZE };
+        OutputLayer output_layer;
+        bench_layer(group, output_layer, output_shape, repetitions);
+
+        //Wider hidden shapes for kernel tuning
+        const uint32_t widths[] = { 64, 256, 1024 };
+        for (uint32_t width : widths) {
+            LayerShape shape{ "Hidden " + std::to_string(width) + "x" + std::to_string(width), width, width };
+            HiddenLayer wide_layer(width, width);
+            uint32_t scaled = repetitions / (width / 16) + 1;
+            bench_layer(group, wide_layer, shape, scaled);
+        }
+
+        //Full predict, the input layer is a copy so only the two dense layers contribute FLOPs
+        MLP mlp(INPUT_SIZE);
+        std::vector<float> input = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f };
+        for (uint32_t r = 0; r < repetitions / 10 + 1; ++r) {
+            mlp.predict(input);
+        }
+        volatile float sink = 0.0f;
+        PerfSample sample = measure_per_call(group, repetitions, [&]() {
+            sink = mlp.predict(input);
+        });
+        double flops = layer_flops(hidden_shape) + layer_flops(output_shape);
+        double bytes = layer_bytes(hidden_shape) + layer_bytes(output_shape);
+        print_row("MLP::predict", sample, flops, bytes);
+        (void)sink;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -5,7 +5,9 @@
 #include "MLP.h"
 #include "layers.h"
 #include "utilities.h"
+#include "threadpool.h"
 #include <cmath>
+#include <cstdio>
 #include <algorithm>
 #include <iostream>
 #include <stdexcept>
@@ -61,49 +63,107 @@ std::vector<float> MLP::normalize_input(const std::vector<int>& input) {
     return normalized;
 }
 
-std::vector<float> MLP::get_weights() const {
-    std::vector<float> all_weights;
+namespace {
+    //Arena layout, all weights (input, hidden, output) and then all biases (hidden, output, input) so both halves are
+    //single contiguous views and so are the trained parameters, the input layer only copies and is never updated.
+    //InputLayer is always INPUT_SIZE x HIDDEN_LAYER1_SIZE whatever size MLP is built with.
+    constexpr size_t INPUT_WEIGHTS = static_cast<size_t>(INPUT_SIZE) * HIDDEN_LAYER1_SIZE;
+    constexpr size_t HIDDEN_WEIGHTS = static_cast<size_t>(HIDDEN_LAYER1_SIZE) * OUTPUT_SIZE;
+    constexpr size_t OUTPUT_WEIGHTS = static_cast<size_t>(HIDDEN_LAYER1_SIZE) * OUTPUT_SIZE;
+    constexpr size_t WEIGHT_COUNT = INPUT_WEIGHTS + HIDDEN_WEIGHTS + OUTPUT_WEIGHTS;
+    constexpr size_t BIAS_COUNT = HIDDEN_LAYER1_SIZE + OUTPUT_SIZE + OUTPUT_SIZE;
 
-    // Collect weights from input layer
-    const auto& input_weights = input_layer.get_weights();
-    all_weights.insert(all_weights.end(), input_weights.begin(), input_weights.end());
+    constexpr size_t HIDDEN_WEIGHT_OFFSET = INPUT_WEIGHTS;
+    constexpr size_t OUTPUT_WEIGHT_OFFSET = HIDDEN_WEIGHT_OFFSET + HIDDEN_WEIGHTS;
+    constexpr size_t HIDDEN_BIAS_OFFSET = WEIGHT_COUNT;
+    constexpr size_t OUTPUT_BIAS_OFFSET = HIDDEN_BIAS_OFFSET + OUTPUT_SIZE;
+    constexpr size_t INPUT_BIAS_OFFSET = OUTPUT_BIAS_OFFSET + OUTPUT_SIZE;
+    constexpr size_t TRAINABLE_COUNT = INPUT_BIAS_OFFSET - HIDDEN_WEIGHT_OFFSET;
 
-    // Collect weights from hidden layer
-    const auto& hidden_weights = hidden_layer1.get_weights();
-    all_weights.insert(all_weights.end(), hidden_weights.begin(), hidden_weights.end());
+    const char PARAMETER_MAGIC[4] = { 'E', 'M', 'L', 'P' };
+    constexpr uint32_t PARAMETER_VERSION = 2;
+}
 
-    // Collect weights from output layer
-    const auto& output_weights = output_layer.get_weights();
-    all_weights.insert(all_weights.end(), output_weights.begin(), output_weights.end());
+Span<const float> MLP::get_weights() const {
+    return arena.view(0, WEIGHT_COUNT);
+}
 
-    return all_weights;
+Span<const float> MLP::get_biases() const {
+    return arena.view(WEIGHT_COUNT, BIAS_COUNT);
 }
 
-std::vector<float> MLP::get_biases() const {
-    std::vector<float> all_biases;
+Span<float> MLP::get_parameters() {
+    return arena.all();
+}
 
-    // Collect biases from input layer
-    const auto& input_biases = input_layer.get_biases();
-    all_biases.insert(all_biases.end(), input_biases.begin(), input_biases.end());
+Span<const float> MLP::get_parameters() const {
+    return arena.all();
+}
 
-    // Collect biases from hidden layer
-    const auto& hidden_biases = hidden_layer1.get_biases();
-    all_biases.insert(all_biases.end(), hidden_biases.begin(), hidden_biases.end());
+bool MLP::save_parameters(const std::string& file_path) const {
+    FILE* file = std::fopen(file_path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    uint64_t count = arena.size();
+    bool ok = std::fwrite(PARAMETER_MAGIC, 1, sizeof(PARAMETER_MAGIC), file) == sizeof(PARAMETER_MAGIC)
+        && std::fwrite(&PARAMETER_VERSION, sizeof(PARAMETER_VERSION), 1, file) == 1
+        && std::fwrite(&count, sizeof(count), 1, file) == 1
+        && std::fwrite(arena.data(), sizeof(float), count, file) == count;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Unable to write parameters to " << file_path << std::endl;
+    }
+    return ok;
+}
 
-    // Collect biases from output layer
-    const auto& output_biases = output_layer.get_biases();
-    all_biases.insert(all_biases.end(), output_biases.begin(), output_biases.end());
+bool MLP::load_parameters(const std::string& file_path) {
+    FILE* file = std::fopen(file_path.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    char magic[sizeof(PARAMETER_MAGIC)] = {};
+    uint32_t version = 0;
+    uint64_t count = 0;
+    bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && std::equal(magic, magic + sizeof(magic), PARAMETER_MAGIC)
+        && std::fread(&version, sizeof(version), 1, file) == 1 && version == PARAMETER_VERSION
+        && std::fread(&count, sizeof(count), 1, file) == 1 && count == arena.size();
+    //Read into a scratch copy so a truncated file leaves the current parameters untouched
+    std::vector<float> values(ok ? count : 0);
+    ok = ok && std::fread(values.data(), sizeof(float), count, file) == count;
+    std::fclose(file);
+    if (!ok) {
+        std::cerr << "Error: " << file_path << " does not hold parameters for this MLP" << std::endl;
+        return false;
+    }
+    std::copy(values.begin(), values.end(), arena.data());
+    mark_parameters_changed();
+    return true;
+}
 
-    return all_biases;
+void MLP::mark_parameters_changed() {
+    input_layer.mark_changed();
+    hidden_layer1.mark_changed();
+    output_layer.mark_changed();
 }
 
 // Initializing member defining the initial layers, and MLP (1 Output Layer) 
 MLP::MLP(uint32_t max_input_size)
-    : input_layer(max_input_size + 1, HIDDEN_LAYER1_SIZE), // +1 for parity feature
-    hidden_layer1(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE),
-    output_layer(),
+    : arena(WEIGHT_COUNT + BIAS_COUNT),
+    gradients(WEIGHT_COUNT + BIAS_COUNT),
+    input_layer(max_input_size + 1, HIDDEN_LAYER1_SIZE, arena.view(0, INPUT_WEIGHTS), arena.view(INPUT_BIAS_OFFSET, HIDDEN_LAYER1_SIZE)), // +1 for parity feature
+    hidden_layer1(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE, arena.view(HIDDEN_WEIGHT_OFFSET, HIDDEN_WEIGHTS), arena.view(HIDDEN_BIAS_OFFSET, OUTPUT_SIZE)),
+    output_layer(arena.view(OUTPUT_WEIGHT_OFFSET, OUTPUT_WEIGHTS), arena.view(OUTPUT_BIAS_OFFSET, OUTPUT_SIZE)),
+    layers(input_layer, hidden_layer1, output_layer),
+    padded_input(10, 0.0f),
     intermediate(std::max(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE)),
-    output(OUTPUT_SIZE) {
+    output(OUTPUT_SIZE),
+    network_packed(false),
+    packed_hidden_version(0),
+    packed_output_version(0) {
 
     // Size Check
     if (max_input_size < 1 || max_input_size > 9) {
@@ -112,6 +172,14 @@ MLP::MLP(uint32_t max_input_size)
     // std::cout << "MLP constructed with max_input_size: " << max_input_size << std::endl;
 }
 
+//Only the parameters are copied, run forward on the copy before calling update_weights on its layers
+MLP::MLP(const MLP& other) : MLP(1) {
+    std::copy(other.arena.data(), other.arena.data() + arena.size(), arena.data());
+    input_layer.mark_changed();
+    hidden_layer1.mark_changed();
+    output_layer.mark_changed();
+}
+
 MLP::~MLP() {}
 
 void MLP::forward(const std::vector<float>& input) const {
@@ -120,25 +188,163 @@ void MLP::forward(const std::vector<float>& input) const {
         throw std::invalid_argument("Input size must be between 1 and 10");
     }
 
-    // Create padded input
-    std::vector<float> padded_input(10, 0.0f);  // Initialize with 10 zeros
-    for (size_t i = 0; i < input.size(); ++i) {
-        padded_input[i] = static_cast<float>(input[i]);
-    }
+    // Padded input, reused between calls
+    std::copy(input.begin(), input.end(), padded_input.begin());
+    std::fill(padded_input.begin() + input.size(), padded_input.end(), 0.0f);
 
     // std::cout << "MLP forward start. Input size: " << input.size() << std::endl;
 
     // Forward pass through layers
-    input_layer.forward(padded_input.data(), intermediate.data());
-    hidden_layer1.forward(intermediate.data(), intermediate.data());
-    output_layer.forward(intermediate.data(), output.data());
+    layers.forward(padded_input.data(), intermediate.data(), output.data());
 
     // std::cout << "MLP forward end. Final output: " << output[0] << std::endl;
 }
 
+void MLP::update_weights(float error, float learning_rate) {
+    layers.update_weights(error, learning_rate);
+}
+
+//The input layer's gradients stay zero, it only copies
+void MLP::compute_gradients(float error) {
+    hidden_layer1.compute_gradients(error, gradients.view(HIDDEN_WEIGHT_OFFSET, HIDDEN_WEIGHTS), gradients.view(HIDDEN_BIAS_OFFSET, OUTPUT_SIZE));
+    output_layer.compute_gradients(error, gradients.view(OUTPUT_WEIGHT_OFFSET, OUTPUT_WEIGHTS), gradients.view(OUTPUT_BIAS_OFFSET, OUTPUT_SIZE));
+}
+
+void MLP::update_weights(float error, optim::Optimizer& optimizer) {
+    compute_gradients(error);
+    optimizer.step(arena.view(HIDDEN_WEIGHT_OFFSET, TRAINABLE_COUNT), gradients.view(HIDDEN_WEIGHT_OFFSET, TRAINABLE_COUNT));
+    hidden_layer1.mark_changed();
+    output_layer.mark_changed();
+}
+
+void MLP::apply_gradients(Span<const float> trainable_gradients, optim::Optimizer& optimizer) {
+    optimizer.step(arena.view(HIDDEN_WEIGHT_OFFSET, TRAINABLE_COUNT), trainable_gradients);
+    hidden_layer1.mark_changed();
+    output_layer.mark_changed();
+}
+
+Span<const float> MLP::get_trainable_gradients() const {
+    return gradients.view(HIDDEN_WEIGHT_OFFSET, TRAINABLE_COUNT);
+}
+
+Span<float> MLP::get_trainable_parameters() {
+    return arena.view(HIDDEN_WEIGHT_OFFSET, TRAINABLE_COUNT);
+}
+
+Span<const float> MLP::get_gradients() const {
+    return gradients.all();
+}
+
+//The layered pass pads the input to HIDDEN_LAYER1_SIZE, the hidden layer overwrites the first slots of that buffer in place
+//and the output layer reads it back, so the output sees the hidden activations followed by the untouched input values.
+//The fused kernel gets that as a hidden layer over the real inputs plus a skip connection for the inputs the output layer still sees.
+void MLP::pack_network() const {
+    pack_network(INPUT_SIZE, network);
+    network_packed = true;
+    packed_hidden_version = hidden_layer1.get_version();
+    packed_output_version = output_layer.get_version();
+}
+
+void MLP::pack_network(uint32_t feature_count, fused::SmallNetwork& target) const {
+    if (feature_count == 0 || feature_count > INPUT_SIZE) {
+        throw std::invalid_argument("Feature count must be between 1 and 9");
+    }
+    const uint32_t padded_size = hidden_layer1.get_input_size();
+    const uint32_t hidden_size = hidden_layer1.get_output_size();
+    Span<const float> hidden_weights = hidden_layer1.get_weights();
+    Span<const float> output_weights = output_layer.get_weights();
+
+    std::vector<float> packed_hidden_weights(hidden_size * feature_count);
+    for (uint32_t h = 0; h < hidden_size; ++h) {
+        std::copy(hidden_weights.begin() + h * padded_size, hidden_weights.begin() + h * padded_size + feature_count,
+            packed_hidden_weights.begin() + h * feature_count);
+    }
+    std::vector<float> packed_output_weights(OUTPUT_SIZE * hidden_size);
+    std::vector<float> packed_skip_weights(OUTPUT_SIZE * feature_count, 0.0f);
+    for (uint32_t o = 0; o < OUTPUT_SIZE; ++o) {
+        for (uint32_t j = 0; j < std::max(hidden_size, feature_count); ++j) {
+            float w = output_weights[o * padded_size + j];
+            if (j < hidden_size) packed_output_weights[o * hidden_size + j] = w;
+            else packed_skip_weights[o * feature_count + j] = w;
+        }
+    }
+    target.pack(packed_hidden_weights.data(), hidden_layer1.get_biases().data(),
+        packed_output_weights.data(), output_layer.get_biases().data(), packed_skip_weights.data(),
+        feature_count, hidden_size, OUTPUT_SIZE);
+}
+
+//Same split as pack_network, input j feeds every hidden unit, and the outputs directly once j is past the hidden slots
+std::vector<float> MLP::input_columns(uint32_t feature_count, uint32_t skip_offset, uint32_t stride) const {
+    const uint32_t padded_size = hidden_layer1.get_input_size();
+    const uint32_t hidden_size = hidden_layer1.get_output_size();
+    if (feature_count == 0 || feature_count > INPUT_SIZE || skip_offset < hidden_size || skip_offset + OUTPUT_SIZE > stride) {
+        throw std::invalid_argument("Input columns do not fit the network");
+    }
+    Span<const float> hidden_weights = hidden_layer1.get_weights();
+    Span<const float> output_weights = output_layer.get_weights();
+    std::vector<float> columns(static_cast<size_t>(feature_count) * stride, 0.0f);
+    for (uint32_t j = 0; j < feature_count; ++j) {
+        float* column = columns.data() + static_cast<size_t>(j) * stride;
+        for (uint32_t h = 0; h < hidden_size; ++h) {
+            column[h] = hidden_weights[h * padded_size + j];
+        }
+        for (uint32_t o = 0; o < OUTPUT_SIZE && j >= hidden_size; ++o) {
+            column[skip_offset + o] = output_weights[o * padded_size + j];
+        }
+    }
+    return columns;
+}
+
 float MLP::predict(const std::vector<float>& input) const {
-    // std::cout << "MLP predict start" << std::endl;
-    forward(input);
-    // std::cout << "MLP predict end. Prediction: " << output[0] << std::endl;
+    // Size Check
+    if (input.empty() || input.size() > 10) {
+        throw std::invalid_argument("Input size must be between 1 and 10");
+    }
+
+    //Training updates the layers directly, so repack whenever either layer changed since the last call
+    if (!network_packed || packed_hidden_version != hidden_layer1.get_version()
+        || packed_output_version != output_layer.get_version()) {
+        pack_network();
+    }
+
+    float features[INPUT_SIZE] = {};
+    std::copy(input.begin(), input.begin() + std::min<size_t>(input.size(), INPUT_SIZE), features);
+    network.forward(features, output.data());
     return output[0];
 }
+
+std::vector<float> MLP::predict_batch(const std::vector<std::pair<std::vector<float>, int>>& samples) const {
+    for (const auto& sample : samples) {
+        if (sample.first.empty() || sample.first.size() > 10) {
+            throw std::invalid_argument("Input size must be between 1 and 10");
+        }
+    }
+    prepare_batch();
+
+    std::vector<float> scores(samples.size());
+    const uint64_t work_per_sample = static_cast<uint64_t>(INPUT_SIZE + OUTPUT_SIZE) * HIDDEN_LAYER1_SIZE;
+    parallel::parallel_for(static_cast<uint32_t>(samples.size()), work_per_sample, 1, [&](uint32_t begin, uint32_t end) {
+        predict_range(samples.data() + begin, end - begin, scores.data() + begin);
+    });
+    return scores;
+}
+
+void MLP::prepare_batch() const {
+    if (!network_packed || packed_hidden_version != hidden_layer1.get_version()
+        || packed_output_version != output_layer.get_version()) {
+        pack_network();
+    }
+}
+
+void MLP::predict_range(const std::pair<std::vector<float>, int>* samples, size_t count, float* scores) const {
+    //Each sample only touches its own stack buffers, so the packed network is shared read-only
+    float features[INPUT_SIZE];
+    float result[fused::SmallNetwork::MAX_OUTPUTS];
+    for (size_t i = 0; i < count; ++i) {
+        const std::vector<float>& input = samples[i].first;
+        std::fill(features, features + INPUT_SIZE, 0.0f);
+        std::copy(input.begin(), input.begin() + std::min<size_t>(input.size(), INPUT_SIZE), features);
+        network.forward(features, result);
+        scores[i] = result[0];
+    }
+}
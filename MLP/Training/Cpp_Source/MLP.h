@@ -5,19 +5,64 @@
 // Purpose: This header file declares functions relates to the MLP such as layers, get/put methods, and internal variables
 
 #include "layers.h"
+#include "fused.h"
+#include "pipeline.h"
+#include "optimizer.h"
 #include <vector>
 #include <string>
 
 class MLP {
 public:
     MLP(uint32_t input_size);
+    //Copies get their own arena with the same parameters
+    MLP(const MLP& other);
+    MLP& operator=(const MLP&) = delete;
     ~MLP();
 
+    //Layer by layer pass that also fills each layer's caches, use it before update_weights
     void forward(const std::vector<float>& input) const;
+    //Backpropagates error through every layer, output layer first, using the caches left by forward
+    void update_weights(float error, float learning_rate);
+    //The same gradients applied through an optimizer (momentum, Adam, ...) in one pass over get_trainable_parameters,
+    //build the optimizer for get_trainable_parameters().size() values
+    void update_weights(float error, optim::Optimizer& optimizer);
+    //Fills the gradient arena from the caches left by forward, same layout as get_parameters
+    void compute_gradients(float error);
+    Span<const float> get_gradients() const;
+    //The part of get_gradients that matches get_trainable_parameters
+    Span<const float> get_trainable_gradients() const;
+    //Steps the trainable parameters with gradients gathered elsewhere, e.g. summed over a minibatch or over workers
+    void apply_gradients(Span<const float> trainable_gradients, optim::Optimizer& optimizer);
+    //Same result as forward through one fused kernel straight from the current weights, the layer caches and get_output are not updated
     float predict(const std::vector<float>& input) const;
+    //predict for every sample (labels are ignored), large batches are split across the shared thread pool
+    std::vector<float> predict_batch(const std::vector<std::pair<std::vector<float>, int>>& samples) const;
+    //The two halves of predict_batch for callers that split the work themselves: prepare_batch repacks the fused network
+    //if the weights changed, then predict_range scores count samples on the calling thread without checking their sizes
+    //(inputs past 9 values are ignored) and may run on several threads at once until the weights change again
+    void prepare_batch() const;
+    void predict_range(const std::pair<std::vector<float>, int>* samples, size_t count, float* scores) const;
+    //The fused network predict runs, packed into target for inputs whose features past the first feature_count are
+    //always zero, so those columns are dropped (the range scorer only ever feeds the 2 number features)
+    void pack_network(uint32_t feature_count, fused::SmallNetwork& target) const;
+    //The input side of that network is linear: column j (stride floats) is what one unit of feature j adds to the hidden
+    //pre-activations, at [0, hidden size), and to each output's skip sum, from skip_offset on, zero everywhere else
+    std::vector<float> input_columns(uint32_t feature_count, uint32_t skip_offset, uint32_t stride) const;
 
-    std::vector<float> get_weights() const;
-    std::vector<float> get_biases() const;
+    //Views of the parameter arena, every layer's weights back to back (input, hidden, output) and then every layer's biases
+    //(hidden, output, input)
+    Span<const float> get_weights() const;
+    Span<const float> get_biases() const;
+    //Weights followed by biases, the whole arena as one flat buffer
+    Span<float> get_parameters();
+    Span<const float> get_parameters() const;
+    //The part of the arena training changes (hidden and output layers), one contiguous view
+    Span<float> get_trainable_parameters();
+    //Call after writing parameters through get_parameters or get_trainable_parameters, so the fused kernel repacks
+    void mark_parameters_changed();
+    //Writes and reads the whole arena in one block, load also tells the layers their parameters changed
+    bool save_parameters(const std::string& file_path) const;
+    bool load_parameters(const std::string& file_path);
     const std::vector<float>& get_output() const;
     const Layer& get_input_layer() const;
     const Layer& get_hidden_layer1() const;
@@ -26,12 +71,25 @@ public:
     Layer& get_hidden_layer1();
     Layer& get_output_layer();
 
+    //Per-sample scaling by the largest value, see normalize.h for dataset level normalization that folds into the exported model
     static std::vector<float> normalize_input(const std::vector<int>& input);
 
 private:
+    //Declared first so it exists before the layers that view into it
+    ParameterArena arena;
+    ParameterArena gradients;
     InputLayer input_layer;
     HiddenLayer hidden_layer1;
     OutputLayer output_layer;
+    //forward and update_weights go through this, not the Layer vtable
+    pipeline::StaticPipeline<InputLayer, HiddenLayer, OutputLayer> layers;
+    mutable std::vector<float> padded_input;
     mutable std::vector<float> intermediate;
     mutable std::vector<float> output;
+    mutable fused::SmallNetwork network;
+    mutable bool network_packed;
+    mutable uint64_t packed_hidden_version;
+    mutable uint64_t packed_output_version;
+
+    void pack_network() const;
 };
\ No newline at end of file
@@ -4,7 +4,9 @@
 // Purpose: This file implements various activation functions for the neural network.
 
 #include "activate.h"
+#include "simd.h"
 #include <algorithm>
+#include <atomic>
 
 
 float activate::leaky_relu(float x, float alpha) {
@@ -37,4 +39,176 @@ void activate::softmax(float* input, float* output, int size) {
     for (int i = 0; i < size; ++i) {
         output[i] /= sum;
     }
-}
\ No newline at end of file
+}
+
+//Array versions, see activate.h for the documented error bounds of the fast mode
+namespace {
+    std::atomic<activate::Mode> default_mode{ activate::Mode::Fast };
+
+    //Cephes style expf: x = n*ln2 + r with |r| <= ln2/2, e^r from a degree 6 polynomial, then scaled by 2^n
+    template <typename V>
+    inline V exp_approx(V x) {
+        x = simd::min(simd::max(x, simd::set1(-87.0f, x)), simd::set1(88.0f, x));
+        auto n = simd::round_to_int(simd::mul(x, simd::set1(1.44269504088896341f, x)));
+        V nf = simd::to_float(n);
+        V r = simd::sub(x, simd::mul(nf, simd::set1(0.693359375f, x)));
+        r = simd::sub(r, simd::mul(nf, simd::set1(-2.12194440e-4f, x)));
+
+        V y = simd::set1(1.9875691500e-4f, x);
+        y = simd::fmadd(y, r, simd::set1(1.3981999507e-3f, x));
+        y = simd::fmadd(y, r, simd::set1(8.3334519073e-3f, x));
+        y = simd::fmadd(y, r, simd::set1(4.1665795894e-2f, x));
+        y = simd::fmadd(y, r, simd::set1(1.6666665459e-1f, x));
+        y = simd::fmadd(y, r, simd::set1(5.0000001201e-1f, x));
+        y = simd::fmadd(y, simd::mul(r, r), simd::add(r, simd::set1(1.0f, x)));
+        return simd::mul(y, simd::pow2i(n));
+    }
+
+    template <typename V>
+    inline V sigmoid_approx(V x) {
+        V one = simd::set1(1.0f, x);
+        return simd::div(one, simd::add(one, exp_approx(simd::sub(simd::set1(0.0f, x), x))));
+    }
+
+    //Odd polynomial near zero (where 1 - 2/(e^2x + 1) would cancel), exp based identity elsewhere
+    template <typename V>
+    inline V tanh_approx(V x) {
+        V ax = simd::abs(x);
+        V z = simd::mul(x, x);
+        V p = simd::set1(-5.70498872745e-3f, x);
+        p = simd::fmadd(p, z, simd::set1(2.06390887954e-2f, x));
+        p = simd::fmadd(p, z, simd::set1(-5.37397155531e-2f, x));
+        p = simd::fmadd(p, z, simd::set1(1.33314422036e-1f, x));
+        p = simd::fmadd(p, z, simd::set1(-3.33332819422e-1f, x));
+        V small = simd::fmadd(simd::mul(p, z), x, x);
+
+        V one = simd::set1(1.0f, x);
+        V e = exp_approx(simd::add(ax, ax));
+        V large = simd::sub(one, simd::div(simd::set1(2.0f, x), simd::add(e, one)));
+        large = simd::copysign(large, x);
+        return simd::select_lt(ax, simd::set1(0.625f, x), small, large);
+    }
+
+    //Runs op over full vectors, then the same op on single floats for the tail
+    template <typename Op>
+    inline void apply_n(const float* input, float* output, size_t size, Op op) {
+        size_t i = 0;
+        for (; i + simd::WIDTH <= size; i += simd::WIDTH) {
+            simd::store(output + i, op(simd::load(input + i)));
+        }
+        for (; i < size; ++i) {
+            output[i] = op(input[i]);
+        }
+    }
+}
+
+void activate::set_mode(Mode mode) {
+    default_mode.store(mode, std::memory_order_relaxed);
+}
+
+activate::Mode activate::get_mode() {
+    return default_mode.load(std::memory_order_relaxed);
+}
+
+float activate::fast_exp(float x) {
+    return exp_approx(x);
+}
+
+float activate::fast_sigmoid(float x) {
+    return sigmoid_approx(x);
+}
+
+float activate::fast_tanh(float x) {
+    return tanh_approx(x);
+}
+
+void activate::relu_n(const float* input, float* output, size_t size) {
+    apply_n(input, output, size, [](auto x) {
+        return simd::max(x, simd::set1(0.0f, x));
+    });
+}
+
+void activate::leaky_relu_n(const float* input, float* output, size_t size, float alpha) {
+    apply_n(input, output, size, [alpha](auto x) {
+        return simd::select_gt(x, simd::set1(0.0f, x), x, simd::mul(x, simd::set1(alpha, x)));
+    });
+}
+
+void activate::sigmoid_n(const float* input, float* output, size_t size) {
+    sigmoid_n(input, output, size, get_mode());
+}
+
+void activate::sigmoid_n(const float* input, float* output, size_t size, Mode mode) {
+    if (mode == Mode::Exact) {
+        for (size_t i = 0; i < size; ++i) {
+            output[i] = sigmoid(input[i]);
+        }
+        return;
+    }
+    apply_n(input, output, size, [](auto x) { return sigmoid_approx(x); });
+}
+
+void activate::tanh_n(const float* input, float* output, size_t size) {
+    tanh_n(input, output, size, get_mode());
+}
+
+void activate::tanh_n(const float* input, float* output, size_t size, Mode mode) {
+    if (mode == Mode::Exact) {
+        for (size_t i = 0; i < size; ++i) {
+            output[i] = std::tanh(input[i]);
+        }
+        return;
+    }
+    apply_n(input, output, size, [](auto x) { return tanh_approx(x); });
+}
+
+void activate::softmax_n(const float* input, float* output, size_t size) {
+    softmax_n(input, output, size, get_mode());
+}
+
+void activate::softmax_n(const float* input, float* output, size_t size, Mode mode) {
+    if (size == 0) {
+        return;
+    }
+
+    //Maximum for numerical stability
+    float max_val = input[0];
+    size_t i = 0;
+    if (size >= simd::WIDTH) {
+        simd::vfloat vmax = simd::load(input);
+        for (i = simd::WIDTH; i + simd::WIDTH <= size; i += simd::WIDTH) {
+            vmax = simd::max(vmax, simd::load(input + i));
+        }
+        max_val = simd::hmax(vmax);
+    }
+    for (; i < size; ++i) {
+        max_val = std::max(max_val, input[i]);
+    }
+
+    //Exponentials and their sum
+    float sum = 0.0f;
+    if (mode == Mode::Exact) {
+        for (i = 0; i < size; ++i) {
+            output[i] = std::exp(input[i] - max_val);
+            sum += output[i];
+        }
+    }
+    else {
+        simd::vfloat vmax = simd::splat(max_val);
+        simd::vfloat vsum = simd::zero();
+        for (i = 0; i + simd::WIDTH <= size; i += simd::WIDTH) {
+            simd::vfloat e = exp_approx(simd::sub(simd::load(input + i), vmax));
+            simd::store(output + i, e);
+            vsum = simd::add(vsum, e);
+        }
+        sum = simd::hsum(vsum);
+        for (; i < size; ++i) {
+            output[i] = exp_approx(input[i] - max_val);
+            sum += output[i];
+        }
+    }
+
+    //Normalize
+    float inv = 1.0f / sum;
+    apply_n(output, output, size, [inv](auto x) { return simd::mul(x, simd::set1(inv, x)); });
+}
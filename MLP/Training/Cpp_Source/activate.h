@@ -8,6 +8,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <cstddef>
 
 namespace activate {
     //ReLU activation function
@@ -32,6 +33,36 @@ namespace activate {
 
     //Softmax activation function (for output layer)
     void softmax(float* input, float* output, int size);
+
+    //Array versions, input and output may be the same buffer.
+    //Exact calls std::exp/std::tanh per element like the scalar functions above.
+    //Fast uses SIMD polynomial approximations (Cephes style range reduction), measured maximum error over the float range:
+    //  exp:     relative error < 2e-7 for x in [-87, 88], inputs outside are clamped to that range
+    //  sigmoid: absolute error < 2e-7
+    //  tanh:    absolute error < 2e-7, relative error < 3e-7
+    //  softmax: absolute error < 2e-7 per output
+    enum class Mode {
+        Exact,
+        Fast
+    };
+
+    //Process wide default used when no mode is passed, starts out as Fast
+    void set_mode(Mode mode);
+    Mode get_mode();
+
+    void relu_n(const float* input, float* output, size_t size);
+    void leaky_relu_n(const float* input, float* output, size_t size, float alpha = 0.01f);
+    void sigmoid_n(const float* input, float* output, size_t size);
+    void sigmoid_n(const float* input, float* output, size_t size, Mode mode);
+    void tanh_n(const float* input, float* output, size_t size);
+    void tanh_n(const float* input, float* output, size_t size, Mode mode);
+    void softmax_n(const float* input, float* output, size_t size);
+    void softmax_n(const float* input, float* output, size_t size, Mode mode);
+
+    //Scalar versions of the fast approximations, identical to the SIMD lanes
+    float fast_exp(float x);
+    float fast_sigmoid(float x);
+    float fast_tanh(float x);
 }
 
 #endif
\ No newline at end of file
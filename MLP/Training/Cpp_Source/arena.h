@@ -0,0 +1,71 @@
+#pragma once
+// arena.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares Span, a non-owning view of contiguous floats (the C++17 stand-in for std::span), and the parameter arena, one aligned buffer holding every weight and bias of a network that its layers view into.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "packed.h"
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class Span {
+public:
+    Span() : ptr(nullptr), count(0) {}
+    Span(T* data, size_t size) : ptr(data), count(size) {}
+    //Span<float> converts to Span<const float>
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    Span(const Span<U>& other) : ptr(other.data()), count(other.size()) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+    T& operator[](size_t i) const { return ptr[i]; }
+
+    Span subspan(size_t offset, size_t size) const {
+        if (offset + size > count) {
+            throw std::out_of_range("Span subspan out of range");
+        }
+        return Span(ptr + offset, size);
+    }
+    std::vector<typename std::remove_const<T>::type> to_vector() const {
+        return std::vector<typename std::remove_const<T>::type>(ptr, ptr + count);
+    }
+
+private:
+    T* ptr;
+    size_t count;
+};
+
+//Zero filled, 64-byte aligned float storage handed out as views. Copies are deep, so whoever holds views into an
+//arena has to rebind them to the copy (see Layer and Sequential).
+class ParameterArena {
+public:
+    ParameterArena() = default;
+    explicit ParameterArena(size_t count) { buffer.allocate(count, true); }
+
+    size_t size() const { return buffer.size(); }
+    float* data() { return buffer.data(); }
+    const float* data() const { return buffer.data(); }
+
+    Span<float> view(size_t offset, size_t count) {
+        return all().subspan(offset, count);
+    }
+    Span<const float> view(size_t offset, size_t count) const {
+        return all().subspan(offset, count);
+    }
+    Span<float> all() { return Span<float>(buffer.data(), buffer.size()); }
+    Span<const float> all() const { return Span<const float>(buffer.data(), buffer.size()); }
+
+private:
+    packed::AlignedBuffer buffer;
+};
+
+#endif
@@ -0,0 +1,277 @@
+// autotune.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the kernel autotuner and its tuning cache.
+
+#include "autotune.h"
+#include "fused.h"
+#include "packed.h"
+#include "simd.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+    const char* const TUNING_HEADER = "EdgeMLP-tuning";
+    constexpr uint32_t TUNING_VERSION = 1;
+
+    const autotune::Kernel CANDIDATES[] = {
+        autotune::Kernel::RowMajor, autotune::Kernel::Packed1, autotune::Kernel::Packed2,
+        autotune::Kernel::Packed4, autotune::Kernel::Packed8
+    };
+
+    //Each timed run repeats the batch until it lasts at least this long, the best of MEASUREMENTS runs is kept
+    constexpr double MIN_RUN_NS = 200000.0;
+    constexpr int MEASUREMENTS = 5;
+
+    template <typename Body>
+    double time_per_call(Body body) {
+        using clock = std::chrono::steady_clock;
+        body();
+        uint64_t calls = 1;
+        double best = 0.0;
+        for (int m = 0; m < MEASUREMENTS; ++m) {
+            double elapsed;
+            while (true) {
+                auto start = clock::now();
+                for (uint64_t c = 0; c < calls; ++c) {
+                    body();
+                }
+                elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+                if (elapsed >= MIN_RUN_NS) {
+                    break;
+                }
+                calls *= 2;
+            }
+            double per_call = elapsed / static_cast<double>(calls);
+            best = m == 0 ? per_call : std::min(best, per_call);
+        }
+        return best;
+    }
+}
+
+const char* autotune::kernel_name(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Packed1: return "packed1";
+    case Kernel::Packed2: return "packed2";
+    case Kernel::Packed4: return "packed4";
+    case Kernel::Packed8: return "packed8";
+    default: return "rowmajor";
+    }
+}
+
+bool autotune::parse_kernel(const std::string& name, Kernel& kernel) {
+    for (Kernel candidate : CANDIDATES) {
+        if (name == kernel_name(candidate)) {
+            kernel = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t autotune::row_tile(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Packed1: return 1;
+    case Kernel::Packed2: return 2;
+    case Kernel::Packed4: return 4;
+    case Kernel::Packed8: return 8;
+    default: return 0;
+    }
+}
+
+std::string autotune::cpu_model() {
+    std::string model;
+#if defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        //x86 reports "model name", most ARM kernels only "CPU part"
+        if (line.rfind("model name", 0) == 0 || (model.empty() && line.rfind("CPU part", 0) == 0)) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                model = line.substr(line.find_first_not_of(" \t", colon + 1));
+                if (line.rfind("model name", 0) == 0) {
+                    break;
+                }
+            }
+        }
+    }
+#endif
+    if (model.empty()) {
+        model = "unknown";
+    }
+    return model + " [" + simd::ISA + "]";
+}
+
+uint64_t autotune::model_hash(const std::vector<Shape>& layers) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t value) {
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (value >> (byte * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+    for (const Shape& layer : layers) {
+        mix(layer.inputs);
+        mix(layer.outputs);
+        mix(layer.batch);
+    }
+    return hash;
+}
+
+autotune::Choice autotune::tune(const Shape& shape) {
+    std::mt19937 rng(shape.inputs * 31 + shape.outputs);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> weights(static_cast<size_t>(shape.inputs) * shape.outputs);
+    std::vector<float> inputs(static_cast<size_t>(shape.inputs) * shape.batch);
+    std::vector<float> biases(shape.outputs, 0.0f);
+    std::vector<float> output(shape.outputs);
+    for (auto& w : weights) w = dist(rng);
+    for (auto& x : inputs) x = dist(rng);
+
+    //Every candidate runs the linear kernel, the activation pass is the same for all of them
+    Choice best;
+    best.shape = shape;
+    for (Kernel kernel : CANDIDATES) {
+        double ns;
+        if (kernel == Kernel::RowMajor) {
+            ns = time_per_call([&]() {
+                for (uint32_t b = 0; b < shape.batch; ++b) {
+                    fused::dense_linear(inputs.data() + static_cast<size_t>(b) * shape.inputs, weights.data(), biases.data(),
+                        output.data(), shape.inputs, shape.outputs);
+                }
+            });
+        }
+        else {
+            packed::PackedMatrix matrix;
+            matrix.pack(weights.data(), shape.outputs, shape.inputs, row_tile(kernel));
+            ns = time_per_call([&]() {
+                for (uint32_t b = 0; b < shape.batch; ++b) {
+                    fused::dense_linear(inputs.data() + static_cast<size_t>(b) * shape.inputs, matrix, biases.data(), output.data());
+                }
+            });
+        }
+        ns /= std::max(1u, shape.batch);
+        if (kernel == Kernel::RowMajor || ns < best.ns_per_sample) {
+            best.kernel = kernel;
+            best.ns_per_sample = ns;
+        }
+    }
+    return best;
+}
+
+//TuningCache implementation
+bool autotune::TuningCache::load(const std::string& file_path) {
+    choices.clear();
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string header, line;
+    uint32_t version = 0;
+    if (!(file >> header >> version) || header != TUNING_HEADER || version != TUNING_VERSION) {
+        std::cerr << "Error: " << file_path << " is not a tuning file" << std::endl;
+        return false;
+    }
+    std::getline(file, line);
+
+    //A cache from another cpu or model is not an error, it just gets retuned
+    std::string file_cpu;
+    if (!std::getline(file, line) || line.rfind("cpu ", 0) != 0) {
+        std::cerr << "Error: Missing cpu line in " << file_path << std::endl;
+        return false;
+    }
+    file_cpu = line.substr(4);
+    std::string key;
+    uint64_t file_hash = 0;
+    if (!(file >> key >> std::hex >> file_hash >> std::dec) || key != "hash") {
+        std::cerr << "Error: Missing hash line in " << file_path << std::endl;
+        return false;
+    }
+    if (file_cpu != cpu || file_hash != hash) {
+        return false;
+    }
+
+    std::vector<Choice> loaded;
+    Choice choice;
+    std::string name;
+    while (file >> choice.shape.inputs >> choice.shape.outputs >> choice.shape.batch >> name >> choice.ns_per_sample) {
+        if (!parse_kernel(name, choice.kernel)) {
+            std::cerr << "Error: Unknown kernel " << name << " in " << file_path << std::endl;
+            return false;
+        }
+        loaded.push_back(choice);
+    }
+    if (!file.eof()) {
+        std::cerr << "Error: Malformed entry in " << file_path << std::endl;
+        return false;
+    }
+    choices = std::move(loaded);
+    return true;
+}
+
+bool autotune::TuningCache::save(const std::string& file_path) const {
+    std::ofstream file(file_path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    file << TUNING_HEADER << " " << TUNING_VERSION << "\n";
+    file << "cpu " << cpu << "\n";
+    file << "hash " << std::hex << hash << std::dec << "\n";
+    for (const Choice& choice : choices) {
+        file << choice.shape.inputs << " " << choice.shape.outputs << " " << choice.shape.batch << " "
+            << kernel_name(choice.kernel) << " " << std::fixed << std::setprecision(2) << choice.ns_per_sample << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool autotune::TuningCache::find(const Shape& shape, Choice& out) const {
+    for (const Choice& choice : choices) {
+        if (choice.shape == shape) {
+            out = choice;
+            return true;
+        }
+    }
+    return false;
+}
+
+void autotune::TuningCache::set(const Choice& choice) {
+    for (Choice& existing : choices) {
+        if (existing.shape == choice.shape) {
+            existing = choice;
+            return;
+        }
+    }
+    choices.push_back(choice);
+}
+
+std::vector<autotune::Choice> autotune::tune_model(const std::vector<Shape>& layers, const std::string& cache_path, uint32_t* tuned) {
+    TuningCache cache(cpu_model(), model_hash(layers));
+    if (!cache_path.empty()) {
+        cache.load(cache_path);
+    }
+    std::vector<Choice> result;
+    uint32_t timed = 0;
+    for (const Shape& shape : layers) {
+        Choice choice;
+        if (!cache.find(shape, choice)) {
+            choice = tune(shape);
+            cache.set(choice);
+            ++timed;
+        }
+        result.push_back(choice);
+    }
+    if (timed > 0 && !cache_path.empty()) {
+        cache.save(cache_path);
+    }
+    if (tuned != nullptr) {
+        *tuned = timed;
+    }
+    return result;
+}
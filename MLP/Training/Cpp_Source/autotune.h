@@ -0,0 +1,79 @@
+#pragma once
+// autotune.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the kernel autotuner, which times every dense kernel candidate for each layer shape and batch size on the machine it runs on, and the tuning cache that keeps the winners so later startups skip the timing.
+
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace autotune {
+    //Dense kernel candidates, the row-major fused kernel or the packed kernel with a given row tile
+    enum class Kernel : uint8_t {
+        RowMajor = 0,
+        Packed1,
+        Packed2,
+        Packed4,
+        Packed8
+    };
+
+    const char* kernel_name(Kernel kernel);
+    bool parse_kernel(const std::string& name, Kernel& kernel);
+    //Row tile for the packed kernels, 0 for RowMajor
+    uint32_t row_tile(Kernel kernel);
+
+    struct Shape {
+        uint32_t inputs = 0;
+        uint32_t outputs = 0;
+        uint32_t batch = 1;     //Samples run back to back through the same weights
+
+        bool operator==(const Shape& other) const {
+            return inputs == other.inputs && outputs == other.outputs && batch == other.batch;
+        }
+    };
+
+    struct Choice {
+        Shape shape;
+        Kernel kernel = Kernel::RowMajor;
+        double ns_per_sample = 0.0;
+    };
+
+    //CPU model from the OS plus the vector ISA this build targets, since both change which kernel wins
+    std::string cpu_model();
+    //FNV-1a over the layer shapes. Weight values do not change the timings, so retraining keeps the tuning.
+    uint64_t model_hash(const std::vector<Shape>& layers);
+
+    //Times every candidate on random weights of the given shape and returns the fastest
+    Choice tune(const Shape& shape);
+
+    //Winners for one CPU and one model, saved as text:
+    //  EdgeMLP-tuning 1 / cpu <model> / hash <hex> / one "<inputs> <outputs> <batch> <kernel> <ns>" line per shape
+    class TuningCache {
+    public:
+        TuningCache() = default;
+        TuningCache(const std::string& cpu, uint64_t hash) : cpu(cpu), hash(hash) {}
+
+        //Fails (and leaves the cache empty) when the file is missing, malformed or for another cpu or model
+        bool load(const std::string& file_path);
+        bool save(const std::string& file_path) const;
+
+        bool find(const Shape& shape, Choice& out) const;
+        void set(const Choice& choice);
+        const std::vector<Choice>& get_choices() const { return choices; }
+
+    private:
+        std::string cpu;
+        uint64_t hash = 0;
+        std::vector<Choice> choices;
+    };
+
+    //Returns a kernel per shape, read from cache_path when it matches this cpu and model, otherwise tuned
+    //and written back. An empty cache_path always tunes. tuned counts the shapes that had to be timed.
+    std::vector<Choice> tune_model(const std::vector<Shape>& layers, const std::string& cache_path, uint32_t* tuned = nullptr);
+}
+
+#endif
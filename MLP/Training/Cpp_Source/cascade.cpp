@@ -0,0 +1,297 @@
+// cascade.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements cascade inference, the gate's distillation by Newton's method on standardized features, the threshold calibration over the gate's most confident samples, and the single, batched and evaluation paths, the batched one packing the samples the gate passes on into feature major batches for SmallNetwork::forward_batch.
+
+#include "cascade.h"
+#include "MLP.h"
+#include "activate.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t PARAMS = INPUT_SIZE + 1;     //Gate weights then the bias
+    constexpr uint32_t CHUNK = 256;                 //Surviving samples per forward_batch
+
+    //Mean cross-entropy of the gate against the soft targets plus the ridge term, x is [sample][PARAMS] with a trailing 1
+    double gate_loss(const std::vector<double>& x, const std::vector<float>& targets, size_t count, const double* theta, double ridge) {
+        double loss = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double z = 0.0;
+            for (uint32_t j = 0; j < PARAMS; ++j) z += theta[j] * x[i * PARAMS + j];
+            //log(1 + e^z) - t z, written to stay finite for large |z|
+            loss += std::max(z, 0.0) + std::log1p(std::exp(-std::abs(z))) - targets[i] * z;
+        }
+        double penalty = 0.0;
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) penalty += theta[j] * theta[j];
+        return loss / static_cast<double>(count) + 0.5 * ridge * penalty;
+    }
+
+    //The gate's answer through the same sigmoid as the network's output, so it follows activate::get_mode()
+    inline float gate_probability(float z) {
+        return activate::get_mode() == activate::Mode::Exact ? activate::sigmoid(z) : activate::fast_sigmoid(z);
+    }
+
+    //Solves a * x = b in place by Gaussian elimination with partial pivoting, a is [PARAMS][PARAMS]
+    void solve(double* a, double* b) {
+        for (uint32_t c = 0; c < PARAMS; ++c) {
+            uint32_t pivot = c;
+            for (uint32_t r = c + 1; r < PARAMS; ++r) {
+                if (std::abs(a[r * PARAMS + c]) > std::abs(a[pivot * PARAMS + c])) pivot = r;
+            }
+            if (pivot != c) {
+                for (uint32_t k = 0; k < PARAMS; ++k) std::swap(a[c * PARAMS + k], a[pivot * PARAMS + k]);
+                std::swap(b[c], b[pivot]);
+            }
+            for (uint32_t r = c + 1; r < PARAMS; ++r) {
+                const double f = a[r * PARAMS + c] / a[c * PARAMS + c];
+                for (uint32_t k = c; k < PARAMS; ++k) a[r * PARAMS + k] -= f * a[c * PARAMS + k];
+                b[r] -= f * b[c];
+            }
+        }
+        for (uint32_t c = PARAMS; c-- > 0;) {
+            for (uint32_t k = c + 1; k < PARAMS; ++k) b[c] -= a[c * PARAMS + k] * b[k];
+            b[c] /= a[c * PARAMS + c];
+        }
+    }
+}
+
+namespace cascade {
+    Cascade::Cascade(const MLP& mlp, const Dataset& calibration, const Config& config)
+        : gate_bias(0.0f), threshold(std::numeric_limits<float>::infinity()), predictions(0), exits(0) {
+        if (calibration.empty()) {
+            throw std::invalid_argument("Cascade calibration needs at least one sample");
+        }
+        if (!(config.target_agreement > 0.0 && config.target_agreement <= 1.0)) {
+            throw std::invalid_argument("Target agreement must be in (0, 1]");
+        }
+        mlp.pack_network(INPUT_SIZE, network);
+        if (network.get_output_size() != 1) {
+            throw std::invalid_argument("Cascade inference needs a single output model");
+        }
+        std::fill(gate_weights, gate_weights + INPUT_SIZE, 0.0f);
+
+        const size_t count = calibration.size();
+        std::vector<float> features(count * INPUT_SIZE);
+        for (size_t i = 0; i < count; ++i) {
+            load_features(calibration[i].first, features.data() + i * INPUT_SIZE);
+        }
+        std::vector<float> logits(count), scores(count);
+        score_both(features, count, logits.data(), scores.data());
+        fit(features, scores, count, config);
+
+        //The gate's answers from the most confident down, the threshold is the lowest confidence where the answered
+        //samples still agree with the MLP often enough. Ties are taken or left together.
+        score_both(features, count, logits.data(), scores.data());
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return std::abs(logits[a]) > std::abs(logits[b]); });
+        uint64_t agree = 0;
+        for (size_t k = 0; k < count; ++k) {
+            const uint32_t i = order[k];
+            agree += (gate_probability(logits[i]) > 0.5f) == (scores[i] > 0.5f) ? 1 : 0;
+            const bool tie_ends = k + 1 == count || std::abs(logits[order[k + 1]]) < std::abs(logits[i]);
+            if (tie_ends && static_cast<double>(agree) >= config.target_agreement * static_cast<double>(k + 1)) {
+                threshold = std::abs(logits[i]);
+            }
+        }
+    }
+
+    void Cascade::load_features(const std::vector<float>& input, float* features) {
+        if (input.empty() || input.size() > 10) {
+            throw std::invalid_argument("Input size must be between 1 and 10");
+        }
+        const size_t n = std::min<size_t>(input.size(), INPUT_SIZE);
+        std::copy(input.begin(), input.begin() + n, features);
+        std::fill(features + n, features + INPUT_SIZE, 0.0f);
+    }
+
+    float Cascade::gate_logit(const float* features) const {
+        float z = gate_bias;
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+            z += gate_weights[j] * features[j];
+        }
+        return z;
+    }
+
+    void Cascade::fit(const std::vector<float>& features, const std::vector<float>& targets, size_t count, const Config& config) {
+        //Standardized so one ridge and one starting point suit features of any scale, a constant feature keeps scale 1
+        double mean[INPUT_SIZE] = {}, scale[INPUT_SIZE];
+        for (size_t i = 0; i < count; ++i) {
+            for (uint32_t j = 0; j < INPUT_SIZE; ++j) mean[j] += features[i * INPUT_SIZE + j];
+        }
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+            mean[j] /= static_cast<double>(count);
+            double variance = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                const double d = features[i * INPUT_SIZE + j] - mean[j];
+                variance += d * d;
+            }
+            const double deviation = std::sqrt(variance / static_cast<double>(count));
+            scale[j] = deviation > 0.0 ? deviation : 1.0;
+        }
+        std::vector<double> x(count * PARAMS);
+        for (size_t i = 0; i < count; ++i) {
+            for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+                x[i * PARAMS + j] = (features[i * INPUT_SIZE + j] - mean[j]) / scale[j];
+            }
+            x[i * PARAMS + INPUT_SIZE] = 1.0;
+        }
+
+        //Newton's method, halving a step until the loss goes down since the full step can overshoot on separable data
+        const double ridge = config.ridge;
+        double theta[PARAMS] = {};
+        double loss = gate_loss(x, targets, count, theta, ridge);
+        for (uint32_t iteration = 0; iteration < config.iterations; ++iteration) {
+            double gradient[PARAMS] = {};
+            double hessian[PARAMS * PARAMS] = {};
+            for (size_t i = 0; i < count; ++i) {
+                const double* xi = x.data() + i * PARAMS;
+                double z = 0.0;
+                for (uint32_t j = 0; j < PARAMS; ++j) z += theta[j] * xi[j];
+                const double p = 1.0 / (1.0 + std::exp(-z));
+                const double weight = p * (1.0 - p);
+                for (uint32_t j = 0; j < PARAMS; ++j) {
+                    gradient[j] += (p - targets[i]) * xi[j];
+                    for (uint32_t k = 0; k <= j; ++k) hessian[j * PARAMS + k] += weight * xi[j] * xi[k];
+                }
+            }
+            for (uint32_t j = 0; j < PARAMS; ++j) {
+                gradient[j] /= static_cast<double>(count);
+                for (uint32_t k = 0; k <= j; ++k) {
+                    hessian[j * PARAMS + k] /= static_cast<double>(count);
+                    hessian[k * PARAMS + j] = hessian[j * PARAMS + k];
+                }
+                //The bias gets a sliver too so the system stays solvable when every sample saturates
+                hessian[j * PARAMS + j] += j < INPUT_SIZE ? ridge : 1e-9;
+                if (j < INPUT_SIZE) gradient[j] += ridge * theta[j];
+            }
+            solve(hessian, gradient);
+            double step = 1.0;
+            bool improved = false;
+            for (int halving = 0; halving < 30 && !improved; ++halving, step *= 0.5) {
+                double candidate[PARAMS];
+                for (uint32_t j = 0; j < PARAMS; ++j) candidate[j] = theta[j] - step * gradient[j];
+                const double candidate_loss = gate_loss(x, targets, count, candidate, ridge);
+                if (candidate_loss < loss) {
+                    std::copy(candidate, candidate + PARAMS, theta);
+                    loss = candidate_loss;
+                    improved = true;
+                }
+            }
+            if (!improved) {
+                break;
+            }
+        }
+
+        //Folds the standardization into weights over the raw features
+        double bias = theta[INPUT_SIZE];
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+            gate_weights[j] = static_cast<float>(theta[j] / scale[j]);
+            bias -= theta[j] * mean[j] / scale[j];
+        }
+        gate_bias = static_cast<float>(bias);
+    }
+
+    void Cascade::score_both(const std::vector<float>& features, size_t count, float* logits, float* scores) const {
+        for (size_t i = 0; i < count; ++i) {
+            logits[i] = gate_logit(features.data() + i * INPUT_SIZE);
+            network.forward(features.data() + i * INPUT_SIZE, scores + i);
+        }
+    }
+
+    float Cascade::predict(const std::vector<float>& input) {
+        float features[INPUT_SIZE];
+        load_features(input, features);
+        ++predictions;
+        const float z = gate_logit(features);
+        if (std::abs(z) >= threshold) {
+            ++exits;
+            return gate_probability(z);
+        }
+        float score;
+        network.forward(features, &score);
+        return score;
+    }
+
+    std::vector<float> Cascade::predict_batch(const Dataset& samples) {
+        std::vector<float> results(samples.size());
+        std::vector<uint32_t> survivors;
+        float features[INPUT_SIZE];
+        for (size_t i = 0; i < samples.size(); ++i) {
+            load_features(samples[i].first, features);
+            results[i] = gate_logit(features);
+            if (std::abs(results[i]) < threshold) {
+                survivors.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        //One vectorized sigmoid over every logit, the survivors' are overwritten below
+        activate::sigmoid_n(results.data(), results.data(), results.size());
+
+        //Survivors are packed feature major, feature j of the m-th at batch[j * CHUNK + m], and scattered back after
+        std::vector<float> batch(static_cast<size_t>(INPUT_SIZE) * CHUNK);
+        float scores[CHUNK];
+        for (size_t begin = 0; begin < survivors.size(); begin += CHUNK) {
+            const uint32_t count = static_cast<uint32_t>(std::min<size_t>(CHUNK, survivors.size() - begin));
+            for (uint32_t m = 0; m < count; ++m) {
+                load_features(samples[survivors[begin + m]].first, features);
+                for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+                    batch[j * CHUNK + m] = features[j];
+                }
+            }
+            network.forward_batch(batch.data(), CHUNK, count, scores);
+            for (uint32_t m = 0; m < count; ++m) {
+                results[survivors[begin + m]] = scores[m];
+            }
+        }
+        predictions += samples.size();
+        exits += samples.size() - survivors.size();
+        return results;
+    }
+
+    Report Cascade::evaluate(const Dataset& data) const {
+        Report report;
+        const size_t count = data.size();
+        std::vector<float> features(count * INPUT_SIZE);
+        for (size_t i = 0; i < count; ++i) {
+            load_features(data[i].first, features.data() + i * INPUT_SIZE);
+        }
+        std::vector<float> logits(count), scores(count);
+        score_both(features, count, logits.data(), scores.data());
+        uint64_t agree = 0, full_correct = 0, cascade_correct = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const bool positive = data[i].second != 0;
+            const bool full_class = scores[i] > 0.5f;
+            bool cascade_class = full_class;
+            if (std::abs(logits[i]) >= threshold) {
+                ++report.exits;
+                cascade_class = gate_probability(logits[i]) > 0.5f;
+            }
+            agree += cascade_class == full_class ? 1 : 0;
+            full_correct += full_class == positive ? 1 : 0;
+            cascade_correct += cascade_class == positive ? 1 : 0;
+        }
+        report.count = count;
+        if (count > 0) {
+            const double n = static_cast<double>(count);
+            report.exit_rate = static_cast<double>(report.exits) / n;
+            report.agreement = static_cast<double>(agree) / n;
+            report.full_accuracy = static_cast<double>(full_correct) / n;
+            report.cascade_accuracy = static_cast<double>(cascade_correct) / n;
+            report.accuracy_delta = report.cascade_accuracy - report.full_accuracy;
+        }
+        return report;
+    }
+
+    double Cascade::get_exit_rate() const {
+        return predictions == 0 ? 0.0 : static_cast<double>(exits) / static_cast<double>(predictions);
+    }
+
+    void Cascade::reset_counters() {
+        predictions = 0;
+        exits = 0;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+// cascade.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares cascade inference, a logistic gate on the raw features distilled from the MLP answers the samples it is confident about and only the rest go through the hidden and output layers. The gate's confidence threshold is calibrated on a dataset so its answers agree with the MLP's at a chosen rate, and the cascade reports how often it exits early and what that costs in accuracy.
+
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include "fused.h"
+#include "layers.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace cascade {
+    using Sample = std::pair<std::vector<float>, int>;
+    using Dataset = std::vector<Sample>;
+
+    struct Config {
+        //Newton steps fitting the gate to the MLP's scores
+        uint32_t iterations = 12;
+        //L2 penalty on the gate weights, over the standardized features
+        float ridge = 1e-4f;
+        //Of the calibration samples the gate answers, the share whose class must match the MLP's. 1 exits only where
+        //the gate never disagreed.
+        double target_agreement = 0.995;
+    };
+
+    //Labels other than 0 count as positive, score > 0.5 is predicted positive
+    struct Report {
+        uint64_t count = 0;
+        uint64_t exits = 0;                 //Answered by the gate
+        double exit_rate = 0.0;
+        double agreement = 0.0;             //Share of samples where the cascade's class matches the MLP's
+        double full_accuracy = 0.0;         //The MLP alone
+        double cascade_accuracy = 0.0;
+        double accuracy_delta = 0.0;        //cascade_accuracy - full_accuracy
+    };
+
+    class Cascade {
+    public:
+        //Snapshot of the MLP's current weights. The gate is distilled from the MLP's scores on calibration (the labels are
+        //not used) and its threshold calibrated on the same samples. Throws std::invalid_argument for an empty dataset,
+        //inputs predict would refuse or a target_agreement outside (0, 1].
+        Cascade(const MLP& mlp, const Dataset& calibration, const Config& config = Config());
+
+        //Same input rules as MLP::predict. The gate's probability when it exits, else the MLP's score.
+        float predict(const std::vector<float>& input);
+        //Gates every sample first and runs the survivors through the network as compacted batches
+        std::vector<float> predict_batch(const Dataset& samples);
+        //Scores data both ways, leaves the counters alone
+        Report evaluate(const Dataset& data) const;
+
+        //|logit| at or above which the gate answers, infinite when calibration found no safe threshold
+        float get_threshold() const { return threshold; }
+        const float* get_gate_weights() const { return gate_weights; }
+        float get_gate_bias() const { return gate_bias; }
+        uint64_t get_predictions() const { return predictions; }
+        uint64_t get_exits() const { return exits; }
+        double get_exit_rate() const;
+        void reset_counters();
+
+    private:
+        fused::SmallNetwork network;
+        float gate_weights[INPUT_SIZE];     //Over the raw features, the standardization folded in
+        float gate_bias;
+        float threshold;
+        uint64_t predictions;
+        uint64_t exits;
+
+        float gate_logit(const float* features) const;
+        //Writes the first INPUT_SIZE values of input into features, zero padded
+        static void load_features(const std::vector<float>& input, float* features);
+        void fit(const std::vector<float>& features, const std::vector<float>& targets, size_t count, const Config& config);
+        //Gate logits and MLP scores for every sample, features is [sample][INPUT_SIZE]
+        void score_both(const std::vector<float>& features, size_t count, float* logits, float* scores) const;
+    };
+}
+
+#endif
@@ -0,0 +1,401 @@
+// checkpoint.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the checkpoint file format and the background checkpoint writer.
+// File layout (little endian): "EMLPCKPT", uint32 version, trainer state, uint32 layer count,
+// per layer {name, input_size, output_size, weights, biases}, uint8 optimizer present and if set {method, config,
+// steps, beta powers, first moment, second moment}, then a FNV-1a checksum of everything before it. Version 1 files
+// end after the layers and still load, without optimizer state.
+
+#include "checkpoint.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char CHECKPOINT_MAGIC[8] = { 'E', 'M', 'L', 'P', 'C', 'K', 'P', 'T' };
+    constexpr uint32_t CHECKPOINT_VERSION = 2;
+
+    uint32_t fnv1a(const char* data, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    //Appends plain values and length-prefixed arrays to a byte buffer
+    class ByteWriter {
+    public:
+        template <typename T>
+        void put(const T& value) {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+        void put_string(const std::string& value) {
+            put(static_cast<uint32_t>(value.size()));
+            buffer.insert(buffer.end(), value.begin(), value.end());
+        }
+        void put_floats(const std::vector<float>& values) {
+            put(static_cast<uint64_t>(values.size()));
+            const char* bytes = reinterpret_cast<const char*>(values.data());
+            buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(float));
+        }
+        std::vector<char> buffer;
+    };
+
+    //Reads what ByteWriter wrote, every read is bounds checked
+    class ByteReader {
+    public:
+        ByteReader(const char* data, size_t size) : data(data), size(size), pos(0) {}
+        template <typename T>
+        T get() {
+            T value;
+            take(&value, sizeof(T));
+            return value;
+        }
+        std::string get_string() {
+            uint32_t length = get<uint32_t>();
+            check(length);
+            std::string value(data + pos, length);
+            pos += length;
+            return value;
+        }
+        void get_floats(std::vector<float>& values) {
+            uint64_t count = get<uint64_t>();
+            check(count * sizeof(float));
+            values.resize(static_cast<size_t>(count));
+            take(values.data(), static_cast<size_t>(count) * sizeof(float));
+        }
+    private:
+        void check(uint64_t bytes) const {
+            if (bytes > size - pos) {
+                throw std::runtime_error("Checkpoint file is truncated");
+            }
+        }
+        void take(void* out, size_t bytes) {
+            check(bytes);
+            std::memcpy(out, data + pos, bytes);
+            pos += bytes;
+        }
+        const char* data;
+        size_t size;
+        size_t pos;
+    };
+
+    void capture_layer(const char* name, const Layer& layer, LayerParameters& out) {
+        out.name = name;
+        out.input_size = layer.get_input_size();
+        out.output_size = layer.get_output_size();
+        out.weights.assign(layer.get_weights().begin(), layer.get_weights().end());
+        out.biases.assign(layer.get_biases().begin(), layer.get_biases().end());
+    }
+
+    void restore_layer(const char* name, const LayerParameters& in, Layer& layer) {
+        if (in.name != name || in.input_size != layer.get_input_size() || in.output_size != layer.get_output_size()) {
+            throw std::runtime_error("Checkpoint layer '" + in.name + "' does not match " + name);
+        }
+        layer.set_weights(in.weights);
+        layer.set_biases(in.biases);
+    }
+
+    //Flushes file contents and, on POSIX, the directory entry so the rename itself survives a power loss
+    bool sync_and_rename(FILE* file, const std::string& tmp_path, const std::string& file_path) {
+        if (std::fflush(file) != 0) {
+            std::fclose(file);
+            return false;
+        }
+#if defined(_WIN32)
+        _commit(_fileno(file));
+        std::fclose(file);
+        return MoveFileExA(tmp_path.c_str(), file_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        if (fsync(fileno(file)) != 0) {
+            std::fclose(file);
+            return false;
+        }
+        std::fclose(file);
+        if (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+            return false;
+        }
+        size_t slash = file_path.find_last_of('/');
+        std::string dir = (slash == std::string::npos) ? "." : file_path.substr(0, slash + 1);
+        int dir_fd = open(dir.c_str(), O_RDONLY);
+        if (dir_fd >= 0) {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+        return true;
+#endif
+    }
+}
+
+void capture_checkpoint(const MLP& mlp, const TrainerState& state, Checkpoint& out, const optim::Optimizer* optimizer) {
+    out.state = state;
+    out.layers.resize(3);
+    capture_layer("input_layer", mlp.get_input_layer(), out.layers[0]);
+    capture_layer("hidden_layer1", mlp.get_hidden_layer1(), out.layers[1]);
+    capture_layer("output_layer", mlp.get_output_layer(), out.layers[2]);
+
+    OptimizerState& saved = out.optimizer;
+    saved.present = optimizer != nullptr;
+    if (optimizer == nullptr) {
+        saved.first.clear();
+        saved.second.clear();
+        return;
+    }
+    saved.config = optimizer->get_config();
+    saved.steps = optimizer->get_steps();
+    saved.beta1_power = optimizer->get_beta1_power();
+    saved.beta2_power = optimizer->get_beta2_power();
+    saved.first.assign(optimizer->get_first_moment().begin(), optimizer->get_first_moment().end());
+    saved.second.assign(optimizer->get_second_moment().begin(), optimizer->get_second_moment().end());
+}
+
+void restore_checkpoint(const Checkpoint& checkpoint, MLP& mlp) {
+    if (checkpoint.layers.size() != 3) {
+        throw std::runtime_error("Checkpoint layer count does not match the MLP");
+    }
+    restore_layer("input_layer", checkpoint.layers[0], mlp.get_input_layer());
+    restore_layer("hidden_layer1", checkpoint.layers[1], mlp.get_hidden_layer1());
+    restore_layer("output_layer", checkpoint.layers[2], mlp.get_output_layer());
+}
+
+void restore_optimizer(const Checkpoint& checkpoint, optim::Optimizer& optimizer) {
+    const OptimizerState& saved = checkpoint.optimizer;
+    if (!saved.present) {
+        throw std::runtime_error("Checkpoint has no optimizer state");
+    }
+    if (saved.config.method != optimizer.get_config().method) {
+        throw std::runtime_error(std::string("Checkpoint optimizer is ") + optim::method_name(saved.config.method) +
+            ", not " + optim::method_name(optimizer.get_config().method));
+    }
+    optimizer.restore(saved.steps, saved.beta1_power, saved.beta2_power,
+        Span<const float>(saved.first.data(), saved.first.size()), Span<const float>(saved.second.data(), saved.second.size()));
+}
+
+bool write_checkpoint_file(const Checkpoint& checkpoint, const std::string& file_path) {
+    TRACE_SCOPE("checkpoint_write", "checkpoint");
+    ByteWriter writer;
+    writer.buffer.insert(writer.buffer.end(), CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+    writer.put(CHECKPOINT_VERSION);
+
+    const TrainerState& state = checkpoint.state;
+    writer.put(state.epoch);
+    writer.put(state.sample_index);
+    writer.put(state.learning_rate);
+    writer.put(state.epoch_loss);
+    writer.put(state.epoch_correct);
+    writer.put_string(state.rng_state);
+
+    writer.put(static_cast<uint32_t>(checkpoint.layers.size()));
+    for (const LayerParameters& layer : checkpoint.layers) {
+        writer.put_string(layer.name);
+        writer.put(layer.input_size);
+        writer.put(layer.output_size);
+        writer.put_floats(layer.weights);
+        writer.put_floats(layer.biases);
+    }
+
+    const OptimizerState& optimizer = checkpoint.optimizer;
+    writer.put(static_cast<uint8_t>(optimizer.present ? 1 : 0));
+    if (optimizer.present) {
+        const optim::Config& config = optimizer.config;
+        writer.put(static_cast<uint8_t>(config.method));
+        writer.put(config.learning_rate);
+        writer.put(config.momentum);
+        writer.put(config.beta1);
+        writer.put(config.beta2);
+        writer.put(config.epsilon);
+        writer.put(config.weight_decay);
+        writer.put(config.clip);
+        writer.put(optimizer.steps);
+        writer.put(optimizer.beta1_power);
+        writer.put(optimizer.beta2_power);
+        writer.put_floats(optimizer.first);
+        writer.put_floats(optimizer.second);
+    }
+    writer.put(fnv1a(writer.buffer.data(), writer.buffer.size()));
+
+    std::string tmp_path = file_path + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << tmp_path << std::endl;
+        return false;
+    }
+    if (std::fwrite(writer.buffer.data(), 1, writer.buffer.size(), file) != writer.buffer.size()) {
+        std::fclose(file);
+        std::remove(tmp_path.c_str());
+        std::cerr << "Error: Unable to write checkpoint " << tmp_path << std::endl;
+        return false;
+    }
+    if (!sync_and_rename(file, tmp_path, file_path)) {
+        std::remove(tmp_path.c_str());
+        std::cerr << "Error: Unable to commit checkpoint " << file_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_checkpoint_file(const std::string& file_path, Checkpoint& out) {
+    TRACE_SCOPE("checkpoint_read", "checkpoint");
+    FILE* file = std::fopen(file_path.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    std::vector<char> bytes;
+    char chunk[65536];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + count);
+    }
+    std::fclose(file);
+
+    try {
+        if (bytes.size() < sizeof(CHECKPOINT_MAGIC) + 2 * sizeof(uint32_t) ||
+            std::memcmp(bytes.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+            throw std::runtime_error("not a checkpoint file");
+        }
+        size_t payload = bytes.size() - sizeof(uint32_t);
+        uint32_t stored;
+        std::memcpy(&stored, bytes.data() + payload, sizeof(stored));
+        if (stored != fnv1a(bytes.data(), payload)) {
+            throw std::runtime_error("checksum mismatch");
+        }
+
+        ByteReader reader(bytes.data() + sizeof(CHECKPOINT_MAGIC), payload - sizeof(CHECKPOINT_MAGIC));
+        uint32_t version = reader.get<uint32_t>();
+        if (version < 1 || version > CHECKPOINT_VERSION) {
+            throw std::runtime_error("unsupported version");
+        }
+        TrainerState& state = out.state;
+        state.epoch = reader.get<uint32_t>();
+        state.sample_index = reader.get<uint64_t>();
+        state.learning_rate = reader.get<float>();
+        state.epoch_loss = reader.get<double>();
+        state.epoch_correct = reader.get<uint64_t>();
+        state.rng_state = reader.get_string();
+
+        uint32_t layer_count = reader.get<uint32_t>();
+        out.layers.resize(layer_count);
+        for (LayerParameters& layer : out.layers) {
+            layer.name = reader.get_string();
+            layer.input_size = reader.get<uint32_t>();
+            layer.output_size = reader.get<uint32_t>();
+            reader.get_floats(layer.weights);
+            reader.get_floats(layer.biases);
+        }
+
+        OptimizerState& optimizer = out.optimizer;
+        optimizer.present = version >= 2 && reader.get<uint8_t>() != 0;
+        optimizer.first.clear();
+        optimizer.second.clear();
+        if (optimizer.present) {
+            uint8_t method = reader.get<uint8_t>();
+            if (method > static_cast<uint8_t>(optim::Method::AdamW)) {
+                throw std::runtime_error("unknown optimizer method");
+            }
+            optim::Config& config = optimizer.config;
+            config.method = static_cast<optim::Method>(method);
+            config.learning_rate = reader.get<float>();
+            config.momentum = reader.get<float>();
+            config.beta1 = reader.get<float>();
+            config.beta2 = reader.get<float>();
+            config.epsilon = reader.get<float>();
+            config.weight_decay = reader.get<float>();
+            config.clip = reader.get<float>();
+            optimizer.steps = reader.get<uint64_t>();
+            optimizer.beta1_power = reader.get<double>();
+            optimizer.beta2_power = reader.get<double>();
+            reader.get_floats(optimizer.first);
+            reader.get_floats(optimizer.second);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: Invalid checkpoint " << file_path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//CheckpointWriter implementation
+CheckpointWriter::CheckpointWriter(const std::string& file_path)
+    : file_path(file_path), writing(false), stopping(false), written(0), skipped(0) {
+    worker = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_one();
+    worker.join();
+}
+
+void CheckpointWriter::submit(const MLP& mlp, const TrainerState& state, const optim::Optimizer* optimizer) {
+    TRACE_SCOPE("checkpoint_snapshot", "checkpoint");
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending) {
+        ++skipped;
+    }
+    else {
+        pending = spare ? std::move(spare) : std::make_unique<Checkpoint>();
+    }
+    //The writer only takes the lock to swap buffers, so this copy never waits on disk
+    capture_checkpoint(mlp, state, *pending, optimizer);
+    work_ready.notify_one();
+}
+
+void CheckpointWriter::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return !pending && !writing; });
+}
+
+uint64_t CheckpointWriter::get_written() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+uint64_t CheckpointWriter::get_skipped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return skipped;
+}
+
+void CheckpointWriter::run() {
+    trace::set_thread_name("checkpoint_writer");
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        work_ready.wait(lock, [this]() { return pending || stopping; });
+        if (!pending) {
+            break;
+        }
+        std::unique_ptr<Checkpoint> in_flight = std::move(pending);
+        writing = true;
+        lock.unlock();
+
+        bool ok = write_checkpoint_file(*in_flight, file_path);
+
+        lock.lock();
+        writing = false;
+        if (ok) {
+            ++written;
+        }
+        spare = std::move(in_flight);
+        if (!pending) {
+            idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+// checkpoint.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares resumable training checkpoints, a binary self-describing file with every layer's weights and biases, the fused optimizer's moments plus the trainer state, and a background writer so training does not stall on disk I/O.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "MLP.h"
+#include "optimizer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Everything besides the parameters needed to continue a run exactly where it stopped
+struct TrainerState {
+    uint32_t epoch = 0;            //Epoch to continue from
+    uint64_t sample_index = 0;     //Samples of that epoch already trained on
+    float learning_rate = 0.0f;
+    double epoch_loss = 0.0;       //Running totals of the partially finished epoch
+    uint64_t epoch_correct = 0;
+    std::string rng_state;         //std::mt19937 state at the start of the epoch, so the shuffle order is reproduced
+};
+
+struct LayerParameters {
+    std::string name;
+    uint32_t input_size = 0;
+    uint32_t output_size = 0;
+    std::vector<float> weights;
+    std::vector<float> biases;
+};
+
+//The fused optimizer's config and moments, present is false for runs on the per-layer SGD update
+struct OptimizerState {
+    bool present = false;
+    optim::Config config;
+    uint64_t steps = 0;
+    double beta1_power = 1.0;
+    double beta2_power = 1.0;
+    std::vector<float> first;
+    std::vector<float> second;
+};
+
+struct Checkpoint {
+    TrainerState state;
+    std::vector<LayerParameters> layers;
+    OptimizerState optimizer;
+};
+
+//Copies the MLP parameters and, if one is given, the optimizer's state into out, reusing its buffers so periodic
+//snapshots do not allocate
+void capture_checkpoint(const MLP& mlp, const TrainerState& state, Checkpoint& out, const optim::Optimizer* optimizer = nullptr);
+//Loads the parameters back, throws if the layer names or shapes do not match this MLP
+void restore_checkpoint(const Checkpoint& checkpoint, MLP& mlp);
+//Loads the saved moments and step count into an optimizer built from checkpoint.optimizer.config, throws if the
+//checkpoint has no optimizer state or it does not fit this optimizer
+void restore_optimizer(const Checkpoint& checkpoint, optim::Optimizer& optimizer);
+
+//Writes to file_path + ".tmp", fsyncs and renames over file_path so a crash never leaves a torn checkpoint
+bool write_checkpoint_file(const Checkpoint& checkpoint, const std::string& file_path);
+bool read_checkpoint_file(const std::string& file_path, Checkpoint& out);
+
+//Serializes checkpoints on a background thread, submit only copies the parameters and returns.
+//If a write is still running the newest pending snapshot replaces an older one that was not written yet.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const std::string& file_path);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    void submit(const MLP& mlp, const TrainerState& state, const optim::Optimizer* optimizer = nullptr);
+    //Blocks until every submitted checkpoint is on disk
+    void wait_idle();
+
+    uint64_t get_written() const;
+    uint64_t get_skipped() const;
+
+private:
+    void run();
+
+    std::string file_path;
+    mutable std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable idle;
+    std::unique_ptr<Checkpoint> pending;
+    std::unique_ptr<Checkpoint> spare;
+    bool writing;
+    bool stopping;
+    uint64_t written;
+    uint64_t skipped;
+    std::thread worker;
+};
+
+#endif
@@ -0,0 +1,214 @@
+// compact_model.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements evaluation, validation and the text file format of the compact model.
+
+#include "compact_model.h"
+#include "fused.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    const char* COMPACT_HEADER = "EdgeMLP-compact";
+    constexpr uint32_t COMPACT_VERSION = 1;
+
+    const char* activation_name(compact::Activation activation) {
+        switch (activation) {
+        case compact::Activation::ClipRelu: return "clip_relu";
+        case compact::Activation::Sigmoid: return "sigmoid";
+        default: return "linear";
+        }
+    }
+
+    bool parse_activation(const std::string& name, compact::Activation& activation) {
+        if (name == "linear") activation = compact::Activation::Linear;
+        else if (name == "clip_relu") activation = compact::Activation::ClipRelu;
+        else if (name == "sigmoid") activation = compact::Activation::Sigmoid;
+        else return false;
+        return true;
+    }
+
+    //Reads the next token and checks it is the expected keyword
+    void expect(std::istream& in, const char* keyword) {
+        std::string token;
+        if (!(in >> token) || token != keyword) {
+            throw std::runtime_error(std::string("expected ") + keyword);
+        }
+    }
+
+    template <typename T>
+    T read_value(std::istream& in) {
+        T value;
+        if (!(in >> value)) {
+            throw std::runtime_error("truncated file");
+        }
+        return value;
+    }
+}
+
+compact::Model::Model() : input_size(0), threshold(0.0f) {}
+
+uint32_t compact::Model::value_count() const {
+    uint32_t count = input_size;
+    for (const Stage& stage : stages) {
+        count += stage.outputs();
+    }
+    return count;
+}
+
+uint64_t compact::Model::mac_count() const {
+    uint64_t macs = 0;
+    for (const Stage& stage : stages) {
+        macs += static_cast<uint64_t>(stage.sources.size()) * stage.outputs();
+    }
+    return macs;
+}
+
+void compact::Model::validate() const {
+    if (input_size == 0 || stages.empty()) {
+        throw std::invalid_argument("Compact model needs inputs and at least one stage");
+    }
+    uint32_t available = input_size;
+    for (const Stage& stage : stages) {
+        if (stage.outputs() == 0 || stage.weights.size() != stage.sources.size() * stage.outputs()) {
+            throw std::invalid_argument("Compact stage weights size mismatch");
+        }
+        for (uint32_t source : stage.sources) {
+            if (source >= available) {
+                throw std::invalid_argument("Compact stage reads a value computed after it");
+            }
+        }
+        available += stage.outputs();
+    }
+}
+
+float compact::Model::score(const std::vector<float>& input) const {
+    thread_local Workspace workspace;
+    return score(input, workspace);
+}
+
+float compact::Model::score(const std::vector<float>& input, Workspace& workspace) const {
+    std::vector<float>& values = workspace.values;
+    std::vector<float>& gathered = workspace.gathered;
+    values.resize(value_count());
+    size_t copied = std::min<size_t>(input.size(), input_size);
+    std::copy(input.begin(), input.begin() + copied, values.begin());
+    std::fill(values.begin() + copied, values.begin() + input_size, 0.0f);
+
+    uint32_t offset = input_size;
+    for (const Stage& stage : stages) {
+        uint32_t count = static_cast<uint32_t>(stage.sources.size());
+        gathered.resize(std::max<size_t>(count, 1));
+        for (uint32_t j = 0; j < count; ++j) {
+            gathered[j] = values[stage.sources[j]];
+        }
+        float* out = values.data() + offset;
+        switch (stage.activation) {
+        case Activation::ClipRelu:
+            fused::dense_relu(gathered.data(), stage.weights.data(), stage.biases.data(), out, count, stage.outputs(),
+                stage.clip_min, stage.clip_max);
+            break;
+        case Activation::Sigmoid:
+            fused::dense_sigmoid(gathered.data(), stage.weights.data(), stage.biases.data(), out, count, stage.outputs());
+            break;
+        default:
+            fused::dense_linear(gathered.data(), stage.weights.data(), stage.biases.data(), out, count, stage.outputs());
+            break;
+        }
+        offset += stage.outputs();
+    }
+    return values.back();
+}
+
+bool compact::save_model(const Model& model, const std::string& file_path) {
+    std::ofstream file(file_path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    //max_digits10 so every float reads back bit for bit
+    file.precision(std::numeric_limits<float>::max_digits10);
+    file << COMPACT_HEADER << " " << COMPACT_VERSION << "\n";
+    file << "inputs " << model.input_size << "\n";
+    file << "threshold " << model.threshold << "\n";
+    file << "stages " << model.stages.size() << "\n";
+    for (const Stage& stage : model.stages) {
+        file << "stage " << activation_name(stage.activation) << " " << stage.clip_min << " " << stage.clip_max
+            << " outputs " << stage.outputs() << " sources " << stage.sources.size() << "\n";
+        for (uint32_t source : stage.sources) {
+            file << source << " ";
+        }
+        file << "\n";
+        for (uint32_t i = 0; i < stage.outputs(); ++i) {
+            for (size_t j = 0; j < stage.sources.size(); ++j) {
+                file << stage.weights[i * stage.sources.size() + j] << " ";
+            }
+            file << "\n";
+        }
+        for (float bias : stage.biases) {
+            file << bias << " ";
+        }
+        file << "\n";
+    }
+    file.close();
+    if (!file) {
+        std::cerr << "Error: Unable to write compact model " << file_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool compact::load_model(const std::string& file_path, Model& out) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    try {
+        expect(file, COMPACT_HEADER);
+        if (read_value<uint32_t>(file) != COMPACT_VERSION) {
+            throw std::runtime_error("unsupported version");
+        }
+        Model model;
+        expect(file, "inputs");
+        model.input_size = read_value<uint32_t>(file);
+        expect(file, "threshold");
+        model.threshold = read_value<float>(file);
+        expect(file, "stages");
+        model.stages.resize(read_value<uint32_t>(file));
+        for (Stage& stage : model.stages) {
+            expect(file, "stage");
+            if (!parse_activation(read_value<std::string>(file), stage.activation)) {
+                throw std::runtime_error("unknown activation");
+            }
+            stage.clip_min = read_value<float>(file);
+            stage.clip_max = read_value<float>(file);
+            expect(file, "outputs");
+            uint32_t outputs = read_value<uint32_t>(file);
+            expect(file, "sources");
+            uint32_t sources = read_value<uint32_t>(file);
+            stage.sources.resize(sources);
+            for (uint32_t& source : stage.sources) {
+                source = read_value<uint32_t>(file);
+            }
+            stage.weights.resize(static_cast<size_t>(outputs) * sources);
+            for (float& weight : stage.weights) {
+                weight = read_value<float>(file);
+            }
+            stage.biases.resize(outputs);
+            for (float& bias : stage.biases) {
+                bias = read_value<float>(file);
+            }
+        }
+        model.validate();
+        out = model;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: Invalid compact model " << file_path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
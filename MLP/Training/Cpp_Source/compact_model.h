@@ -0,0 +1,66 @@
+#pragma once
+// compact_model.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the compact model, the deployable form the graph optimizer writes out. It is a list of dense stages that each read an arbitrary set of earlier values, so padding, identity layers and pruned neurons simply do not appear in it.
+
+#ifndef COMPACT_MODEL_H
+#define COMPACT_MODEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace compact {
+    enum class Activation : uint8_t {
+        Linear = 0,
+        ClipRelu,
+        Sigmoid
+    };
+
+    //Values are numbered with the input features first (0 .. input_size-1), then every stage's outputs in stage order
+    struct Stage {
+        Activation activation = Activation::Linear;
+        float clip_min = -88.0f;
+        float clip_max = 88.0f;
+        std::vector<uint32_t> sources;  //Values this stage reads
+        std::vector<float> weights;     //Row-major [outputs][sources]
+        std::vector<float> biases;      //One per output
+
+        uint32_t outputs() const { return static_cast<uint32_t>(biases.size()); }
+    };
+
+    //Scratch for one evaluation, every value of it once score returns (inputs first)
+    struct Workspace {
+        std::vector<float> values;
+        std::vector<float> gathered;
+    };
+
+    //The last value of the last stage is the score, a sample is positive when the score is above threshold
+    class Model {
+    public:
+        Model();
+
+        uint32_t input_size;
+        std::vector<Stage> stages;
+        float threshold;
+
+        uint32_t value_count() const;
+        //Multiply-adds per sample, used to report what the optimizer saved
+        uint64_t mac_count() const;
+        //Throws if a stage reads a value that is not computed before it or the shapes do not line up
+        void validate() const;
+
+        //Shorter inputs are zero padded, longer ones are truncated to input_size. The model itself is never written, so
+        //one Model can be shared between threads: this overload uses a per thread workspace, the other the caller's.
+        float score(const std::vector<float>& input) const;
+        float score(const std::vector<float>& input, Workspace& workspace) const;
+        bool classify(const std::vector<float>& input) const { return score(input) > threshold; }
+    };
+
+    //Plain text so the file can be read next to weights.txt/biases.txt
+    bool save_model(const Model& model, const std::string& file_path);
+    bool load_model(const std::string& file_path, Model& out);
+}
+
+#endif
@@ -0,0 +1,622 @@
+// distributed.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the shared memory and Unix socket ring transports, the ring all-reduce, fp16 conversion, the worker launcher and the data-parallel training loop. The transports and launcher need Linux, elsewhere they throw.
+
+#include "distributed.h"
+#include "MLP.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+
+extern char** environ;
+#endif
+
+namespace {
+    //How long a rank waits on a neighbour that makes no progress before giving up
+    constexpr int PEER_TIMEOUT_MS = 60000;
+
+#if defined(__linux__)
+    constexpr uint64_t SEGMENT_MAGIC = 0x45444745524e4731ull;     //"EDGERNG1"
+    constexpr size_t CACHE_LINE = 64;
+
+    //Rank r writes its outgoing piece into mailbox r and rank r + 1 reads it, one piece in flight at a time
+    struct MailboxControl {
+        alignas(CACHE_LINE) std::atomic<uint64_t> written;
+        alignas(CACHE_LINE) std::atomic<uint64_t> consumed;
+    };
+
+    struct SegmentHeader {
+        alignas(CACHE_LINE) uint64_t magic;
+        uint32_t size;
+        uint64_t capacity;
+    };
+
+    size_t round_up(size_t value) {
+        return (value + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    }
+
+    size_t mailbox_stride(size_t capacity) {
+        return sizeof(MailboxControl) + round_up(capacity);
+    }
+
+    size_t segment_bytes(uint32_t size, size_t capacity) {
+        return sizeof(SegmentHeader) + size * mailbox_stride(capacity);
+    }
+
+    std::string segment_name(const std::string& name) {
+        return "/" + name;
+    }
+
+    std::string system_error(const std::string& what) {
+        return what + ": " + std::strerror(errno);
+    }
+
+    //Spins briefly, then yields, so ranks sharing a core still make progress. Throws once the peer looks gone.
+    class Backoff {
+    public:
+        void wait() {
+            if (++spins < 64) {
+                return;
+            }
+            if (spins == 64) {
+                start = std::chrono::steady_clock::now();
+            }
+            std::this_thread::yield();
+            if ((spins & 1023) == 0 && std::chrono::steady_clock::now() - start > std::chrono::milliseconds(PEER_TIMEOUT_MS)) {
+                throw std::runtime_error("Ring peer stopped responding");
+            }
+        }
+        void reset() { spins = 0; }
+
+    private:
+        uint64_t spins = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    class SharedMemoryTransport : public distributed::Transport {
+    public:
+        explicit SharedMemoryTransport(const distributed::Endpoint& endpoint)
+            : my_rank(endpoint.rank), ring_size(endpoint.size), capacity(endpoint.capacity) {
+            int fd = shm_open(segment_name(endpoint.name).c_str(), O_RDWR, 0);
+            if (fd < 0) {
+                throw std::runtime_error(system_error("Unable to open shared memory segment " + endpoint.name));
+            }
+            bytes = segment_bytes(ring_size, capacity);
+            struct stat info;
+            bool sized = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == bytes;
+            base = sized ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            close(fd);
+            if (base == MAP_FAILED) {
+                throw std::runtime_error("Shared memory segment " + endpoint.name + " does not match the ring size and capacity");
+            }
+            const SegmentHeader* header = static_cast<const SegmentHeader*>(base);
+            if (header->magic != SEGMENT_MAGIC || header->size != ring_size || header->capacity != capacity) {
+                munmap(base, bytes);
+                throw std::runtime_error("Shared memory segment " + endpoint.name + " was not set up for this ring");
+            }
+        }
+
+        ~SharedMemoryTransport() override {
+            munmap(base, bytes);
+        }
+
+        uint32_t rank() const override { return my_rank; }
+        uint32_t size() const override { return ring_size; }
+
+        void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) override {
+            MailboxControl& out = control(my_rank);
+            MailboxControl& in = control((my_rank + ring_size - 1) % ring_size);
+            unsigned char* out_data = data(my_rank);
+            const unsigned char* in_data = data((my_rank + ring_size - 1) % ring_size);
+            size_t sent = 0, received = 0;
+            Backoff backoff;
+            while (sent < send_bytes || received < recv_bytes) {
+                bool progress = false;
+                //The reader bumps consumed after copying out, so the mailbox is free once it catches up
+                if (sent < send_bytes && out.consumed.load(std::memory_order_acquire) == out.written.load(std::memory_order_relaxed)) {
+                    size_t piece = std::min(capacity, send_bytes - sent);
+                    std::memcpy(out_data, static_cast<const unsigned char*>(send) + sent, piece);
+                    sent += piece;
+                    out.written.fetch_add(1, std::memory_order_release);
+                    progress = true;
+                }
+                if (received < recv_bytes && in.written.load(std::memory_order_acquire) != in.consumed.load(std::memory_order_relaxed)) {
+                    size_t piece = std::min(capacity, recv_bytes - received);
+                    std::memcpy(static_cast<unsigned char*>(recv) + received, in_data, piece);
+                    received += piece;
+                    in.consumed.fetch_add(1, std::memory_order_release);
+                    progress = true;
+                }
+                if (progress) {
+                    backoff.reset();
+                }
+                else {
+                    backoff.wait();
+                }
+            }
+        }
+
+    private:
+        uint32_t my_rank;
+        uint32_t ring_size;
+        size_t capacity;
+        size_t bytes = 0;
+        void* base = nullptr;
+
+        MailboxControl& control(uint32_t rank) {
+            unsigned char* start = static_cast<unsigned char*>(base) + sizeof(SegmentHeader) + rank * mailbox_stride(capacity);
+            return *reinterpret_cast<MailboxControl*>(start);
+        }
+
+        unsigned char* data(uint32_t rank) {
+            return reinterpret_cast<unsigned char*>(&control(rank)) + sizeof(MailboxControl);
+        }
+    };
+
+    //Linux abstract namespace address, nothing to clean up on disk
+    socklen_t socket_address(const std::string& name, uint32_t rank, sockaddr_un& address) {
+        std::string path = "edgemlp/" + name + "/" + std::to_string(rank);
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() + 1 > sizeof(address.sun_path)) {
+            throw std::invalid_argument("Ring name too long for a socket address: " + name);
+        }
+        std::memcpy(address.sun_path + 1, path.data(), path.size());
+        return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+    }
+
+    class SocketTransport : public distributed::Transport {
+    public:
+        explicit SocketTransport(const distributed::Endpoint& endpoint) : my_rank(endpoint.rank), ring_size(endpoint.size) {
+            //Listen first, then connect forward and accept from behind, the backlog holds the incoming connection
+            //until accept so no ordering between ranks is needed
+            sockaddr_un address;
+            socklen_t length = socket_address(endpoint.name, my_rank, address);
+            int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), length) != 0 || listen(listener, 1) != 0) {
+                std::string error = system_error("Unable to listen on ring socket");
+                if (listener >= 0) close(listener);
+                throw std::runtime_error(error);
+            }
+            try {
+                next_fd = connect_next(endpoint.name, (my_rank + 1) % ring_size);
+                pollfd waiting = { listener, POLLIN, 0 };
+                if (poll(&waiting, 1, PEER_TIMEOUT_MS) != 1 || (prev_fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC)) < 0) {
+                    throw std::runtime_error(system_error("Previous rank never connected"));
+                }
+            }
+            catch (...) {
+                close(listener);
+                if (next_fd >= 0) close(next_fd);
+                throw;
+            }
+            close(listener);
+            fcntl(next_fd, F_SETFL, fcntl(next_fd, F_GETFL) | O_NONBLOCK);
+            fcntl(prev_fd, F_SETFL, fcntl(prev_fd, F_GETFL) | O_NONBLOCK);
+        }
+
+        ~SocketTransport() override {
+            close(next_fd);
+            close(prev_fd);
+        }
+
+        uint32_t rank() const override { return my_rank; }
+        uint32_t size() const override { return ring_size; }
+
+        //Sends and receives together, blocking on one direction alone would deadlock the ring once the
+        //socket buffers fill up
+        void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) override {
+            size_t sent = 0, received = 0;
+            while (sent < send_bytes || received < recv_bytes) {
+                pollfd fds[2] = { { next_fd, static_cast<short>(sent < send_bytes ? POLLOUT : 0), 0 },
+                    { prev_fd, static_cast<short>(received < recv_bytes ? POLLIN : 0), 0 } };
+                int ready = poll(fds, 2, PEER_TIMEOUT_MS);
+                if (ready == 0) {
+                    throw std::runtime_error("Ring peer stopped responding");
+                }
+                if (ready < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error(system_error("Ring poll failed"));
+                }
+                //A neighbour that already finished hangs up, that only matters while something is still owed
+                if (sent < send_bytes && (fds[0].revents & (POLLOUT | POLLERR | POLLHUP))) {
+                    ssize_t n = ::send(next_fd, static_cast<const char*>(send) + sent, send_bytes - sent, MSG_NOSIGNAL);
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        throw std::runtime_error(system_error("Ring send failed"));
+                    }
+                    sent += n > 0 ? static_cast<size_t>(n) : 0;
+                }
+                if (received < recv_bytes && (fds[1].revents & (POLLIN | POLLERR | POLLHUP))) {
+                    ssize_t n = ::recv(prev_fd, static_cast<char*>(recv) + received, recv_bytes - received, 0);
+                    if (n == 0) {
+                        throw std::runtime_error("Ring peer closed its connection");
+                    }
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        throw std::runtime_error(system_error("Ring receive failed"));
+                    }
+                    received += n > 0 ? static_cast<size_t>(n) : 0;
+                }
+            }
+        }
+
+    private:
+        uint32_t my_rank;
+        uint32_t ring_size;
+        int next_fd = -1;
+        int prev_fd = -1;
+
+        static int connect_next(const std::string& name, uint32_t next) {
+            sockaddr_un address;
+            socklen_t length = socket_address(name, next, address);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(PEER_TIMEOUT_MS);
+            for (;;) {
+                int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                if (fd < 0) {
+                    throw std::runtime_error(system_error("Unable to create ring socket"));
+                }
+                if (::connect(fd, reinterpret_cast<sockaddr*>(&address), length) == 0) {
+                    return fd;
+                }
+                close(fd);
+                if (std::chrono::steady_clock::now() > deadline) {
+                    throw std::runtime_error("Next rank never started listening");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    };
+#endif
+
+    //Bulk conversions for the compressed ring, 8 at a time with F16C (same rounding as to_half)
+    void encode_half(const float* in, uint16_t* out, size_t count) {
+        size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= count; i += 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = distributed::to_half(in[i]);
+        }
+    }
+
+    void decode_half(const uint16_t* in, float* out, size_t count) {
+        size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = distributed::from_half(in[i]);
+        }
+    }
+
+    //First element of segment s when count values are split into size segments
+    size_t segment_begin(size_t count, uint32_t segment, uint32_t size) {
+        return count * segment / size;
+    }
+}
+
+const char* distributed::backend_name(Backend backend) {
+    switch (backend) {
+    case Backend::SharedMemory: return "shm";
+    case Backend::Socket: return "socket";
+    }
+    return "unknown";
+}
+
+bool distributed::parse_backend(const std::string& name, Backend& backend) {
+    const Backend all[] = { Backend::SharedMemory, Backend::Socket };
+    for (Backend candidate : all) {
+        if (name == backend_name(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<distributed::Transport> distributed::connect(const Endpoint& endpoint) {
+    if (endpoint.size == 0 || endpoint.rank >= endpoint.size || endpoint.name.empty() || endpoint.capacity == 0) {
+        throw std::invalid_argument("Ring endpoint needs a name, a positive size and capacity and a rank below the size");
+    }
+#if defined(__linux__)
+    switch (endpoint.backend) {
+    case Backend::SharedMemory: return std::make_unique<SharedMemoryTransport>(endpoint);
+    case Backend::Socket: return std::make_unique<SocketTransport>(endpoint);
+    }
+#endif
+    throw std::runtime_error(std::string("Ring transport ") + backend_name(endpoint.backend) + " is not supported on this platform");
+}
+
+//Session implementation
+distributed::Session::Session(const Endpoint& endpoint) {
+    if (endpoint.backend != Backend::SharedMemory) {
+        return;
+    }
+#if defined(__linux__)
+    std::string name = segment_name(endpoint.name);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error(system_error("Unable to create shared memory segment " + endpoint.name));
+    }
+    const size_t bytes = segment_bytes(endpoint.size, endpoint.capacity);
+    void* base = ftruncate(fd, static_cast<off_t>(bytes)) == 0
+        ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error(system_error("Unable to size shared memory segment " + endpoint.name));
+    }
+    unsigned char* start = static_cast<unsigned char*>(base);
+    for (uint32_t r = 0; r < endpoint.size; ++r) {
+        MailboxControl* control = reinterpret_cast<MailboxControl*>(start + sizeof(SegmentHeader) + r * mailbox_stride(endpoint.capacity));
+        new (&control->written) std::atomic<uint64_t>(0);
+        new (&control->consumed) std::atomic<uint64_t>(0);
+    }
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(start);
+    header->size = endpoint.size;
+    header->capacity = endpoint.capacity;
+    header->magic = SEGMENT_MAGIC;
+    munmap(base, bytes);
+    segment = name;
+#else
+    throw std::runtime_error("Shared memory rings are not supported on this platform");
+#endif
+}
+
+distributed::Session::~Session() {
+#if defined(__linux__)
+    if (!segment.empty()) {
+        shm_unlink(segment.c_str());
+    }
+#endif
+}
+
+//fp16 conversion, the bit tricks are the usual round to nearest even ones
+uint16_t distributed::to_half(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t magnitude = bits & 0x7fffffffu;
+    if (magnitude >= 0x7f800000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u);                //Rounds past 65504
+    }
+    if (magnitude < 0x38800000u) {
+        //Subnormal half: adding 0.5 lines the float's last mantissa bit up with the half's 2^-24 step
+        float scaled;
+        std::memcpy(&scaled, &magnitude, sizeof(scaled));
+        scaled += 0.5f;
+        uint32_t rounded;
+        std::memcpy(&rounded, &scaled, sizeof(rounded));
+        return static_cast<uint16_t>(sign | (rounded - 0x3f000000u));
+    }
+    const uint32_t odd = (magnitude >> 13) & 1u;
+    magnitude += 0xc8000fffu + odd;                                 //Rebias the exponent and round
+    return static_cast<uint16_t>(sign | (magnitude >> 13));
+}
+
+float distributed::from_half(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1fu;
+    const uint32_t mantissa = value & 0x3ffu;
+    if (exponent == 0) {
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+    uint32_t bits = exponent == 0x1fu ? sign | 0x7f800000u | (mantissa << 13) : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void distributed::all_reduce(Transport& transport, Span<float> values, bool compress) {
+    const uint32_t size = transport.size();
+    const size_t count = values.size();
+    if (size <= 1 || count == 0) {
+        return;
+    }
+    const uint32_t rank = transport.rank();
+    const size_t largest = count / size + 1;
+    std::vector<float> incoming(largest);
+    std::vector<uint16_t> send_half(compress ? largest : 0), recv_half(compress ? largest : 0);
+
+    //Sends segment send_segment while receiving recv_segment into incoming
+    auto step = [&](uint32_t send_segment, uint32_t recv_segment) {
+        const size_t send_begin = segment_begin(count, send_segment, size);
+        const size_t send_count = segment_begin(count, send_segment + 1, size) - send_begin;
+        const size_t recv_count = segment_begin(count, recv_segment + 1, size) - segment_begin(count, recv_segment, size);
+        if (!compress) {
+            transport.exchange(values.data() + send_begin, send_count * sizeof(float), incoming.data(), recv_count * sizeof(float));
+            return recv_count;
+        }
+        encode_half(values.data() + send_begin, send_half.data(), send_count);
+        transport.exchange(send_half.data(), send_count * sizeof(uint16_t), recv_half.data(), recv_count * sizeof(uint16_t));
+        decode_half(recv_half.data(), incoming.data(), recv_count);
+        return recv_count;
+    };
+
+    //Reduce-scatter: after size - 1 steps rank r holds the full sum of segment r + 1
+    for (uint32_t s = 0; s + 1 < size; ++s) {
+        const uint32_t recv_segment = (rank + 2 * size - s - 1) % size;
+        const size_t received = step((rank + size - s) % size, recv_segment);
+        float* target = values.data() + segment_begin(count, recv_segment, size);
+        for (size_t i = 0; i < received; ++i) {
+            target[i] += incoming[i];
+        }
+    }
+    //Compressed rings round the owned sum the same way the others will receive it, so every rank ends identical
+    const uint32_t owned = (rank + 1) % size;
+    if (compress) {
+        const size_t begin = segment_begin(count, owned, size);
+        const size_t owned_count = segment_begin(count, owned + 1, size) - begin;
+        encode_half(values.data() + begin, send_half.data(), owned_count);
+        decode_half(send_half.data(), values.data() + begin, owned_count);
+    }
+    //All-gather: pass the finished segments around
+    for (uint32_t s = 0; s + 1 < size; ++s) {
+        const uint32_t recv_segment = (rank + size - s) % size;
+        const size_t received = step((rank + 1 + size - s) % size, recv_segment);
+        std::copy(incoming.begin(), incoming.begin() + received, values.begin() + segment_begin(count, recv_segment, size));
+    }
+}
+
+void distributed::broadcast(Transport& transport, Span<float> values, uint32_t root) {
+    //Adding zeros is exact, so a sum where only root contributes is root's values
+    if (transport.rank() != root) {
+        std::fill(values.begin(), values.end(), 0.0f);
+    }
+    all_reduce(transport, values, false);
+}
+
+uint32_t distributed::run_workers(const std::string& program, const std::vector<std::vector<std::string>>& args) {
+#if defined(__linux__)
+    std::vector<pid_t> running;
+    uint32_t failed = 0;
+    for (const auto& worker_args : args) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(program.c_str()));
+        for (const auto& arg : worker_args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        pid_t pid;
+        if (posix_spawn(&pid, program.c_str(), nullptr, nullptr, argv.data(), environ) == 0) {
+            running.push_back(pid);
+        }
+        else {
+            ++failed;
+        }
+    }
+    bool stopping = failed > 0;
+    if (stopping) {
+        for (pid_t pid : running) kill(pid, SIGTERM);
+    }
+    while (!running.empty()) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        auto it = std::find(running.begin(), running.end(), pid);
+        if (it == running.end()) {
+            continue;
+        }
+        running.erase(it);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failed;
+            //The others would wait on the ring forever
+            if (!stopping) {
+                stopping = true;
+                for (pid_t other : running) kill(other, SIGTERM);
+            }
+        }
+    }
+    return failed + static_cast<uint32_t>(running.size());
+#else
+    (void)program;
+    (void)args;
+    throw std::runtime_error("Launching workers is not supported on this platform");
+#endif
+}
+
+std::vector<distributed::EpochStats> distributed::train_data_parallel(MLP& mlp, Transport& transport, const Dataset& data,
+    const TrainConfig& config, optim::Optimizer& optimizer, const std::function<void(int epoch, const EpochStats& stats)>& on_epoch) {
+    if (config.batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    const uint32_t size = transport.size();
+    const uint32_t rank = transport.rank();
+    broadcast(transport, mlp.get_parameters(), 0);
+    mlp.mark_parameters_changed();
+
+    std::vector<uint32_t> shard;
+    for (size_t i = rank; i < data.size(); i += size) {
+        shard.push_back(static_cast<uint32_t>(i));
+    }
+    //Every rank runs the same number of steps so the collectives line up, short shards send empty batches at the end
+    const size_t largest_shard = (data.size() + size - 1) / size;
+    const size_t steps = (largest_shard + config.batch_size - 1) / config.batch_size;
+    std::mt19937 rng(config.seed + rank);
+
+    const size_t parameter_count = mlp.get_trainable_parameters().size();
+    std::vector<float> gradient(parameter_count);
+    std::vector<EpochStats> history;
+    for (int epoch = 0; epoch < config.epochs; ++epoch) {
+        if (config.shuffle) {
+            std::shuffle(shard.begin(), shard.end(), rng);
+        }
+        EpochStats stats;
+        double correct = 0.0;
+        for (size_t step = 0; step < steps; ++step) {
+            std::fill(gradient.begin(), gradient.end(), 0.0f);
+            float totals[3] = { 0.0f, 0.0f, 0.0f };        //Loss, correct, samples
+            const size_t end = std::min(shard.size(), (step + 1) * config.batch_size);
+            for (size_t i = step * config.batch_size; i < end; ++i) {
+                const auto& sample = data[shard[i]];
+                mlp.forward(sample.first);
+                const float output = mlp.get_output()[0];
+                const float error = output - sample.second;
+                totals[0] += 0.5f * error * error;
+                totals[1] += (output > 0.5f) == (sample.second != 0) ? 1.0f : 0.0f;
+                totals[2] += 1.0f;
+                mlp.compute_gradients(error);
+                Span<const float> g = mlp.get_trainable_gradients();
+                for (size_t j = 0; j < parameter_count; ++j) {
+                    gradient[j] += g[j];
+                }
+            }
+            all_reduce(transport, Span<float>(gradient.data(), gradient.size()), config.compress);
+            all_reduce(transport, Span<float>(totals, 3), false);
+            if (totals[2] > 0.0f) {
+                const float scale = 1.0f / totals[2];
+                for (float& g : gradient) {
+                    g *= scale;
+                }
+                mlp.apply_gradients(Span<const float>(gradient.data(), gradient.size()), optimizer);
+            }
+            stats.loss += totals[0];
+            correct += totals[1];
+            stats.samples += static_cast<uint64_t>(totals[2]);
+        }
+        if (stats.samples > 0) {
+            stats.loss /= static_cast<double>(stats.samples);
+            stats.accuracy = correct / static_cast<double>(stats.samples);
+        }
+        history.push_back(stats);
+        if (on_epoch) {
+            on_epoch(epoch, stats);
+        }
+    }
+    return history;
+}
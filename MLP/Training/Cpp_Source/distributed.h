@@ -0,0 +1,104 @@
+#pragma once
+// distributed.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares multi-process data-parallel training, the pluggable ring transport (POSIX shared memory or Unix sockets today), the ring all-reduce with optional fp16 compression on top of it, the worker launcher and the synchronous data-parallel training loop.
+
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include "arena.h"
+#include "optimizer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace distributed {
+    using Dataset = std::vector<std::pair<std::vector<float>, int>>;
+
+    enum class Backend : uint8_t {
+        SharedMemory = 0,
+        Socket
+    };
+
+    const char* backend_name(Backend backend);
+    bool parse_backend(const std::string& name, Backend& backend);
+
+    //Where one rank finds the others: every rank of a job uses the same backend, name and size
+    struct Endpoint {
+        Backend backend = Backend::SharedMemory;
+        std::string name;                   //Shared memory segment or socket name prefix, unique per job
+        uint32_t rank = 0;
+        uint32_t size = 1;
+        size_t capacity = 64 * 1024;        //Shared memory mailbox bytes per rank, longer messages go in pieces
+    };
+
+    //One rank's link into the ring. A new backend (e.g. TCP across machines) only has to implement exchange.
+    class Transport {
+    public:
+        virtual ~Transport() = default;
+        virtual uint32_t rank() const = 0;
+        virtual uint32_t size() const = 0;
+        //Sends send_bytes to rank + 1 while receiving recv_bytes from rank - 1 (both around the ring), the one
+        //step the ring collectives are made of. Throws std::runtime_error when a peer goes away.
+        virtual void exchange(const void* send, size_t send_bytes, void* recv, size_t recv_bytes) = 0;
+    };
+
+    //Joins the ring, blocks until the neighbours are there. Throws std::runtime_error on failure.
+    std::unique_ptr<Transport> connect(const Endpoint& endpoint);
+
+    //What the launching process sets up before the workers start and removes once they are done: the shared
+    //memory segment for SharedMemory, nothing for sockets (they use the abstract namespace)
+    class Session {
+    public:
+        explicit Session(const Endpoint& endpoint);
+        ~Session();
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+    private:
+        std::string segment;
+    };
+
+    //Elementwise sum over every rank, every rank ends with the same values. The ring splits values into size()
+    //segments, a reduce-scatter and an all-gather each take size() - 1 exchanges. compress sends fp16 instead of
+    //float, halving the bytes at about 3 significant digits per hop.
+    void all_reduce(Transport& transport, Span<float> values, bool compress = false);
+    //Every rank ends with root's values
+    void broadcast(Transport& transport, Span<float> values, uint32_t root = 0);
+
+    //IEEE half precision, round to nearest even, out of range values become infinity
+    uint16_t to_half(float value);
+    float from_half(uint16_t value);
+
+    //Starts one process per argument list (program plus args[i]) and waits for all of them. When one fails the
+    //others are stopped. Returns the number of workers that did not exit with 0.
+    uint32_t run_workers(const std::string& program, const std::vector<std::vector<std::string>>& args);
+
+    struct TrainConfig {
+        int epochs = 20;
+        uint32_t batch_size = 16;           //Per worker, one step covers batch_size * workers samples
+        bool compress = false;
+        bool shuffle = false;
+        uint32_t seed = 42;
+    };
+
+    struct EpochStats {
+        uint64_t samples = 0;
+        double loss = 0.0;                  //Mean half squared error, like the single process trainer
+        double accuracy = 0.0;
+    };
+
+    //Synchronous data-parallel SGD: rank r trains on samples r, r + size, r + 2 * size, ... and every step the
+    //minibatch gradients of all ranks are all-reduced and averaged, so every rank applies the same update through
+    //its optimizer. Rank 0's starting parameters are broadcast first. on_epoch gets the stats of all ranks combined.
+    std::vector<EpochStats> train_data_parallel(MLP& mlp, Transport& transport, const Dataset& data, const TrainConfig& config,
+        optim::Optimizer& optimizer, const std::function<void(int epoch, const EpochStats& stats)>& on_epoch = nullptr);
+}
+
+#endif
@@ -0,0 +1,114 @@
+// embedding.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the digit embedding table, building the (position, digit) rows from the MLP's hidden and output weights and predicting by adding one row per nonzero digit to the biases before handing the sums to the fused network for the activations and the output layer.
+
+#include "embedding.h"
+#include "MLP.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    //Row sized buffers on the stack, the table checks its rows fit
+    constexpr uint32_t MAX_STRIDE = 64;
+
+    inline void add_row(float* sums, const float* row, uint32_t stride) {
+        for (uint32_t k = 0; k < stride; k += static_cast<uint32_t>(simd::WIDTH)) {
+            simd::store(sums + k, simd::add(simd::load(sums + k), simd::load(row + k)));
+        }
+    }
+}
+
+namespace embedding {
+    DigitTable::DigitTable(const MLP& mlp) : positions(INPUT_SIZE) {
+        mlp.pack_network(positions, network);
+        const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+        hidden_size = network.get_hidden_size();
+        stride = (hidden_size + network.get_output_size() + width - 1) / width * width;
+        if (stride > MAX_STRIDE || network.get_padded_hidden_size() > MAX_STRIDE) {
+            throw std::invalid_argument("Network too wide for the digit table");
+        }
+
+        parity_rows = mlp.input_columns(positions, hidden_size, stride);
+        //digit / largest rounded the way normalize_input rounds it, before the multiply
+        rows.assign(static_cast<size_t>(DIGITS - 1) * positions * DIGITS * stride, 0.0f);
+        for (uint32_t largest = 1; largest < DIGITS; ++largest) {
+            for (uint32_t position = 0; position < positions; ++position) {
+                for (uint32_t digit = 0; digit <= largest; ++digit) {
+                    const float value = static_cast<float>(digit) / static_cast<float>(largest);
+                    float* row = rows.data() + (((largest - 1) * positions + position) * DIGITS + digit) * stride;
+                    for (uint32_t k = 0; k < stride; ++k) {
+                        row[k] = value * parity_rows[position * stride + k];
+                    }
+                }
+            }
+        }
+        Span<const float> hidden_biases = mlp.get_hidden_layer1().get_biases();
+        biases.assign(stride, 0.0f);
+        std::copy(hidden_biases.begin(), hidden_biases.begin() + hidden_size, biases.begin());
+    }
+
+    int DigitTable::check(const std::vector<int>& digits) const {
+        //normalize_input appends the parity feature and predict takes at most 10 values
+        if (digits.empty() || digits.size() > positions) {
+            throw std::invalid_argument("Digit inputs must have between 1 and 9 digits");
+        }
+        int largest = 0;
+        for (int digit : digits) {
+            if (digit < 0 || digit >= static_cast<int>(DIGITS)) {
+                throw std::invalid_argument("Digit inputs must be between 0 and 9");
+            }
+            largest = std::max(largest, digit);
+        }
+        if (largest == 0) {
+            throw std::invalid_argument("Digit inputs need a nonzero digit");
+        }
+        return largest;
+    }
+
+    float DigitTable::score(const std::vector<int>& digits, int largest) const {
+        alignas(64) float sums[MAX_STRIDE];
+        std::copy(biases.begin(), biases.end(), sums);
+        const float* table = rows.data() + static_cast<size_t>(largest - 1) * positions * DIGITS * stride;
+        const uint32_t count = static_cast<uint32_t>(digits.size());
+        //Zero digits have all zero rows
+        for (uint32_t position = 0; position < count; ++position) {
+            if (digits[position] != 0) {
+                add_row(sums, table + (position * DIGITS + digits[position]) * stride, stride);
+            }
+        }
+        //The parity feature (1 for an odd last digit) sits right after the digits, a 9th digit pushes it past the inputs
+        if (count < positions && digits.back() % 2 != 0) {
+            add_row(sums, parity_rows.data() + count * stride, stride);
+        }
+
+        //forward_hidden wants the hidden pre-activations on their own, zero padded to whole vectors
+        alignas(64) float pre_activations[MAX_STRIDE];
+        std::fill(pre_activations, pre_activations + network.get_padded_hidden_size(), 0.0f);
+        std::copy(sums, sums + hidden_size, pre_activations);
+        float result[fused::SmallNetwork::MAX_OUTPUTS];
+        network.forward_hidden(pre_activations, sums + hidden_size, result);
+        return result[0];
+    }
+
+    float DigitTable::predict(const std::vector<int>& digits) const {
+        return score(digits, check(digits));
+    }
+
+    std::vector<float> DigitTable::predict_batch(const std::vector<std::pair<std::vector<int>, int>>& samples) const {
+        std::vector<int> largest(samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            largest[i] = check(samples[i].first);
+        }
+        std::vector<float> scores(samples.size());
+        const uint64_t work_per_sample = static_cast<uint64_t>(positions + 1) * stride;
+        parallel::parallel_for(static_cast<uint32_t>(samples.size()), work_per_sample, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                scores[i] = score(samples[i].first, largest[i]);
+            }
+        });
+        return scores;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+// embedding.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the embedding table inference mode for digit inputs. Every input position of read_data's digit vectors holds one of 10 values, so what each (position, digit) pair adds to the layers that read the input (the hidden layer and the skip into the output layer) is worked out once when the table is built and a prediction gathers and adds a row per digit instead of running those matrix-vector products.
+
+#ifndef EMBEDDING_H
+#define EMBEDDING_H
+
+#include "fused.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace embedding {
+    constexpr uint32_t DIGITS = 10;
+
+    //Snapshot of an MLP's weights for digit vectors, build it after training or load_parameters and rebuild it when they change.
+    //predict(digits) gives MLP::predict(MLP::normalize_input(digits)). normalize_input divides by the largest digit, so there
+    //is a table per largest digit with that division already in it, and the parity feature it appends is one more row.
+    class DigitTable {
+    public:
+        explicit DigitTable(const MLP& mlp);
+
+        //Throws std::invalid_argument unless there are 1 to 9 digits (normalize_input plus predict takes at most 9 too), each
+        //0-9 and not all 0 (normalize_input would divide by zero)
+        float predict(const std::vector<int>& digits) const;
+        //predict for every sample of read_data (labels are ignored), large batches are split across the shared thread pool
+        std::vector<float> predict_batch(const std::vector<std::pair<std::vector<int>, int>>& samples) const;
+
+        uint32_t get_positions() const { return positions; }
+
+    private:
+        fused::SmallNetwork network;
+        uint32_t positions;
+        uint32_t hidden_size;
+        uint32_t stride;                //Floats per row, the hidden pre-activations then the skip sums, padded to whole vectors
+        std::vector<float> rows;        //[largest - 1][position][digit][stride], the input column times digit / largest
+        std::vector<float> parity_rows; //[position][stride], the column alone, for the parity feature at that position
+        std::vector<float> biases;      //[stride], the hidden biases, zero for the skip sums
+
+        //Returns the largest digit
+        int check(const std::vector<int>& digits) const;
+        float score(const std::vector<int>& digits, int largest) const;
+    };
+}
+
+#endif
@@ -0,0 +1,259 @@
+// evaluation.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the one pass evaluation engine, every task scores its chunks and folds them into its own histograms, then the histograms are merged and every metric is read off them.
+
+#include "evaluation.h"
+#include "MLP.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+    constexpr float LOG_EPSILON = 1e-7f;
+
+    //Integer counts of one task, merging them is exact in any order
+    struct Histograms {
+        std::vector<uint64_t> positive;         //[bins]
+        std::vector<uint64_t> negative;         //[bins]
+        std::vector<uint64_t> bucket_count;     //[calibration_buckets]
+        std::vector<uint64_t> bucket_positive;
+        uint64_t correct = 0;
+
+        Histograms(uint32_t bins, uint32_t buckets)
+            : positive(bins), negative(bins), bucket_count(buckets), bucket_positive(buckets) {}
+
+        void merge(const Histograms& other) {
+            for (size_t i = 0; i < positive.size(); ++i) {
+                positive[i] += other.positive[i];
+                negative[i] += other.negative[i];
+            }
+            for (size_t i = 0; i < bucket_count.size(); ++i) {
+                bucket_count[i] += other.bucket_count[i];
+                bucket_positive[i] += other.bucket_positive[i];
+            }
+            correct += other.correct;
+        }
+    };
+
+    inline uint32_t bin_of(float score, uint32_t bins) {
+        //NaN and negative scores land in bin 0
+        float scaled = score * static_cast<float>(bins);
+        if (!(scaled > 0.0f)) {
+            return 0;
+        }
+        return std::min(static_cast<uint32_t>(scaled), bins - 1);
+    }
+
+    //fill(begin, count, scores, labels) writes the scores and labels of samples [begin, begin + count)
+    template <typename Fill>
+    evaluation::Report evaluate_chunks(size_t count, const evaluation::Config& config, uint64_t work_per_sample, Fill fill) {
+        if (config.bins == 0 || config.calibration_buckets == 0 || config.chunk == 0) {
+            throw std::invalid_argument("Evaluation bins, calibration buckets and chunk must be positive");
+        }
+        const uint32_t bins = config.bins;
+        const uint32_t buckets = config.calibration_buckets;
+        const uint32_t chunk = config.chunk;
+        if (count > static_cast<size_t>(std::numeric_limits<uint32_t>::max() - chunk)) {
+            throw std::invalid_argument("Too many samples for one evaluation");
+        }
+        const uint32_t chunks = static_cast<uint32_t>((count + chunk - 1) / chunk);
+
+        //Floating point sums are kept per chunk and added up in chunk order afterwards, so the result is the same
+        //however the chunks were split between threads
+        const size_t sums_per_chunk = 1 + static_cast<size_t>(buckets);
+        std::vector<double> chunk_sums(static_cast<size_t>(chunks) * sums_per_chunk, 0.0);
+        std::vector<std::unique_ptr<Histograms>> partial(chunks);
+
+        parallel::parallel_for(chunks, work_per_sample * chunk, 1, [&](uint32_t begin, uint32_t end) {
+            auto histograms = std::make_unique<Histograms>(bins, buckets);
+            std::vector<float> scores(chunk);
+            std::vector<int> labels(chunk);
+            for (uint32_t c = begin; c < end; ++c) {
+                const size_t first = static_cast<size_t>(c) * chunk;
+                const uint32_t n = static_cast<uint32_t>(std::min<size_t>(chunk, count - first));
+                fill(first, n, scores.data(), labels.data());
+                double* sums = chunk_sums.data() + static_cast<size_t>(c) * sums_per_chunk;
+                for (uint32_t i = 0; i < n; ++i) {
+                    const float score = scores[i];
+                    const bool positive = labels[i] != 0;
+                    (positive ? histograms->positive : histograms->negative)[bin_of(score, bins)] += 1;
+                    histograms->correct += (score > 0.5f) == positive ? 1 : 0;
+                    const float q = positive ? score : 1.0f - score;
+                    sums[0] -= std::log(std::min(std::max(q, LOG_EPSILON), 1.0f - LOG_EPSILON));
+                    const uint32_t bucket = bin_of(score, buckets);
+                    histograms->bucket_count[bucket] += 1;
+                    histograms->bucket_positive[bucket] += positive ? 1 : 0;
+                    sums[1 + bucket] += score;
+                }
+            }
+            partial[begin] = std::move(histograms);
+        });
+
+        Histograms total(bins, buckets);
+        for (const auto& histograms : partial) {
+            if (histograms) {
+                total.merge(*histograms);
+            }
+        }
+        double loss = 0.0;
+        std::vector<double> bucket_sum(buckets, 0.0);
+        for (uint32_t c = 0; c < chunks; ++c) {
+            const double* sums = chunk_sums.data() + static_cast<size_t>(c) * sums_per_chunk;
+            loss += sums[0];
+            for (uint32_t b = 0; b < buckets; ++b) {
+                bucket_sum[b] += sums[1 + b];
+            }
+        }
+
+        evaluation::Report report;
+        report.count = count;
+        for (uint32_t b = 0; b < bins; ++b) {
+            report.positives += total.positive[b];
+        }
+        const uint64_t negatives = count - report.positives;
+        if (count > 0) {
+            report.accuracy = static_cast<double>(total.correct) / count;
+            report.log_loss = loss / count;
+        }
+
+        //Walk the bins from the highest score down, every bin is one step of the ROC and PR curves and its scores
+        //count as ties (half credit for the ROC area)
+        double roc_area = 0.0;
+        double precision_sum = 0.0;
+        uint64_t tp = 0, fp = 0;
+        for (uint32_t b = bins; b-- > 0;) {
+            const uint64_t p = total.positive[b];
+            const uint64_t n = total.negative[b];
+            roc_area += static_cast<double>(n) * (static_cast<double>(tp) + 0.5 * static_cast<double>(p));
+            tp += p;
+            fp += n;
+            if (p > 0) {
+                precision_sum += static_cast<double>(p) * static_cast<double>(tp) / static_cast<double>(tp + fp);
+            }
+        }
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        report.roc_auc = report.positives > 0 && negatives > 0
+            ? roc_area / (static_cast<double>(report.positives) * static_cast<double>(negatives)) : nan;
+        report.pr_auc = report.positives > 0 && negatives > 0 ? precision_sum / static_cast<double>(report.positives) : nan;
+
+        //Confusion matrices from suffix sums of the histograms, bins at or above the threshold's edge are positive
+        std::vector<float> thresholds = config.thresholds;
+        if (thresholds.empty()) {
+            for (int t = 1; t <= 19; ++t) {
+                thresholds.push_back(0.05f * static_cast<float>(t));
+            }
+        }
+        std::vector<uint64_t> positive_above(bins + 1, 0), negative_above(bins + 1, 0);
+        for (uint32_t b = bins; b-- > 0;) {
+            positive_above[b] = positive_above[b + 1] + total.positive[b];
+            negative_above[b] = negative_above[b + 1] + total.negative[b];
+        }
+        for (float threshold : thresholds) {
+            const double scaled = std::round(static_cast<double>(std::min(std::max(threshold, 0.0f), 1.0f)) * bins);
+            const uint32_t edge = static_cast<uint32_t>(scaled);
+            evaluation::ThresholdCounts counts;
+            counts.threshold = static_cast<float>(static_cast<double>(edge) / bins);
+            counts.true_positives = positive_above[edge];
+            counts.false_positives = negative_above[edge];
+            counts.false_negatives = report.positives - counts.true_positives;
+            counts.true_negatives = negatives - counts.false_positives;
+            report.thresholds.push_back(counts);
+        }
+
+        double calibration_error = 0.0;
+        for (uint32_t b = 0; b < buckets; ++b) {
+            evaluation::CalibrationBucket bucket;
+            bucket.lower = static_cast<float>(b) / buckets;
+            bucket.upper = static_cast<float>(b + 1) / buckets;
+            bucket.count = total.bucket_count[b];
+            if (bucket.count > 0) {
+                bucket.mean_score = bucket_sum[b] / bucket.count;
+                bucket.positive_rate = static_cast<double>(total.bucket_positive[b]) / bucket.count;
+                calibration_error += static_cast<double>(bucket.count) * std::abs(bucket.mean_score - bucket.positive_rate);
+            }
+            report.calibration.push_back(bucket);
+        }
+        report.calibration_error = count > 0 ? calibration_error / count : 0.0;
+        return report;
+    }
+
+    double ratio(uint64_t numerator, uint64_t denominator) {
+        return denominator > 0 ? static_cast<double>(numerator) / denominator : 0.0;
+    }
+}
+
+double evaluation::ThresholdCounts::precision() const {
+    return ratio(true_positives, true_positives + false_positives);
+}
+
+double evaluation::ThresholdCounts::recall() const {
+    return ratio(true_positives, true_positives + false_negatives);
+}
+
+double evaluation::ThresholdCounts::accuracy() const {
+    return ratio(true_positives + true_negatives, true_positives + false_positives + true_negatives + false_negatives);
+}
+
+double evaluation::ThresholdCounts::f1() const {
+    double p = precision(), r = recall();
+    return p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+}
+
+evaluation::Report evaluation::evaluate(const Dataset& data, const Scorer& scorer, const Config& config) {
+    //The cost model only needs a rough size, about one small forward pass per sample
+    return evaluate_chunks(data.size(), config, 512, [&](size_t begin, uint32_t n, float* scores, int* labels) {
+        scorer(data.data() + begin, n, scores);
+        for (uint32_t i = 0; i < n; ++i) {
+            labels[i] = data[begin + i].second;
+        }
+    });
+}
+
+evaluation::Report evaluation::evaluate(const MLP& mlp, const Dataset& data, const Config& config) {
+    for (const auto& sample : data) {
+        if (sample.first.empty() || sample.first.size() > 10) {
+            throw std::invalid_argument("Input size must be between 1 and 10");
+        }
+    }
+    mlp.prepare_batch();
+    return evaluate(data, [&mlp](const Sample* samples, uint32_t count, float* scores) {
+        mlp.predict_range(samples, count, scores);
+    }, config);
+}
+
+evaluation::Report evaluation::evaluate_scores(const std::vector<float>& scores, const std::vector<int>& labels,
+    const Config& config) {
+    if (scores.size() != labels.size()) {
+        throw std::invalid_argument("Scores and labels differ in size");
+    }
+    return evaluate_chunks(scores.size(), config, 8, [&](size_t begin, uint32_t n, float* out, int* out_labels) {
+        std::copy(scores.begin() + begin, scores.begin() + begin + n, out);
+        std::copy(labels.begin() + begin, labels.begin() + begin + n, out_labels);
+    });
+}
+
+void evaluation::print_report(const Report& report, std::ostream& out) {
+    std::ios state(nullptr);
+    state.copyfmt(out);
+    out << std::fixed << std::setprecision(4);
+    out << "Samples: " << report.count << " (" << report.positives << " positive)" << std::endl;
+    out << "Log loss: " << report.log_loss << ", ROC AUC: " << report.roc_auc << ", PR AUC: " << report.pr_auc
+        << ", calibration error: " << report.calibration_error << std::endl;
+    out << "threshold      tp      fp      tn      fn  precision  recall      f1" << std::endl;
+    for (const auto& t : report.thresholds) {
+        out << std::setw(9) << t.threshold << std::setw(8) << t.true_positives << std::setw(8) << t.false_positives
+            << std::setw(8) << t.true_negatives << std::setw(8) << t.false_negatives << std::setw(11) << t.precision()
+            << std::setw(8) << t.recall() << std::setw(8) << t.f1() << std::endl;
+    }
+    out << "calibration bucket   count  mean score  positive rate" << std::endl;
+    for (const auto& b : report.calibration) {
+        out << "  [" << std::setprecision(2) << b.lower << ", " << b.upper << ")" << std::setw(10) << b.count
+            << std::setprecision(4) << std::setw(12) << b.mean_score << std::setw(15) << b.positive_rate << std::endl;
+    }
+    out.copyfmt(state);
+}
@@ -0,0 +1,78 @@
+#pragma once
+// evaluation.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the evaluation engine, it scores a dataset in chunks across the shared thread pool and in the same pass gathers per-task score histograms from which the confusion matrices, ROC and PR AUC, log loss and calibration buckets are all computed.
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace evaluation {
+    using Sample = std::pair<std::vector<float>, int>;
+    using Dataset = std::vector<Sample>;
+    //Fills scores[0, count) for samples[0, count). Runs on several threads at once and must not throw.
+    using Scorer = std::function<void(const Sample* samples, uint32_t count, float* scores)>;
+
+    struct Config {
+        //Histogram bins over [0, 1], the AUCs treat scores in one bin as ties and thresholds snap to bin edges
+        uint32_t bins = 10000;
+        //Confusion matrix thresholds, empty picks 0.05, 0.10, ..., 0.95
+        std::vector<float> thresholds;
+        uint32_t calibration_buckets = 10;
+        //Samples scored per task, results do not depend on the thread count
+        uint32_t chunk = 4096;
+    };
+
+    //score >= threshold is predicted positive
+    struct ThresholdCounts {
+        float threshold = 0.0f;
+        uint64_t true_positives = 0;
+        uint64_t false_positives = 0;
+        uint64_t true_negatives = 0;
+        uint64_t false_negatives = 0;
+
+        double precision() const;
+        double recall() const;
+        double accuracy() const;
+        double f1() const;
+    };
+
+    struct CalibrationBucket {
+        float lower = 0.0f;
+        float upper = 0.0f;
+        uint64_t count = 0;
+        double mean_score = 0.0;
+        double positive_rate = 0.0;
+    };
+
+    //Labels other than 0 count as positive. The AUCs are NaN when the data has only one class.
+    struct Report {
+        uint64_t count = 0;
+        uint64_t positives = 0;
+        double accuracy = 0.0;              //score > 0.5 is positive, like the trainer always used
+        double log_loss = 0.0;              //Scores clamped to [1e-7, 1 - 1e-7]
+        double roc_auc = 0.0;
+        double pr_auc = 0.0;                //Average precision
+        double calibration_error = 0.0;     //Expected calibration error, the count weighted |mean_score - positive_rate|
+        std::vector<ThresholdCounts> thresholds;
+        std::vector<CalibrationBucket> calibration;
+    };
+
+    Report evaluate(const Dataset& data, const Scorer& scorer, const Config& config = Config());
+    //Scores with the MLP's fused predict kernel, throws std::invalid_argument for inputs predict would refuse
+    Report evaluate(const MLP& mlp, const Dataset& data, const Config& config = Config());
+    //Scores computed elsewhere, e.g. by the inference build
+    Report evaluate_scores(const std::vector<float>& scores, const std::vector<int>& labels, const Config& config = Config());
+
+    void print_report(const Report& report, std::ostream& out);
+}
+
+#endif
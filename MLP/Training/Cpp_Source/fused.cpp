@@ -0,0 +1,359 @@
+// fused.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the fused dense kernels and the single kernel small network.
+
+#include "fused.h"
+#include "activate.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t ROW_BLOCK = 4;
+
+    //Dot products of ROWS consecutive weight rows with the input, each row keeps its own vector accumulator
+    template <uint32_t ROWS>
+    inline void dot_rows(const float* input, const float* weights, uint32_t input_size, float* sums) {
+        simd::vfloat acc[ROWS];
+        for (uint32_t r = 0; r < ROWS; ++r) {
+            acc[r] = simd::zero();
+        }
+        uint32_t j = 0;
+        for (; j + simd::WIDTH <= input_size; j += simd::WIDTH) {
+            simd::vfloat x = simd::load(input + j);
+            for (uint32_t r = 0; r < ROWS; ++r) {
+                acc[r] = simd::fmadd(x, simd::load(weights + r * input_size + j), acc[r]);
+            }
+        }
+        for (uint32_t r = 0; r < ROWS; ++r) {
+            float sum = simd::hsum(acc[r]);
+            for (uint32_t k = j; k < input_size; ++k) {
+                sum += input[k] * weights[r * input_size + k];
+            }
+            sums[r] = sum;
+        }
+    }
+
+    //Walks the rows a block at a time, finish gets the biased sums of each block while they are still in registers
+    template <typename Finish>
+    inline void dense_rows(const float* input, const float* weights, const float* biases, float* output,
+        uint32_t input_size, uint32_t output_size, Finish finish) {
+        float sums[ROW_BLOCK];
+        uint32_t i = 0;
+        for (; i + ROW_BLOCK <= output_size; i += ROW_BLOCK) {
+            dot_rows<ROW_BLOCK>(input, weights + i * input_size, input_size, sums);
+            for (uint32_t r = 0; r < ROW_BLOCK; ++r) {
+                sums[r] += biases[i + r];
+            }
+            finish(sums, output + i, ROW_BLOCK);
+        }
+        for (; i < output_size; ++i) {
+            dot_rows<1>(input, weights + i * input_size, input_size, sums);
+            sums[0] += biases[i];
+            finish(sums, output + i, 1);
+        }
+    }
+
+    //Layers too big for one core split their output neurons across the thread pool in whole row blocks
+    template <typename Finish>
+    inline void dense(const float* input, const float* weights, const float* biases, float* output,
+        uint32_t input_size, uint32_t output_size, Finish finish) {
+        parallel::parallel_for(output_size, input_size, ROW_BLOCK, [&](uint32_t begin, uint32_t end) {
+            dense_rows(input, weights + static_cast<size_t>(begin) * input_size, biases + begin, output + begin,
+                input_size, end - begin, finish);
+        });
+    }
+}
+
+void fused::dense_relu(const float* input, const float* weights, const float* biases, float* output,
+    uint32_t input_size, uint32_t output_size, float clip_min, float clip_max) {
+    dense(input, weights, biases, output, input_size, output_size,
+        [clip_min, clip_max](const float* sums, float* out, uint32_t count) {
+            for (uint32_t r = 0; r < count; ++r) {
+                out[r] = std::max(0.0f, std::max(clip_min, std::min(sums[r], clip_max)));
+            }
+        });
+}
+
+void fused::dense_linear(const float* input, const float* weights, const float* biases, float* output,
+    uint32_t input_size, uint32_t output_size) {
+    dense(input, weights, biases, output, input_size, output_size,
+        [](const float* sums, float* out, uint32_t count) {
+            std::copy(sums, sums + count, out);
+        });
+}
+
+void fused::dense_sigmoid(const float* input, const float* weights, const float* biases, float* output,
+    uint32_t input_size, uint32_t output_size) {
+    activate::Mode mode = activate::get_mode();
+    dense(input, weights, biases, output, input_size, output_size,
+        [mode](const float* sums, float* out, uint32_t count) {
+            activate::sigmoid_n(sums, out, count, mode);
+        });
+}
+
+namespace {
+    //Dot products of one packed panel, ROWS is the panel's row tile
+    template <uint32_t ROWS>
+    inline void dot_panel(const float* input, const float* panel, uint32_t cols, float* sums) {
+        const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+        simd::vfloat acc[ROWS];
+        for (uint32_t r = 0; r < ROWS; ++r) {
+            acc[r] = simd::zero();
+        }
+        uint32_t k = 0;
+        for (; (k + 1) * width <= cols; ++k) {
+            simd::vfloat x = simd::load(input + k * width);
+            const float* chunk = panel + k * ROWS * width;
+            for (uint32_t r = 0; r < ROWS; ++r) {
+                acc[r] = simd::fmadd(x, simd::load(chunk + r * width), acc[r]);
+            }
+        }
+        //The last partial chunk is zero padded in the panel but not in the input, so it is done lane by lane
+        const float* chunk = panel + k * ROWS * width;
+        const uint32_t tail = cols - k * width;
+        for (uint32_t r = 0; r < ROWS; ++r) {
+            float sum = simd::hsum(acc[r]);
+            for (uint32_t l = 0; l < tail; ++l) {
+                sum += input[k * width + l] * chunk[r * width + l];
+            }
+            sums[r] = sum;
+        }
+    }
+
+    template <uint32_t ROWS, typename Finish>
+    inline void dense_panels(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output,
+        uint32_t first_panel, uint32_t last_panel, Finish finish) {
+        float sums[ROWS];
+        for (uint32_t p = first_panel; p < last_panel; ++p) {
+            dot_panel<ROWS>(input, weights.panel(p), weights.cols(), sums);
+            uint32_t first = p * ROWS;
+            uint32_t count = std::min(ROWS, weights.rows() - first);
+            for (uint32_t r = 0; r < count; ++r) {
+                sums[r] += biases[first + r];
+            }
+            finish(sums, output + first, count);
+        }
+    }
+
+    template <typename Finish>
+    inline void dense_packed(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output,
+        Finish finish) {
+        parallel::parallel_for(weights.panels(), static_cast<uint64_t>(weights.row_tile()) * weights.cols(), 1,
+            [&](uint32_t first, uint32_t last) {
+                switch (weights.row_tile()) {
+                case 1: dense_panels<1>(input, weights, biases, output, first, last, finish); break;
+                case 2: dense_panels<2>(input, weights, biases, output, first, last, finish); break;
+                case 4: dense_panels<4>(input, weights, biases, output, first, last, finish); break;
+                default: dense_panels<8>(input, weights, biases, output, first, last, finish); break;
+                }
+            });
+    }
+}
+
+void fused::dense_relu(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output,
+    float clip_min, float clip_max) {
+    dense_packed(input, weights, biases, output,
+        [clip_min, clip_max](const float* sums, float* out, uint32_t count) {
+            for (uint32_t r = 0; r < count; ++r) {
+                out[r] = std::max(0.0f, std::max(clip_min, std::min(sums[r], clip_max)));
+            }
+        });
+}
+
+void fused::dense_linear(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output) {
+    dense_packed(input, weights, biases, output,
+        [](const float* sums, float* out, uint32_t count) {
+            std::copy(sums, sums + count, out);
+        });
+}
+
+void fused::dense_sigmoid(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output) {
+    activate::Mode mode = activate::get_mode();
+    dense_packed(input, weights, biases, output,
+        [mode](const float* sums, float* out, uint32_t count) {
+            activate::sigmoid_n(sums, out, count, mode);
+        });
+}
+
+//SmallNetwork implementation
+fused::SmallNetwork::SmallNetwork()
+    : input_size(0), hidden_size(0), output_size(0), panels(0), clip_min(-88.0f), clip_max(88.0f) {}
+
+void fused::SmallNetwork::pack(const float* new_hidden_weights, const float* new_hidden_biases,
+    const float* new_output_weights, const float* new_output_biases, const float* new_skip_weights,
+    uint32_t new_input_size, uint32_t new_hidden_size, uint32_t new_output_size,
+    float new_clip_min, float new_clip_max) {
+    if (new_input_size == 0 || new_hidden_size == 0 || new_output_size == 0) {
+        throw std::invalid_argument("Layer sizes must be positive");
+    }
+    if (new_output_size > MAX_OUTPUTS) {
+        throw std::invalid_argument("SmallNetwork supports at most 4 outputs");
+    }
+    input_size = new_input_size;
+    hidden_size = new_hidden_size;
+    output_size = new_output_size;
+    clip_min = new_clip_min;
+    clip_max = new_clip_max;
+    panels = static_cast<uint32_t>((hidden_size + simd::WIDTH - 1) / simd::WIDTH);
+
+    //Padding lanes get zero weights and biases, relu(0) = 0 so they add nothing to the outputs
+    const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+    hidden_panels.assign(static_cast<size_t>(panels) * input_size * width, 0.0f);
+    hidden_biases.assign(static_cast<size_t>(panels) * width, 0.0f);
+    output_panels.assign(static_cast<size_t>(panels) * output_size * width, 0.0f);
+    for (uint32_t h = 0; h < hidden_size; ++h) {
+        uint32_t panel = h / width, lane = h % width;
+        for (uint32_t j = 0; j < input_size; ++j) {
+            hidden_panels[(panel * input_size + j) * width + lane] = new_hidden_weights[h * input_size + j];
+        }
+        hidden_biases[panel * width + lane] = new_hidden_biases[h];
+        for (uint32_t o = 0; o < output_size; ++o) {
+            output_panels[(panel * output_size + o) * width + lane] = new_output_weights[o * hidden_size + h];
+        }
+    }
+    output_biases.assign(new_output_biases, new_output_biases + output_size);
+    hidden_rows.assign(new_hidden_weights, new_hidden_weights + static_cast<size_t>(hidden_size) * input_size);
+    hidden_bias_rows.assign(new_hidden_biases, new_hidden_biases + hidden_size);
+    output_rows.assign(new_output_weights, new_output_weights + static_cast<size_t>(output_size) * hidden_size);
+    if (new_skip_weights != nullptr) {
+        skip_weights.assign(new_skip_weights, new_skip_weights + output_size * input_size);
+    }
+    else {
+        skip_weights.clear();
+    }
+}
+
+void fused::SmallNetwork::forward(const float* input, float* output) const {
+    if (panels == 0) {
+        throw std::runtime_error("SmallNetwork used before pack");
+    }
+    const size_t width = simd::WIDTH;
+    simd::vfloat acc[MAX_OUTPUTS];
+    for (uint32_t o = 0; o < output_size; ++o) {
+        acc[o] = simd::zero();
+    }
+    const simd::vfloat lo = simd::splat(clip_min);
+    const simd::vfloat hi = simd::splat(clip_max);
+    const simd::vfloat zero = simd::zero();
+    for (uint32_t p = 0; p < panels; ++p) {
+        const float* w = hidden_panels.data() + p * input_size * width;
+        //Two accumulators so the chain of dependent multiply-adds is half as long
+        simd::vfloat h = simd::load(hidden_biases.data() + p * width);
+        simd::vfloat h_odd = zero;
+        uint32_t j = 0;
+        for (; j + 2 <= input_size; j += 2) {
+            h = simd::fmadd(simd::splat(input[j]), simd::load(w + j * width), h);
+            h_odd = simd::fmadd(simd::splat(input[j + 1]), simd::load(w + (j + 1) * width), h_odd);
+        }
+        if (j < input_size) {
+            h = simd::fmadd(simd::splat(input[j]), simd::load(w + j * width), h);
+        }
+        h = simd::add(h, h_odd);
+        h = simd::max(simd::min(simd::max(h, lo), hi), zero);
+        const float* wo = output_panels.data() + p * output_size * width;
+        for (uint32_t o = 0; o < output_size; ++o) {
+            acc[o] = simd::fmadd(h, simd::load(wo + o * width), acc[o]);
+        }
+    }
+
+    float sums[MAX_OUTPUTS];
+    if (!skip_weights.empty()) {
+        for (uint32_t o = 0; o < output_size; ++o) {
+            dot_rows<1>(input, skip_weights.data() + o * input_size, input_size, sums + o);
+            sums[o] += simd::hsum(acc[o]) + output_biases[o];
+        }
+    }
+    else {
+        for (uint32_t o = 0; o < output_size; ++o) {
+            sums[o] = simd::hsum(acc[o]) + output_biases[o];
+        }
+    }
+    activate::sigmoid_n(sums, output, output_size);
+}
+
+void fused::SmallNetwork::forward_hidden(const float* pre_activations, const float* skip_sums, float* output) const {
+    if (panels == 0) {
+        throw std::runtime_error("SmallNetwork used before pack");
+    }
+    const size_t width = simd::WIDTH;
+    simd::vfloat acc[MAX_OUTPUTS];
+    for (uint32_t o = 0; o < output_size; ++o) {
+        acc[o] = simd::zero();
+    }
+    const simd::vfloat lo = simd::splat(clip_min);
+    const simd::vfloat hi = simd::splat(clip_max);
+    const simd::vfloat zero = simd::zero();
+    for (uint32_t p = 0; p < panels; ++p) {
+        simd::vfloat h = simd::load(pre_activations + p * width);
+        h = simd::max(simd::min(simd::max(h, lo), hi), zero);
+        const float* wo = output_panels.data() + p * output_size * width;
+        for (uint32_t o = 0; o < output_size; ++o) {
+            acc[o] = simd::fmadd(h, simd::load(wo + o * width), acc[o]);
+        }
+    }
+
+    float sums[MAX_OUTPUTS];
+    for (uint32_t o = 0; o < output_size; ++o) {
+        sums[o] = simd::hsum(acc[o]) + output_biases[o] + (skip_sums != nullptr ? skip_sums[o] : 0.0f);
+    }
+    activate::sigmoid_n(sums, output, output_size);
+}
+
+uint32_t fused::SmallNetwork::get_padded_hidden_size() const {
+    return panels * static_cast<uint32_t>(simd::WIDTH);
+}
+
+//Samples across the lanes, so every weight is a broadcast scalar and nothing needs a horizontal sum. Hidden units
+//alternate between two accumulators per output to keep the dependent multiply-add chains short.
+void fused::SmallNetwork::forward_batch(const float* inputs, size_t stride, uint32_t count, float* outputs) const {
+    if (panels == 0) {
+        throw std::runtime_error("SmallNetwork used before pack");
+    }
+    const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+    const uint32_t vector_count = count / width * width;
+    const simd::vfloat lo = simd::splat(clip_min);
+    const simd::vfloat hi = simd::splat(clip_max);
+    const simd::vfloat zero = simd::zero();
+    for (uint32_t i = 0; i < vector_count; i += width) {
+        simd::vfloat acc[MAX_OUTPUTS][2];
+        for (uint32_t o = 0; o < output_size; ++o) {
+            acc[o][0] = simd::splat(output_biases[o]);
+            acc[o][1] = zero;
+            for (uint32_t j = 0; j < input_size && !skip_weights.empty(); ++j) {
+                acc[o][0] = simd::fmadd(simd::splat(skip_weights[o * input_size + j]), simd::load(inputs + j * stride + i), acc[o][0]);
+            }
+        }
+        for (uint32_t h = 0; h < hidden_size; ++h) {
+            const float* w = hidden_rows.data() + static_cast<size_t>(h) * input_size;
+            simd::vfloat z = simd::splat(hidden_bias_rows[h]);
+            for (uint32_t j = 0; j < input_size; ++j) {
+                z = simd::fmadd(simd::splat(w[j]), simd::load(inputs + j * stride + i), z);
+            }
+            z = simd::max(simd::min(simd::max(z, lo), hi), zero);
+            for (uint32_t o = 0; o < output_size; ++o) {
+                acc[o][h & 1] = simd::fmadd(simd::splat(output_rows[static_cast<size_t>(o) * hidden_size + h]), z, acc[o][h & 1]);
+            }
+        }
+        for (uint32_t o = 0; o < output_size; ++o) {
+            simd::store(outputs + o * stride + i, simd::add(acc[o][0], acc[o][1]));
+        }
+    }
+    for (uint32_t o = 0; o < output_size && vector_count > 0; ++o) {
+        activate::sigmoid_n(outputs + o * stride, outputs + o * stride, vector_count);
+    }
+    //The last few samples one at a time
+    std::vector<float> sample(vector_count < count ? input_size : 0);
+    float result[MAX_OUTPUTS];
+    for (uint32_t i = vector_count; i < count; ++i) {
+        for (uint32_t j = 0; j < input_size; ++j) {
+            sample[j] = inputs[j * stride + i];
+        }
+        forward(sample.data(), result);
+        for (uint32_t o = 0; o < output_size; ++o) {
+            outputs[o * stride + i] = result[o];
+        }
+    }
+}
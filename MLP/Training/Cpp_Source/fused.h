@@ -0,0 +1,85 @@
+#pragma once
+// fused.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the fused dense kernels, the matmul, bias add, clip and activation of a layer run in one pass with the sums kept in registers, and a single kernel network for small one hidden layer topologies.
+
+#ifndef FUSED_H
+#define FUSED_H
+
+#include "packed.h"
+#include <cstdint>
+#include <vector>
+
+namespace fused {
+    //output = relu(clip(W * input + b, clip_min, clip_max)), weights are row-major [output_size][input_size].
+    //output must not overlap input.
+    void dense_relu(const float* input, const float* weights, const float* biases, float* output,
+        uint32_t input_size, uint32_t output_size, float clip_min, float clip_max);
+
+    //output = W * input + b
+    void dense_linear(const float* input, const float* weights, const float* biases, float* output,
+        uint32_t input_size, uint32_t output_size);
+
+    //output = sigmoid(W * input + b), the sigmoid follows activate::get_mode()
+    void dense_sigmoid(const float* input, const float* weights, const float* biases, float* output,
+        uint32_t input_size, uint32_t output_size);
+
+    //The same three kernels on a matrix prepacked into panels, input holds weights.cols() values.
+    //Each panel is streamed once with one accumulator per row of the tile.
+    void dense_relu(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output,
+        float clip_min, float clip_max);
+    void dense_linear(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output);
+    void dense_sigmoid(const float* input, const packed::PackedMatrix& weights, const float* biases, float* output);
+
+    //input -> relu(clip(dense)) hidden layer -> sigmoid output layer as one kernel, the hidden activations are
+    //computed a vector at a time and consumed by the output sums right away so they never go to memory.
+    //An optional skip matrix adds input values straight into the output sums (the MLP class feeds part of
+    //its padded input past the hidden layer, see MLP::predict).
+    class SmallNetwork {
+    public:
+        static constexpr uint32_t MAX_OUTPUTS = 4;
+
+        SmallNetwork();
+
+        //Copies the row-major layer parameters into vector-width panels, skip_weights is [output_size][input_size] or nullptr
+        void pack(const float* hidden_weights, const float* hidden_biases,
+            const float* output_weights, const float* output_biases, const float* skip_weights,
+            uint32_t input_size, uint32_t hidden_size, uint32_t output_size,
+            float clip_min = -88.0f, float clip_max = 88.0f);
+
+        void forward(const float* input, float* output) const;
+        //forward for count samples at once, one sample per vector lane. inputs is feature major, feature j of sample i
+        //at inputs[j * stride + i], and outputs is written the same way, output o of sample i at outputs[o * stride + i].
+        void forward_batch(const float* inputs, size_t stride, uint32_t count, float* outputs) const;
+
+        //forward for callers that work out the input's linear parts their own way: pre_activations holds the hidden layer's
+        //get_padded_hidden_size() values (biases included, zero past get_hidden_size()) and skip_sums the skip connection's
+        //one value per output, or nullptr to leave the skip out.
+        void forward_hidden(const float* pre_activations, const float* skip_sums, float* output) const;
+
+        uint32_t get_input_size() const { return input_size; }
+        uint32_t get_hidden_size() const { return hidden_size; }
+        uint32_t get_output_size() const { return output_size; }
+        //Hidden size rounded up to whole vectors
+        uint32_t get_padded_hidden_size() const;
+
+    private:
+        uint32_t input_size;
+        uint32_t hidden_size;
+        uint32_t output_size;
+        uint32_t panels;
+        float clip_min;
+        float clip_max;
+        std::vector<float> hidden_panels;   //[panel][input][lane]
+        std::vector<float> hidden_biases;   //[panel][lane]
+        std::vector<float> output_panels;   //[panel][output][lane]
+        std::vector<float> output_biases;
+        std::vector<float> skip_weights;    //[output][input], empty without a skip
+        std::vector<float> hidden_rows;     //[hidden][input], row-major copies for forward_batch
+        std::vector<float> hidden_bias_rows;
+        std::vector<float> output_rows;     //[output][hidden]
+    };
+}
+
+#endif
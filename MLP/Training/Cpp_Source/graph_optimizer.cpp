@@ -0,0 +1,368 @@
+// graph_optimizer.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the lowering of the MLP to a layer graph and the optimization passes that turn it into a compact model.
+
+#include "graph_optimizer.h"
+#include "activate.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr int64_t ZERO_SLOT = -1;
+
+    float apply_activation(const compact::Stage& stage, float x) {
+        switch (stage.activation) {
+        case compact::Activation::ClipRelu: return activate::relu(activate::clip(x, stage.clip_min, stage.clip_max));
+        case compact::Activation::Sigmoid: return activate::sigmoid(x);
+        default: return x;
+        }
+    }
+
+    //Erases the weight columns whose source matches, fold gets (source, column index) first so it can move the contribution into the biases
+    template <typename Match, typename Fold>
+    void erase_sources(compact::Stage& stage, Match match, Fold fold) {
+        const size_t old_count = stage.sources.size();
+        std::vector<uint32_t> kept;
+        for (size_t j = 0; j < old_count; ++j) {
+            if (match(stage.sources[j], j)) {
+                fold(stage.sources[j], j);
+            }
+            else {
+                kept.push_back(static_cast<uint32_t>(j));
+            }
+        }
+        if (kept.size() == old_count) {
+            return;
+        }
+        std::vector<uint32_t> sources;
+        std::vector<float> weights;
+        for (uint32_t i = 0; i < stage.outputs(); ++i) {
+            for (uint32_t j : kept) {
+                weights.push_back(stage.weights[i * old_count + j]);
+            }
+        }
+        for (uint32_t j : kept) {
+            sources.push_back(stage.sources[j]);
+        }
+        stage.sources = sources;
+        stage.weights = weights;
+    }
+
+    //Which values some stage reads, the score (last value) always counts as used
+    std::vector<bool> used_values(const compact::Model& model) {
+        std::vector<bool> used(model.value_count(), false);
+        for (const compact::Stage& stage : model.stages) {
+            for (uint32_t source : stage.sources) {
+                used[source] = true;
+            }
+        }
+        used.back() = true;
+        return used;
+    }
+
+    //Drops every stage output nobody reads and renumbers the remaining values, empty stages disappear
+    uint32_t drop_unused(compact::Model& model) {
+        std::vector<bool> used = used_values(model);
+        std::vector<uint32_t> remap(used.size(), 0);
+        uint32_t next = model.input_size;
+        for (uint32_t v = 0; v < model.input_size; ++v) {
+            remap[v] = v;
+        }
+        uint32_t dropped = 0;
+        uint32_t value = model.input_size;
+        std::vector<compact::Stage> stages;
+        for (const compact::Stage& stage : model.stages) {
+            compact::Stage kept = stage;
+            kept.weights.clear();
+            kept.biases.clear();
+            const size_t columns = stage.sources.size();
+            for (uint32_t i = 0; i < stage.outputs(); ++i, ++value) {
+                if (!used[value]) {
+                    ++dropped;
+                    continue;
+                }
+                remap[value] = next++;
+                kept.weights.insert(kept.weights.end(), stage.weights.begin() + i * columns,
+                    stage.weights.begin() + (i + 1) * columns);
+                kept.biases.push_back(stage.biases[i]);
+            }
+            for (uint32_t& source : kept.sources) {
+                source = remap[source];
+            }
+            if (kept.outputs() > 0) {
+                stages.push_back(kept);
+            }
+        }
+        model.stages = stages;
+        return dropped;
+    }
+}
+
+graph::LayerGraph graph::lower_mlp(const MLP& mlp) {
+    LayerGraph graph;
+    const Layer& input_layer = mlp.get_input_layer();
+    const Layer& hidden_layer = mlp.get_hidden_layer1();
+    const Layer& output_layer = mlp.get_output_layer();
+    graph.input_size = input_layer.get_input_size();
+    graph.threshold = 0.5f;
+
+    //InputLayer copies its inputs into the zero padded intermediate buffer
+    GraphLayer input;
+    input.name = "input_layer";
+    input.kind = LayerKind::Identity;
+    input.input_size = input_layer.get_input_size();
+    input.output_size = input_layer.get_output_size();
+    graph.layers.push_back(input);
+
+    //MLP::forward runs the hidden layer in place on that buffer
+    GraphLayer hidden;
+    hidden.name = "hidden_layer1";
+    hidden.input_size = hidden_layer.get_input_size();
+    hidden.output_size = hidden_layer.get_output_size();
+    hidden.weights = hidden_layer.get_weights().to_vector();
+    hidden.biases = hidden_layer.get_biases().to_vector();
+    hidden.activation = compact::Activation::ClipRelu;
+    hidden.in_place = true;
+    graph.layers.push_back(hidden);
+
+    GraphLayer output;
+    output.name = "output_layer";
+    output.input_size = output_layer.get_input_size();
+    output.output_size = output_layer.get_output_size();
+    output.weights = output_layer.get_weights().to_vector();
+    output.biases = output_layer.get_biases().to_vector();
+    output.activation = compact::Activation::Sigmoid;
+    graph.layers.push_back(output);
+    return graph;
+}
+
+float graph::evaluate_graph(const LayerGraph& graph, const std::vector<float>& input) {
+    std::vector<float> buffer(graph.input_size, 0.0f);
+    std::copy(input.begin(), input.begin() + std::min<size_t>(input.size(), graph.input_size), buffer.begin());
+    for (const GraphLayer& layer : graph.layers) {
+        buffer.resize(std::max<size_t>(buffer.size(), layer.input_size), 0.0f);
+        if (layer.kind == LayerKind::Identity) {
+            buffer.resize(layer.output_size, 0.0f);
+            std::fill(buffer.begin() + std::min(layer.input_size, layer.output_size), buffer.end(), 0.0f);
+            continue;
+        }
+        compact::Stage activation;
+        activation.activation = layer.activation;
+        activation.clip_min = layer.clip_min;
+        activation.clip_max = layer.clip_max;
+        std::vector<float> result(layer.output_size);
+        for (uint32_t i = 0; i < layer.output_size; ++i) {
+            float sum = layer.biases[i];
+            for (uint32_t j = 0; j < layer.input_size; ++j) {
+                sum += layer.weights[i * layer.input_size + j] * buffer[j];
+            }
+            result[i] = apply_activation(activation, sum);
+        }
+        if (layer.in_place) {
+            buffer.resize(layer.input_size);
+            std::copy(result.begin(), result.end(), buffer.begin());
+        }
+        else {
+            buffer = result;
+        }
+    }
+    return buffer[0];
+}
+
+compact::Model graph::eliminate_padding(const LayerGraph& graph, OptimizeReport& report) {
+    if (graph.layers.empty() || graph.layers.back().kind != LayerKind::Dense || graph.layers.back().output_size != 1) {
+        throw std::invalid_argument("Graph must end in a dense layer with a single output");
+    }
+    compact::Model model;
+    model.input_size = graph.input_size;
+    model.threshold = graph.threshold;
+
+    //Each slot of the working buffer holds the value it carries, or ZERO_SLOT when it is structurally zero
+    std::vector<int64_t> slots(graph.input_size);
+    for (uint32_t i = 0; i < graph.input_size; ++i) {
+        slots[i] = i;
+    }
+    uint32_t next_value = graph.input_size;
+    for (const GraphLayer& layer : graph.layers) {
+        if (layer.kind == LayerKind::Identity) {
+            slots.resize(layer.output_size, ZERO_SLOT);
+            std::fill(slots.begin() + std::min(layer.input_size, layer.output_size), slots.end(), ZERO_SLOT);
+            ++report.identity_layers_removed;
+            continue;
+        }
+        if (layer.weights.size() != static_cast<size_t>(layer.input_size) * layer.output_size || layer.biases.size() != layer.output_size) {
+            throw std::invalid_argument("Weights size mismatch in layer " + layer.name);
+        }
+        report.macs_before += static_cast<uint64_t>(layer.input_size) * layer.output_size;
+        slots.resize(std::max<size_t>(slots.size(), layer.input_size), ZERO_SLOT);
+
+        //Columns against zero slots contribute nothing, columns reading the same value are merged
+        compact::Stage stage;
+        stage.activation = layer.activation;
+        stage.clip_min = layer.clip_min;
+        stage.clip_max = layer.clip_max;
+        stage.biases = layer.biases;
+        std::map<int64_t, uint32_t> column_of;
+        std::vector<std::vector<uint32_t>> columns_of_source;
+        for (uint32_t j = 0; j < layer.input_size; ++j) {
+            if (slots[j] == ZERO_SLOT) {
+                report.padding_macs_removed += layer.output_size;
+                continue;
+            }
+            auto found = column_of.find(slots[j]);
+            if (found == column_of.end()) {
+                found = column_of.emplace(slots[j], static_cast<uint32_t>(stage.sources.size())).first;
+                stage.sources.push_back(static_cast<uint32_t>(slots[j]));
+                columns_of_source.emplace_back();
+            }
+            columns_of_source[found->second].push_back(j);
+        }
+        const size_t count = stage.sources.size();
+        stage.weights.assign(count * layer.output_size, 0.0f);
+        for (uint32_t i = 0; i < layer.output_size; ++i) {
+            for (size_t c = 0; c < count; ++c) {
+                for (uint32_t j : columns_of_source[c]) {
+                    stage.weights[i * count + c] += layer.weights[i * layer.input_size + j];
+                }
+            }
+        }
+
+        std::vector<int64_t> outputs(layer.output_size);
+        for (uint32_t i = 0; i < layer.output_size; ++i) {
+            outputs[i] = next_value++;
+        }
+        if (layer.in_place) {
+            slots.resize(layer.input_size);
+            std::copy(outputs.begin(), outputs.end(), slots.begin());
+        }
+        else {
+            slots = outputs;
+        }
+        model.stages.push_back(stage);
+    }
+    //Only the score is read in the end, anything else the last layers computed goes away
+    drop_unused(model);
+    model.validate();
+    return model;
+}
+
+void graph::fold_constants(compact::Model& model, OptimizeReport& report) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        //Zero weight columns first, they may leave a neuron without inputs
+        for (compact::Stage& stage : model.stages) {
+            const size_t columns = stage.sources.size();
+            erase_sources(stage, [&](uint32_t, size_t j) {
+                for (uint32_t i = 0; i < stage.outputs(); ++i) {
+                    if (stage.weights[i * columns + j] != 0.0f) return false;
+                }
+                return true;
+            }, [](uint32_t, size_t) {});
+        }
+
+        std::map<uint32_t, float> constants;
+        uint32_t value = model.input_size;
+        const uint32_t score = model.value_count() - 1;
+        for (compact::Stage& stage : model.stages) {
+            const size_t columns = stage.sources.size();
+            erase_sources(stage, [&](uint32_t source, size_t) { return constants.count(source) > 0; },
+                [&](uint32_t source, size_t j) {
+                    for (uint32_t i = 0; i < stage.outputs(); ++i) {
+                        stage.biases[i] += stage.weights[i * columns + j] * constants[source];
+                    }
+                    changed = true;
+                });
+            //A neuron whose remaining weights are all zero only depends on its bias
+            const size_t remaining = stage.sources.size();
+            for (uint32_t i = 0; i < stage.outputs(); ++i, ++value) {
+                bool constant = value != score;
+                for (size_t j = 0; j < remaining && constant; ++j) {
+                    constant = stage.weights[i * remaining + j] == 0.0f;
+                }
+                if (constant) {
+                    constants[value] = apply_activation(stage, stage.biases[i]);
+                }
+            }
+        }
+        report.constants_folded += drop_unused(model);
+    }
+}
+
+void graph::remove_dead_neurons(compact::Model& model, const std::vector<std::pair<std::vector<float>, int>>& calibration,
+    OptimizeReport& report) {
+    if (calibration.empty()) {
+        return;
+    }
+    //A clipped ReLU output is never negative, so "never above zero" means it was exactly zero on every sample
+    std::vector<bool> active(model.value_count(), false);
+    compact::Workspace workspace;
+    for (const auto& sample : calibration) {
+        model.score(sample.first, workspace);
+        const std::vector<float>& values = workspace.values;
+        for (size_t v = 0; v < values.size(); ++v) {
+            if (values[v] != 0.0f) active[v] = true;
+        }
+    }
+    std::vector<bool> dead(model.value_count(), false);
+    uint32_t value = model.input_size;
+    for (const compact::Stage& stage : model.stages) {
+        for (uint32_t i = 0; i < stage.outputs(); ++i, ++value) {
+            dead[value] = stage.activation == compact::Activation::ClipRelu && !active[value];
+        }
+    }
+    dead.back() = false;
+    for (compact::Stage& stage : model.stages) {
+        erase_sources(stage, [&](uint32_t source, size_t) { return dead[source]; }, [](uint32_t, size_t) {});
+    }
+    report.dead_neurons_removed += drop_unused(model);
+}
+
+void graph::threshold_to_logit(compact::Model& model, OptimizeReport& report) {
+    compact::Stage& last = model.stages.back();
+    if (last.activation != compact::Activation::Sigmoid || model.threshold <= 0.0f || model.threshold >= 1.0f) {
+        return;
+    }
+    //sigmoid is monotonic, so sigmoid(z) > t exactly when z > log(t / (1 - t))
+    last.activation = compact::Activation::Linear;
+    model.threshold = std::log(model.threshold / (1.0f - model.threshold));
+    report.logit_threshold = true;
+}
+
+compact::Model graph::optimize(const LayerGraph& graph, const std::vector<std::pair<std::vector<float>, int>>& calibration,
+    OptimizeReport& report) {
+    report = OptimizeReport();
+    compact::Model model = eliminate_padding(graph, report);
+    fold_constants(model, report);
+    remove_dead_neurons(model, calibration, report);
+    fold_constants(model, report);
+    threshold_to_logit(model, report);
+    model.validate();
+    report.macs_after = model.mac_count();
+
+    for (const auto& sample : calibration) {
+        bool reference = evaluate_graph(graph, sample.first) > graph.threshold;
+        if (model.classify(sample.first) != reference) {
+            ++report.calibration_mismatches;
+        }
+        ++report.calibration_samples;
+    }
+    return model;
+}
+
+std::string graph::format_report(const OptimizeReport& report) {
+    std::ostringstream out;
+    out << "Multiply-adds per sample: " << report.macs_before << " -> " << report.macs_after << "\n"
+        << "Identity layers removed: " << report.identity_layers_removed
+        << ", padding multiply-adds removed: " << report.padding_macs_removed << "\n"
+        << "Constant neurons folded: " << report.constants_folded
+        << ", dead neurons removed: " << report.dead_neurons_removed << "\n"
+        << "Final sigmoid replaced by logit threshold: " << (report.logit_threshold ? "yes" : "no") << "\n"
+        << "Calibration samples: " << report.calibration_samples
+        << ", classification mismatches: " << report.calibration_mismatches;
+    return out.str();
+}
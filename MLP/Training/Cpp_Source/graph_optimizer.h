@@ -0,0 +1,72 @@
+#pragma once
+// graph_optimizer.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the offline graph optimizer, a trained network is lowered to a layer graph that mirrors how it is executed, then passes strip the padding and identity layers, fold constants, drop neurons that never activate on calibration data and turn the final sigmoid into a logit threshold. The result is a compact::Model.
+
+#ifndef GRAPH_OPTIMIZER_H
+#define GRAPH_OPTIMIZER_H
+
+#include "compact_model.h"
+#include "MLP.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graph {
+    enum class LayerKind : uint8_t {
+        Identity = 0,   //Copies its input, zero padded or truncated to output_size
+        Dense
+    };
+
+    struct GraphLayer {
+        std::string name;
+        LayerKind kind = LayerKind::Dense;
+        uint32_t input_size = 0;
+        uint32_t output_size = 0;
+        std::vector<float> weights;     //Row-major [output_size][input_size], empty for identity layers
+        std::vector<float> biases;
+        compact::Activation activation = compact::Activation::Linear;
+        float clip_min = -88.0f;
+        float clip_max = 88.0f;
+        bool in_place = false;          //Output overwrites the first output_size slots of the input buffer, the other slots pass through
+    };
+
+    //The features are zero padded to the first layer's input size, the score is the first slot of the last layer's output
+    struct LayerGraph {
+        uint32_t input_size = 0;
+        std::vector<GraphLayer> layers;
+        float threshold = 0.5f;
+    };
+
+    //Describes exactly what MLP::forward computes
+    LayerGraph lower_mlp(const MLP& mlp);
+    //Slot by slot reference evaluation of the unoptimized graph
+    float evaluate_graph(const LayerGraph& graph, const std::vector<float>& input);
+
+    struct OptimizeReport {
+        uint64_t macs_before = 0;
+        uint64_t macs_after = 0;
+        uint32_t identity_layers_removed = 0;
+        uint64_t padding_macs_removed = 0;  //Multiply-adds against structurally zero slots
+        uint32_t constants_folded = 0;      //Neurons whose value does not depend on the input
+        uint32_t dead_neurons_removed = 0;  //ReLU neurons that stayed at zero on every calibration sample
+        bool logit_threshold = false;
+        uint64_t calibration_samples = 0;
+        uint64_t calibration_mismatches = 0; //Samples the optimized model classifies differently from the graph
+    };
+
+    //The individual passes, optimize runs them in this order
+    compact::Model eliminate_padding(const LayerGraph& graph, OptimizeReport& report);
+    void fold_constants(compact::Model& model, OptimizeReport& report);
+    void remove_dead_neurons(compact::Model& model, const std::vector<std::pair<std::vector<float>, int>>& calibration,
+        OptimizeReport& report);
+    void threshold_to_logit(compact::Model& model, OptimizeReport& report);
+
+    compact::Model optimize(const LayerGraph& graph, const std::vector<std::pair<std::vector<float>, int>>& calibration,
+        OptimizeReport& report);
+    std::string format_report(const OptimizeReport& report);
+}
+
+#endif
@@ -0,0 +1,97 @@
+// incremental.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the incremental predictor, the cached input-side sums, their rank-1 corrections, the periodic full recompute and the fused network's remaining layers on top.
+
+#include "incremental.h"
+#include "MLP.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    //y += a * x over whole vectors
+    inline void axpy(float a, const float* x, float* y, uint32_t n) {
+        const simd::vfloat av = simd::splat(a);
+        for (uint32_t k = 0; k < n; k += static_cast<uint32_t>(simd::WIDTH)) {
+            simd::store(y + k, simd::fmadd(av, simd::load(x + k), simd::load(y + k)));
+        }
+    }
+}
+
+namespace incremental {
+    DeltaPredictor::DeltaPredictor(const MLP& mlp, uint32_t resync_interval)
+        : resync_interval(resync_interval), since_resync(0), features(), score(0.0f), corrections(0), resyncs(0) {
+        mlp.pack_network(INPUT_SIZE, network);
+        //The sums are laid out the way forward_hidden reads them, padded hidden pre-activations then the skip sums
+        const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+        padded_hidden = network.get_padded_hidden_size();
+        stride = padded_hidden + (network.get_output_size() + width - 1) / width * width;
+        columns = mlp.input_columns(INPUT_SIZE, padded_hidden, stride);
+        Span<const float> hidden_biases = mlp.get_hidden_layer1().get_biases();
+        biases.assign(stride, 0.0f);
+        std::copy(hidden_biases.begin(), hidden_biases.begin() + network.get_hidden_size(), biases.begin());
+        sums = biases;
+        finish(false);
+    }
+
+    void DeltaPredictor::apply(uint32_t feature, float value) {
+        const float delta = value - features[feature];
+        features[feature] = value;
+        //A correction from or to infinity or NaN would leave NaN in the sums for good, start over instead
+        if (!std::isfinite(delta)) {
+            resync();
+            return;
+        }
+        axpy(delta, columns.data() + static_cast<size_t>(feature) * stride, sums.data(), stride);
+        ++corrections;
+    }
+
+    float DeltaPredictor::finish(bool changed) {
+        if (changed && resync_interval != 0 && ++since_resync >= resync_interval) {
+            resync();
+        }
+        float result[fused::SmallNetwork::MAX_OUTPUTS];
+        network.forward_hidden(sums.data(), sums.data() + padded_hidden, result);
+        score = result[0];
+        return score;
+    }
+
+    float DeltaPredictor::update(const std::vector<float>& input) {
+        if (input.empty() || input.size() > 10) {
+            throw std::invalid_argument("Input size must be between 1 and 10");
+        }
+        bool changed = false;
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+            const float value = j < input.size() ? input[j] : 0.0f;
+            if (value != features[j]) {
+                apply(j, value);
+                changed = true;
+            }
+        }
+        return changed ? finish(true) : score;
+    }
+
+    float DeltaPredictor::update(uint32_t feature, float value) {
+        if (feature >= INPUT_SIZE) {
+            throw std::invalid_argument("Feature index must be below 9");
+        }
+        if (value == features[feature]) {
+            return score;
+        }
+        apply(feature, value);
+        return finish(true);
+    }
+
+    void DeltaPredictor::resync() {
+        std::copy(biases.begin(), biases.end(), sums.begin());
+        for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+            if (features[j] != 0.0f) {
+                axpy(features[j], columns.data() + static_cast<size_t>(j) * stride, sums.data(), stride);
+            }
+        }
+        since_resync = 0;
+        ++resyncs;
+    }
+}
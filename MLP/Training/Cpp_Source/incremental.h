@@ -0,0 +1,57 @@
+#pragma once
+// incremental.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the incremental (delta) predictor for slowly changing inputs such as sensor readings. It keeps the network's input-side sums from the last reading and corrects them with one weight column times the change for every feature that moved, instead of recomputing the input products, and recomputes them in full every so often so rounding cannot pile up.
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "fused.h"
+#include "layers.h"
+#include <cstdint>
+#include <vector>
+
+class MLP;
+
+namespace incremental {
+    class DeltaPredictor {
+    public:
+        //Snapshot of the MLP's current weights, starting from all zero features. resync_interval is how many corrected
+        //readings pass between full recomputes, 0 never recomputes on its own.
+        explicit DeltaPredictor(const MLP& mlp, uint32_t resync_interval = 1024);
+
+        //Scores the next reading, same input rules and result as MLP::predict (1 to 10 values, missing features are 0,
+        //the 10th is ignored). Only the features that differ from the last reading cost anything.
+        float update(const std::vector<float>& input);
+        //Changes one feature and scores, for callers that already know what changed
+        float update(uint32_t feature, float value);
+        //Recomputes the sums from the current features
+        void resync();
+
+        //Score of the current features
+        float get_score() const { return score; }
+        const float* get_features() const { return features; }
+        uint64_t get_corrections() const { return corrections; }
+        uint64_t get_resyncs() const { return resyncs; }
+
+    private:
+        fused::SmallNetwork network;
+        uint32_t padded_hidden;         //Skip sums start here in sums and every column
+        uint32_t stride;
+        uint32_t resync_interval;
+        uint32_t since_resync;
+        std::vector<float> columns;     //[feature][stride], see MLP::input_columns
+        std::vector<float> biases;      //[stride], the hidden biases, zero for the skip sums
+        std::vector<float> sums;        //[stride], hidden pre-activations then skip sums for the current features
+        float features[INPUT_SIZE];
+        float score;
+        uint64_t corrections;           //Rank-1 corrections applied, one per changed feature
+        uint64_t resyncs;
+
+        void apply(uint32_t feature, float value);
+        float finish(bool changed);
+    };
+}
+
+#endif
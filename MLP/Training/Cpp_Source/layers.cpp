@@ -4,7 +4,8 @@
 // Purpose: This is the layer implementation file in which each layer of the network is defined, and their respective propagation and activation is applied.
 
 #include "layers.h"
-#include "activate.h"
+#include "fused.h"
+#include "threadpool.h"
 #include <random>
 #include <algorithm>
 #include <iostream>
@@ -23,20 +24,36 @@ void initialize_weights(std::vector<float>& weights, uint32_t input_size, uint32
 }
 
 //Layer class implementation
-Layer::Layer(uint32_t input_size, uint32_t output_size)
-    : input_size(input_size), output_size(output_size) {
+Layer::Layer(uint32_t input_size, uint32_t output_size, Span<float> weights_view, Span<float> biases_view)
+    : input_size(input_size), output_size(output_size), weights(weights_view), biases(biases_view) {
 
     //Layer positive check
     if (input_size == 0 || output_size == 0) {
         throw std::invalid_argument("Layer sizes must be positive");
     }
-    weights.resize(input_size * output_size);
-    biases.resize(output_size);
+    if (weights.empty() && biases.empty()) {
+        own_parameters = ParameterArena(static_cast<size_t>(input_size) * output_size + output_size);
+        weights = own_parameters.view(0, static_cast<size_t>(input_size) * output_size);
+        biases = own_parameters.view(weights.size(), output_size);
+    }
+    if (weights.size() != static_cast<size_t>(input_size) * output_size || biases.size() != output_size) {
+        throw std::invalid_argument("Parameter views do not match the layer size");
+    }
     initialize_layer_weights();
     //std::cout << "Layer constructed: input_size = " << input_size << ", output_size = " << output_size
     //    << ", weights size = " << weights.size() << ", biases size = " << biases.size() << std::endl;
 }
 
+Layer::Layer(const Layer& other)
+    : input_size(other.input_size), output_size(other.output_size),
+    own_parameters(other.weights.size() + other.biases.size()), version(other.version),
+    input_cache(other.input_cache), output_cache(other.output_cache) {
+    weights = own_parameters.view(0, other.weights.size());
+    biases = own_parameters.view(weights.size(), other.biases.size());
+    std::copy(other.weights.begin(), other.weights.end(), weights.begin());
+    std::copy(other.biases.begin(), other.biases.end(), biases.begin());
+}
+
 //Initializing Weights method that allows a random weight initialization per required sizes
 void Layer::initialize_layer_weights() {
     float limit = std::sqrt(6.0f / (input_size + output_size));
@@ -51,8 +68,39 @@ void Layer::initialize_layer_weights() {
     }
 }
 
+//Methods that allow restoring weights, e.g. when resuming from a checkpoint
+void Layer::set_weights(const std::vector<float>& new_weights) {
+    if (new_weights.size() != weights.size()) {
+        throw std::invalid_argument("Weights size mismatch");
+    }
+    std::copy(new_weights.begin(), new_weights.end(), weights.begin());
+    ++version;
+}
+
+void Layer::set_biases(const std::vector<float>& new_biases) {
+    if (new_biases.size() != biases.size()) {
+        throw std::invalid_argument("Biases size mismatch");
+    }
+    std::copy(new_biases.begin(), new_biases.end(), biases.begin());
+    ++version;
+}
+
+void Layer::compute_gradients(float error, Span<float> weight_gradients, Span<float> bias_gradients) const {
+    assert(input_cache.size() == input_size && "Input cache size mismatch");
+    if (weight_gradients.size() != weights.size() || bias_gradients.size() != biases.size()) {
+        throw std::invalid_argument("Gradient views do not match the layer size");
+    }
+    for (uint32_t i = 0; i < output_size; ++i) {
+        for (uint32_t j = 0; j < input_size; ++j) {
+            weight_gradients[i * input_size + j] = error * input_cache[j];
+        }
+        bias_gradients[i] = error;
+    }
+}
+
 //InputLayer class implementation
-InputLayer::InputLayer(uint32_t input_size, uint32_t output_size) : Layer(INPUT_SIZE, HIDDEN_LAYER1_SIZE) {
+InputLayer::InputLayer(uint32_t input_size, uint32_t output_size, Span<float> weights_view, Span<float> biases_view)
+    : Layer(INPUT_SIZE, HIDDEN_LAYER1_SIZE, weights_view, biases_view) {
     //std::cout << "InputLayer constructed" << std::endl;
 }
 
@@ -75,13 +123,19 @@ void InputLayer::update_weights(float error, float learning_rate) {
     //std::cout << "InputLayer update_weights called (no action)" << std::endl;
 }
 
+//The input layer only copies, nothing to train
+void InputLayer::compute_gradients(float, Span<float> weight_gradients, Span<float> bias_gradients) const {
+    std::fill(weight_gradients.begin(), weight_gradients.end(), 0.0f);
+    std::fill(bias_gradients.begin(), bias_gradients.end(), 0.0f);
+}
+
 float InputLayer::get_output_derivative() const {
     return 1.0f; //Identity function derivative
 }
 
 //HiddenLayer class implementation
-HiddenLayer::HiddenLayer(uint32_t input_size, uint32_t output_size)
-    : Layer(input_size, output_size) {
+HiddenLayer::HiddenLayer(uint32_t input_size, uint32_t output_size, Span<float> weights_view, Span<float> biases_view)
+    : Layer(input_size, output_size, weights_view, biases_view) {
     //std::cout << "HiddenLayer constructed: input_size = " << input_size << ", output_size = " << output_size << std::endl;
 }
 
@@ -96,14 +150,9 @@ void HiddenLayer::forward(const float* input, float* output) const{
     if (weights.size() != input_size * output_size || biases.size() != output_size) {
         throw std::runtime_error("Weight or bias size mismatch in HiddenLayer");
     }
+    //Reads from the cached copy since the MLP runs this layer in place
     input_cache.assign(input, input + input_size);
-    for (uint32_t i = 0; i < output_size; ++i) {
-        float sum = 0.0f;
-        for (uint32_t j = 0; j < input_size; ++j) {
-            sum += input[j] * weights.at(i * input_size + j);
-        }
-        output[i] = activate::relu(activate::clip(sum + biases.at(i), -88.0f, 88.0f));
-    }
+    fused::dense_relu(input_cache.data(), weights.data(), biases.data(), output, input_size, output_size, -88.0f, 88.0f);
     output_cache.assign(output, output + output_size);
     //std::cout << "HiddenLayer forward: input[0] = " << input[0] << ", output[0] = " << output[0] << std::endl;
 }
@@ -111,12 +160,16 @@ void HiddenLayer::forward(const float* input, float* output) const{
 //HiddenLayer update weights method that shalll use backpropagation to calculate, and then update the weights for the hidden layer.
 void HiddenLayer::update_weights(float error, float learning_rate) {
     assert(input_cache.size() == input_size && "Input cache size mismatch");
-    for (uint32_t i = 0; i < output_size; ++i) {
-        for (uint32_t j = 0; j < input_size; ++j) {
-            weights[i * input_size + j] -= learning_rate * error * input_cache[j];
+    //Rows are independent, wide layers split them across the thread pool like forward does
+    parallel::parallel_for(output_size, input_size, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            for (uint32_t j = 0; j < input_size; ++j) {
+                weights[i * input_size + j] -= learning_rate * error * input_cache[j];
+            }
+            biases[i] -= learning_rate * error;
         }
-        biases[i] -= learning_rate * error;
-    }
+    });
+    ++version;
     //std::cout << "HiddenLayer update_weights: error = " << error << ", learning_rate = " << learning_rate << std::endl;
 }
 
@@ -131,7 +184,8 @@ float HiddenLayer::get_output_derivative() const {
 }
 
 //OutputLayer class implementation
-OutputLayer::OutputLayer() : Layer(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE) {
+OutputLayer::OutputLayer(Span<float> weights_view, Span<float> biases_view)
+    : Layer(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE, weights_view, biases_view) {
     //std::cout << "OutputLayer constructed. InputSize: " << input_size << ", OutputSize: " << output_size << std::endl;
     //std::cout << "Weights size: " << weights.size() << ", Biases size: " << biases.size() << std::endl;
 }
@@ -152,26 +206,23 @@ void OutputLayer::forward(const float* input, float* output) const{
     //std::cout << "Weights size: " << weights.size() << ", Biases size: " << biases.size() << std::endl;
 
     input_cache.assign(input, input + input_size);
-    for (uint32_t i = 0; i < OUTPUT_SIZE; ++i) {
-        float sum = 0.0f;
-        for (uint32_t j = 0; j < HIDDEN_LAYER1_SIZE; ++j) {
-            sum += input[j] * weights[i * HIDDEN_LAYER1_SIZE + j];
-        }
-        output[i] = activate::sigmoid(sum + biases[i]);
-        //std::cout << "Output[" << i << "]: " << output[i] << std::endl;
-    }
+    fused::dense_sigmoid(input_cache.data(), weights.data(), biases.data(), output, input_size, output_size);
     output_cache.assign(output, output + output_size);
     //std::cout << "OutputLayer forward end: input[0] = " << input[0] << ", output[0] = " << output[0] << std::endl;
 }
 
 void OutputLayer::update_weights(float error, float learning_rate) {
     assert(input_cache.size() == input_size && "Input cache size mismatch");
-    for (uint32_t i = 0; i < output_size; ++i) {
-        for (uint32_t j = 0; j < input_size; ++j) {
-            weights[i * input_size + j] -= learning_rate * error * input_cache[j];
+    //Rows are independent, wide layers split them across the thread pool like forward does
+    parallel::parallel_for(output_size, input_size, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            for (uint32_t j = 0; j < input_size; ++j) {
+                weights[i * input_size + j] -= learning_rate * error * input_cache[j];
+            }
+            biases[i] -= learning_rate * error;
         }
-        biases[i] -= learning_rate * error;
-    }
+    });
+    ++version;
     //std::cout << "OutputLayer update_weights: error = " << error << ", learning_rate = " << learning_rate << std::endl;
 }
 
@@ -6,6 +6,7 @@
 #ifndef LAYERS_H
 #define LAYERS_H
 
+#include "arena.h"
 #include <cstdint>
 #include <cstdlib>
 #include <vector>
@@ -17,52 +18,72 @@ constexpr uint32_t INPUT_SIZE = 9;
 constexpr uint32_t HIDDEN_LAYER1_SIZE = 64;
 constexpr uint32_t OUTPUT_SIZE = 1;
 
+//A layer's weights and biases are views. A network passes views into its own parameter arena, a layer built
+//without them allocates a small arena of its own.
 class Layer {
 public:
-    Layer(uint32_t input_size, uint32_t output_size);
+    Layer(uint32_t input_size, uint32_t output_size, Span<float> weights_view = {}, Span<float> biases_view = {});
     virtual ~Layer() = default;
+    //Copies own their parameters, they never alias the original's arena
+    Layer(const Layer& other);
+    Layer& operator=(const Layer&) = delete;
 
     virtual void forward(const float* input, float* output) const = 0;
     virtual void update_weights(float error, float learning_rate) = 0;
     virtual float get_output_derivative() const = 0;
-    virtual const std::vector<float>& get_weights() const { return weights; }
-    virtual const std::vector<float>& get_biases() const { return biases; }
+    //Writes the gradient behind update_weights (error times the cached input, error for the biases) into views shaped
+    //like get_weights/get_biases, so an optimizer can apply it
+    virtual void compute_gradients(float error, Span<float> weight_gradients, Span<float> bias_gradients) const;
+    virtual Span<const float> get_weights() const { return weights; }
+    virtual Span<const float> get_biases() const { return biases; }
     virtual const std::vector<float>& get_output() const = 0;
 
+    void set_weights(const std::vector<float>& new_weights);
+    void set_biases(const std::vector<float>& new_biases);
+    uint32_t get_input_size() const { return input_size; }
+    uint32_t get_output_size() const { return output_size; }
+    //Bumped whenever the weights or biases change, lets callers keep derived copies (e.g. packed kernels) in sync
+    uint64_t get_version() const { return version; }
+    //For code that writes the parameters through the arena directly
+    void mark_changed() { ++version; }
+
 protected:
     uint32_t input_size;
     uint32_t output_size;
-    std::vector<float> weights;
-    std::vector<float> biases;
+    ParameterArena own_parameters;
+    Span<float> weights;
+    Span<float> biases;
+    uint64_t version = 0;
     mutable std::vector<float> input_cache;
     mutable std::vector<float> output_cache;
 
     void initialize_layer_weights();
 };
 
-//Most of the methods are just for retrieving data
-class InputLayer : public Layer {
+//Most of the methods are just for retrieving data. The concrete layers are final so calls through them skip the vtable,
+//see pipeline.h for the statically dispatched chain MLP runs them through.
+class InputLayer final : public Layer {
 public:
-    InputLayer(uint32_t input_size, uint32_t output_size);
+    InputLayer(uint32_t input_size, uint32_t output_size, Span<float> weights_view = {}, Span<float> biases_view = {});
     void forward(const float* input, float* output) const override;
     void update_weights(float error, float learning_rate) override;
     float get_output_derivative() const override;
-    uint32_t get_input_size() const { return input_size; }
+    void compute_gradients(float error, Span<float> weight_gradients, Span<float> bias_gradients) const override;
     const std::vector<float>& get_output() const override { return output_cache; }
 };
 
-class HiddenLayer : public Layer {
+class HiddenLayer final : public Layer {
 public:
-    HiddenLayer(uint32_t input_size, uint32_t output_size);
+    HiddenLayer(uint32_t input_size, uint32_t output_size, Span<float> weights_view = {}, Span<float> biases_view = {});
     void forward(const float* input, float* output) const override;
     void update_weights(float error, float learning_rate) override;
     float get_output_derivative() const override;
     const std::vector<float>& get_output() const override { return output_cache; }
 };
 
-class OutputLayer : public Layer {
+class OutputLayer final : public Layer {
 public:
-    OutputLayer();
+    OutputLayer(Span<float> weights_view = {}, Span<float> biases_view = {});
     void forward(const float* input, float* output) const override;
     void update_weights(float error, float learning_rate) override;
     float get_output_derivative() const override;
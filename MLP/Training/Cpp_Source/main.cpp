@@ -3,7 +3,19 @@
 // Date: 8/21/2024
 // Purpose: This is main is to orchistrate and performing traing for the MLP class. 
 #include "MLP.h"
+#include "optimizer.h"
 #include "utilities.h"
+#include "trace.h"
+#include "checkpoint.h"
+#include "metrics.h"
+#include "graph_optimizer.h"
+#include "normalize.h"
+#include "threadpool.h"
+#include "sweep.h"
+#include "evaluation.h"
+#include "distributed.h"
+#include "range_scorer.h"
+#include "cascade.h"
 #include <iostream>
 #include <vector>
 #include <fstream>
@@ -12,64 +24,301 @@
 #include <iomanip>
 #include <numeric>
 #include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+#include <random>
+#include <memory>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
 
-// Function to read data from a file and return a vector of pairs
-std::vector<std::pair<std::vector<float>, int>> read_data_from_file(const std::string& file_path) {
-    std::vector<std::pair<std::vector<float>, int>> data;
-    std::ifstream file(file_path);
+// Function to evaluate the model on a dataset, one multithreaded pass for accuracy, the confusion matrices, AUCs,
+// log loss and calibration
+void evaluate_model(MLP& mlp, const std::vector<std::pair<std::vector<float>, int>>& data) {
+    TRACE_SCOPE("evaluate_model", "eval");
+    evaluation::Report report = evaluation::evaluate(mlp, data);
+    std::cout << "Validation Accuracy: " << report.accuracy * 100 << "%" << std::endl;
+    evaluation::print_report(report, std::cout);
+}
 
-    if (!file.is_open()) {
-        throw std::runtime_error("Error: Unable to open file " + file_path);
+// Parses one bound of --score-range, all digits and within uint64_t
+bool parse_bound(const std::string& text, uint64_t& value) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
     }
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        int number, target;
-        char delimiter;
-        if (ss >> number >> delimiter >> target) {
-            // Create a feature vector with the number and its divisibility flag
-            std::vector<float> features;
-            features.push_back(static_cast<float>(number)); // Original number
-            features.push_back(number % 2 == 0 ? 1.0f : 0.0f); // Divisibility flag
+// Parses begin:end for --score-range, false unless both bounds are whole numbers and begin <= end
+bool parse_range(const std::string& spec, uint64_t& begin, uint64_t& end) {
+    size_t colon = spec.find(':');
+    return colon != std::string::npos && parse_bound(spec.substr(0, colon), begin) &&
+        parse_bound(spec.substr(colon + 1), end) && begin <= end;
+}
 
-            data.emplace_back(features, target);
-        }
-        else {
-            std::cerr << "Warning: Invalid line format: " << line << std::endl;
-        }
+// Scores every integer of [begin, end) with the trained model and prints how many it calls positive
+void score_range(const MLP& mlp, const Normalizer& normalizer, uint64_t begin, uint64_t end) {
+    TRACE_SCOPE("score_range", "eval");
+    range::RangeScorer scorer(mlp, normalizer);
+    auto start = std::chrono::steady_clock::now();
+    range::PositiveBitmap positives = scorer.positives(begin, end);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\nScored " << end - begin << " numbers in [" << begin << ", " << end << ") in " << seconds << " s, "
+        << static_cast<double>(end - begin) / std::max(seconds, 1e-9) << " numbers/s, " << positives.count() << " positive" << std::endl;
+}
+
+// Distills the linear gate from the trained model on the training set and reports on the test set how often it answers
+// alone and what that costs in accuracy
+void run_cascade(const MLP& mlp, const std::vector<std::pair<std::vector<float>, int>>& training_set,
+    const std::vector<std::pair<std::vector<float>, int>>& test_set) {
+    TRACE_SCOPE("run_cascade", "eval");
+    cascade::Cascade model(mlp, training_set);
+    cascade::Report report = model.evaluate(test_set);
+    std::cout << "\nCascade gate exits at |logit| >= " << model.get_threshold() << ": exit rate " << report.exit_rate * 100
+        << "%, accuracy " << report.cascade_accuracy * 100 << "% against " << report.full_accuracy * 100
+        << "% for the full network (" << report.accuracy_delta * 100 << " points)" << std::endl;
+}
+
+// Optimized deployable model, the training set doubles as calibration data for dead neuron removal
+void export_compact(const MLP& mlp, const Normalizer& normalizer, const std::vector<std::pair<std::vector<float>, int>>& training_set,
+    const std::string& path) {
+    TRACE_SCOPE("export_compact", "checkpoint");
+    graph::OptimizeReport report;
+    compact::Model model = graph::optimize(graph::lower_mlp(mlp), training_set, report);
+    // The exported model takes raw features, the normalization lives in its first layer's weights and biases
+    fold_normalizer(model, normalizer);
+    if (!compact::save_model(model, path)) {
+        throw std::runtime_error("Unable to export " + path);
     }
+    std::cout << "\nCompact model written to " << path << "\n" << graph::format_report(report) << std::endl;
+}
 
-    if (data.empty()) {
-        std::cerr << "Warning: No data read from file. Check file format and content." << std::endl;
+// Trains every model of a sweep grid at once on the shared training set and ranks them on the test set. The ranking is
+// headed by how the sweep models differ from the MLP.
+void run_sweep(const std::string& grid, const std::vector<std::pair<std::vector<float>, int>>& training_set,
+    const std::vector<std::pair<std::vector<float>, int>>& test_set, int epochs, uint32_t batch_size, bool shuffle, uint32_t seed) {
+    TRACE_SCOPE("sweep", "train");
+    std::vector<sweep::ModelSpec> specs = sweep::parse_grid(grid);
+    if (training_set.empty()) {
+        throw std::runtime_error("No training data to sweep");
     }
+    uint32_t feature_count = static_cast<uint32_t>(training_set.front().first.size());
+    sweep::StackedTrainer trainer(feature_count, specs);
+    std::cout << "Sweeping " << specs.size() << " models (" << trainer.total_hidden() << " stacked hidden units), batch "
+        << batch_size << std::endl;
 
-    file.close();
-    return data;
-}
+    std::vector<uint32_t> order(training_set.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::mt19937 rng(seed);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<sweep::ModelStats> train_stats;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        if (shuffle) {
+            std::shuffle(order.begin(), order.end(), rng);
+        }
+        train_stats = trainer.train_epoch(training_set, order, batch_size);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Sweep trained in " << seconds << " s, "
+        << static_cast<double>(training_set.size()) * epochs * specs.size() / std::max(seconds, 1e-9) << " model-samples/s" << std::endl;
 
-// Function to evaluate the model on a dataset
-void evaluate_model(MLP& mlp, const std::vector<std::pair<std::vector<float>, int>>& data) {
-    int correct_predictions = 0;
-    for (const auto& sample : data) {
-        const std::vector<float>& input_features = sample.first;
-        int target = sample.second;
+    std::vector<sweep::ModelStats> test_stats = trainer.evaluate(test_set);
+    std::vector<size_t> ranking(specs.size());
+    std::iota(ranking.begin(), ranking.end(), size_t(0));
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) {
+        return test_stats[a].accuracy != test_stats[b].accuracy ? test_stats[a].accuracy > test_stats[b].accuracy
+            : test_stats[a].loss < test_stats[b].loss;
+    });
+    std::cout << sweep::mlp_difference() << std::endl;
+    for (size_t k : ranking) {
+        std::cout << sweep::describe(specs[k]) << ": train loss " << train_stats[k].loss << ", train accuracy "
+            << train_stats[k].accuracy * 100 << "%, validation loss " << test_stats[k].loss << ", validation accuracy "
+            << test_stats[k].accuracy * 100 << "%" << std::endl;
+    }
+}
 
-        mlp.forward(input_features);
+// Data-parallel launcher: starts one trainer process per rank with this process's arguments plus the rank, waits for
+// them and loads what rank 0 trained into mlp. A --trace path becomes path.rankN for each worker so they do not all
+// write over the launcher's file.
+bool run_distributed(int argc, char** argv, uint32_t workers, distributed::Backend backend, MLP& mlp) {
+    TRACE_SCOPE("distributed", "train");
+    std::random_device random;
+    std::ostringstream name;
+    name << "edgemlp_" << std::hex << random() << random();
+    const std::string result_path = name.str() + ".params";
+    distributed::Endpoint endpoint;
+    endpoint.backend = backend;
+    endpoint.name = name.str();
+    endpoint.size = workers;
+    distributed::Session session(endpoint);
 
-        float output = mlp.get_output()[0];
-        bool predicted_class = output > 0.5f;
-        if (predicted_class == target) {
-            ++correct_predictions;
+    std::vector<std::vector<std::string>> args(workers, std::vector<std::string>(argv + 1, argv + argc));
+    for (uint32_t rank = 0; rank < workers; ++rank) {
+        for (size_t i = 0; i + 1 < args[rank].size(); ++i) {
+            if (args[rank][i] == "--trace") {
+                args[rank][++i] += ".rank" + std::to_string(rank);
+            }
         }
+        args[rank].insert(args[rank].end(), { "--rank", std::to_string(rank), "--rendezvous", endpoint.name, "--result", result_path });
     }
+    std::cout << "Launching " << workers << " data-parallel workers over " << distributed::backend_name(backend) << std::endl;
+    // The workers are this same program, like the transports this needs Linux
+    uint32_t failed = distributed::run_workers("/proc/self/exe", args);
+    if (failed > 0) {
+        std::cerr << "Error: " << failed << " of " << workers << " workers failed" << std::endl;
+        std::remove(result_path.c_str());
+        return false;
+    }
+    bool loaded = mlp.load_parameters(result_path);
+    std::remove(result_path.c_str());
+    return loaded;
+}
 
-    float accuracy = static_cast<float>(correct_predictions) / data.size();
-    std::cout << "Validation Accuracy: " << accuracy * 100 << "%" << std::endl;
+// One data-parallel worker, trains its shard of the training set in lockstep with the others. Rank 0 reports the
+// combined progress on console and writes the trained parameters to result_path.
+int run_worker(const distributed::Endpoint& endpoint, const std::vector<std::pair<std::vector<float>, int>>& training_set,
+    const distributed::TrainConfig& config, const optim::Config& optimizer_config, const std::string& result_path, std::ostream& console) {
+    MLP mlp(2);
+    optim::Optimizer optimizer(optimizer_config, mlp.get_trainable_parameters().size());
+    std::unique_ptr<distributed::Transport> transport = distributed::connect(endpoint);
+    auto start = std::chrono::steady_clock::now();
+    distributed::train_data_parallel(mlp, *transport, training_set, config, optimizer, [&](int epoch, const distributed::EpochStats& stats) {
+        if (endpoint.rank == 0) {
+            console << "Epoch " << epoch + 1 << "/" << config.epochs << " - Mean Loss: " << stats.loss << ", Accuracy: "
+                << stats.accuracy * 100 << "%" << std::endl;
+        }
+    });
+    if (endpoint.rank != 0) {
+        return 0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    console << "Data-parallel training on " << endpoint.size << " workers (batch " << config.batch_size << " each"
+        << (config.compress ? ", fp16 gradients" : "") << "): "
+        << static_cast<double>(training_set.size()) * config.epochs / std::max(seconds, 1e-9) << " samples/s" << std::endl;
+    return mlp.save_parameters(result_path) ? 0 : 1;
 }
 
 // Main Method
-int main() {
+// Usage: main [--trace trace.json] [--trace-sample N] [--checkpoint file] [--checkpoint-every N] [--resume file] [--shuffle] [--seed N]
+//             [--log-level error|warning|info|debug] [--metrics metrics.jsonl] [--export-compact model.txt]
+//             [--normalize none|standard|minmax] [--threads N] [--pin-threads]
+//             [--optimizer sgd|momentum|adam|adamw] [--learning-rate X] [--weight-decay X] [--clip X]
+//             [--sweep "lr=0.1,0.05 hidden=16,64 seeds=3"] [--batch N] [--workers N] [--transport shm|socket] [--fp16]
+//             [--score-range begin:end] [--cascade]
+// --sweep trains its own inputs,H:relu,1:sigmoid networks on cross entropy, not this MLP (see sweep::mlp_difference).
+// Workers are started with --rank N --rendezvous name --result file added, those are not meant to be passed by hand.
+int main(int argc, char** argv) {
+    std::string trace_path, checkpoint_path, resume_path, metrics_path, compact_path;
+    uint32_t trace_sample = 1;
+    uint64_t checkpoint_every = 0; // samples between checkpoints, 0 = only at the end of each epoch
+    bool shuffle = false;
+    NormalizationKind normalization = NormalizationKind::None;
+    uint32_t seed = 42;
+    unsigned threads = 0; // 0 = hardware thread count
+    bool pin_threads = false;
+    std::string sweep_grid;
+    uint32_t batch_size = 16; // sweep and data-parallel minibatch, per worker
+    uint32_t workers = 1;
+    distributed::Backend backend = distributed::Backend::SharedMemory;
+    bool compress_gradients = false;
+    int worker_rank = -1; // set in the worker processes only
+    std::string rendezvous, result_path;
+    bool score_numbers = false; // --score-range begin:end
+    uint64_t range_begin = 0, range_end = 0;
+    bool cascade_report = false;
+    optim::Config optimizer_config;
+    optimizer_config.learning_rate = 0.0f; // 0 = the trainer's default
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) trace_path = argv[++i];
+        else if (arg == "--trace-sample" && i + 1 < argc) trace_sample = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpoint_path = argv[++i];
+        else if (arg == "--checkpoint-every" && i + 1 < argc) checkpoint_every = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--resume" && i + 1 < argc) resume_path = argv[++i];
+        else if (arg == "--shuffle") shuffle = true;
+        else if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--metrics" && i + 1 < argc) metrics_path = argv[++i];
+        else if (arg == "--export-compact" && i + 1 < argc) compact_path = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--pin-threads") pin_threads = true;
+        else if (arg == "--sweep" && i + 1 < argc) sweep_grid = argv[++i];
+        else if (arg == "--batch" && i + 1 < argc) batch_size = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--workers" && i + 1 < argc) workers = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--fp16") compress_gradients = true;
+        else if (arg == "--score-range" && i + 1 < argc) {
+            if (!parse_range(argv[++i], range_begin, range_end)) {
+                std::cerr << "Invalid --score-range " << argv[i] << ", expected begin:end with whole numbers and begin <= end" << std::endl;
+                return 1;
+            }
+            score_numbers = true;
+        }
+        else if (arg == "--cascade") cascade_report = true;
+        else if (arg == "--rank" && i + 1 < argc) worker_rank = std::atoi(argv[++i]);
+        else if (arg == "--rendezvous" && i + 1 < argc) rendezvous = argv[++i];
+        else if (arg == "--result" && i + 1 < argc) result_path = argv[++i];
+        else if (arg == "--transport" && i + 1 < argc) {
+            if (!distributed::parse_backend(argv[++i], backend)) {
+                std::cerr << "Unknown transport " << argv[i] << ", expected shm or socket" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--learning-rate" && i + 1 < argc) optimizer_config.learning_rate = std::strtof(argv[++i], nullptr);
+        else if (arg == "--weight-decay" && i + 1 < argc) optimizer_config.weight_decay = std::strtof(argv[++i], nullptr);
+        else if (arg == "--clip" && i + 1 < argc) optimizer_config.clip = std::strtof(argv[++i], nullptr);
+        else if (arg == "--optimizer" && i + 1 < argc) {
+            if (!optim::parse_method(argv[++i], optimizer_config.method)) {
+                std::cerr << "Unknown optimizer " << argv[i] << ", expected sgd, momentum, adam or adamw" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--normalize" && i + 1 < argc) {
+            if (!parse_normalization_kind(argv[++i], normalization)) {
+                std::cerr << "Unknown normalization " << argv[i] << ", expected none, standard or minmax" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--log-level" && i + 1 < argc) {
+            metrics::LogLevel level;
+            if (!metrics::parse_log_level(argv[++i], level)) {
+                std::cerr << "Unknown log level " << argv[i] << ", expected error, warning, info or debug" << std::endl;
+                return 1;
+            }
+            metrics::set_log_level(level);
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--trace trace.json] [--trace-sample N] [--checkpoint file] [--checkpoint-every N]"
+                << " [--resume file] [--shuffle] [--seed N] [--log-level error|warning|info|debug] [--metrics metrics.jsonl]"
+                << " [--export-compact model.txt] [--normalize none|standard|minmax] [--threads N] [--pin-threads]"
+                << " [--optimizer sgd|momentum|adam|adamw] [--learning-rate X] [--weight-decay X] [--clip X]"
+                << " [--sweep grid] [--batch N] [--workers N] [--transport shm|socket] [--fp16]"
+                << " [--score-range begin:end] [--cascade]" << std::endl;
+            std::cerr << "--sweep: " << sweep::mlp_difference() << std::endl;
+            return 1;
+        }
+    }
+    // Data-parallel training has no checkpoints, metrics file or sweep of its own, refuse them instead of ignoring them
+    if (workers > 1 && (!checkpoint_path.empty() || checkpoint_every > 0 || !resume_path.empty() || !metrics_path.empty() ||
+        !sweep_grid.empty())) {
+        std::cerr << "--workers cannot be combined with --checkpoint, --checkpoint-every, --resume, --metrics or --sweep" << std::endl;
+        return 1;
+    }
+    // Worker processes share the machine, one thread each unless told otherwise, and only rank 0 talks
+    std::streambuf* console = std::cout.rdbuf();
+    if (worker_rank >= 0) {
+        threads = threads == 0 ? 1 : threads;
+        std::cout.rdbuf(nullptr);
+    }
+    // One scheduler for the parsers, the feature statistics, evaluation and the wide layer kernels
+    parallel::set_threads(threads, pin_threads);
+    if (!trace_path.empty() && trace::start(trace_path, trace_sample)) {
+        trace::set_thread_name("trainer");
+    }
+
     try {
         std::cout << "Starting MLP training and testing from file..." << std::endl;
 
@@ -81,50 +330,230 @@ int main() {
         std::vector<std::pair<std::vector<float>, int>> training_data = read_data_from_file("train.txt");
         std::cout << "Loaded " << training_data.size() << " training samples from file." << std::endl;
 
-        float learning_rate = 0.1f; // Adjust learning rate
+        // Dataset level normalization, recomputed the same way on resume since the statistics are deterministic
+        Normalizer normalizer;
+        if (normalization != NormalizationKind::None && !training_data.empty()) {
+            uint32_t feature_count = static_cast<uint32_t>(training_data.front().first.size());
+            normalizer = Normalizer::from_stats(compute_feature_stats(training_data, feature_count), normalization);
+            std::cout << "Normalizing " << feature_count << " features with dataset statistics." << std::endl;
+        }
+        // Bound by reference so the raw set is not copied when there is nothing to normalize
+        std::vector<std::pair<std::vector<float>, int>> normalized_training;
+        if (!normalizer.empty()) {
+            normalized_training = normalizer.apply_all(training_data);
+        }
+        const std::vector<std::pair<std::vector<float>, int>>& training_set = normalizer.empty() ? training_data : normalized_training;
+
+        float learning_rate = optimizer_config.learning_rate > 0.0f ? optimizer_config.learning_rate : 0.1f;
         int epochs = 20;
+
+        // Data-parallel mode, the launcher starts the workers and evaluates what rank 0 trained
+        if (worker_rank >= 0) {
+            distributed::Endpoint endpoint;
+            endpoint.backend = backend;
+            endpoint.name = rendezvous;
+            endpoint.rank = static_cast<uint32_t>(worker_rank);
+            endpoint.size = workers;
+            distributed::TrainConfig config;
+            config.epochs = epochs;
+            config.batch_size = batch_size;
+            config.compress = compress_gradients;
+            config.shuffle = shuffle;
+            config.seed = seed;
+            optim::Config worker_optimizer = optimizer_config;
+            worker_optimizer.learning_rate = learning_rate;
+            std::ostream console_out(console);
+            int code = run_worker(endpoint, training_set, config, worker_optimizer, result_path, console_out);
+            trace::stop();
+            return code;
+        }
+        if (workers > 1) {
+            if (!run_distributed(argc, argv, workers, backend, mlp)) {
+                throw std::runtime_error("Data-parallel training failed");
+            }
+            std::cout << "\nTraining completed." << std::endl;
+            std::vector<std::pair<std::vector<float>, int>> test_data = read_data_from_file("test.txt");
+            std::cout << "Loaded " << test_data.size() << " test samples from file." << std::endl;
+            std::vector<std::pair<std::vector<float>, int>> normalized_test;
+            if (!normalizer.empty()) {
+                normalized_test = normalizer.apply_all(test_data);
+            }
+            const std::vector<std::pair<std::vector<float>, int>>& test_set = normalizer.empty() ? test_data : normalized_test;
+            evaluate_model(mlp, test_set);
+            if (score_numbers) {
+                score_range(mlp, normalizer, range_begin, range_end);
+            }
+            if (cascade_report) {
+                run_cascade(mlp, training_set, test_set);
+            }
+            if (!compact_path.empty()) {
+                export_compact(mlp, normalizer, training_set, compact_path);
+            }
+            metrics::stop();
+            trace::stop();
+            std::cout << "\nProgram completed successfully." << std::endl;
+            return 0;
+        }
+
+        // Sweep mode trains the whole grid in this one process instead of the single MLP below
+        if (!sweep_grid.empty()) {
+            std::vector<std::pair<std::vector<float>, int>> test_data = read_data_from_file("test.txt");
+            std::vector<std::pair<std::vector<float>, int>> normalized_test;
+            if (!normalizer.empty()) {
+                normalized_test = normalizer.apply_all(test_data);
+            }
+            run_sweep(sweep_grid, training_set, normalizer.empty() ? test_data : normalized_test, epochs, batch_size, shuffle, seed);
+            metrics::stop();
+            trace::stop();
+            std::cout << "\nProgram completed successfully." << std::endl;
+            return 0;
+        }
+
+        // Trainer state, restored from a checkpoint when resuming
+        std::mt19937 rng(seed);
+        TrainerState state;
+        state.learning_rate = learning_rate;
+        Checkpoint checkpoint;
+        if (!resume_path.empty()) {
+            if (!read_checkpoint_file(resume_path, checkpoint)) {
+                throw std::runtime_error("Unable to resume from " + resume_path);
+            }
+            restore_checkpoint(checkpoint, mlp);
+            state = checkpoint.state;
+            learning_rate = state.learning_rate;
+            std::istringstream(state.rng_state) >> rng;
+            std::cout << "Resumed from " << resume_path << " at epoch " << state.epoch + 1
+                << ", sample " << state.sample_index << std::endl;
+            // The run continues with the optimizer it was checkpointed with, whatever the command line asks for
+            if (checkpoint.optimizer.present) {
+                if (checkpoint.optimizer.config.method != optimizer_config.method) {
+                    std::cout << "Continuing with the checkpointed optimizer "
+                        << optim::method_name(checkpoint.optimizer.config.method) << std::endl;
+                }
+                optimizer_config = checkpoint.optimizer.config;
+            }
+        }
         std::cout << "Learning rate: " << learning_rate << ", Epochs: " << epochs << std::endl;
 
-        for (int epoch = 0; epoch < epochs; ++epoch) {
-            std::cout << "\n--- Epoch " << epoch + 1 << "/" << epochs << " ---" << std::endl;
-            float total_loss = 0.0f;
-            int correct_predictions = 0;
+        // Plain SGD keeps the per-layer update, anything else goes through the fused optimizer over the parameter arena.
+        // Its moments and step count are checkpointed with the parameters and restored here on resume.
+        std::unique_ptr<optim::Optimizer> optimizer;
+        if (checkpoint.optimizer.present || optimizer_config.method != optim::Method::Sgd ||
+            optimizer_config.weight_decay > 0.0f || optimizer_config.clip > 0.0f) {
+            optimizer_config.learning_rate = learning_rate;
+            optimizer = std::make_unique<optim::Optimizer>(optimizer_config, mlp.get_trainable_parameters().size());
+            if (checkpoint.optimizer.present) {
+                restore_optimizer(checkpoint, *optimizer);
+            }
+            else if (!resume_path.empty()) {
+                std::cout << "Checkpoint has no optimizer state, the moments start from zero" << std::endl;
+            }
+            std::cout << "Optimizer: " << optim::method_name(optimizer_config.method) << std::endl;
+        }
 
-            for (const auto& sample : training_data) {
+        std::unique_ptr<CheckpointWriter> checkpoints;
+        if (!checkpoint_path.empty()) {
+            checkpoints = std::make_unique<CheckpointWriter>(checkpoint_path);
+        }
+
+        std::vector<size_t> order(training_data.size());
+        uint64_t steps = 0;
+        // From here on console output goes through the background metrics writer
+        if (!metrics::start(metrics_path)) {
+            throw std::runtime_error("Unable to start the metrics writer");
+        }
+
+        for (int epoch = static_cast<int>(state.epoch); epoch < epochs; ++epoch) {
+            TRACE_SCOPE("epoch", "train");
+
+            // The RNG state is captured before the shuffle so a resumed run reproduces the same order
+            std::ostringstream rng_state;
+            rng_state << rng;
+            state.epoch = static_cast<uint32_t>(epoch);
+            state.rng_state = rng_state.str();
+            std::iota(order.begin(), order.end(), size_t(0));
+            if (shuffle) {
+                std::shuffle(order.begin(), order.end(), rng);
+            }
+
+            float total_loss = static_cast<float>(state.epoch_loss);
+            int correct_predictions = static_cast<int>(state.epoch_correct);
+
+            const size_t first_index = static_cast<size_t>(state.sample_index);
+            for (size_t index = first_index; index < order.size(); ++index) {
+                TRACE_SAMPLE_TICK();
+                TRACE_SCOPE_SAMPLED("sample", "train");
+                const auto& sample = training_set[order[index]];
                 const std::vector<float>& input_features = sample.first;
                 int target = sample.second;
+                float output, error;
+
+                {
+                    TRACE_SCOPE_SAMPLED("forward", "train");
+                    mlp.forward(input_features);
+                    output = mlp.get_output()[0];
+                }
 
-                // Normalize inputs if necessary
-                std::vector<float> normalized_input = input_features; // Apply normalization if needed
+                {
+                    TRACE_SCOPE_SAMPLED("backward", "train");
+                    float loss = 0.5f * std::pow(output - target, 2);
+                    total_loss += loss;
 
-                mlp.forward(normalized_input);
+                    // Determine if prediction is correct
+                    bool predicted_class = output > 0.5f;
+                    bool correct = predicted_class == target;
+                    if (correct) {
+                        ++correct_predictions;
+                    }
 
-                float output = mlp.get_output()[0];
-                float loss = 0.5f * std::pow(output - target, 2);
-                total_loss += loss;
+                    // Calculate error
+                    error = output - target;
 
-                // Determine if prediction is correct
-                bool predicted_class = output > 0.5f;
-                if (predicted_class == target) {
-                    ++correct_predictions;
+                    // Only a fixed-size record is queued, the writer thread aggregates and prints it
+                    metrics::record_sample(static_cast<uint32_t>(epoch), input_features[0], static_cast<float>(target), output, loss, correct);
                 }
 
-                // Calculate error and update weights
-                float error = output - target;
-                std::vector<float> errors(1, error);
+                {
+                    TRACE_SCOPE_SAMPLED("update_weights", "train");
+                    if (optimizer) {
+                        mlp.update_weights(error, *optimizer);
+                    }
+                    else {
+                        mlp.update_weights(error, learning_rate);
+                    }
+                }
 
-                mlp.get_output_layer().update_weights(errors[0], learning_rate);
-                mlp.get_hidden_layer1().update_weights(errors[0], learning_rate);
-                mlp.get_input_layer().update_weights(errors[0], learning_rate);
+                // Mid-epoch checkpoint, the writer copies the parameters and serializes them in the background
+                if (checkpoints && checkpoint_every > 0 && ++steps % checkpoint_every == 0 && index + 1 < order.size()) {
+                    state.sample_index = index + 1;
+                    state.epoch_loss = total_loss;
+                    state.epoch_correct = static_cast<uint64_t>(correct_predictions);
+                    checkpoints->submit(mlp, state, optimizer.get());
+                }
+            }
 
-                // Debug prints
-                std::cout << "Input: " << input_features[0] << ", Target: " << target
-                    << ", Output: " << output << ", Error: " << error << std::endl;
+            metrics::end_epoch(static_cast<uint32_t>(epoch), static_cast<uint32_t>(epochs), total_loss,
+                static_cast<uint64_t>(correct_predictions), order.size(), order.size() - first_index);
+
+            // End of epoch checkpoint points at the start of the next epoch
+            state.sample_index = 0;
+            state.epoch_loss = 0.0;
+            state.epoch_correct = 0;
+            if (checkpoints) {
+                std::ostringstream next_rng_state;
+                next_rng_state << rng;
+                TrainerState next = state;
+                next.epoch = static_cast<uint32_t>(epoch + 1);
+                next.rng_state = next_rng_state.str();
+                checkpoints->submit(mlp, next, optimizer.get());
             }
+            trace::flush();
+        }
 
-            float accuracy = static_cast<float>(correct_predictions) / training_data.size();
-            std::cout << "Total Loss: " << total_loss
-                << ", Accuracy: " << accuracy * 100 << "%" << std::endl;
+        metrics::flush();
+        if (checkpoints) {
+            checkpoints->wait_idle();
+            std::cout << "Checkpoints written: " << checkpoints->get_written() << " to " << checkpoint_path << std::endl;
         }
 
         std::cout << "\nTraining completed." << std::endl;
@@ -132,14 +561,33 @@ int main() {
         // Read test data from file and evaluate
         std::vector<std::pair<std::vector<float>, int>> test_data = read_data_from_file("test.txt");
         std::cout << "Loaded " << test_data.size() << " test samples from file." << std::endl;
-        evaluate_model(mlp, test_data);
+        std::vector<std::pair<std::vector<float>, int>> normalized_test;
+        if (!normalizer.empty()) {
+            normalized_test = normalizer.apply_all(test_data);
+        }
+        const std::vector<std::pair<std::vector<float>, int>>& test_set = normalizer.empty() ? test_data : normalized_test;
+        evaluate_model(mlp, test_set);
+        if (score_numbers) {
+            score_range(mlp, normalizer, range_begin, range_end);
+        }
+        if (cascade_report) {
+            run_cascade(mlp, training_set, test_set);
+        }
+
+        if (!compact_path.empty()) {
+            export_compact(mlp, normalizer, training_set, compact_path);
+        }
 
     }
     catch (const std::exception& e) {
+        metrics::stop();
         std::cerr << "Error: " << e.what() << std::endl;
+        trace::stop();
         return 1;
     }
 
+    metrics::stop();
+    trace::stop();
     std::cout << "\nProgram completed successfully." << std::endl;
     return 0;
 }
@@ -0,0 +1,315 @@
+// metrics.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the lock-free record queue and the background writer that turns training records into per-epoch summaries and log lines.
+
+#include "metrics.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace metrics {
+    namespace detail {
+        std::atomic<uint8_t> level{ static_cast<uint8_t>(LogLevel::Info) };
+    }
+
+    namespace {
+        constexpr uint32_t QUEUE_CAPACITY = 1u << 15;
+
+        struct Sink {
+            std::unique_ptr<RecordQueue> queue;
+            std::thread writer;
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable drained;
+            std::atomic<bool> running{ false };
+            bool stopping = false;
+            uint64_t flush_requested = 0;
+            uint64_t flush_completed = 0;
+            std::ofstream metrics_file;
+            std::atomic<uint64_t> dropped{ 0 };
+            //Trainer side, when the current epoch started and the dropped count it started from
+            std::atomic<int64_t> epoch_start_ns{ 0 };
+            std::atomic<uint64_t> dropped_before_epoch{ 0 };
+        };
+
+        Sink& sink() {
+            static Sink instance;
+            return instance;
+        }
+
+        int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        //Sample and message records are dropped when the queue is full, control records (must_deliver) wait for room
+        void push(const MetricRecord& record, bool wake_writer, bool must_deliver = false) {
+            Sink& s = sink();
+            if (!s.running.load(std::memory_order_relaxed)) {
+                return;
+            }
+            while (!s.queue->push(record)) {
+                if (!must_deliver) {
+                    s.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                s.wake.notify_one();
+                std::this_thread::yield();
+            }
+            if (wake_writer) {
+                s.wake.notify_one();
+            }
+        }
+
+        void write_message(const MetricRecord& record) {
+            std::ostream& out = (record.level <= LogLevel::Warning) ? std::cerr : std::cout;
+            out.write(record.text, record.length);
+            out << '\n';
+        }
+
+        //Everything below runs on the writer thread only
+        void handle(Sink& s, const MetricRecord& record) {
+            switch (record.kind) {
+            case RecordKind::Sample: {
+                if (should_log(LogLevel::Debug)) {
+                    std::cout << "Input: " << record.input << ", Target: " << record.target
+                        << ", Output: " << record.output << ", Error: " << record.output - record.target << '\n';
+                }
+                break;
+            }
+            case RecordKind::EpochEnd: {
+                double throughput = (record.epoch_seconds > 0.0) ? record.epoch_trained / record.epoch_seconds : 0.0;
+                double accuracy = (record.epoch_samples > 0) ? static_cast<double>(record.epoch_correct) / record.epoch_samples : 0.0;
+                uint64_t dropped = record.epoch_dropped;
+                if (should_log(LogLevel::Info)) {
+                    std::cout << "Epoch " << record.epoch + 1 << "/" << record.total_epochs
+                        << " - Total Loss: " << record.epoch_loss << ", Accuracy: " << accuracy * 100 << "%"
+                        << ", Throughput: " << throughput << " samples/s";
+                    if (dropped > 0) std::cout << " (" << dropped << " records dropped)";
+                    std::cout << '\n';
+                }
+                if (s.metrics_file.is_open()) {
+                    s.metrics_file << "{\"epoch\": " << record.epoch + 1 << ", \"samples\": " << record.epoch_samples
+                        << ", \"loss\": " << record.epoch_loss << ", \"accuracy\": " << accuracy
+                        << ", \"samples_per_sec\": " << throughput << ", \"dropped\": " << dropped << "}\n";
+                }
+                break;
+            }
+            case RecordKind::Message:
+                write_message(record);
+                break;
+            }
+        }
+
+        void writer_loop() {
+            trace::set_thread_name("metrics_writer");
+            Sink& s = sink();
+            MetricRecord record;
+            for (;;) {
+                uint64_t flush_target;
+                bool stop_now;
+                {
+                    std::unique_lock<std::mutex> lock(s.mutex);
+                    s.wake.wait_for(lock, std::chrono::milliseconds(2));
+                    flush_target = s.flush_requested;
+                    stop_now = s.stopping;
+                }
+                {
+                    TRACE_SCOPE("metrics_drain", "logging");
+                    while (s.queue->pop(record)) {
+                        handle(s, record);
+                    }
+                    std::cout.flush();
+                    if (s.metrics_file.is_open()) s.metrics_file.flush();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(s.mutex);
+                    s.flush_completed = std::max(s.flush_completed, flush_target);
+                }
+                s.drained.notify_all();
+                if (stop_now) {
+                    break;
+                }
+            }
+        }
+    }
+
+    RecordQueue::RecordQueue(uint32_t capacity)
+        : cells(capacity), mask(capacity - 1), enqueue_pos(0), dequeue_pos(0) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("Record queue capacity must be a power of two");
+        }
+        for (uint32_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool RecordQueue::push(const MetricRecord& record) {
+        uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.record = record;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool RecordQueue::pop(MetricRecord& record) {
+        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell& cell = cells[pos & mask];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1) < 0) {
+            return false;
+        }
+        record = cell.record;
+        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+        dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void set_log_level(LogLevel level) {
+        detail::level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    LogLevel get_log_level() {
+        return static_cast<LogLevel>(detail::level.load(std::memory_order_relaxed));
+    }
+
+    bool parse_log_level(const std::string& name, LogLevel& level) {
+        if (name == "error") level = LogLevel::Error;
+        else if (name == "warning") level = LogLevel::Warning;
+        else if (name == "info") level = LogLevel::Info;
+        else if (name == "debug") level = LogLevel::Debug;
+        else return false;
+        return true;
+    }
+
+    bool start(const std::string& metrics_file) {
+        Sink& s = sink();
+        if (s.running.load()) {
+            return true;
+        }
+        if (!metrics_file.empty()) {
+            s.metrics_file.open(metrics_file);
+            if (!s.metrics_file.is_open()) {
+                std::cerr << "Error: Unable to open file " << metrics_file << std::endl;
+                return false;
+            }
+        }
+        //The queue is only allocated once training actually uses the writer
+        if (!s.queue) {
+            s.queue = std::make_unique<RecordQueue>(QUEUE_CAPACITY);
+        }
+        s.stopping = false;
+        s.epoch_start_ns.store(now_ns(), std::memory_order_relaxed);
+        s.dropped_before_epoch.store(s.dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        s.writer = std::thread(writer_loop);
+        s.running.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void flush() {
+        Sink& s = sink();
+        if (!s.running.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(s.mutex);
+        uint64_t target = ++s.flush_requested;
+        s.wake.notify_one();
+        s.drained.wait(lock, [&]() { return s.flush_completed >= target; });
+    }
+
+    void stop() {
+        Sink& s = sink();
+        if (!s.running.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.stopping = true;
+        }
+        s.wake.notify_one();
+        s.writer.join();
+        if (s.metrics_file.is_open()) {
+            s.metrics_file.close();
+        }
+    }
+
+    void record_sample(uint32_t epoch, float input, float target, float output, float loss, bool correct) {
+        MetricRecord record;
+        record.kind = RecordKind::Sample;
+        record.level = LogLevel::Debug;
+        record.length = 0;
+        record.epoch = epoch;
+        record.timestamp_ns = now_ns();
+        record.input = input;
+        record.target = target;
+        record.output = output;
+        record.loss = loss;
+        record.correct = correct ? 1 : 0;
+        record.total_epochs = 0;
+        push(record, false);
+    }
+
+    void end_epoch(uint32_t epoch, uint32_t total_epochs, double total_loss, uint64_t correct, uint64_t samples, uint64_t trained) {
+        Sink& s = sink();
+        MetricRecord record = {};
+        record.kind = RecordKind::EpochEnd;
+        record.level = LogLevel::Info;
+        record.epoch = epoch;
+        record.timestamp_ns = now_ns();
+        record.total_epochs = total_epochs;
+        record.epoch_loss = total_loss;
+        record.epoch_correct = correct;
+        record.epoch_samples = samples;
+        record.epoch_trained = trained;
+        //The next epoch's time and drops count from here
+        record.epoch_seconds = (record.timestamp_ns - s.epoch_start_ns.exchange(record.timestamp_ns, std::memory_order_relaxed)) / 1e9;
+        uint64_t dropped = s.dropped.load(std::memory_order_relaxed);
+        record.epoch_dropped = dropped - s.dropped_before_epoch.exchange(dropped, std::memory_order_relaxed);
+        //A lost boundary would leave an epoch without its summary, so this one waits for the writer
+        push(record, true, true);
+    }
+
+    void log(LogLevel level, const std::string& message) {
+        if (!should_log(level)) {
+            return;
+        }
+        MetricRecord record = {};
+        record.kind = RecordKind::Message;
+        record.level = level;
+        record.timestamp_ns = now_ns();
+        record.length = static_cast<uint16_t>(std::min(message.size(), sizeof(record.text)));
+        std::memcpy(record.text, message.data(), record.length);
+        if (!sink().running.load(std::memory_order_acquire)) {
+            write_message(record);
+            return;
+        }
+        push(record, level <= LogLevel::Warning);
+    }
+
+    uint64_t get_dropped() {
+        return sink().dropped.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+// metrics.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the asynchronous metrics and logging sink, the training loop pushes fixed-size records into a lock-free queue and a background writer aggregates them into per-epoch loss, accuracy and throughput.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace metrics {
+    enum class LogLevel : uint8_t {
+        Error = 0,
+        Warning,
+        Info,
+        Debug
+    };
+
+    enum class RecordKind : uint8_t {
+        Sample = 0,
+        EpochEnd,
+        Message
+    };
+
+    //Fixed-size so pushing one never allocates, messages longer than the text buffer are truncated
+    struct MetricRecord {
+        RecordKind kind;
+        LogLevel level;
+        uint16_t length;
+        uint32_t epoch;
+        int64_t timestamp_ns;
+        float input;
+        float target;
+        float output;
+        float loss;
+        uint32_t correct;
+        uint32_t total_epochs;
+        //EpochEnd only, the trainer's own totals for the whole epoch and what end_epoch measured
+        double epoch_loss;
+        uint64_t epoch_correct;
+        uint64_t epoch_samples;
+        uint64_t epoch_trained;     //Of epoch_samples, the ones trained since the epoch started in this run
+        uint64_t epoch_dropped;     //Records dropped during the epoch
+        double epoch_seconds;
+        char text[96];
+    };
+
+    //Bounded multi-producer single-consumer queue (Vyukov style), push fails instead of blocking when full
+    class RecordQueue {
+    public:
+        explicit RecordQueue(uint32_t capacity);
+        bool push(const MetricRecord& record);
+        bool pop(MetricRecord& record);
+
+    private:
+        struct Cell {
+            std::atomic<uint64_t> sequence;
+            MetricRecord record;
+        };
+        std::vector<Cell> cells;
+        uint64_t mask;
+        alignas(64) std::atomic<uint64_t> enqueue_pos;
+        alignas(64) std::atomic<uint64_t> dequeue_pos;
+    };
+
+    //The log level can be changed at any time, records above it are not formatted or queued
+    void set_log_level(LogLevel level);
+    LogLevel get_log_level();
+    bool parse_log_level(const std::string& name, LogLevel& level);
+
+    //Starts the background writer, per-epoch summaries are also appended to metrics_file as JSON lines when given
+    bool start(const std::string& metrics_file = "");
+    //Blocks until everything queued so far is written, call it before printing from the calling thread
+    void flush();
+    //Drains the queue and joins the writer
+    void stop();
+
+    void record_sample(uint32_t epoch, float input, float target, float output, float loss, bool correct);
+    //The summary reports the totals given here, the queued sample records only feed the debug lines, so it stays right
+    //after a mid-epoch resume or when records were dropped. samples is the whole epoch, trained the part this run did
+    //(less after a mid-epoch resume) and the throughput is trained over the time since the previous epoch ended. Never
+    //dropped itself, it waits for room.
+    void end_epoch(uint32_t epoch, uint32_t total_epochs, double total_loss, uint64_t correct, uint64_t samples, uint64_t trained);
+    //Without a running writer messages go straight to std::cout/std::cerr
+    void log(LogLevel level, const std::string& message);
+
+    uint64_t get_dropped();
+
+    namespace detail {
+        extern std::atomic<uint8_t> level;
+    }
+
+    inline bool should_log(LogLevel level) {
+        return static_cast<uint8_t>(level) <= detail::level.load(std::memory_order_relaxed);
+    }
+}
+
+#endif
@@ -0,0 +1,157 @@
+// normalize.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the streaming feature statistics, the normalizer and folding it into the first layer of a compact model.
+
+#include "normalize.h"
+#include "threadpool.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t STATS_CHUNK = 4096;
+}
+
+FeatureStats::FeatureStats(uint32_t feature_count)
+    : mean(feature_count, 0.0), m2(feature_count, 0.0),
+    min(feature_count, std::numeric_limits<double>::infinity()),
+    max(feature_count, -std::numeric_limits<double>::infinity()) {}
+
+void FeatureStats::add(const std::vector<float>& sample) {
+    ++count;
+    const double n = static_cast<double>(count);
+    for (uint32_t f = 0; f < feature_count(); ++f) {
+        //Missing trailing features count as zero, the same padding the MLP applies
+        double x = f < sample.size() ? sample[f] : 0.0;
+        double delta = x - mean[f];
+        mean[f] += delta / n;
+        m2[f] += delta * (x - mean[f]);
+        min[f] = std::min(min[f], x);
+        max[f] = std::max(max[f], x);
+    }
+}
+
+void FeatureStats::merge(const FeatureStats& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (other.feature_count() != feature_count()) {
+        throw std::invalid_argument("Feature count mismatch");
+    }
+    const double n_a = static_cast<double>(count);
+    const double n_b = static_cast<double>(other.count);
+    const double n = n_a + n_b;
+    for (uint32_t f = 0; f < feature_count(); ++f) {
+        double delta = other.mean[f] - mean[f];
+        mean[f] += delta * n_b / n;
+        m2[f] += other.m2[f] + delta * delta * n_a * n_b / n;
+        min[f] = std::min(min[f], other.min[f]);
+        max[f] = std::max(max[f], other.max[f]);
+    }
+    count += other.count;
+}
+
+double FeatureStats::stddev(uint32_t feature) const {
+    return count > 0 ? std::sqrt(m2[feature] / static_cast<double>(count)) : 0.0;
+}
+
+FeatureStats compute_feature_stats(const std::vector<std::pair<std::vector<float>, int>>& data, uint32_t feature_count,
+    unsigned threads) {
+    TRACE_SCOPE("feature_stats", "data");
+    const size_t chunks = (data.size() + STATS_CHUNK - 1) / STATS_CHUNK;
+    std::vector<FeatureStats> partial(chunks, FeatureStats(feature_count));
+    if (threads == 0) {
+        threads = parallel::default_pool().size();
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunks));
+
+    //Task t takes chunks t, t + threads, ... and the partial results are merged in chunk order afterwards
+    parallel::default_pool().run(threads, [&](uint32_t t) {
+        for (size_t c = t; c < chunks; c += threads) {
+            size_t end = std::min(data.size(), (c + 1) * STATS_CHUNK);
+            for (size_t i = c * STATS_CHUNK; i < end; ++i) {
+                partial[c].add(data[i].first);
+            }
+        }
+    });
+
+    FeatureStats stats(feature_count);
+    for (const FeatureStats& chunk : partial) {
+        stats.merge(chunk);
+    }
+    return stats;
+}
+
+bool parse_normalization_kind(const std::string& name, NormalizationKind& kind) {
+    if (name == "none") kind = NormalizationKind::None;
+    else if (name == "standard") kind = NormalizationKind::Standard;
+    else if (name == "minmax") kind = NormalizationKind::MinMax;
+    else return false;
+    return true;
+}
+
+Normalizer Normalizer::from_stats(const FeatureStats& stats, NormalizationKind kind) {
+    Normalizer normalizer;
+    if (kind == NormalizationKind::None || stats.count == 0) {
+        return normalizer;
+    }
+    normalizer.scale.resize(stats.feature_count());
+    normalizer.shift.resize(stats.feature_count());
+    for (uint32_t f = 0; f < stats.feature_count(); ++f) {
+        double offset, range;
+        if (kind == NormalizationKind::Standard) {
+            offset = stats.mean[f];
+            range = stats.stddev(f);
+        }
+        else {
+            offset = stats.min[f];
+            range = stats.max[f] - stats.min[f];
+        }
+        double scale = range > 0.0 ? 1.0 / range : 1.0;
+        normalizer.scale[f] = static_cast<float>(scale);
+        normalizer.shift[f] = static_cast<float>(-offset * scale);
+    }
+    return normalizer;
+}
+
+void Normalizer::apply(const std::vector<float>& input, std::vector<float>& out) const {
+    //Missing features are normalized as zeros, matching the statistics and the folded model
+    out.resize(std::max(input.size(), scale.size()));
+    for (size_t f = 0; f < scale.size(); ++f) {
+        float x = f < input.size() ? input[f] : 0.0f;
+        out[f] = x * scale[f] + shift[f];
+    }
+    for (size_t f = scale.size(); f < input.size(); ++f) {
+        out[f] = input[f];
+    }
+}
+
+std::vector<std::pair<std::vector<float>, int>> Normalizer::apply_all(const std::vector<std::pair<std::vector<float>, int>>& data) const {
+    std::vector<std::pair<std::vector<float>, int>> normalized(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        apply(data[i].first, normalized[i].first);
+        normalized[i].second = data[i].second;
+    }
+    return normalized;
+}
+
+void fold_normalizer(compact::Model& model, const Normalizer& normalizer) {
+    const uint32_t features = std::min(model.input_size, static_cast<uint32_t>(normalizer.scale.size()));
+    for (compact::Stage& stage : model.stages) {
+        const size_t columns = stage.sources.size();
+        for (size_t j = 0; j < columns; ++j) {
+            uint32_t source = stage.sources[j];
+            if (source >= features) {
+                continue;
+            }
+            for (uint32_t i = 0; i < stage.outputs(); ++i) {
+                float& weight = stage.weights[i * columns + j];
+                stage.biases[i] += weight * normalizer.shift[source];
+                weight *= normalizer.scale[source];
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+// normalize.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares dataset level input normalization, per-feature statistics gathered in one parallel streaming pass (Welford), the affine normalizer built from them, and folding that normalizer into a compact model so deployed inference does no normalization work.
+
+#ifndef NORMALIZE_H
+#define NORMALIZE_H
+
+#include "compact_model.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Running per-feature statistics, Welford's update per sample and Chan's formula to merge two partial results
+struct FeatureStats {
+    uint64_t count = 0;
+    std::vector<double> mean;
+    std::vector<double> m2;     //Sum of squared differences from the mean
+    std::vector<double> min;
+    std::vector<double> max;
+
+    explicit FeatureStats(uint32_t feature_count = 0);
+    void add(const std::vector<float>& sample);
+    void merge(const FeatureStats& other);
+    //Population standard deviation
+    double stddev(uint32_t feature) const;
+    uint32_t feature_count() const { return static_cast<uint32_t>(mean.size()); }
+};
+
+//Splits the data into fixed size chunks so the result does not depend on how many threads ran, 0 threads uses the whole shared pool
+FeatureStats compute_feature_stats(const std::vector<std::pair<std::vector<float>, int>>& data, uint32_t feature_count,
+    unsigned threads = 0);
+
+enum class NormalizationKind {
+    None = 0,
+    Standard,   //(x - mean) / stddev
+    MinMax      //(x - min) / (max - min), into [0, 1]
+};
+
+bool parse_normalization_kind(const std::string& name, NormalizationKind& kind);
+
+//normalized = x * scale + shift per feature, features past the end of scale pass through unchanged.
+//A constant feature only gets shifted so it never divides by zero.
+struct Normalizer {
+    std::vector<float> scale;
+    std::vector<float> shift;
+
+    static Normalizer from_stats(const FeatureStats& stats, NormalizationKind kind);
+    bool empty() const { return scale.empty(); }
+    //out is resized to cover the input and every normalized feature, reuse it across calls to avoid allocating
+    void apply(const std::vector<float>& input, std::vector<float>& out) const;
+    std::vector<std::pair<std::vector<float>, int>> apply_all(const std::vector<std::pair<std::vector<float>, int>>& data) const;
+};
+
+//Rewrites every stage that reads an input feature so the model takes raw features: w * (a*x + c) = (w*a) * x + w*c
+void fold_normalizer(compact::Model& model, const Normalizer& normalizer);
+
+#endif
@@ -0,0 +1,184 @@
+// optimizer.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the fused optimizer step, one vectorized loop per method over the parameter, gradient and moment buffers.
+
+#include "optimizer.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    //Per step constants, the bias corrections are folded into step_size and second_scale
+    struct Coefficients {
+        float neg_lr;
+        float weight_decay;
+        float clip;
+        float neg_clip;
+        float momentum;
+        float beta1;
+        float beta2;
+        float one_minus_beta1;
+        float one_minus_beta2;
+        float neg_step_size;        //-lr / (1 - beta1^t)
+        float second_scale;         //1 / sqrt(1 - beta2^t)
+        float epsilon;
+        float decay_scale;          //1 - lr * weight_decay, AdamW only
+    };
+
+    //One vector (or, for the tail, one float) of the update, returns the new parameter value. The broadcasts of the
+    //constants are loop invariant once this is inlined.
+    template <optim::Method M, typename V>
+    inline V update_lane(V p, V g, V& m, V& v, const Coefficients& c) {
+        g = simd::min(simd::max(g, simd::set1(c.neg_clip, p)), simd::set1(c.clip, p));
+        if (M != optim::Method::AdamW) {
+            g = simd::fmadd(simd::set1(c.weight_decay, p), p, g);
+        }
+        if (M == optim::Method::Sgd) {
+            return simd::fmadd(simd::set1(c.neg_lr, p), g, p);
+        }
+        if (M == optim::Method::Momentum) {
+            m = simd::fmadd(simd::set1(c.momentum, p), m, g);
+            return simd::fmadd(simd::set1(c.neg_lr, p), m, p);
+        }
+        m = simd::fmadd(simd::set1(c.beta1, p), m, simd::mul(simd::set1(c.one_minus_beta1, p), g));
+        v = simd::fmadd(simd::set1(c.beta2, p), v, simd::mul(simd::set1(c.one_minus_beta2, p), simd::mul(g, g)));
+        V update = simd::div(m, simd::fmadd(simd::sqrt(v), simd::set1(c.second_scale, p), simd::set1(c.epsilon, p)));
+        if (M == optim::Method::AdamW) {
+            p = simd::mul(p, simd::set1(c.decay_scale, p));
+        }
+        return simd::fmadd(simd::set1(c.neg_step_size, p), update, p);
+    }
+
+    template <optim::Method M>
+    void update_range(const Coefficients& c, float* parameters, const float* gradients, float* first, float* second,
+        size_t begin, size_t end) {
+        constexpr bool has_first = M != optim::Method::Sgd;
+        constexpr bool has_second = M == optim::Method::Adam || M == optim::Method::AdamW;
+        size_t i = begin;
+#if !defined(EDGEMLP_SIMD_SCALAR)
+        for (; i + simd::WIDTH <= end; i += simd::WIDTH) {
+            simd::vfloat m = has_first ? simd::load(first + i) : simd::zero();
+            simd::vfloat v = has_second ? simd::load(second + i) : simd::zero();
+            simd::vfloat p = update_lane<M>(simd::load(parameters + i), simd::load(gradients + i), m, v, c);
+            simd::store(parameters + i, p);
+            if (has_first) simd::store(first + i, m);
+            if (has_second) simd::store(second + i, v);
+        }
+#endif
+        for (; i < end; ++i) {
+            float m = has_first ? first[i] : 0.0f;
+            float v = has_second ? second[i] : 0.0f;
+            parameters[i] = update_lane<M>(parameters[i], gradients[i], m, v, c);
+            if (has_first) first[i] = m;
+            if (has_second) second[i] = v;
+        }
+    }
+
+    template <optim::Method M>
+    void update_all(const Coefficients& c, float* parameters, const float* gradients, float* first, float* second,
+        size_t count) {
+        //Rough multiply-adds per value for the cost model, Adam's divide and square root count extra
+        const uint64_t work = M == optim::Method::Adam || M == optim::Method::AdamW ? 16 : 4;
+        parallel::parallel_for(static_cast<uint32_t>(count), work, 16, [&](uint32_t begin, uint32_t end) {
+            update_range<M>(c, parameters, gradients, first, second, begin, end);
+        });
+    }
+}
+
+const char* optim::method_name(Method method) {
+    switch (method) {
+    case Method::Sgd: return "sgd";
+    case Method::Momentum: return "momentum";
+    case Method::Adam: return "adam";
+    case Method::AdamW: return "adamw";
+    }
+    return "unknown";
+}
+
+bool optim::parse_method(const std::string& name, Method& method) {
+    const Method all[] = { Method::Sgd, Method::Momentum, Method::Adam, Method::AdamW };
+    for (Method candidate : all) {
+        if (name == method_name(candidate)) {
+            method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+optim::Optimizer::Optimizer(const Config& config, size_t parameter_count)
+    : config(config), count(parameter_count),
+    first(config.method == Method::Sgd ? 0 : parameter_count),
+    second(config.method == Method::Adam || config.method == Method::AdamW ? parameter_count : 0) {
+    if (config.learning_rate <= 0.0f || config.clip < 0.0f || config.weight_decay < 0.0f) {
+        throw std::invalid_argument("Learning rate must be positive, clip and weight decay not negative");
+    }
+    if (config.beta1 < 0.0f || config.beta1 >= 1.0f || config.beta2 < 0.0f || config.beta2 >= 1.0f) {
+        throw std::invalid_argument("Adam betas must be in [0, 1)");
+    }
+}
+
+void optim::Optimizer::reset() {
+    steps = 0;
+    beta1_power = 1.0;
+    beta2_power = 1.0;
+    std::fill(first.data(), first.data() + first.size(), 0.0f);
+    std::fill(second.data(), second.data() + second.size(), 0.0f);
+}
+
+void optim::Optimizer::restore(uint64_t steps, double beta1_power, double beta2_power, Span<const float> first_moment,
+    Span<const float> second_moment) {
+    if (first_moment.size() != first.size() || second_moment.size() != second.size()) {
+        throw std::invalid_argument("Saved optimizer moments do not match the method and parameter count");
+    }
+    this->steps = steps;
+    this->beta1_power = beta1_power;
+    this->beta2_power = beta2_power;
+    std::copy(first_moment.begin(), first_moment.end(), first.data());
+    std::copy(second_moment.begin(), second_moment.end(), second.data());
+}
+
+void optim::Optimizer::step(Span<float> parameters, Span<const float> gradients) {
+    if (parameters.size() != count || gradients.size() != count) {
+        throw std::invalid_argument("Optimizer buffers do not match the parameter count");
+    }
+    ++steps;
+    Coefficients c;
+    c.neg_lr = -config.learning_rate;
+    c.weight_decay = config.weight_decay;
+    c.clip = config.clip > 0.0f ? config.clip : std::numeric_limits<float>::infinity();
+    c.neg_clip = -c.clip;
+    c.momentum = config.momentum;
+    c.beta1 = config.beta1;
+    c.beta2 = config.beta2;
+    c.one_minus_beta1 = 1.0f - config.beta1;
+    c.one_minus_beta2 = 1.0f - config.beta2;
+    //beta^t kept as running products instead of a pow per step
+    beta1_power *= config.beta1;
+    beta2_power *= config.beta2;
+    c.neg_step_size = static_cast<float>(-config.learning_rate / (1.0 - beta1_power));
+    c.second_scale = static_cast<float>(1.0 / std::sqrt(1.0 - beta2_power));
+    c.epsilon = config.epsilon;
+    c.decay_scale = 1.0f - config.learning_rate * config.weight_decay;
+
+    float* p = parameters.data();
+    const float* g = gradients.data();
+    switch (config.method) {
+    case Method::Sgd:
+        update_all<Method::Sgd>(c, p, g, nullptr, nullptr, count);
+        break;
+    case Method::Momentum:
+        update_all<Method::Momentum>(c, p, g, first.data(), nullptr, count);
+        break;
+    case Method::Adam:
+        update_all<Method::Adam>(c, p, g, first.data(), second.data(), count);
+        break;
+    case Method::AdamW:
+        update_all<Method::AdamW>(c, p, g, first.data(), second.data(), count);
+        break;
+    }
+}
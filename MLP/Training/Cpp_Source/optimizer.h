@@ -0,0 +1,74 @@
+#pragma once
+// optimizer.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the optimizer engine, SGD, momentum, Adam and AdamW applied to a whole network's flat parameter buffer in one fused SIMD pass that also does the gradient clipping and weight decay.
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "arena.h"
+#include <cstdint>
+#include <string>
+
+namespace optim {
+    enum class Method : uint8_t {
+        Sgd = 0,
+        Momentum,
+        Adam,
+        AdamW
+    };
+
+    const char* method_name(Method method);
+    bool parse_method(const std::string& name, Method& method);
+
+    struct Config {
+        Method method = Method::Sgd;
+        float learning_rate = 0.01f;
+        float momentum = 0.9f;          //Momentum
+        float beta1 = 0.9f;             //Adam and AdamW
+        float beta2 = 0.999f;
+        float epsilon = 1e-8f;
+        //Added to the gradient as L2 (weight_decay * parameter), except AdamW which decays the parameter directly
+        float weight_decay = 0.0f;
+        //Every gradient value is clamped to [-clip, clip] before use, like clip_gradient, 0 turns it off
+        float clip = 0.0f;
+    };
+
+    //Holds the moment buffers for one parameter buffer, laid out like it
+    class Optimizer {
+    public:
+        Optimizer(const Config& config, size_t parameter_count);
+
+        //Clip, weight decay, moment updates and the parameter update for every value in one pass. Buffers large
+        //enough to pay for it are split across the shared thread pool.
+        void step(Span<float> parameters, Span<const float> gradients);
+        //Zeroes the moments and the step count
+        void reset();
+
+        const Config& get_config() const { return config; }
+        void set_learning_rate(float learning_rate) { config.learning_rate = learning_rate; }
+        uint64_t get_steps() const { return steps; }
+        //beta^t after get_steps() steps, the Adam bias corrections
+        double get_beta1_power() const { return beta1_power; }
+        double get_beta2_power() const { return beta2_power; }
+        //Momentum velocity or Adam first moment, and the Adam second moment (empty for the methods without them)
+        Span<const float> get_first_moment() const { return first.all(); }
+        Span<const float> get_second_moment() const { return second.all(); }
+        //Continues from a saved state (a checkpoint) instead of zero. Throws std::invalid_argument if the moments are
+        //not the sizes this method and parameter count use.
+        void restore(uint64_t steps, double beta1_power, double beta2_power, Span<const float> first_moment,
+            Span<const float> second_moment);
+
+    private:
+        Config config;
+        size_t count;
+        uint64_t steps = 0;
+        double beta1_power = 1.0;
+        double beta2_power = 1.0;
+        ParameterArena first;
+        ParameterArena second;
+    };
+}
+
+#endif
@@ -0,0 +1,179 @@
+// packed.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the aligned (optionally huge page backed) buffers and the panel packing of weight matrices.
+
+#include "packed.h"
+#include "simd.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+    size_t round_up(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    void* aligned_allocate(size_t bytes) {
+#if defined(_WIN32)
+        void* memory = _aligned_malloc(bytes, packed::ALIGNMENT);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, packed::ALIGNMENT, bytes) != 0) {
+            memory = nullptr;
+        }
+#endif
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void aligned_free(void* memory) {
+#if defined(_WIN32)
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+//AlignedBuffer implementation
+packed::AlignedBuffer::AlignedBuffer() : values(nullptr), count(0), bytes(0), mapped(false) {}
+
+packed::AlignedBuffer::~AlignedBuffer() {
+    release();
+}
+
+packed::AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept
+    : values(other.values), count(other.count), bytes(other.bytes), mapped(other.mapped) {
+    other.values = nullptr;
+    other.count = 0;
+    other.bytes = 0;
+    other.mapped = false;
+}
+
+packed::AlignedBuffer& packed::AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(values, other.values);
+        std::swap(count, other.count);
+        std::swap(bytes, other.bytes);
+        std::swap(mapped, other.mapped);
+    }
+    return *this;
+}
+
+packed::AlignedBuffer::AlignedBuffer(const AlignedBuffer& other) : AlignedBuffer() {
+    *this = other;
+}
+
+packed::AlignedBuffer& packed::AlignedBuffer::operator=(const AlignedBuffer& other) {
+    if (this != &other) {
+        allocate(other.count, other.mapped);
+        if (other.count > 0) {
+            std::memcpy(values, other.values, other.count * sizeof(float));
+        }
+    }
+    return *this;
+}
+
+void packed::AlignedBuffer::allocate(size_t new_count, bool allow_huge_pages) {
+    release();
+    if (new_count == 0) {
+        return;
+    }
+    size_t new_bytes = round_up(new_count * sizeof(float), ALIGNMENT);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    //Large layers get their own mapping rounded to whole huge pages so the kernel can back it with 2MB pages,
+    //fresh anonymous memory is already zero
+    if (allow_huge_pages && new_bytes >= HUGE_PAGE_SIZE) {
+        size_t mapped_bytes = round_up(new_bytes, HUGE_PAGE_SIZE);
+        void* memory = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+            madvise(memory, mapped_bytes, MADV_HUGEPAGE);
+            values = static_cast<float*>(memory);
+            count = new_count;
+            bytes = mapped_bytes;
+            mapped = true;
+            return;
+        }
+    }
+#else
+    (void)allow_huge_pages;
+#endif
+    values = static_cast<float*>(aligned_allocate(new_bytes));
+    std::memset(values, 0, new_bytes);
+    count = new_count;
+    bytes = new_bytes;
+    mapped = false;
+}
+
+void packed::AlignedBuffer::release() {
+    if (values == nullptr) {
+        return;
+    }
+#if defined(__linux__)
+    if (mapped) {
+        munmap(values, bytes);
+    }
+    else {
+        aligned_free(values);
+    }
+#else
+    aligned_free(values);
+#endif
+    values = nullptr;
+    count = 0;
+    bytes = 0;
+    mapped = false;
+}
+
+//PackedMatrix implementation
+packed::PackedMatrix::PackedMatrix()
+    : row_count(0), col_count(0), tile(DEFAULT_ROW_TILE), padded_col_count(0), panel_count(0) {}
+
+void packed::PackedMatrix::pack(const float* weights, uint32_t rows, uint32_t cols, uint32_t row_tile, bool allow_huge_pages) {
+    if (row_tile != 1 && row_tile != 2 && row_tile != 4 && row_tile != 8) {
+        throw std::invalid_argument("Row tile must be 1, 2, 4 or 8");
+    }
+    const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+    row_count = rows;
+    col_count = cols;
+    tile = row_tile;
+    //Columns pad to whole cache lines so every panel, whatever its tile, starts on an ALIGNMENT boundary
+    const size_t line = std::max(static_cast<size_t>(width), ALIGNMENT / sizeof(float));
+    padded_col_count = static_cast<uint32_t>(round_up(cols, line));
+    panel_count = static_cast<uint32_t>((rows + row_tile - 1) / row_tile);
+    buffer.allocate(static_cast<size_t>(panel_count) * tile * padded_col_count, allow_huge_pages);
+
+    const uint32_t chunks = padded_col_count / width;
+    for (uint32_t p = 0; p < panel_count; ++p) {
+        float* panel_data = buffer.data() + static_cast<size_t>(p) * tile * padded_col_count;
+        for (uint32_t r = 0; r < tile && p * tile + r < rows; ++r) {
+            const float* row = weights + static_cast<size_t>(p * tile + r) * cols;
+            for (uint32_t k = 0; k < chunks; ++k) {
+                uint32_t begin = k * width;
+                uint32_t end = std::min(cols, begin + width);
+                if (begin < end) {
+                    std::copy(row + begin, row + end, panel_data + (static_cast<size_t>(k) * tile + r) * width);
+                }
+            }
+        }
+    }
+}
+
+float packed::PackedMatrix::at(uint32_t row, uint32_t col) const {
+    if (row >= row_count || col >= col_count) {
+        throw std::out_of_range("Packed matrix index out of range");
+    }
+    const uint32_t width = static_cast<uint32_t>(simd::WIDTH);
+    uint32_t r = row % tile, k = col / width, lane = col % width;
+    return panel(row / tile)[(static_cast<size_t>(k) * tile + r) * width + lane];
+}
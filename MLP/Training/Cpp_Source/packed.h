@@ -0,0 +1,76 @@
+#pragma once
+// packed.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares prepacked weight matrices, a layer's row-major weights reordered once at load time into 64-byte aligned panels that match the vector width and register tile of the fused kernels.
+
+#ifndef PACKED_H
+#define PACKED_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace packed {
+    constexpr size_t ALIGNMENT = 64;
+    //Buffers at least this large are backed by transparent huge pages where the OS supports it
+    constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+    constexpr uint32_t DEFAULT_ROW_TILE = 8;
+
+    //Float storage aligned to ALIGNMENT and zero filled, copies are deep
+    class AlignedBuffer {
+    public:
+        AlignedBuffer();
+        ~AlignedBuffer();
+        AlignedBuffer(AlignedBuffer&& other) noexcept;
+        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+        AlignedBuffer(const AlignedBuffer& other);
+        AlignedBuffer& operator=(const AlignedBuffer& other);
+
+        void allocate(size_t count, bool allow_huge_pages);
+        void release();
+
+        float* data() { return values; }
+        const float* data() const { return values; }
+        size_t size() const { return count; }
+        bool huge_pages() const { return mapped; }
+
+    private:
+        float* values;
+        size_t count;
+        size_t bytes;
+        bool mapped;
+    };
+
+    //Rows are grouped into panels of row_tile rows. Inside a panel the columns are split into vector-width chunks
+    //and the row_tile chunks of one column range are stored back to back, so a kernel holding row_tile
+    //accumulators walks the panel strictly sequentially. Rows are zero padded to whole tiles and columns to whole cache lines.
+    class PackedMatrix {
+    public:
+        PackedMatrix();
+
+        //row_tile must be 1, 2, 4 or 8, 8 accumulators fit the register file of every supported vector width
+        void pack(const float* weights, uint32_t rows, uint32_t cols, uint32_t row_tile = DEFAULT_ROW_TILE,
+            bool allow_huge_pages = true);
+
+        uint32_t rows() const { return row_count; }
+        uint32_t cols() const { return col_count; }
+        uint32_t row_tile() const { return tile; }
+        uint32_t padded_cols() const { return padded_col_count; }
+        uint32_t panels() const { return panel_count; }
+        const float* panel(uint32_t p) const { return buffer.data() + static_cast<size_t>(p) * tile * padded_col_count; }
+        bool empty() const { return panel_count == 0; }
+        bool huge_pages() const { return buffer.huge_pages(); }
+        //Row-major value, reads back through the packed layout
+        float at(uint32_t row, uint32_t col) const;
+
+    private:
+        AlignedBuffer buffer;
+        uint32_t row_count;
+        uint32_t col_count;
+        uint32_t tile;
+        uint32_t padded_col_count;
+        uint32_t panel_count;
+    };
+}
+
+#endif
@@ -0,0 +1,153 @@
+// perf_counters.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the perf_event_open counter group, on platforms or kernels where counters are not permitted it falls back to wall time only.
+
+#include "perf_counters.h"
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double PerfSample::ipc() const {
+    if (!valid[PERF_CYCLES] || !valid[PERF_INSTRUCTIONS] || values[PERF_CYCLES] <= 0.0) {
+        return 0.0;
+    }
+    return values[PERF_INSTRUCTIONS] / values[PERF_CYCLES];
+}
+
+const char* PerfCounterGroup::event_name(uint32_t event) {
+    switch (event) {
+    case PERF_CYCLES: return "cycles";
+    case PERF_INSTRUCTIONS: return "instructions";
+    case PERF_L1D_MISSES: return "l1d_misses";
+    case PERF_LLC_MISSES: return "llc_misses";
+    case PERF_BRANCH_MISSES: return "branch_misses";
+    default: return "unknown";
+    }
+}
+
+#if defined(__linux__)
+//Helper that fills the perf_event_attr for each of our events
+static void describe_event(uint32_t event, perf_event_attr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    switch (event) {
+    case PERF_CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_L1D_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_LLC_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_BRANCH_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+#endif
+
+PerfCounterGroup::PerfCounterGroup() : leader_fd(-1), open_count(0), start_ns(0) {
+    for (uint32_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        fds[e] = -1;
+        read_order[e] = 0;
+    }
+#if defined(__linux__)
+    for (uint32_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        perf_event_attr attr;
+        describe_event(e, attr);
+        attr.disabled = (e == PERF_CYCLES) ? 1 : 0;
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader_fd, 0));
+        if (fd < 0) {
+            if (e == PERF_CYCLES) {
+                status_message = std::string("perf_event_open unavailable (") + std::strerror(errno) +
+                    "), falling back to wall time only";
+                return;
+            }
+            //Individual events (mostly cache events inside VMs) may be missing, the rest of the group still works
+            continue;
+        }
+        if (e == PERF_CYCLES) {
+            leader_fd = fd;
+        }
+        fds[e] = fd;
+        read_order[open_count++] = e;
+    }
+    status_message = "perf_event_open: " + std::to_string(open_count) + " of " +
+        std::to_string(PERF_EVENT_COUNT) + " counters enabled";
+#else
+    status_message = "perf_event_open not supported on this platform, falling back to wall time only";
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#if defined(__linux__)
+    for (uint32_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (fds[e] >= 0) {
+            close(fds[e]);
+        }
+    }
+#endif
+}
+
+void PerfCounterGroup::start() {
+#if defined(__linux__)
+    if (leader_fd >= 0) {
+        ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    start_ns = now_ns();
+}
+
+PerfSample PerfCounterGroup::stop() {
+    PerfSample sample;
+    int64_t end_ns = now_ns();
+#if defined(__linux__)
+    if (leader_fd >= 0) {
+        ioctl(leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        //Group read layout: nr, time_enabled, time_running, value[nr]
+        uint64_t buffer[3 + PERF_EVENT_COUNT] = {};
+        ssize_t bytes = read(leader_fd, buffer, sizeof(buffer));
+        if (bytes >= static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            uint64_t nr = buffer[0];
+            double enabled = static_cast<double>(buffer[1]);
+            double running = static_cast<double>(buffer[2]);
+            //Scale for multiplexing when the PMU could not keep the whole group scheduled
+            double scale = (running > 0.0) ? enabled / running : 0.0;
+            for (uint64_t i = 0; i < nr && i < open_count; ++i) {
+                uint32_t e = read_order[i];
+                sample.values[e] = static_cast<double>(buffer[3 + i]) * scale;
+                sample.valid[e] = running > 0.0;
+            }
+        }
+    }
+#endif
+    sample.wall_ns = static_cast<double>(end_ns - start_ns);
+    return sample;
+}
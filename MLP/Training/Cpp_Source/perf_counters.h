@@ -0,0 +1,75 @@
+#pragma once
+// perf_counters.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares a small wrapper around Linux perf_event_open counter groups so the dense kernels can be measured in cycles, instructions, cache and branch misses instead of only wall time.
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+//Hardware events opened in one group, the first one (cycles) is the group leader
+enum PerfEvent : uint32_t {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_COUNT
+};
+
+//One set of counter deltas, events that could not be opened are left at zero and flagged invalid
+struct PerfSample {
+    double values[PERF_EVENT_COUNT] = {};
+    bool valid[PERF_EVENT_COUNT] = {};
+    double wall_ns = 0.0;
+
+    double ipc() const;
+};
+
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    //True when at least the cycle counter could be opened, otherwise only wall time is measured
+    bool available() const { return leader_fd >= 0; }
+    const std::string& status() const { return status_message; }
+
+    void start();
+    PerfSample stop();
+
+    static const char* event_name(uint32_t event);
+
+private:
+    int leader_fd;
+    int fds[PERF_EVENT_COUNT];
+    uint32_t read_order[PERF_EVENT_COUNT];
+    uint32_t open_count;
+    int64_t start_ns;
+    std::string status_message;
+};
+
+//Per-call counter deltas averaged over a number of repetitions of fn
+template <typename Fn>
+PerfSample measure_per_call(PerfCounterGroup& group, uint32_t repetitions, Fn&& fn) {
+    group.start();
+    for (uint32_t r = 0; r < repetitions; ++r) {
+        fn();
+    }
+    PerfSample total = group.stop();
+    if (repetitions > 1) {
+        for (uint32_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+            total.values[e] /= repetitions;
+        }
+        total.wall_ns /= repetitions;
+    }
+    return total;
+}
+
+#endif
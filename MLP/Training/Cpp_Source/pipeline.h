@@ -0,0 +1,69 @@
+#pragma once
+// pipeline.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header defines the statically dispatched layer pipeline, a fixed chain of concrete layer types held in a tuple so every per-sample forward and update call is resolved at compile time instead of through Layer's vtable.
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace pipeline {
+    //Chain of layers known by their concrete types. Each call is qualified with that type (layer.T::forward), which is
+    //never a virtual call, so the compiler sees one straight line of direct calls it can inline and schedule across.
+    //The layers are referenced, not owned.
+    template <typename... Layers>
+    class StaticPipeline {
+    public:
+        static constexpr size_t SIZE = sizeof...(Layers);
+        static_assert(SIZE > 0, "A pipeline needs at least one layer");
+
+        explicit StaticPipeline(Layers&... layers) : layers(layers...) {}
+
+        //The first layer reads input and writes scratch, the middle layers run in place on scratch (they cache their
+        //input, like MLP::forward has always relied on) and the last layer writes output
+        void forward(const float* input, float* scratch, float* output) const {
+            forward_stages(input, scratch, output, std::make_index_sequence<SIZE>());
+        }
+
+        //Last layer first, the order the training loop has always used
+        void update_weights(float error, float learning_rate) {
+            update_stages(error, learning_rate, std::make_index_sequence<SIZE>());
+        }
+
+        template <size_t I>
+        typename std::tuple_element<I, std::tuple<Layers...>>::type& layer() const {
+            return std::get<I>(layers);
+        }
+
+    private:
+        std::tuple<Layers&...> layers;
+
+        template <size_t I>
+        void forward_stage(const float* input, float* scratch, float* output) const {
+            using Stage = typename std::tuple_element<I, std::tuple<Layers...>>::type;
+            std::get<I>(layers).Stage::forward(I == 0 ? input : scratch, I + 1 == SIZE ? output : scratch);
+        }
+
+        template <size_t... I>
+        void forward_stages(const float* input, float* scratch, float* output, std::index_sequence<I...>) const {
+            (forward_stage<I>(input, scratch, output), ...);
+        }
+
+        template <size_t I>
+        void update_stage(float error, float learning_rate) {
+            using Stage = typename std::tuple_element<I, std::tuple<Layers...>>::type;
+            std::get<I>(layers).Stage::update_weights(error, learning_rate);
+        }
+
+        template <size_t... I>
+        void update_stages(float error, float learning_rate, std::index_sequence<I...>) {
+            (update_stage<SIZE - 1 - I>(error, learning_rate), ...);
+        }
+    };
+}
+
+#endif
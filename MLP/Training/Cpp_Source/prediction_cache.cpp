@@ -0,0 +1,317 @@
+// prediction_cache.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the prediction cache, the input keys and their hash, the seqlock read of a bucket, the locked insert with CLOCK eviction, the weight generation check, and the sampled miss timing behind the latency saved.
+
+#include "prediction_cache.h"
+#include "MLP.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t CHUNK = 256;                 //Misses per forward_batch in predict_batch
+    constexpr double MAX_CELL = 1073741824.0;       //2^30, quantized cells past it are not keyed
+
+    uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+}
+
+namespace cache {
+    PredictionCache::PredictionCache(const MLP& mlp, const Config& config)
+        : mlp(mlp), quantum(config.quantum), shard_count(config.shards), generation(1), invalidations(0), uncached(0),
+        timed_misses(0), miss_nanoseconds(0) {
+        if (config.shards == 0) {
+            throw std::invalid_argument("Prediction cache needs at least one shard");
+        }
+        if (!(config.quantum >= 0.0f) || !std::isfinite(config.quantum)) {
+            throw std::invalid_argument("Quantum must be finite and not negative");
+        }
+        //Whole buckets, a power of two per shard so a mask picks one
+        const size_t bucket_bytes = WAYS * sizeof(Entry) + sizeof(uint8_t);
+        const size_t per_shard = config.memory_cap / shard_count / bucket_bytes;
+        size_t buckets = 1;
+        while (buckets * 2 <= per_shard) buckets *= 2;
+        bucket_mask = static_cast<uint32_t>(buckets - 1);
+        shards.reset(new Shard[shard_count]);
+        for (uint32_t s = 0; s < shard_count; ++s) {
+            shards[s].entries.reset(new Entry[buckets * WAYS]);
+            shards[s].hands.reset(new uint8_t[buckets]());
+        }
+        mlp.pack_network(INPUT_SIZE, network);
+        hidden_version.store(mlp.get_hidden_layer1().get_version());
+        output_version.store(mlp.get_output_layer().get_version());
+    }
+
+    uint32_t PredictionCache::refresh() {
+        const uint64_t hidden = mlp.get_hidden_layer1().get_version();
+        const uint64_t output = mlp.get_output_layer().get_version();
+        if (hidden == hidden_version.load(std::memory_order_acquire) && output == output_version.load(std::memory_order_acquire)) {
+            return generation.load(std::memory_order_acquire);
+        }
+        std::lock_guard<std::mutex> lock(refresh_mutex);
+        if (hidden != hidden_version.load() || output != output_version.load()) {
+            mlp.pack_network(INPUT_SIZE, network);
+            //Entries of older generations read as empty, 0 is kept for never filled
+            uint32_t next = generation.load() + 1;
+            generation.store(next == 0 ? 1 : next);
+            hidden_version.store(hidden, std::memory_order_release);
+            output_version.store(output, std::memory_order_release);
+            invalidations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return generation.load(std::memory_order_acquire);
+    }
+
+    bool PredictionCache::make_key(const std::vector<float>& input, Key& key) const {
+        if (input.empty() || input.size() > 10) {
+            throw std::invalid_argument("Input size must be between 1 and 10");
+        }
+        key.length = static_cast<uint32_t>(input.size());
+        std::fill(key.features, key.features + INPUT_SIZE, 0.0f);
+        bool keyed = true;
+        for (uint32_t k = 0; k < key.length; ++k) {
+            float value = input[k];
+            if (quantum == 0.0f) {
+                std::memcpy(&key.words[k], &value, sizeof(value));
+            }
+            else {
+                const double cell = std::nearbyint(static_cast<double>(value) / quantum);
+                if (std::abs(cell) <= MAX_CELL) {
+                    key.words[k] = static_cast<uint32_t>(static_cast<int32_t>(cell));
+                    value = static_cast<float>(cell * quantum);
+                }
+                else {
+                    keyed = false;
+                }
+            }
+            if (k < INPUT_SIZE) {
+                key.features[k] = value;
+            }
+        }
+        if (!keyed) {
+            //Scored as given
+            std::copy(input.begin(), input.begin() + std::min<size_t>(input.size(), INPUT_SIZE), key.features);
+            return false;
+        }
+        uint64_t h = 0x9e3779b97f4a7c15ULL ^ key.length;
+        for (uint32_t k = 0; k < key.length; ++k) {
+            h = (h ^ key.words[k]) * 0x100000001b3ULL;
+            h ^= h >> 29;
+        }
+        key.hash = mix(h);
+        return true;
+    }
+
+    bool PredictionCache::lookup(const Key& key, uint32_t current, float& score) {
+        Entry* bucket = bucket_of(shard_of(key.hash), key.hash);
+        for (uint32_t w = 0; w < WAYS; ++w) {
+            Entry& entry = bucket[w];
+            const uint32_t before = entry.sequence.load(std::memory_order_acquire);
+            //A way being rewritten is passed over rather than waited for, the worst case is a spurious miss
+            if ((before & 1) || entry.hash.load(std::memory_order_relaxed) != key.hash
+                || entry.generation.load(std::memory_order_relaxed) != current
+                || entry.length.load(std::memory_order_relaxed) != key.length) {
+                continue;
+            }
+            bool same = true;
+            for (uint32_t k = 0; k < key.length; ++k) {
+                same = same && entry.key[k].load(std::memory_order_relaxed) == key.words[k];
+            }
+            const float cached = entry.score.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!same || entry.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            //Only written when clear so hot entries do not bounce their cache line between readers
+            if (!entry.referenced.load(std::memory_order_relaxed)) {
+                entry.referenced.store(1, std::memory_order_relaxed);
+            }
+            score = cached;
+            return true;
+        }
+        return false;
+    }
+
+    void PredictionCache::insert(const Key& key, uint32_t current, float score) {
+        Shard& shard = shard_of(key.hash);
+        const uint64_t b = key.hash & bucket_mask;
+        Entry* bucket = shard.entries.get() + b * WAYS;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        //Another thread's copy of the same key, then a free or stale way, then the CLOCK victim
+        uint32_t target = WAYS;
+        for (uint32_t w = 0; w < WAYS && target == WAYS; ++w) {
+            Entry& entry = bucket[w];
+            if (entry.generation.load(std::memory_order_relaxed) != current || entry.hash.load(std::memory_order_relaxed) != key.hash
+                || entry.length.load(std::memory_order_relaxed) != key.length) {
+                continue;
+            }
+            bool same = true;
+            for (uint32_t k = 0; k < key.length; ++k) {
+                same = same && entry.key[k].load(std::memory_order_relaxed) == key.words[k];
+            }
+            if (same) target = w;
+        }
+        for (uint32_t w = 0; w < WAYS && target == WAYS; ++w) {
+            if (bucket[w].generation.load(std::memory_order_relaxed) != current) target = w;
+        }
+        if (target == WAYS) {
+            //Second chance: the hand clears referenced bits until it reaches an entry no hit touched since its last pass
+            uint8_t hand = shard.hands[b];
+            while (bucket[hand].referenced.load(std::memory_order_relaxed)) {
+                bucket[hand].referenced.store(0, std::memory_order_relaxed);
+                hand = static_cast<uint8_t>((hand + 1) % WAYS);
+            }
+            target = hand;
+            shard.hands[b] = static_cast<uint8_t>((hand + 1) % WAYS);
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Entry& entry = bucket[target];
+        const uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+        entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.hash.store(key.hash, std::memory_order_relaxed);
+        entry.length.store(key.length, std::memory_order_relaxed);
+        for (uint32_t k = 0; k < key.length; ++k) {
+            entry.key[k].store(key.words[k], std::memory_order_relaxed);
+        }
+        entry.score.store(score, std::memory_order_relaxed);
+        entry.generation.store(current, std::memory_order_relaxed);
+        entry.referenced.store(0, std::memory_order_relaxed);
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    float PredictionCache::score_timed(const Key& key, bool timed) {
+        float result[fused::SmallNetwork::MAX_OUTPUTS];
+        if (!timed) {
+            network.forward(key.features, result);
+            return result[0];
+        }
+        const auto start = std::chrono::steady_clock::now();
+        network.forward(key.features, result);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        miss_nanoseconds.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            std::memory_order_relaxed);
+        timed_misses.fetch_add(1, std::memory_order_relaxed);
+        return result[0];
+    }
+
+    float PredictionCache::predict(const std::vector<float>& input) {
+        const uint32_t current = refresh();
+        Key key;
+        if (!make_key(input, key)) {
+            uncached.fetch_add(1, std::memory_order_relaxed);
+            return score_timed(key, false);
+        }
+        Shard& shard = shard_of(key.hash);
+        const uint64_t n = shard.lookups.fetch_add(1, std::memory_order_relaxed);
+        float score;
+        if (lookup(key, current, score)) {
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return score;
+        }
+        score = score_timed(key, (n & 15) == 0);
+        insert(key, current, score);
+        return score;
+    }
+
+    std::vector<float> PredictionCache::predict_batch(const std::vector<std::pair<std::vector<float>, int>>& samples) {
+        //Sizes first, so a bad input throws before anything is counted
+        for (const auto& sample : samples) {
+            if (sample.first.empty() || sample.first.size() > 10) {
+                throw std::invalid_argument("Input size must be between 1 and 10");
+            }
+        }
+        const uint32_t current = refresh();
+        std::vector<float> results(samples.size());
+        //A chunk of samples at a time: keys and lookups, then the misses packed feature major (feature j of the m-th at
+        //batch[j * CHUNK + m]) through forward_batch, then their inserts
+        std::vector<Key> keys(CHUNK);
+        std::vector<uint8_t> keyed(CHUNK);
+        std::vector<float> batch(static_cast<size_t>(INPUT_SIZE) * CHUNK);
+        uint32_t misses[CHUNK];
+        float scores[CHUNK];
+        for (size_t begin = 0; begin < samples.size(); begin += CHUNK) {
+            const uint32_t count = static_cast<uint32_t>(std::min<size_t>(CHUNK, samples.size() - begin));
+            uint32_t missed = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                Key& key = keys[i];
+                keyed[i] = make_key(samples[begin + i].first, key) ? 1 : 0;
+                if (!keyed[i]) {
+                    uncached.fetch_add(1, std::memory_order_relaxed);
+                    misses[missed++] = i;
+                    continue;
+                }
+                Shard& shard = shard_of(key.hash);
+                shard.lookups.fetch_add(1, std::memory_order_relaxed);
+                if (lookup(key, current, results[begin + i])) {
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    misses[missed++] = i;
+                }
+            }
+            if (missed == 0) {
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t m = 0; m < missed; ++m) {
+                for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+                    batch[j * CHUNK + m] = keys[misses[m]].features[j];
+                }
+            }
+            network.forward_batch(batch.data(), CHUNK, missed, scores);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            miss_nanoseconds.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+            timed_misses.fetch_add(missed, std::memory_order_relaxed);
+            //Repeats inside a chunk find the first copy already there and overwrite it with the same score
+            for (uint32_t m = 0; m < missed; ++m) {
+                const uint32_t i = misses[m];
+                results[begin + i] = scores[m];
+                if (keyed[i]) {
+                    insert(keys[i], current, scores[m]);
+                }
+            }
+        }
+        return results;
+    }
+
+    void PredictionCache::clear() {
+        std::lock_guard<std::mutex> lock(refresh_mutex);
+        uint32_t next = generation.load() + 1;
+        generation.store(next == 0 ? 1 : next, std::memory_order_release);
+    }
+
+    Stats PredictionCache::get_stats() const {
+        Stats stats;
+        const uint32_t current = generation.load(std::memory_order_acquire);
+        const size_t buckets = static_cast<size_t>(bucket_mask) + 1;
+        for (uint32_t s = 0; s < shard_count; ++s) {
+            const Shard& shard = shards[s];
+            stats.lookups += shard.lookups.load(std::memory_order_relaxed);
+            stats.hits += shard.hits.load(std::memory_order_relaxed);
+            stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+            for (size_t e = 0; e < buckets * WAYS; ++e) {
+                stats.entries += shard.entries[e].generation.load(std::memory_order_relaxed) == current ? 1 : 0;
+            }
+        }
+        stats.lookups += uncached.load(std::memory_order_relaxed);
+        stats.misses = stats.lookups - stats.hits;
+        stats.invalidations = invalidations.load(std::memory_order_relaxed);
+        stats.hit_rate = stats.lookups == 0 ? 0.0 : static_cast<double>(stats.hits) / static_cast<double>(stats.lookups);
+        stats.memory_bytes = shard_count * buckets * (WAYS * sizeof(Entry) + sizeof(uint8_t));
+        const uint64_t timed = timed_misses.load(std::memory_order_relaxed);
+        stats.miss_nanoseconds = timed == 0 ? 0.0 : static_cast<double>(miss_nanoseconds.load(std::memory_order_relaxed)) / static_cast<double>(timed);
+        stats.saved_seconds = static_cast<double>(stats.hits) * stats.miss_nanoseconds * 1e-9;
+        return stats;
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+// prediction_cache.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the prediction cache, an optional result cache in front of the fused predict kernel for traffic that scores the same inputs again and again. Keys are the exact input values or their quantization, the table is split into shards of small buckets with CLOCK eviction inside each bucket under a fixed memory cap, lookups take no lock, and a weight change anywhere in the MLP drops every cached score at once.
+
+#ifndef PREDICTION_CACHE_H
+#define PREDICTION_CACHE_H
+
+#include "fused.h"
+#include "layers.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace cache {
+    struct Config {
+        //Insert locks are per shard, more shards let more threads fill the cache at once
+        uint32_t shards = 16;
+        //Bytes of table over all shards, rounded down to whole buckets (at least one per shard)
+        size_t memory_cap = size_t(4) << 20;
+        //0 keys on the exact input values. Above 0 each value is rounded to the nearest multiple of quantum, inputs in
+        //one cell share an entry and are scored as the cell's center so the cached score does not depend on which came first.
+        float quantum = 0.0f;
+    };
+
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;                //Scored by the network, including inputs that cannot be keyed
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;         //Weight changes noticed, each drops the whole cache
+        double hit_rate = 0.0;
+        size_t memory_bytes = 0;
+        uint64_t entries = 0;               //Live entries for the current weights
+        double miss_nanoseconds = 0.0;      //Mean network time per miss, sampled
+        double saved_seconds = 0.0;         //hits * miss_nanoseconds, the network time the hits did not spend
+    };
+
+    class PredictionCache {
+    public:
+        //Scores with the MLP's current weights and follows them, any later change to the hidden or output layer (training,
+        //load_parameters, mark_parameters_changed) is noticed on the next call. Throws std::invalid_argument for no shards
+        //or a negative or non-finite quantum.
+        explicit PredictionCache(const MLP& mlp, const Config& config = Config());
+        PredictionCache(const PredictionCache&) = delete;
+        PredictionCache& operator=(const PredictionCache&) = delete;
+
+        //Same input rules and result as MLP::predict (for quantum 0). Safe from any number of threads at once, as long as
+        //the weights do not change while calls are running.
+        float predict(const std::vector<float>& input);
+        //predict for every sample (labels are ignored), the misses are scored together after the lookups
+        std::vector<float> predict_batch(const std::vector<std::pair<std::vector<float>, int>>& samples);
+        //Drops every entry, the counters carry on
+        void clear();
+        Stats get_stats() const;
+
+    private:
+        static constexpr uint32_t WAYS = 8;
+        static constexpr uint32_t KEY_WORDS = 10;
+
+        //Written under the shard's lock, read without one: sequence is odd while a writer is inside, and a reader that
+        //sees the same even sequence before and after copying the fields has a consistent copy
+        struct Entry {
+            std::atomic<uint32_t> sequence{ 0 };
+            std::atomic<uint32_t> generation{ 0 };     //0 is empty, else the weights' generation when it was filled
+            std::atomic<uint64_t> hash{ 0 };
+            std::atomic<uint32_t> length{ 0 };
+            std::atomic<uint32_t> key[KEY_WORDS];
+            std::atomic<float> score{ 0.0f };
+            std::atomic<uint8_t> referenced{ 0 };      //CLOCK bit, set by hits and cleared as the hand passes
+        };
+
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::unique_ptr<Entry[]> entries;           //[bucket][WAYS]
+            std::unique_ptr<uint8_t[]> hands;           //CLOCK hand per bucket, under mutex
+            std::atomic<uint64_t> lookups{ 0 };
+            std::atomic<uint64_t> hits{ 0 };
+            std::atomic<uint64_t> evictions{ 0 };
+        };
+
+        //A keyed input, features are what the network is given
+        struct Key {
+            uint64_t hash;
+            uint32_t length;
+            uint32_t words[KEY_WORDS];
+            float features[INPUT_SIZE];
+        };
+
+        const MLP& mlp;
+        fused::SmallNetwork network;
+        float quantum;
+        uint32_t shard_count;
+        uint32_t bucket_mask;                           //Buckets per shard - 1
+        std::unique_ptr<Shard[]> shards;
+        std::mutex refresh_mutex;
+        std::atomic<uint32_t> generation;
+        std::atomic<uint64_t> hidden_version;
+        std::atomic<uint64_t> output_version;
+        std::atomic<uint64_t> invalidations;
+        std::atomic<uint64_t> uncached;                 //Inputs make_key could not key
+        //Every 16th lookup that misses is timed, batches count their whole network time over their misses
+        std::atomic<uint64_t> timed_misses;
+        std::atomic<uint64_t> miss_nanoseconds;
+
+        //Repacks the network and moves to a new generation if the weights changed since the last call
+        uint32_t refresh();
+        //False for inputs that cannot be keyed (quantized values out of int range), which skip the cache
+        bool make_key(const std::vector<float>& input, Key& key) const;
+        bool lookup(const Key& key, uint32_t current, float& score);
+        void insert(const Key& key, uint32_t current, float score);
+        float score_timed(const Key& key, bool timed);
+        Shard& shard_of(uint64_t hash) const { return shards[(hash >> 32) % shard_count]; }
+        Entry* bucket_of(Shard& shard, uint64_t hash) const { return shard.entries.get() + (hash & bucket_mask) * WAYS; }
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+// range_scorer.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the integer range scoring engine, each task walks its share of the range a block at a time, writes the block's features into its own feature major buffer, runs SmallNetwork::forward_batch over it and hands the scores on, no per-number vectors or calls.
+
+#include "range_scorer.h"
+#include "MLP.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t FEATURES = 2;                //value, even flag, the features read_data_from_file builds
+    constexpr uint64_t WORK_PER_NUMBER = 4 * 64;    //About one multiply-add per hidden weight
+    //Blocks per parallel_for, keeps the block count inside uint32 for ranges of any length
+    constexpr uint64_t SEGMENT_BLOCKS = uint64_t(1) << 24;
+}
+
+namespace range {
+    bool PositiveBitmap::test(uint64_t number) const {
+        if (number < begin || number >= end) {
+            return false;
+        }
+        const uint64_t bit = number - begin;
+        return (words[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    uint64_t PositiveBitmap::count() const {
+        uint64_t total = 0;
+        for (uint64_t word : words) {
+            total += static_cast<uint64_t>(__builtin_popcountll(word));
+        }
+        return total;
+    }
+
+    std::vector<uint64_t> PositiveBitmap::to_numbers() const {
+        std::vector<uint64_t> numbers;
+        numbers.reserve(count());
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word) {
+                numbers.push_back(begin + w * 64 + static_cast<uint64_t>(__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+        return numbers;
+    }
+
+    RangeScorer::RangeScorer(const MLP& mlp, const Normalizer& normalizer) {
+        mlp.pack_network(FEATURES, network);
+        if (network.get_output_size() != 1) {
+            throw std::invalid_argument("Range scoring needs a single output model");
+        }
+        for (uint32_t j = 0; j < FEATURES && j < normalizer.scale.size(); ++j) {
+            scale[j] = normalizer.scale[j];
+            shift[j] = normalizer.shift[j];
+        }
+    }
+
+    void RangeScorer::score_block(uint64_t first, uint32_t count, float* features, float* scores) const {
+        float* value = features;
+        float* even = features + BLOCK;
+        //Parity alternates, so both normalized flag values are worked out once
+        const float even_value = 1.0f * scale[1] + shift[1];
+        const float odd_value = shift[1];
+        const float flags[2] = { (first & 1) ? odd_value : even_value, (first & 1) ? even_value : odd_value };
+        for (uint32_t i = 0; i < count; ++i) {
+            value[i] = static_cast<float>(first + i) * scale[0] + shift[0];
+            even[i] = flags[i & 1];
+        }
+        network.forward_batch(features, BLOCK, count, scores);
+    }
+
+    template <typename Body>
+    void RangeScorer::for_each_block(uint64_t begin, uint64_t end, Body body) const {
+        if (begin > end) {
+            throw std::invalid_argument("Range begin is past its end");
+        }
+        const uint64_t blocks = (end - begin + BLOCK - 1) / BLOCK;
+        for (uint64_t segment = 0; segment < blocks; segment += SEGMENT_BLOCKS) {
+            const uint32_t segment_blocks = static_cast<uint32_t>(std::min(SEGMENT_BLOCKS, blocks - segment));
+            parallel::parallel_for(segment_blocks, WORK_PER_NUMBER * BLOCK, 1, [&](uint32_t first_block, uint32_t last_block) {
+                std::vector<float> features(static_cast<size_t>(FEATURES) * BLOCK);
+                std::vector<float> scores(BLOCK);
+                for (uint32_t b = first_block; b < last_block; ++b) {
+                    const uint64_t first = begin + (segment + b) * BLOCK;
+                    const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(BLOCK, end - first));
+                    score_block(first, count, features.data(), scores.data());
+                    body(first, scores.data(), count);
+                }
+            });
+        }
+    }
+
+    void RangeScorer::score_range(uint64_t begin, uint64_t end, const ScoreCallback& callback) const {
+        for_each_block(begin, end, [&](uint64_t first, const float* scores, uint32_t count) {
+            callback(first, scores, count);
+        });
+    }
+
+    PositiveBitmap RangeScorer::positives(uint64_t begin, uint64_t end, float threshold) const {
+        if (begin > end) {
+            throw std::invalid_argument("Range begin is past its end");
+        }
+        if ((end - begin) / 64 >= std::numeric_limits<size_t>::max() / sizeof(uint64_t)) {
+            throw std::invalid_argument("Range too long for a bitmap");
+        }
+        PositiveBitmap bitmap;
+        bitmap.begin = begin;
+        bitmap.end = end;
+        bitmap.words.assign(static_cast<size_t>((end - begin + 63) / 64), 0);
+        //Blocks start at multiples of BLOCK from begin, so every task owns whole words
+        for_each_block(begin, end, [&](uint64_t first, const float* scores, uint32_t count) {
+            uint64_t* words = bitmap.words.data() + (first - begin) / 64;
+            for (uint32_t w = 0; w * 64 < count; ++w) {
+                const uint32_t lanes = std::min(64u, count - w * 64);
+                const float* block = scores + w * 64;
+                uint64_t word = 0;
+                for (uint32_t i = 0; i < lanes; ++i) {
+                    word |= static_cast<uint64_t>(block[i] > threshold) << i;
+                }
+                words[w] = word;
+            }
+        });
+        return bitmap;
+    }
+}
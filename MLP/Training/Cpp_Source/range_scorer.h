@@ -0,0 +1,59 @@
+#pragma once
+// range_scorer.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the integer range scoring engine, it runs the number classifier over a contiguous range of integers by generating the features (value and even flag, the ones read_data_from_file builds) straight into feature major batch buffers and scoring them with the batched fused kernel, split across the thread pool, with results streamed to a callback or collected as a bitmap of positives.
+
+#ifndef RANGE_SCORER_H
+#define RANGE_SCORER_H
+
+#include "fused.h"
+#include "normalize.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class MLP;
+
+namespace range {
+    //Numbers per batch buffer, a multiple of 64 so bitmap words never straddle two tasks
+    constexpr uint32_t BLOCK = 1024;
+
+    //scores[i] is the model output for first + i. Blocks arrive from several threads at once and in no
+    //particular order, the buffer is only valid during the call.
+    using ScoreCallback = std::function<void(uint64_t first, const float* scores, uint32_t count)>;
+
+    //One bit per number of [begin, end), set where the score is above the threshold. 32 times smaller than the scores.
+    struct PositiveBitmap {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        std::vector<uint64_t> words;
+
+        bool test(uint64_t number) const;
+        uint64_t count() const;
+        //Every positive number in increasing order
+        std::vector<uint64_t> to_numbers() const;
+    };
+
+    class RangeScorer {
+    public:
+        //Snapshot of the MLP's current weights. normalizer is the one the model was trained with, if any.
+        explicit RangeScorer(const MLP& mlp, const Normalizer& normalizer = Normalizer());
+
+        //Scores every number of [begin, end), throws std::invalid_argument when begin > end. The callback must not throw.
+        void score_range(uint64_t begin, uint64_t end, const ScoreCallback& callback) const;
+        PositiveBitmap positives(uint64_t begin, uint64_t end, float threshold = 0.5f) const;
+
+    private:
+        fused::SmallNetwork network;
+        float scale[2] = { 1.0f, 1.0f };
+        float shift[2] = { 0.0f, 0.0f };
+
+        //Runs body(first, scores, count) for every block, the blocks of one task are contiguous and in order
+        template <typename Body>
+        void for_each_block(uint64_t begin, uint64_t end, Body body) const;
+        void score_block(uint64_t first, uint32_t count, float* features, float* scores) const;
+    };
+}
+
+#endif
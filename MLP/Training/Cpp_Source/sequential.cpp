@@ -0,0 +1,381 @@
+// sequential.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the runtime topology network, the spec parser, the forward pass on the fused kernels, backpropagation into the flat gradient arena and the flat binary save format.
+
+#include "sequential.h"
+#include "activate.h"
+#include "fused.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr float LEAKY_ALPHA = 0.01f;
+    constexpr float LOG_EPSILON = 1e-7f;
+
+    const char FILE_MAGIC[4] = { 'E', 'M', 'L', 'S' };
+    constexpr uint32_t FILE_VERSION = 1;
+
+    //Derivative of the activation written in terms of its output, which is what backprop has cached
+    inline float derivative(sequential::Activation activation, float out) {
+        switch (activation) {
+        case sequential::Activation::Relu: return out > 0.0f ? 1.0f : 0.0f;
+        case sequential::Activation::LeakyRelu: return out > 0.0f ? 1.0f : LEAKY_ALPHA;
+        case sequential::Activation::Sigmoid: return out * (1.0f - out);
+        case sequential::Activation::Tanh: return 1.0f - out * out;
+        default: return 1.0f;
+        }
+    }
+}
+
+const char* sequential::activation_name(Activation activation) {
+    switch (activation) {
+    case Activation::Linear: return "linear";
+    case Activation::Relu: return "relu";
+    case Activation::LeakyRelu: return "leaky_relu";
+    case Activation::Sigmoid: return "sigmoid";
+    case Activation::Tanh: return "tanh";
+    }
+    return "unknown";
+}
+
+bool sequential::parse_activation(const std::string& name, Activation& activation) {
+    const Activation all[] = { Activation::Linear, Activation::Relu, Activation::LeakyRelu, Activation::Sigmoid, Activation::Tanh };
+    for (Activation candidate : all) {
+        if (name == activation_name(candidate)) {
+            activation = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+//Topology implementation
+sequential::Topology sequential::Topology::parse(const std::string& text) {
+    Topology topology;
+    std::stringstream ss(text);
+    std::string item;
+    bool first = true;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        size_t colon = item.find(':');
+        std::string units = item.substr(0, colon);
+        unsigned long value = 0;
+        try {
+            size_t used = 0;
+            value = std::stoul(units, &used);
+            if (used != units.size()) {
+                throw std::invalid_argument(units);
+            }
+        }
+        catch (const std::exception&) {
+            throw std::invalid_argument("Invalid layer width in topology: " + item);
+        }
+        if (value == 0 || value > UINT32_MAX) {
+            throw std::invalid_argument("Layer widths must be positive: " + item);
+        }
+        if (first) {
+            if (colon != std::string::npos) {
+                throw std::invalid_argument("The input width takes no activation: " + item);
+            }
+            topology.inputs = static_cast<uint32_t>(value);
+            first = false;
+            continue;
+        }
+        LayerSpec spec;
+        spec.units = static_cast<uint32_t>(value);
+        if (colon != std::string::npos && !parse_activation(item.substr(colon + 1), spec.activation)) {
+            throw std::invalid_argument("Unknown activation in topology: " + item);
+        }
+        topology.layers.push_back(spec);
+    }
+    if (topology.layers.empty()) {
+        throw std::invalid_argument("Topology needs an input width and at least one layer");
+    }
+    return topology;
+}
+
+std::string sequential::Topology::to_string() const {
+    std::string text = std::to_string(inputs);
+    for (const auto& layer : layers) {
+        text += "," + std::to_string(layer.units) + ":" + activation_name(layer.activation);
+    }
+    return text;
+}
+
+size_t sequential::Topology::weight_count() const {
+    size_t count = 0;
+    uint32_t fan_in = inputs;
+    for (const auto& layer : layers) {
+        count += static_cast<size_t>(fan_in) * layer.units;
+        fan_in = layer.units;
+    }
+    return count;
+}
+
+size_t sequential::Topology::bias_count() const {
+    size_t count = 0;
+    for (const auto& layer : layers) {
+        count += layer.units;
+    }
+    return count;
+}
+
+uint32_t sequential::Topology::widest() const {
+    uint32_t width = inputs;
+    for (const auto& layer : layers) {
+        width = std::max(width, layer.units);
+    }
+    return width;
+}
+
+//Sequential implementation
+sequential::Sequential::Sequential(const Topology& topology, uint32_t seed)
+    : topology(topology),
+    parameters(topology.weight_count() + topology.bias_count()),
+    gradients(topology.weight_count() + topology.bias_count()) {
+
+    if (topology.inputs == 0 || topology.layers.empty()) {
+        throw std::invalid_argument("Topology needs an input width and at least one layer");
+    }
+    bind_views();
+    std::mt19937 rng(seed);
+    uint32_t fan_in = topology.inputs;
+    for (size_t l = 0; l < topology.layers.size(); ++l) {
+        float limit = std::sqrt(6.0f / (fan_in + topology.layers[l].units));
+        std::uniform_real_distribution<float> dist(-limit, limit);
+        for (auto& w : weight_views[l]) {
+            w = dist(rng);
+        }
+        fan_in = topology.layers[l].units;
+    }
+}
+
+sequential::Sequential::Sequential(const Sequential& other)
+    : topology(other.topology),
+    parameters(other.parameters.size()),
+    gradients(other.gradients.size()) {
+    bind_views();
+    std::copy(other.parameters.data(), other.parameters.data() + parameters.size(), parameters.data());
+    std::copy(other.gradients.data(), other.gradients.data() + gradients.size(), gradients.data());
+}
+
+void sequential::Sequential::bind_views() {
+    const size_t weight_total = topology.weight_count();
+    size_t weight_offset = 0;
+    size_t bias_offset = weight_total;
+    size_t value_offset = topology.inputs;
+    uint32_t fan_in = topology.inputs;
+    for (const auto& layer : topology.layers) {
+        size_t count = static_cast<size_t>(fan_in) * layer.units;
+        weight_views.push_back(parameters.view(weight_offset, count));
+        weight_gradients.push_back(gradients.view(weight_offset, count));
+        bias_views.push_back(parameters.view(bias_offset, layer.units));
+        bias_gradients.push_back(gradients.view(bias_offset, layer.units));
+        activation_offsets.push_back(value_offset);
+        weight_offset += count;
+        bias_offset += layer.units;
+        value_offset += layer.units;
+        fan_in = layer.units;
+    }
+    activations.assign(value_offset, 0.0f);
+    deltas.assign(2 * static_cast<size_t>(topology.widest()), 0.0f);
+}
+
+void sequential::Sequential::run(const float* input, float* values) const {
+    std::copy(input, input + topology.inputs, values);
+    const float* in = values;
+    uint32_t fan_in = topology.inputs;
+    for (size_t l = 0; l < topology.layers.size(); ++l) {
+        const LayerSpec& layer = topology.layers[l];
+        float* out = values + activation_offsets[l];
+        const float* w = weight_views[l].data();
+        const float* b = bias_views[l].data();
+        switch (layer.activation) {
+        case Activation::Relu:
+            fused::dense_relu(in, w, b, out, fan_in, layer.units, -88.0f, 88.0f);
+            break;
+        case Activation::Sigmoid:
+            fused::dense_sigmoid(in, w, b, out, fan_in, layer.units);
+            break;
+        case Activation::LeakyRelu:
+            fused::dense_linear(in, w, b, out, fan_in, layer.units);
+            activate::leaky_relu_n(out, out, layer.units, LEAKY_ALPHA);
+            break;
+        case Activation::Tanh:
+            fused::dense_linear(in, w, b, out, fan_in, layer.units);
+            activate::tanh_n(out, out, layer.units);
+            break;
+        default:
+            fused::dense_linear(in, w, b, out, fan_in, layer.units);
+            break;
+        }
+        in = out;
+        fan_in = layer.units;
+    }
+}
+
+void sequential::Sequential::forward(const float* input, float* output) const {
+    //Per thread scratch so concurrent callers never share buffers
+    thread_local std::vector<float> values;
+    values.resize(activations.size());
+    run(input, values.data());
+    const float* last = values.data() + activation_offsets.back();
+    std::copy(last, last + topology.outputs(), output);
+}
+
+float sequential::Sequential::predict(const std::vector<float>& input) const {
+    if (input.size() != topology.inputs) {
+        throw std::invalid_argument("Input size does not match the topology");
+    }
+    std::vector<float> output(topology.outputs());
+    forward(input.data(), output.data());
+    return output[0];
+}
+
+float sequential::Sequential::accumulate_gradients(const float* input, const float* target) {
+    run(input, activations.data());
+
+    const size_t last = topology.layers.size() - 1;
+    const LayerSpec& output_layer = topology.layers[last];
+    const float* out = activations.data() + activation_offsets[last];
+    float* delta = deltas.data();
+    float* next_delta = deltas.data() + topology.widest();
+    float loss = 0.0f;
+    for (uint32_t i = 0; i < output_layer.units; ++i) {
+        float diff = out[i] - target[i];
+        if (output_layer.activation == Activation::Sigmoid) {
+            //Cross entropy through a sigmoid, the sigmoid derivative cancels
+            float p = std::min(std::max(out[i], LOG_EPSILON), 1.0f - LOG_EPSILON);
+            loss -= target[i] * std::log(p) + (1.0f - target[i]) * std::log(1.0f - p);
+            delta[i] = diff;
+        }
+        else {
+            loss += 0.5f * diff * diff;
+            delta[i] = diff * derivative(output_layer.activation, out[i]);
+        }
+    }
+
+    for (size_t l = last + 1; l-- > 0;) {
+        const uint32_t units = topology.layers[l].units;
+        const uint32_t fan_in = l == 0 ? topology.inputs : topology.layers[l - 1].units;
+        const float* in = l == 0 ? activations.data() : activations.data() + activation_offsets[l - 1];
+        float* gw = weight_gradients[l].data();
+        float* gb = bias_gradients[l].data();
+        for (uint32_t i = 0; i < units; ++i) {
+            const float d = delta[i];
+            float* row = gw + static_cast<size_t>(i) * fan_in;
+            for (uint32_t j = 0; j < fan_in; ++j) {
+                row[j] += d * in[j];
+            }
+            gb[i] += d;
+        }
+        if (l == 0) {
+            break;
+        }
+        //delta for the layer below, W^T * delta scaled by that layer's activation derivative
+        const float* w = weight_views[l].data();
+        std::fill(next_delta, next_delta + fan_in, 0.0f);
+        for (uint32_t i = 0; i < units; ++i) {
+            const float d = delta[i];
+            const float* row = w + static_cast<size_t>(i) * fan_in;
+            for (uint32_t j = 0; j < fan_in; ++j) {
+                next_delta[j] += row[j] * d;
+            }
+        }
+        const Activation below = topology.layers[l - 1].activation;
+        for (uint32_t j = 0; j < fan_in; ++j) {
+            next_delta[j] *= derivative(below, in[j]);
+        }
+        std::swap(delta, next_delta);
+    }
+    return loss;
+}
+
+void sequential::Sequential::zero_gradients() {
+    std::fill(gradients.data(), gradients.data() + gradients.size(), 0.0f);
+}
+
+void sequential::Sequential::step(float learning_rate) {
+    float* p = parameters.data();
+    const float* g = gradients.data();
+    const size_t count = parameters.size();
+    for (size_t i = 0; i < count; ++i) {
+        p[i] -= learning_rate * g[i];
+    }
+}
+
+void sequential::Sequential::step(optim::Optimizer& optimizer) {
+    optimizer.step(parameters.all(), gradients.all());
+}
+
+float sequential::Sequential::train_step(const float* input, const float* target, float learning_rate) {
+    zero_gradients();
+    float loss = accumulate_gradients(input, target);
+    step(learning_rate);
+    return loss;
+}
+
+bool sequential::Sequential::save(const std::string& file_path) const {
+    FILE* file = std::fopen(file_path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return false;
+    }
+    const std::string spec = topology.to_string();
+    const uint32_t spec_length = static_cast<uint32_t>(spec.size());
+    const uint64_t count = parameters.size();
+    bool ok = std::fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), file) == sizeof(FILE_MAGIC)
+        && std::fwrite(&FILE_VERSION, sizeof(FILE_VERSION), 1, file) == 1
+        && std::fwrite(&spec_length, sizeof(spec_length), 1, file) == 1
+        && std::fwrite(spec.data(), 1, spec.size(), file) == spec.size()
+        && std::fwrite(&count, sizeof(count), 1, file) == 1
+        && std::fwrite(parameters.data(), sizeof(float), count, file) == count;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Unable to write network to " << file_path << std::endl;
+    }
+    return ok;
+}
+
+std::unique_ptr<sequential::Sequential> sequential::Sequential::load(const std::string& file_path) {
+    FILE* file = std::fopen(file_path.c_str(), "rb");
+    if (file == nullptr) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return nullptr;
+    }
+    std::unique_ptr<Sequential> network;
+    char magic[sizeof(FILE_MAGIC)] = {};
+    uint32_t version = 0;
+    uint32_t spec_length = 0;
+    uint64_t count = 0;
+    bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && std::equal(magic, magic + sizeof(magic), FILE_MAGIC)
+        && std::fread(&version, sizeof(version), 1, file) == 1 && version == FILE_VERSION
+        && std::fread(&spec_length, sizeof(spec_length), 1, file) == 1 && spec_length < 4096;
+    std::string spec(ok ? spec_length : 0, '\0');
+    ok = ok && std::fread(&spec[0], 1, spec_length, file) == spec_length
+        && std::fread(&count, sizeof(count), 1, file) == 1;
+    if (ok) {
+        try {
+            network.reset(new Sequential(Topology::parse(spec)));
+        }
+        catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    ok = ok && count == network->parameters.size()
+        && std::fread(network->parameters.data(), sizeof(float), count, file) == count;
+    std::fclose(file);
+    if (!ok) {
+        std::cerr << "Error: " << file_path << " is not a valid network file" << std::endl;
+        return nullptr;
+    }
+    return network;
+}
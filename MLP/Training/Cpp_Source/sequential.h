@@ -0,0 +1,115 @@
+#pragma once
+// sequential.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the runtime topology network, a stack of dense layers whose widths and activations are read from a spec at run time instead of being fixed at compile time, with every parameter and gradient kept in one flat arena.
+
+#ifndef SEQUENTIAL_H
+#define SEQUENTIAL_H
+
+#include "arena.h"
+#include "optimizer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sequential {
+    enum class Activation : uint8_t {
+        Linear = 0,
+        Relu,
+        LeakyRelu,
+        Sigmoid,
+        Tanh
+    };
+
+    const char* activation_name(Activation activation);
+    bool parse_activation(const std::string& name, Activation& activation);
+
+    struct LayerSpec {
+        uint32_t units = 0;
+        Activation activation = Activation::Relu;
+
+        bool operator==(const LayerSpec& other) const {
+            return units == other.units && activation == other.activation;
+        }
+    };
+
+    //Input width plus one dense layer per entry, written as "9,64:relu,32:tanh,1:sigmoid"
+    struct Topology {
+        uint32_t inputs = 0;
+        std::vector<LayerSpec> layers;
+
+        //Throws std::invalid_argument on a malformed spec, a layer without an activation defaults to relu
+        static Topology parse(const std::string& text);
+        std::string to_string() const;
+
+        size_t weight_count() const;
+        size_t bias_count() const;
+        uint32_t outputs() const { return layers.empty() ? 0 : layers.back().units; }
+        uint32_t widest() const;
+
+        bool operator==(const Topology& other) const {
+            return inputs == other.inputs && layers == other.layers;
+        }
+    };
+
+    //Arena layout: layer 0 weights, layer 1 weights, ..., then layer 0 biases, layer 1 biases, ...
+    //Weights are row-major [units][inputs]. The gradient arena has the same layout, so an optimizer
+    //step is one pass over two flat buffers.
+    class Sequential {
+    public:
+        //Xavier uniform weights from seed, zero biases
+        explicit Sequential(const Topology& topology, uint32_t seed = 42);
+        Sequential(const Sequential& other);
+        Sequential& operator=(const Sequential&) = delete;
+
+        const Topology& get_topology() const { return topology; }
+        size_t layer_count() const { return topology.layers.size(); }
+
+        Span<const float> get_weights(size_t layer) const { return weight_views.at(layer); }
+        Span<const float> get_biases(size_t layer) const { return bias_views.at(layer); }
+        Span<float> get_parameters() { return parameters.all(); }
+        Span<const float> get_parameters() const { return parameters.all(); }
+        Span<float> get_gradients() { return gradients.all(); }
+        Span<const float> get_gradients() const { return gradients.all(); }
+
+        //output holds topology.outputs() values. Safe to call from several threads at once.
+        void forward(const float* input, float* output) const;
+        float predict(const std::vector<float>& input) const;
+
+        //Backpropagates one sample and adds its gradients into the gradient arena, returns the sample loss.
+        //A sigmoid output layer trains on binary cross entropy, any other on half squared error.
+        float accumulate_gradients(const float* input, const float* target);
+        void zero_gradients();
+        //parameters -= learning_rate * gradients
+        void step(float learning_rate);
+        //Applies the gradient arena through an optimizer built for get_parameters().size() values
+        void step(optim::Optimizer& optimizer);
+        //zero_gradients, accumulate_gradients and step for a single sample
+        float train_step(const float* input, const float* target, float learning_rate);
+
+        //Binary file with the topology spec followed by the arena as one block
+        bool save(const std::string& file_path) const;
+        //nullptr (and an error on std::cerr) when the file is missing or malformed
+        static std::unique_ptr<Sequential> load(const std::string& file_path);
+
+    private:
+        Topology topology;
+        ParameterArena parameters;
+        ParameterArena gradients;
+        std::vector<Span<float>> weight_views;
+        std::vector<Span<float>> bias_views;
+        std::vector<Span<float>> weight_gradients;
+        std::vector<Span<float>> bias_gradients;
+        std::vector<size_t> activation_offsets;     //Where each layer's output starts in activations
+        std::vector<float> activations;             //Input copy then every layer's output, kept for backprop
+        std::vector<float> deltas;
+
+        void bind_views();
+        //Runs every layer, values needs room for the input and every layer's output
+        void run(const float* input, float* values) const;
+    };
+}
+
+#endif
@@ -0,0 +1,114 @@
+// series.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the streaming series front end, the mirrored ring buffer, the per-push window statistics with monotonic queues for the min and max, and the window scorer that hands the buffer to SmallNetwork::forward_batch as a stride 1 feature major batch.
+
+#include "series.h"
+#include "MLP.h"
+#include <stdexcept>
+
+namespace series {
+    RingSeries::RingSeries(uint32_t capacity, uint32_t window)
+        : capacity(capacity), window(window), pushed(0), head(0), sum(0.0), last(0.0f),
+        min_front(0), min_back(0), max_front(0), max_back(0) {
+        if (window == 0 || window > capacity) {
+            throw std::invalid_argument("Window must be between 1 and the capacity");
+        }
+        data.assign(static_cast<size_t>(capacity) * 2, 0.0f);
+        //A window never holds more than window live entries
+        uint32_t queue_size = 1;
+        while (queue_size < window) queue_size <<= 1;
+        queue_mask = queue_size - 1;
+        min_queue.assign(queue_size, { 0, 0.0f });
+        max_queue.assign(queue_size, { 0, 0.0f });
+    }
+
+    void RingSeries::push(float v) {
+        const uint64_t n = pushed;
+        //The value leaving the window goes before the write, which can land on its slot when capacity == window. Its
+        //second copy is window slots behind the head's.
+        if (n >= window) {
+            sum -= data[head + capacity - window];
+            if (min_front != min_back && min_queue[min_front & queue_mask].first + window <= n) ++min_front;
+            if (max_front != max_back && max_queue[max_front & queue_mask].first + window <= n) ++max_front;
+        }
+        data[head] = v;
+        data[head + capacity] = v;
+        sum += v;
+        while (min_front != min_back && min_queue[(min_back - 1) & queue_mask].second >= v) --min_back;
+        min_queue[min_back++ & queue_mask] = { n, v };
+        while (max_front != max_back && max_queue[(max_back - 1) & queue_mask].second <= v) --max_back;
+        max_queue[max_back++ & queue_mask] = { n, v };
+        ++pushed;
+
+        if (pushed >= window) {
+            current.mean = static_cast<float>(sum / window);
+            current.min = min_queue[min_front & queue_mask].second;
+            current.max = max_queue[max_front & queue_mask].second;
+            current.delta = v - data[head + capacity - window + 1];
+            current.step = n > 0 ? v - last : 0.0f;
+        }
+        last = v;
+        head = head + 1 == capacity ? 0 : head + 1;
+    }
+
+    void RingSeries::push(const float* values, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            push(values[i]);
+        }
+    }
+
+    uint32_t RingSeries::buffered() const {
+        return pushed < capacity ? static_cast<uint32_t>(pushed) : capacity;
+    }
+
+    uint32_t RingSeries::window_count() const {
+        const uint32_t values = buffered();
+        return values < window ? 0 : values - window + 1;
+    }
+
+    const float* RingSeries::window_values(uint32_t k) const {
+        return windows(k, 1);
+    }
+
+    const float* RingSeries::windows(uint32_t first, uint32_t count) const {
+        if (count == 0 || first >= window_count() || count > window_count() - first) {
+            throw std::out_of_range("Windows are not buffered");
+        }
+        //The run is at most capacity values, so starting from the first copy it never passes the end of the second
+        const uint64_t oldest = pushed - buffered();
+        return data.data() + (oldest + first) % capacity;
+    }
+
+    const WindowStats& RingSeries::stats() const {
+        if (pushed < window) {
+            throw std::logic_error("No whole window pushed yet");
+        }
+        return current;
+    }
+
+    WindowScorer::WindowScorer(const MLP& mlp, uint32_t window) {
+        mlp.pack_network(window, network);
+        if (network.get_output_size() != 1) {
+            throw std::invalid_argument("Window scoring needs a single output model");
+        }
+    }
+
+    void WindowScorer::score(const RingSeries& series, uint32_t first, uint32_t count, float* scores) const {
+        if (series.get_window() != network.get_input_size()) {
+            throw std::invalid_argument("Series window does not match the scorer's");
+        }
+        if (count == 0) {
+            return;
+        }
+        //Value j of window first + i sits at [i + j], exactly forward_batch's layout with stride 1, and with one output
+        //the scores take the same stride
+        network.forward_batch(series.windows(first, count), 1, count, scores);
+    }
+
+    std::vector<float> WindowScorer::score_all(const RingSeries& series) const {
+        std::vector<float> scores(series.window_count());
+        score(series, 0, static_cast<uint32_t>(scores.size()), scores.data());
+        return scores;
+    }
+}
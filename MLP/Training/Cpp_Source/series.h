@@ -0,0 +1,87 @@
+#pragma once
+// series.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the streaming front end for sensor series, a ring buffer that keeps every value twice so any run of buffered values is contiguous, which makes the overlapping windows views into it with no copying, running window statistics updated per pushed value, and a scorer that runs a batch of windows straight out of the buffer.
+
+#ifndef SERIES_H
+#define SERIES_H
+
+#include "fused.h"
+#include "layers.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MLP;
+
+namespace series {
+    //Of the newest window, all updated per push
+    struct WindowStats {
+        float mean = 0.0f;
+        float min = 0.0f;
+        float max = 0.0f;
+        float delta = 0.0f;         //Newest value minus the oldest one in the window
+        float step = 0.0f;          //Newest value minus the one before it
+    };
+
+    class RingSeries {
+    public:
+        //Keeps the last capacity values, windows are window values long. Throws std::invalid_argument unless
+        //0 < window <= capacity.
+        explicit RingSeries(uint32_t capacity, uint32_t window = INPUT_SIZE);
+
+        void push(float value);
+        void push(const float* values, size_t count);
+
+        uint32_t get_capacity() const { return capacity; }
+        uint32_t get_window() const { return window; }
+        uint64_t get_pushed() const { return pushed; }
+        //Values still buffered
+        uint32_t buffered() const;
+        //Whole windows among the buffered values, window 0 is the oldest and window_count() - 1 ends at the newest value
+        uint32_t window_count() const;
+        //Window k as window values in time order, valid until the next push
+        const float* window_values(uint32_t k) const;
+        //Windows first .. first + count - 1 as one feature major batch with stride 1: value j of window first + i is
+        //at [j + i]. Throws std::out_of_range when they are not all buffered.
+        const float* windows(uint32_t first, uint32_t count) const;
+        //Of the newest window, throws std::logic_error before the first whole window
+        const WindowStats& stats() const;
+
+    private:
+        uint32_t capacity;
+        uint32_t window;
+        uint64_t pushed;
+        std::vector<float> data;        //[2 * capacity], value n at n % capacity and again capacity later
+        uint32_t head;                  //Slot the next value goes to
+        double sum;                     //Of the newest window, in double so a long run of adds and drops does not drift
+        float last;                     //Newest value, for the step
+        //Monotonic queues of (value number, value), the front is the window's min (max). Entries leave at the back when
+        //a newer value beats them and at the front when they fall out of the window, the rings are a power of two at
+        //least window long so the positions wrap with a mask.
+        std::vector<std::pair<uint64_t, float>> min_queue;
+        std::vector<std::pair<uint64_t, float>> max_queue;
+        uint32_t queue_mask;
+        uint32_t min_front, min_back;
+        uint32_t max_front, max_back;
+        WindowStats current;
+    };
+
+    //Scores windows with the MLP's weights at construction, one window per vector lane, reading them in place
+    class WindowScorer {
+    public:
+        //window is the number of features the model reads, at most INPUT_SIZE
+        WindowScorer(const MLP& mlp, uint32_t window = INPUT_SIZE);
+
+        //scores[i] is the score of window first + i, same as MLP::predict on its values
+        void score(const RingSeries& series, uint32_t first, uint32_t count, float* scores) const;
+        //Every whole window still buffered
+        std::vector<float> score_all(const RingSeries& series) const;
+
+    private:
+        fused::SmallNetwork network;
+    };
+}
+
+#endif
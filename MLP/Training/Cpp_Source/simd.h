@@ -0,0 +1,192 @@
+#pragma once
+// simd.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header is a thin wrapper over the vector instruction sets we build for (AVX2, SSE2, NEON) with a scalar fallback, so kernels can be written once.
+// Every operation also has a plain float overload, kernels written as templates over the value type reuse the exact same math for their scalar tails.
+// Define EDGEMLP_NO_SIMD to force the scalar path.
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+
+#if !defined(EDGEMLP_NO_SIMD) && defined(__AVX2__)
+#define EDGEMLP_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(EDGEMLP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define EDGEMLP_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif !defined(EDGEMLP_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define EDGEMLP_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define EDGEMLP_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+    //Scalar overloads, always available
+    inline float set1(float x, float) { return x; }
+    inline float add(float a, float b) { return a + b; }
+    inline float sub(float a, float b) { return a - b; }
+    inline float mul(float a, float b) { return a * b; }
+    inline float div(float a, float b) { return a / b; }
+    inline float fmadd(float a, float b, float c) { return a * b + c; }
+    inline float max(float a, float b) { return a > b ? a : b; }
+    inline float min(float a, float b) { return a < b ? a : b; }
+    inline float abs(float a) { return a < 0.0f ? -a : a; }
+    inline float sqrt(float a) { return std::sqrt(a); }
+    //Copies the sign of s onto the magnitude of a
+    inline float copysign(float a, float s) { return (s < 0.0f) ? -abs(a) : abs(a); }
+    //Picks x where a < b (or a > b) holds, otherwise y
+    inline float select_lt(float a, float b, float x, float y) { return a < b ? x : y; }
+    inline float select_gt(float a, float b, float x, float y) { return a > b ? x : y; }
+    inline int32_t round_to_int(float a) { return static_cast<int32_t>(std::nearbyint(a)); }
+    inline float to_float(int32_t a) { return static_cast<float>(a); }
+    //2^n for n in [-126, 127]
+    inline float pow2i(int32_t n) {
+        uint32_t bits = static_cast<uint32_t>(n + 127) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    inline float hsum(float a) { return a; }
+    inline float hmax(float a) { return a; }
+
+#if defined(EDGEMLP_SIMD_AVX2)
+    using vfloat = __m256;
+    using vint = __m256i;
+    constexpr size_t WIDTH = 8;
+    constexpr const char* ISA = "avx2";
+
+    inline vfloat load(const float* p) { return _mm256_loadu_ps(p); }
+    inline void store(float* p, vfloat v) { _mm256_storeu_ps(p, v); }
+    inline vfloat set1(float x, vfloat) { return _mm256_set1_ps(x); }
+    inline vfloat splat(float x) { return _mm256_set1_ps(x); }
+    inline vfloat zero() { return _mm256_setzero_ps(); }
+    inline vfloat add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+    inline vfloat sub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+    inline vfloat mul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+    inline vfloat div(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__)
+    inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    inline vfloat max(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+    inline vfloat min(vfloat a, vfloat b) { return _mm256_min_ps(a, b); }
+    inline vfloat abs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline vfloat sqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+    inline vfloat copysign(vfloat a, vfloat s) {
+        vfloat sign = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(sign, a), _mm256_and_ps(sign, s));
+    }
+    inline vfloat select_lt(vfloat a, vfloat b, vfloat x, vfloat y) { return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    inline vfloat select_gt(vfloat a, vfloat b, vfloat x, vfloat y) { return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+    inline vint round_to_int(vfloat a) { return _mm256_cvtps_epi32(a); }
+    inline vfloat to_float(vint a) { return _mm256_cvtepi32_ps(a); }
+    inline vfloat pow2i(vint n) {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+    }
+    inline float hsum(vfloat a) {
+        __m128 lo = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+        lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+        return _mm_cvtss_f32(lo);
+    }
+    inline float hmax(vfloat a) {
+        __m128 lo = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+        lo = _mm_max_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+        return _mm_cvtss_f32(lo);
+    }
+#elif defined(EDGEMLP_SIMD_SSE2)
+    using vfloat = __m128;
+    using vint = __m128i;
+    constexpr size_t WIDTH = 4;
+    constexpr const char* ISA = "sse2";
+
+    inline vfloat load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, vfloat v) { _mm_storeu_ps(p, v); }
+    inline vfloat set1(float x, vfloat) { return _mm_set1_ps(x); }
+    inline vfloat splat(float x) { return _mm_set1_ps(x); }
+    inline vfloat zero() { return _mm_setzero_ps(); }
+    inline vfloat add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+    inline vfloat sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+    inline vfloat mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+    inline vfloat div(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+    inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline vfloat max(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+    inline vfloat min(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+    inline vfloat abs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline vfloat sqrt(vfloat a) { return _mm_sqrt_ps(a); }
+    inline vfloat copysign(vfloat a, vfloat s) {
+        vfloat sign = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(_mm_andnot_ps(sign, a), _mm_and_ps(sign, s));
+    }
+    inline vfloat select_lt(vfloat a, vfloat b, vfloat x, vfloat y) {
+        vfloat mask = _mm_cmplt_ps(a, b);
+        return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+    }
+    inline vfloat select_gt(vfloat a, vfloat b, vfloat x, vfloat y) { return select_lt(b, a, x, y); }
+    inline vint round_to_int(vfloat a) { return _mm_cvtps_epi32(a); }
+    inline vfloat to_float(vint a) { return _mm_cvtepi32_ps(a); }
+    inline vfloat pow2i(vint n) {
+        return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    }
+    inline float hsum(vfloat a) {
+        a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_add_ss(a, _mm_shuffle_ps(a, a, 0x55));
+        return _mm_cvtss_f32(a);
+    }
+    inline float hmax(vfloat a) {
+        a = _mm_max_ps(a, _mm_movehl_ps(a, a));
+        a = _mm_max_ss(a, _mm_shuffle_ps(a, a, 0x55));
+        return _mm_cvtss_f32(a);
+    }
+#elif defined(EDGEMLP_SIMD_NEON)
+    using vfloat = float32x4_t;
+    using vint = int32x4_t;
+    constexpr size_t WIDTH = 4;
+    constexpr const char* ISA = "neon";
+
+    inline vfloat load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, vfloat v) { vst1q_f32(p, v); }
+    inline vfloat set1(float x, vfloat) { return vdupq_n_f32(x); }
+    inline vfloat splat(float x) { return vdupq_n_f32(x); }
+    inline vfloat zero() { return vdupq_n_f32(0.0f); }
+    inline vfloat add(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+    inline vfloat sub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+    inline vfloat mul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+    inline vfloat div(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+    inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return vfmaq_f32(c, a, b); }
+    inline vfloat max(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+    inline vfloat min(vfloat a, vfloat b) { return vminq_f32(a, b); }
+    inline vfloat abs(vfloat a) { return vabsq_f32(a); }
+    inline vfloat sqrt(vfloat a) { return vsqrtq_f32(a); }
+    inline vfloat copysign(vfloat a, vfloat s) { return vbslq_f32(vdupq_n_u32(0x80000000u), s, a); }
+    inline vfloat select_lt(vfloat a, vfloat b, vfloat x, vfloat y) { return vbslq_f32(vcltq_f32(a, b), x, y); }
+    inline vfloat select_gt(vfloat a, vfloat b, vfloat x, vfloat y) { return vbslq_f32(vcgtq_f32(a, b), x, y); }
+    inline vint round_to_int(vfloat a) { return vcvtnq_s32_f32(a); }
+    inline vfloat to_float(vint a) { return vcvtq_f32_s32(a); }
+    inline vfloat pow2i(vint n) { return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23)); }
+    inline float hsum(vfloat a) { return vaddvq_f32(a); }
+    inline float hmax(vfloat a) { return vmaxvq_f32(a); }
+#else
+    using vfloat = float;
+    using vint = int32_t;
+    constexpr size_t WIDTH = 1;
+    constexpr const char* ISA = "scalar";
+
+    inline vfloat load(const float* p) { return *p; }
+    inline void store(float* p, vfloat v) { *p = v; }
+    inline vfloat splat(float x) { return x; }
+    inline vfloat zero() { return 0.0f; }
+#endif
+}
+
+#endif
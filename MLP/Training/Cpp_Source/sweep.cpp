@@ -0,0 +1,385 @@
+// sweep.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the stacked multi-model trainer, the grid parser and the three batched phases every minibatch runs for all models at once.
+
+#include "sweep.h"
+#include "activate.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr float LOG_EPSILON = 1e-7f;
+    constexpr uint32_t EVALUATE_BATCH = 256;
+
+    std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::stringstream ss(text);
+        std::string part;
+        while (std::getline(ss, part, separator)) {
+            if (!part.empty()) {
+                parts.push_back(part);
+            }
+        }
+        return parts;
+    }
+
+    sequential::Topology model_topology(uint32_t inputs, uint32_t hidden) {
+        sequential::Topology topology;
+        topology.inputs = inputs;
+        topology.layers.push_back({ hidden, sequential::Activation::Relu });
+        topology.layers.push_back({ 1, sequential::Activation::Sigmoid });
+        return topology;
+    }
+
+    //The batch loops below are short (one minibatch) and run once per hidden row, so they are vectorized by hand,
+    //the reductions would otherwise stay scalar without -ffast-math
+    inline void axpy(float a, const float* x, float* y, uint32_t n) {
+        uint32_t i = 0;
+#if !defined(EDGEMLP_SIMD_SCALAR)
+        const simd::vfloat va = simd::splat(a);
+        for (; i + simd::WIDTH <= n; i += simd::WIDTH) {
+            simd::store(y + i, simd::fmadd(va, simd::load(x + i), simd::load(y + i)));
+        }
+#endif
+        for (; i < n; ++i) {
+            y[i] += a * x[i];
+        }
+    }
+
+    inline float dot(const float* a, const float* b, uint32_t n) {
+        uint32_t i = 0;
+        float sum = 0.0f;
+#if !defined(EDGEMLP_SIMD_SCALAR)
+        simd::vfloat acc = simd::zero();
+        for (; i + simd::WIDTH <= n; i += simd::WIDTH) {
+            acc = simd::fmadd(simd::load(a + i), simd::load(b + i), acc);
+        }
+        sum = simd::hsum(acc);
+#endif
+        for (; i < n; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    inline void relu(float* x, uint32_t n) {
+        uint32_t i = 0;
+#if !defined(EDGEMLP_SIMD_SCALAR)
+        for (; i + simd::WIDTH <= n; i += simd::WIDTH) {
+            simd::store(x + i, simd::max(simd::load(x + i), simd::zero()));
+        }
+#endif
+        for (; i < n; ++i) {
+            x[i] = std::max(x[i], 0.0f);
+        }
+    }
+
+    //delta = h > 0 ? error * w : 0, returns the sum of delta
+    inline float relu_delta(const float* h, const float* error, float w, float* delta, uint32_t n) {
+        uint32_t i = 0;
+        float sum = 0.0f;
+#if !defined(EDGEMLP_SIMD_SCALAR)
+        const simd::vfloat vw = simd::splat(w);
+        simd::vfloat acc = simd::zero();
+        for (; i + simd::WIDTH <= n; i += simd::WIDTH) {
+            simd::vfloat d = simd::select_gt(simd::load(h + i), simd::zero(), simd::mul(simd::load(error + i), vw), simd::zero());
+            simd::store(delta + i, d);
+            acc = simd::add(acc, d);
+        }
+        sum = simd::hsum(acc);
+#endif
+        for (; i < n; ++i) {
+            delta[i] = h[i] > 0.0f ? error[i] * w : 0.0f;
+            sum += delta[i];
+        }
+        return sum;
+    }
+}
+
+//Batch scratch, everything is laid out feature (or unit) major so the inner loops run over the batch
+struct sweep::StackedTrainer::Batch {
+    uint32_t count = 0;
+    std::vector<float> xt;          //[inputs][count]
+    std::vector<float> targets;     //[count]
+    std::vector<float> hidden;      //[total_hidden][count]
+    std::vector<float> errors;      //[models][count], output minus target
+
+    Batch(uint32_t inputs, uint32_t total_hidden, size_t models, uint32_t capacity)
+        : xt(static_cast<size_t>(inputs) * capacity), targets(capacity),
+        hidden(static_cast<size_t>(total_hidden) * capacity), errors(models * capacity) {}
+};
+
+std::vector<sweep::ModelSpec> sweep::parse_grid(const std::string& text) {
+    std::vector<float> rates = { ModelSpec().learning_rate };
+    std::vector<uint32_t> widths = { ModelSpec().hidden };
+    std::vector<uint32_t> seeds = { ModelSpec().seed };
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), ';', ' ');
+    std::stringstream ss(normalized);
+    std::string item;
+    while (ss >> item) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Expected key=values in sweep grid: " + item);
+        }
+        std::string key = item.substr(0, equals);
+        std::vector<std::string> values = split(item.substr(equals + 1), ',');
+        if (values.empty()) {
+            throw std::invalid_argument("No values for " + key + " in sweep grid");
+        }
+        try {
+            if (key == "lr") {
+                rates.clear();
+                for (const auto& v : values) rates.push_back(std::stof(v));
+            }
+            else if (key == "hidden") {
+                widths.clear();
+                for (const auto& v : values) widths.push_back(static_cast<uint32_t>(std::stoul(v)));
+            }
+            else if (key == "seed") {
+                seeds.clear();
+                for (const auto& v : values) seeds.push_back(static_cast<uint32_t>(std::stoul(v)));
+            }
+            else if (key == "seeds" && values.size() == 1) {
+                uint32_t count = static_cast<uint32_t>(std::stoul(values[0]));
+                seeds.clear();
+                for (uint32_t s = 0; s < count; ++s) seeds.push_back(ModelSpec().seed + s);
+            }
+            else {
+                throw std::invalid_argument(key);
+            }
+        }
+        catch (const std::exception&) {
+            throw std::invalid_argument("Invalid sweep grid entry: " + item);
+        }
+    }
+    std::vector<ModelSpec> specs;
+    for (float rate : rates) {
+        for (uint32_t width : widths) {
+            for (uint32_t seed : seeds) {
+                ModelSpec spec;
+                spec.learning_rate = rate;
+                spec.hidden = width;
+                spec.seed = seed;
+                specs.push_back(spec);
+            }
+        }
+    }
+    return specs;
+}
+
+std::string sweep::describe(const ModelSpec& spec) {
+    std::ostringstream out;
+    out << "lr=" << spec.learning_rate << " hidden=" << spec.hidden << " seed=" << spec.seed;
+    return out.str();
+}
+
+const char* sweep::mlp_difference() {
+    return "Sweep models are inputs,H:relu,1:sigmoid networks trained by backprop on cross entropy in minibatches. The MLP "
+        "that main trains differs: its hidden layer is one unit wide, its output layer also reads the raw inputs past that unit, "
+        "it updates every layer by output error times input one sample at a time and it reports half squared error. Rank "
+        "learning rates and widths with the sweep as a guide, they do not carry over to the MLP as they are.";
+}
+
+//StackedTrainer implementation
+sweep::StackedTrainer::StackedTrainer(uint32_t inputs, const std::vector<ModelSpec>& models)
+    : inputs(inputs), specs(models) {
+    if (inputs == 0 || models.empty()) {
+        throw std::invalid_argument("A sweep needs inputs and at least one model");
+    }
+    row_offsets.push_back(0);
+    for (size_t k = 0; k < models.size(); ++k) {
+        if (models[k].hidden == 0 || !(models[k].learning_rate > 0.0f)) {
+            throw std::invalid_argument("Sweep models need a positive hidden size and learning rate");
+        }
+        row_offsets.push_back(row_offsets.back() + models[k].hidden);
+        row_model.insert(row_model.end(), models[k].hidden, static_cast<uint32_t>(k));
+    }
+    const size_t total = row_offsets.back();
+    parameters = ParameterArena(total * inputs + total + total + models.size());
+    hidden_weights = parameters.view(0, total * inputs);
+    hidden_biases = parameters.view(total * inputs, total);
+    output_weights = parameters.view(total * inputs + total, total);
+    output_biases = parameters.view(total * inputs + 2 * total, models.size());
+
+    //Start every model exactly where a Sequential with the same seed starts
+    for (size_t k = 0; k < models.size(); ++k) {
+        sequential::Sequential network(model_topology(inputs, models[k].hidden), models[k].seed);
+        Span<const float> w1 = network.get_weights(0), w2 = network.get_weights(1);
+        Span<const float> b1 = network.get_biases(0), b2 = network.get_biases(1);
+        const size_t row = row_offsets[k];
+        std::copy(w1.begin(), w1.end(), hidden_weights.begin() + row * inputs);
+        std::copy(b1.begin(), b1.end(), hidden_biases.begin() + row);
+        std::copy(w2.begin(), w2.end(), output_weights.begin() + row);
+        output_biases[k] = b2[0];
+    }
+}
+
+void sweep::StackedTrainer::load_batch(const Dataset& data, const uint32_t* indices, uint32_t count, Batch& batch) const {
+    batch.count = count;
+    for (uint32_t b = 0; b < count; ++b) {
+        const auto& sample = data[indices[b]];
+        if (sample.first.size() != inputs) {
+            throw std::invalid_argument("Sample size does not match the sweep inputs");
+        }
+        for (uint32_t j = 0; j < inputs; ++j) {
+            batch.xt[static_cast<size_t>(j) * count + b] = sample.first[j];
+        }
+        batch.targets[b] = static_cast<float>(sample.second);
+    }
+}
+
+//Phase 1, the stacked hidden layer: hidden = relu(W * X + b) for every row of every model over the whole batch
+void sweep::StackedTrainer::forward(Batch& batch) const {
+    const uint32_t count = batch.count;
+    parallel::parallel_for(total_hidden(), static_cast<uint64_t>(inputs) * count, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; ++r) {
+            float* h = batch.hidden.data() + static_cast<size_t>(r) * count;
+            std::fill(h, h + count, hidden_biases[r]);
+            const float* w = hidden_weights.data() + static_cast<size_t>(r) * inputs;
+            for (uint32_t j = 0; j < inputs; ++j) {
+                axpy(w[j], batch.xt.data() + static_cast<size_t>(j) * count, h, count);
+            }
+            relu(h, count);
+        }
+    });
+}
+
+//Phase 2, each model's sigmoid output over its own rows, the loss and the output error
+void sweep::StackedTrainer::score(Batch& batch, std::vector<double>& loss, std::vector<uint64_t>& correct) const {
+    const uint32_t count = batch.count;
+    const uint32_t models = static_cast<uint32_t>(specs.size());
+    parallel::parallel_for(models, static_cast<uint64_t>(total_hidden() / models + 1) * count, 1, [&](uint32_t begin, uint32_t end) {
+        std::vector<float> z(count);
+        for (uint32_t k = begin; k < end; ++k) {
+            std::fill(z.begin(), z.end(), output_biases[k]);
+            for (uint32_t r = row_offsets[k]; r < row_offsets[k + 1]; ++r) {
+                axpy(output_weights[r], batch.hidden.data() + static_cast<size_t>(r) * count, z.data(), count);
+            }
+            float* error = batch.errors.data() + static_cast<size_t>(k) * count;
+            double model_loss = 0.0;
+            uint64_t model_correct = 0;
+            for (uint32_t b = 0; b < count; ++b) {
+                const float p = activate::sigmoid(z[b]);
+                const float t = batch.targets[b];
+                //Targets are 0 or 1, so only one of the two cross entropy terms is ever nonzero
+                const float q = t > 0.5f ? p : 1.0f - p;
+                model_loss -= std::log(std::min(std::max(q, LOG_EPSILON), 1.0f - LOG_EPSILON));
+                model_correct += (p > 0.5f) == (t > 0.5f) ? 1 : 0;
+                error[b] = p - t;
+            }
+            loss[k] += model_loss;
+            correct[k] += model_correct;
+        }
+    });
+}
+
+//Phase 3, backprop and the SGD update fused per hidden row, every row only touches its own parameters
+void sweep::StackedTrainer::backward_update(Batch& batch) {
+    const uint32_t count = batch.count;
+    for (size_t k = 0; k < specs.size(); ++k) {
+        const float* error = batch.errors.data() + k * count;
+        float sum = 0.0f;
+        for (uint32_t b = 0; b < count; ++b) {
+            sum += error[b];
+        }
+        output_biases[k] -= specs[k].learning_rate / count * sum;
+    }
+    parallel::parallel_for(total_hidden(), static_cast<uint64_t>(inputs + 3) * count, 1, [&](uint32_t begin, uint32_t end) {
+        std::vector<float> delta(count);
+        for (uint32_t r = begin; r < end; ++r) {
+            const uint32_t k = row_model[r];
+            const float scale = specs[k].learning_rate / count;
+            const float* error = batch.errors.data() + static_cast<size_t>(k) * count;
+            const float* h = batch.hidden.data() + static_cast<size_t>(r) * count;
+            const float w2 = output_weights[r];
+            const float output_gradient = dot(error, h, count);
+            const float bias_gradient = relu_delta(h, error, w2, delta.data(), count);
+            float* w = hidden_weights.data() + static_cast<size_t>(r) * inputs;
+            for (uint32_t j = 0; j < inputs; ++j) {
+                w[j] -= scale * dot(delta.data(), batch.xt.data() + static_cast<size_t>(j) * count, count);
+            }
+            hidden_biases[r] -= scale * bias_gradient;
+            output_weights[r] -= scale * output_gradient;
+        }
+    });
+}
+
+std::vector<sweep::ModelStats> sweep::StackedTrainer::train_epoch(const Dataset& data, const std::vector<uint32_t>& order,
+    uint32_t batch_size) {
+    if (batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    Batch batch(inputs, total_hidden(), specs.size(), batch_size);
+    std::vector<double> loss(specs.size(), 0.0);
+    std::vector<uint64_t> correct(specs.size(), 0);
+    for (size_t start = 0; start < order.size(); start += batch_size) {
+        uint32_t count = static_cast<uint32_t>(std::min<size_t>(batch_size, order.size() - start));
+        load_batch(data, order.data() + start, count, batch);
+        forward(batch);
+        score(batch, loss, correct);
+        backward_update(batch);
+    }
+    std::vector<ModelStats> stats(specs.size());
+    for (size_t k = 0; k < specs.size() && !order.empty(); ++k) {
+        stats[k].loss = loss[k] / order.size();
+        stats[k].accuracy = static_cast<double>(correct[k]) / order.size();
+    }
+    return stats;
+}
+
+std::vector<sweep::ModelStats> sweep::StackedTrainer::evaluate(const Dataset& data) const {
+    std::vector<uint32_t> order(data.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    Batch batch(inputs, total_hidden(), specs.size(), EVALUATE_BATCH);
+    std::vector<double> loss(specs.size(), 0.0);
+    std::vector<uint64_t> correct(specs.size(), 0);
+    for (size_t start = 0; start < order.size(); start += EVALUATE_BATCH) {
+        uint32_t count = static_cast<uint32_t>(std::min<size_t>(EVALUATE_BATCH, order.size() - start));
+        load_batch(data, order.data() + start, count, batch);
+        forward(batch);
+        score(batch, loss, correct);
+    }
+    std::vector<ModelStats> stats(specs.size());
+    for (size_t k = 0; k < specs.size() && !data.empty(); ++k) {
+        stats[k].loss = loss[k] / data.size();
+        stats[k].accuracy = static_cast<double>(correct[k]) / data.size();
+    }
+    return stats;
+}
+
+float sweep::StackedTrainer::predict(size_t model, const std::vector<float>& input) const {
+    if (model >= specs.size() || input.size() != inputs) {
+        throw std::invalid_argument("Unknown model or input size mismatch");
+    }
+    float z = output_biases[model];
+    for (uint32_t r = row_offsets[model]; r < row_offsets[model + 1]; ++r) {
+        float h = hidden_biases[r];
+        for (uint32_t j = 0; j < inputs; ++j) {
+            h += hidden_weights[static_cast<size_t>(r) * inputs + j] * input[j];
+        }
+        z += output_weights[r] * std::max(h, 0.0f);
+    }
+    return activate::sigmoid(z);
+}
+
+sequential::Sequential sweep::StackedTrainer::to_sequential(size_t model) const {
+    const ModelSpec& spec = specs.at(model);
+    sequential::Sequential network(model_topology(inputs, spec.hidden), spec.seed);
+    //Sequential layout: hidden weights, output weights, hidden biases, output bias
+    Span<float> out = network.get_parameters();
+    const size_t row = row_offsets[model];
+    const size_t w1 = static_cast<size_t>(spec.hidden) * inputs;
+    std::copy(hidden_weights.begin() + row * inputs, hidden_weights.begin() + row * inputs + w1, out.begin());
+    std::copy(output_weights.begin() + row, output_weights.begin() + row + spec.hidden, out.begin() + w1);
+    std::copy(hidden_biases.begin() + row, hidden_biases.begin() + row + spec.hidden, out.begin() + w1 + spec.hidden);
+    out[w1 + 2 * spec.hidden] = output_biases[model];
+    return network;
+}
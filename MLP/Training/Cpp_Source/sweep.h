@@ -0,0 +1,83 @@
+#pragma once
+// sweep.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares stacked multi-model training for hyperparameter sweeps, K one hidden layer networks with their own hidden size, learning rate and seed trained in one process on one shared dataset, with the hidden layers of all K stacked into one wide matrix so every minibatch runs once for all of them.
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "arena.h"
+#include "sequential.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sweep {
+    using Dataset = std::vector<std::pair<std::vector<float>, int>>;
+
+    //One model of the sweep: inputs -> hidden relu -> 1 sigmoid, trained with minibatch SGD on cross entropy. This is
+    //not the MLP main trains, see mlp_difference().
+    struct ModelSpec {
+        uint32_t hidden = 64;
+        float learning_rate = 0.1f;
+        uint32_t seed = 42;         //Weight initialization, the same as Sequential with this seed
+    };
+
+    //Grid of specs from "lr=0.1,0.05 hidden=16,64 seeds=3", every combination of the listed values. seeds=N runs
+    //each combination with seeds 42..42+N-1. Throws std::invalid_argument on a malformed grid.
+    std::vector<ModelSpec> parse_grid(const std::string& text);
+    std::string describe(const ModelSpec& spec);
+
+    //How a sweep model differs from the MLP, printed with the --sweep usage and the ranking so the ranked settings are
+    //not read as settings for the MLP
+    const char* mlp_difference();
+
+    struct ModelStats {
+        double loss = 0.0;          //Mean cross entropy
+        double accuracy = 0.0;
+    };
+
+    //Parameter layout: every model's hidden weights stacked as one [total_hidden][inputs] matrix, then the stacked
+    //hidden biases, the stacked output weights (one per hidden unit) and one output bias per model. Model k owns
+    //hidden rows [row_offset(k), row_offset(k + 1)).
+    class StackedTrainer {
+    public:
+        StackedTrainer(uint32_t inputs, const std::vector<ModelSpec>& models);
+
+        size_t model_count() const { return specs.size(); }
+        const ModelSpec& get_spec(size_t model) const { return specs.at(model); }
+        uint32_t total_hidden() const { return row_offsets.back(); }
+        uint32_t row_offset(size_t model) const { return row_offsets.at(model); }
+        Span<const float> get_parameters() const { return parameters.all(); }
+
+        //One pass over order in minibatches of batch_size, all models see the same batches. Every batch is three wide
+        //phases (stacked hidden layer, per model output, fused backward and update), each split across the thread pool.
+        std::vector<ModelStats> train_epoch(const Dataset& data, const std::vector<uint32_t>& order, uint32_t batch_size);
+        std::vector<ModelStats> evaluate(const Dataset& data) const;
+        float predict(size_t model, const std::vector<float>& input) const;
+
+        //Model k as a standalone runtime topology network, e.g. to save it
+        sequential::Sequential to_sequential(size_t model) const;
+
+    private:
+        uint32_t inputs;
+        std::vector<ModelSpec> specs;
+        std::vector<uint32_t> row_offsets;      //K + 1 entries
+        std::vector<uint32_t> row_model;        //Owning model of every hidden row
+        ParameterArena parameters;
+        Span<float> hidden_weights;
+        Span<float> hidden_biases;
+        Span<float> output_weights;
+        Span<float> output_biases;
+
+        struct Batch;
+        void forward(Batch& batch) const;
+        void score(Batch& batch, std::vector<double>& loss, std::vector<uint64_t>& correct) const;
+        void backward_update(Batch& batch);
+        void load_batch(const Dataset& data, const uint32_t* indices, uint32_t count, Batch& batch) const;
+    };
+}
+
+#endif
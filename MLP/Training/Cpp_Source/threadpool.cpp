@@ -0,0 +1,284 @@
+// threadpool.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the work-stealing scheduler, the Chase-Lev deques, fork/join and the cost model.
+
+#include "threadpool.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    //Rounds of looking for work before an idle worker goes to sleep, roughly 50us on current x86
+    constexpr uint32_t SPIN_LIMIT = 20000;
+
+    //The pool and deque index of the worker running on this thread, -1 for threads outside every pool
+    thread_local const parallel::ThreadPool* current_pool = nullptr;
+    thread_local int current_index = -1;
+    thread_local uint32_t steal_seed = 0x9E3779B9u;
+
+    std::mutex default_mutex;
+    std::unique_ptr<parallel::ThreadPool> default_instance;
+
+    inline void cpu_relax() {
+#if defined(__SSE2__) || defined(_M_X64)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    inline uint32_t next_random() {
+        steal_seed ^= steal_seed << 13;
+        steal_seed ^= steal_seed >> 17;
+        steal_seed ^= steal_seed << 5;
+        return steal_seed;
+    }
+}
+
+//WorkDeque implementation, the memory orders follow Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models"
+parallel::WorkDeque::WorkDeque(uint32_t capacity) {
+    uint32_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    slots.reset(new std::atomic<Task*>[size]);
+    for (uint32_t i = 0; i < size; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool parallel::WorkDeque::push(Task* task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t > static_cast<int64_t>(mask)) {
+        return false;
+    }
+    slots[b & mask].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+parallel::Task* parallel::WorkDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Task* task = slots[b & mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        //Last task, race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+parallel::Task* parallel::WorkDeque::steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    Task* task = slots[t & mask].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+//ThreadPool implementation
+parallel::ThreadPool::ThreadPool(unsigned threads, bool pin) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        deques.emplace_back(new WorkDeque());
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, t - 1, pin);
+    }
+}
+
+parallel::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void parallel::ThreadPool::submit(Task* task) {
+    if (current_pool == this) {
+        if (!deques[current_index]->push(task)) {
+            //Own deque is full, run it now rather than block
+            execute(task);
+            return;
+        }
+    }
+    else {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        injected.push_back(task);
+    }
+    //Counted after the push so a worker that sees the count also finds the task
+    queued.fetch_add(1);
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        wake.notify_one();
+    }
+}
+
+void parallel::ThreadPool::execute(Task* task) {
+    task->body();
+    task->pending->fetch_sub(1, std::memory_order_release);
+}
+
+bool parallel::ThreadPool::run_one() {
+    Task* task = nullptr;
+    const int self = current_pool == this ? current_index : -1;
+    if (self >= 0) {
+        task = deques[self]->pop();
+    }
+    if (task == nullptr && !deques.empty()) {
+        //Steal from a random victim first so thieves spread out, then sweep the rest
+        const uint32_t count = static_cast<uint32_t>(deques.size());
+        const uint32_t start = next_random() % count;
+        for (uint32_t i = 0; i < count && task == nullptr; ++i) {
+            uint32_t victim = (start + i) % count;
+            if (static_cast<int>(victim) != self) {
+                task = deques[victim]->steal();
+            }
+        }
+    }
+    if (task == nullptr && queued.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (!injected.empty()) {
+            task = injected.front();
+            injected.pop_front();
+        }
+    }
+    if (task == nullptr) {
+        return false;
+    }
+    queued.fetch_sub(1);
+    execute(task);
+    return true;
+}
+
+void parallel::ThreadPool::worker_loop(unsigned index, bool pin) {
+    current_pool = this;
+    current_index = static_cast<int>(index);
+    steal_seed ^= (index + 1) * 0x85EBCA6Bu;
+#if defined(__linux__)
+    if (pin) {
+        //Worker i takes core i + 1, the thread that built the pool usually runs on core 0
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((index + 1) % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#else
+    (void)pin;
+#endif
+    while (!stopping.load(std::memory_order_relaxed)) {
+        uint32_t spins = 0;
+        while (!run_one()) {
+            if (++spins < SPIN_LIMIT) {
+                cpu_relax();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            sleeping.fetch_add(1);
+            wake.wait(lock, [&]() { return stopping.load() || queued.load() > 0; });
+            sleeping.fetch_sub(1);
+            if (stopping.load()) {
+                return;
+            }
+            spins = 0;
+        }
+    }
+}
+
+void parallel::ThreadPool::run(uint32_t tasks, const std::function<void(uint32_t)>& body) {
+    if (tasks <= 1 || workers.empty()) {
+        for (uint32_t t = 0; t < tasks; ++t) {
+            body(t);
+        }
+        return;
+    }
+    TaskGroup group(*this);
+    for (uint32_t t = 1; t < tasks; ++t) {
+        group.spawn([&body, t]() { body(t); });
+    }
+    body(0);
+    group.wait();
+}
+
+//TaskGroup implementation
+void parallel::TaskGroup::spawn(std::function<void()> body) {
+    if (pool.workers.empty()) {
+        body();
+        return;
+    }
+    tasks.emplace_back();
+    Task& task = tasks.back();
+    task.body = std::move(body);
+    task.pending = &pending;
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit(&task);
+}
+
+void parallel::TaskGroup::wait() {
+    //Help instead of blocking, the tasks may be sitting in this thread's own deque
+    uint32_t spins = 0;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (pool.run_one()) {
+            spins = 0;
+        }
+        else if (++spins < SPIN_LIMIT) {
+            cpu_relax();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    tasks.clear();
+}
+
+parallel::ThreadPool& parallel::default_pool() {
+    std::lock_guard<std::mutex> lock(default_mutex);
+    if (!default_instance) {
+        default_instance.reset(new ThreadPool());
+    }
+    return *default_instance;
+}
+
+void parallel::set_threads(unsigned threads, bool pin) {
+    std::lock_guard<std::mutex> lock(default_mutex);
+    default_instance.reset(new ThreadPool(threads, pin));
+}
+
+unsigned parallel::plan_threads(uint64_t work, uint32_t max_tasks) {
+    if (work < 2 * MIN_WORK_PER_THREAD || max_tasks <= 1) {
+        return 1;
+    }
+    uint64_t threads = std::min<uint64_t>(work / MIN_WORK_PER_THREAD, max_tasks);
+    return static_cast<unsigned>(std::min<uint64_t>(threads, default_pool().size()));
+}
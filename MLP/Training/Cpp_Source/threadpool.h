@@ -0,0 +1,144 @@
+#pragma once
+// threadpool.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the work-stealing task scheduler shared by training and inference. Each worker owns a Chase-Lev deque, idle workers steal from the others, and fork/join (TaskGroup, run, parallel_for, parallel_invoke) is built on top, together with the cost model that decides when work is big enough to split.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+    //Work (multiply-adds) one thread should get before splitting pays for the fork/join, a couple of microseconds
+    constexpr uint64_t MIN_WORK_PER_THREAD = 32768;
+
+    class ThreadPool;
+
+    //A spawned unit of work, pending belongs to the TaskGroup that waits for it
+    struct Task {
+        std::function<void()> body;
+        std::atomic<uint32_t>* pending = nullptr;
+    };
+
+    //Chase-Lev deque with a fixed power of two capacity. Only the owning worker pushes and pops at the bottom,
+    //any thread may steal from the top.
+    class WorkDeque {
+    public:
+        explicit WorkDeque(uint32_t capacity = 4096);
+
+        //False when full, the caller then runs the task itself
+        bool push(Task* task);
+        Task* pop();
+        Task* steal();
+
+    private:
+        std::atomic<int64_t> top{ 0 };
+        std::atomic<int64_t> bottom{ 0 };
+        uint32_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    class ThreadPool {
+    public:
+        //threads counts the calling thread too, 0 picks the hardware count. pin binds worker i to core i
+        //(Linux only, pthread_setaffinity_np), the calling thread is left alone.
+        explicit ThreadPool(unsigned threads = 0, bool pin = false);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        //Runs body(task) for every task in [0, tasks) and returns once all are done. The caller runs task 0 and then
+        //helps with the rest, so nested and concurrent calls are fine. body must not throw.
+        void run(uint32_t tasks, const std::function<void(uint32_t)>& body);
+
+    private:
+        friend class TaskGroup;
+
+        void submit(Task* task);
+        //Runs one task from this thread's deque, another worker's deque or the injection queue, false if none was found
+        bool run_one();
+        void execute(Task* task);
+        void worker_loop(unsigned index, bool pin);
+
+        std::vector<std::unique_ptr<WorkDeque>> deques;    //One per worker
+        std::vector<std::thread> workers;
+        std::mutex inject_mutex;
+        std::deque<Task*> injected;                        //Tasks spawned by threads outside the pool
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::atomic<int64_t> queued{ 0 };
+        std::atomic<uint32_t> sleeping{ 0 };
+        std::atomic<bool> stopping{ false };
+    };
+
+    //Shared pool, created on first use
+    ThreadPool& default_pool();
+    //Replaces the shared pool, only call it while nothing is running on it
+    void set_threads(unsigned threads, bool pin = false);
+
+    //Fork/join scope: spawn any number of tasks, wait() (or the destructor) works on queued tasks until they are done
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool = default_pool()) : pool(pool) {}
+        ~TaskGroup() { wait(); }
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        //body must not throw
+        void spawn(std::function<void()> body);
+        void wait();
+
+    private:
+        ThreadPool& pool;
+        std::atomic<uint32_t> pending{ 0 };
+        std::deque<Task> tasks;     //Stable addresses while queued
+    };
+
+    //Runs a and b in parallel
+    template <typename A, typename B>
+    void parallel_invoke(A a, B b) {
+        TaskGroup group;
+        group.spawn(b);
+        a();
+        group.wait();
+    }
+
+    //Cost model: how many threads work units of total work should use, at most max_tasks
+    unsigned plan_threads(uint64_t work, uint32_t max_tasks);
+
+    //Splits [0, count) into contiguous ranges whose starts are multiples of align and runs body(begin, end) on each,
+    //work_per_item is the cost of one item for the cost model. Small jobs run inline.
+    template <typename Body>
+    void parallel_for(uint32_t count, uint64_t work_per_item, uint32_t align, Body body) {
+        align = std::max(align, 1u);
+        const uint32_t units = (count + align - 1) / align;
+        const unsigned threads = plan_threads(work_per_item * count, units);
+        if (threads <= 1) {
+            if (count > 0) {
+                body(0u, count);
+            }
+            return;
+        }
+        default_pool().run(threads, [&](uint32_t t) {
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(units) * t / threads) * align;
+            uint32_t end = std::min(count, static_cast<uint32_t>(static_cast<uint64_t>(units) * (t + 1) / threads) * align);
+            if (begin < end) {
+                body(begin, end);
+            }
+        });
+    }
+}
+
+#endif
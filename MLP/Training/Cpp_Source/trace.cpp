@@ -0,0 +1,206 @@
+// trace.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This file implements the per-thread trace rings and the Chrome trace-event JSON writer.
+
+#include "trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+
+namespace trace {
+    namespace detail {
+        std::atomic<bool> enabled{ false };
+        thread_local bool sample_active = true;
+    }
+
+    namespace {
+        constexpr uint32_t RING_CAPACITY = 1u << 16;
+
+        struct TraceState {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+            std::vector<bool> name_written;
+            std::ofstream file;
+            bool first_event = true;
+            uint32_t next_thread_id = 1;
+            std::atomic<uint32_t> sample_every{ 1 };
+            int64_t origin_ns = 0;
+        };
+
+        TraceState& state() {
+            static TraceState instance;
+            return instance;
+        }
+
+        thread_local std::shared_ptr<ThreadRing> local_ring;
+        thread_local std::string local_name;
+        thread_local uint64_t sample_counter = 0;
+
+        //Rings are registered on a thread's first span and kept alive by the registry until the process exits
+        ThreadRing* get_local_ring() {
+            if (!local_ring) {
+                TraceState& s = state();
+                std::lock_guard<std::mutex> lock(s.mutex);
+                local_ring = std::make_shared<ThreadRing>(s.next_thread_id++, RING_CAPACITY);
+                local_ring->thread_name = local_name.empty() ? "thread " + std::to_string(local_ring->get_thread_id()) : local_name;
+                s.rings.push_back(local_ring);
+                s.name_written.push_back(false);
+            }
+            return local_ring.get();
+        }
+
+        //Writes text as a JSON string, quotes included. Thread names come from callers and span names are only required
+        //to be literals, so either may hold quotes, backslashes or control characters.
+        void write_json_string(std::ostream& out, const char* text) {
+            out << '"';
+            for (const char* c = text; *c != '\0'; ++c) {
+                switch (*c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        static const char hex[] = "0123456789abcdef";
+                        out << "\\u00" << hex[(*c >> 4) & 0xf] << hex[*c & 0xf];
+                    }
+                    else {
+                        out << *c;
+                    }
+                }
+            }
+            out << '"';
+        }
+
+        void write_separator(TraceState& s) {
+            s.file << (s.first_event ? "\n" : ",\n");
+            s.first_event = false;
+        }
+    }
+
+    ThreadRing::ThreadRing(uint32_t thread_id, uint32_t capacity)
+        : thread_id(thread_id), mask(capacity - 1), events(capacity), head(0), tail(0), dropped(0) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("Trace ring capacity must be a power of two");
+        }
+    }
+
+    bool ThreadRing::push(const Event& event) {
+        uint64_t head_pos = head.load(std::memory_order_relaxed);
+        if (head_pos - tail.load(std::memory_order_acquire) >= events.size()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        events[head_pos & mask] = event;
+        head.store(head_pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool start(const std::string& file_path, uint32_t sample_every) {
+        TraceState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.file.is_open()) {
+            return true;
+        }
+        s.file.open(file_path);
+        if (!s.file.is_open()) {
+            std::cerr << "Error: Unable to open trace file " << file_path << std::endl;
+            return false;
+        }
+        s.file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        s.file << std::fixed << std::setprecision(3);
+        s.first_event = true;
+        s.sample_every.store(sample_every == 0 ? 1 : sample_every, std::memory_order_relaxed);
+        s.origin_ns = now_ns();
+        std::fill(s.name_written.begin(), s.name_written.end(), false);
+        detail::enabled.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void flush() {
+        TraceState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.file.is_open()) {
+            return;
+        }
+        for (size_t r = 0; r < s.rings.size(); ++r) {
+            ThreadRing& ring = *s.rings[r];
+            if (!s.name_written[r]) {
+                write_separator(s);
+                s.file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring.get_thread_id()
+                    << ",\"args\":{\"name\":";
+                write_json_string(s.file, ring.thread_name.c_str());
+                s.file << "}}";
+                s.name_written[r] = true;
+            }
+            ring.drain([&](const Event& event) {
+                write_separator(s);
+                s.file << "{\"name\":";
+                write_json_string(s.file, event.name);
+                s.file << ",\"cat\":";
+                write_json_string(s.file, event.category);
+                s.file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring.get_thread_id()
+                    << ",\"ts\":" << (event.start_ns - s.origin_ns) / 1000.0
+                    << ",\"dur\":" << event.duration_ns / 1000.0 << "}";
+            });
+        }
+        s.file.flush();
+    }
+
+    void stop() {
+        detail::enabled.store(false, std::memory_order_release);
+        flush();
+        TraceState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.file.is_open()) {
+            return;
+        }
+        s.file << "\n]}\n";
+        s.file.close();
+        uint64_t dropped = 0;
+        for (const auto& ring : s.rings) {
+            dropped += ring->get_dropped();
+        }
+        if (dropped > 0) {
+            std::cerr << "Warning: " << dropped << " trace events dropped, pass a larger --trace-sample N to record the per-sample spans less often, or flush more often" << std::endl;
+        }
+    }
+
+    void set_thread_name(const std::string& name) {
+        //Threads that never record a span never allocate a ring, the name is applied when they do
+        local_name = name;
+        if (!local_ring) {
+            return;
+        }
+        TraceState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        local_ring->thread_name = name;
+        //Re-emit the metadata event on the next flush so the rename shows up
+        for (size_t r = 0; r < s.rings.size(); ++r) {
+            if (s.rings[r] == local_ring) {
+                s.name_written[r] = false;
+            }
+        }
+    }
+
+    void sample_tick() {
+        uint32_t every = state().sample_every.load(std::memory_order_relaxed);
+        detail::sample_active = (sample_counter++ % every) == 0;
+    }
+
+    void record(const char* name, const char* category, int64_t start_ns, int64_t end_ns) {
+        get_local_ring()->push(Event{ name, category, start_ns, end_ns - start_ns });
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+// trace.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header declares the scoped-span tracer, spans are recorded into a lock-free ring per thread and flushed (normally at the end of an epoch) as Chrome trace-event JSON that loads in Perfetto or chrome://tracing.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trace {
+    //One complete ("ph":"X") event, name and category must be string literals since only the pointer is stored
+    struct Event {
+        const char* name;
+        const char* category;
+        int64_t start_ns;
+        int64_t duration_ns;
+    };
+
+    //Single producer (the owning thread) single consumer (the flusher) ring, events are dropped when it is full
+    class ThreadRing {
+    public:
+        ThreadRing(uint32_t thread_id, uint32_t capacity);
+
+        bool push(const Event& event);
+        template <typename Fn>
+        size_t drain(Fn&& fn) {
+            uint64_t tail_pos = tail.load(std::memory_order_relaxed);
+            uint64_t head_pos = head.load(std::memory_order_acquire);
+            size_t count = 0;
+            for (; tail_pos != head_pos; ++tail_pos, ++count) {
+                fn(events[tail_pos & mask]);
+            }
+            tail.store(tail_pos, std::memory_order_release);
+            return count;
+        }
+
+        uint32_t get_thread_id() const { return thread_id; }
+        uint64_t get_dropped() const { return dropped.load(std::memory_order_relaxed); }
+        std::string thread_name;
+
+    private:
+        uint32_t thread_id;
+        uint64_t mask;
+        std::vector<Event> events;
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        std::atomic<uint64_t> dropped;
+    };
+
+    //Opens the trace file, sample_every = N records the sampled (hot) spans of one in every N iterations
+    bool start(const std::string& file_path, uint32_t sample_every = 1);
+    //Drains every thread ring into the file, call it at the end of each epoch
+    void flush();
+    //Flushes and closes the JSON array
+    void stop();
+
+    int64_t now_ns();
+    void set_thread_name(const std::string& name);
+    //Called once per hot-loop iteration to decide whether its sampled spans are recorded
+    void sample_tick();
+    void record(const char* name, const char* category, int64_t start_ns, int64_t end_ns);
+
+    namespace detail {
+        extern std::atomic<bool> enabled;
+        extern thread_local bool sample_active;
+    }
+
+    inline bool is_enabled() {
+        return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    //Records [construction, destruction) as one span when tracing is on
+    class ScopedSpan {
+    public:
+        ScopedSpan(const char* name, const char* category, bool sampled = false)
+            : name(name), category(category),
+            active(is_enabled() && (!sampled || detail::sample_active)),
+            start_ns(active ? now_ns() : 0) {}
+        ~ScopedSpan() {
+            if (active) {
+                record(name, category, start_ns, now_ns());
+            }
+        }
+        ScopedSpan(const ScopedSpan&) = delete;
+        ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    private:
+        const char* name;
+        const char* category;
+        bool active;
+        int64_t start_ns;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifndef EDGEMLP_NO_TRACE
+//Span recorded every time (epochs, loaders, checkpoints)
+#define TRACE_SCOPE(name, category) ::trace::ScopedSpan TRACE_CONCAT(trace_span_, __LINE__)(name, category)
+//Span inside the per-sample loop, only recorded on iterations picked by trace::sample_tick
+#define TRACE_SCOPE_SAMPLED(name, category) ::trace::ScopedSpan TRACE_CONCAT(trace_span_, __LINE__)(name, category, true)
+#define TRACE_SAMPLE_TICK() ::trace::sample_tick()
+#else
+#define TRACE_SCOPE(name, category) ((void)0)
+#define TRACE_SCOPE_SAMPLED(name, category) ((void)0)
+#define TRACE_SAMPLE_TICK() ((void)0)
+#endif
+
+#endif
@@ -4,67 +4,128 @@
 // Purpose: This file contains the implementation of utility functions for reading data, initializing weights, and saving/loading weights.
 
 #include "utilities.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "metrics.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <random>
 #include <ctime>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
 
+namespace {
+    //Lines per parse task, and the cost model's estimate of one line in multiply-adds
+    constexpr size_t PARSE_CHUNK_LINES = 1024;
+    constexpr uint64_t PARSE_WORK_PER_LINE = 64;
 
-std::vector<std::pair<std::vector<float>, int>> read_float_data(const std::string& file_path) {
-    std::vector<std::pair<std::vector<float>, int>> data;
-    std::ifstream file(file_path);
+    using LineSpan = std::pair<size_t, size_t>;
 
-    if (!file.is_open()) {
-        std::cerr << "Error: Unable to open file " << file_path << std::endl;
-        return data;
+    //Reads the whole file and splits it into the same lines std::getline would return
+    bool read_lines(const std::string& file_path, std::string& text, std::vector<LineSpan>& lines) {
+        std::ifstream file(file_path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        text = contents.str();
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            lines.emplace_back(pos, end - pos);
+            pos = end + 1;
+        }
+        return true;
     }
 
-    std::string line;
-    int line_number = 0;
-    while (std::getline(file, line)) {
-        line_number++;
-        std::stringstream ss(line);
-        std::vector<float> input;
-        std::string token;
-
-        // Read and print the entire line
-        std::cout << "Line " << line_number << ": " << line << std::endl;
-
-        // Read input values
-        while (std::getline(ss, token, ',')) {
-            try {
-                float value = std::stof(token);
-                input.push_back(value);
-            }
-            catch (const std::invalid_argument& e) {
-                std::cerr << "Warning: Invalid float value '" << token << "' found in input at line " << line_number << std::endl;
-            }
-            catch (const std::out_of_range& e) {
-                std::cerr << "Warning: Float value out of range '" << token << "' found in input at line " << line_number << std::endl;
+    //Parses chunks of lines on the shared scheduler. parse_line(line, line_number, samples, warnings) appends to its
+    //chunk's samples and warnings, which are joined (and the warnings printed) in line order afterwards.
+    template <typename Sample, typename ParseLine>
+    std::vector<Sample> parse_lines(const std::string& text, const std::vector<LineSpan>& lines, ParseLine parse_line) {
+        const uint32_t chunks = static_cast<uint32_t>((lines.size() + PARSE_CHUNK_LINES - 1) / PARSE_CHUNK_LINES);
+        std::vector<std::vector<Sample>> samples(chunks);
+        std::vector<std::string> warnings(chunks);
+        parallel::parallel_for(chunks, PARSE_CHUNK_LINES * PARSE_WORK_PER_LINE, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t c = begin; c < end; ++c) {
+                std::ostringstream chunk_warnings;
+                size_t last = std::min(lines.size(), (c + 1) * PARSE_CHUNK_LINES);
+                for (size_t i = c * PARSE_CHUNK_LINES; i < last; ++i) {
+                    std::string line = text.substr(lines[i].first, lines[i].second);
+                    parse_line(line, static_cast<int>(i + 1), samples[c], chunk_warnings);
+                }
+                warnings[c] = chunk_warnings.str();
             }
-        }
+        });
 
-        // Check if input is not empty
-        if (input.empty()) {
-            std::cerr << "Warning: Empty input at line " << line_number << std::endl;
-            continue;
+        std::vector<Sample> data;
+        for (uint32_t c = 0; c < chunks; ++c) {
+            std::cerr << warnings[c];
+            data.insert(data.end(), std::make_move_iterator(samples[c].begin()), std::make_move_iterator(samples[c].end()));
         }
+        return data;
+    }
+}
 
-        // Assume the last value is the label
-        int label = static_cast<int>(input.back());
-        input.pop_back();
+std::vector<std::pair<std::vector<float>, int>> read_float_data(const std::string& file_path) {
+    TRACE_SCOPE("read_float_data", "io");
+    std::string text;
+    std::vector<LineSpan> lines;
+    if (!read_lines(file_path, text, lines)) {
+        std::cerr << "Error: Unable to open file " << file_path << std::endl;
+        return {};
+    }
 
-        if (label != 0 && label != 1) {
-            std::cerr << "Warning: Invalid label " << label << " at line " << line_number << ". Expected 0 or 1." << std::endl;
-            continue;
+    // Echo the lines only at debug level, formatting every line used to dominate load time
+    if (metrics::should_log(metrics::LogLevel::Debug)) {
+        for (size_t i = 0; i < lines.size(); ++i) {
+            metrics::log(metrics::LogLevel::Debug, "Line " + std::to_string(i + 1) + ": " + text.substr(lines[i].first, lines[i].second));
         }
-
-        data.emplace_back(input, label);
     }
 
-    file.close();
+    auto data = parse_lines<std::pair<std::vector<float>, int>>(text, lines,
+        [](const std::string& line, int line_number, std::vector<std::pair<std::vector<float>, int>>& out, std::ostream& warnings) {
+            std::stringstream ss(line);
+            std::vector<float> input;
+            std::string token;
+
+            // Read input values
+            while (std::getline(ss, token, ',')) {
+                try {
+                    float value = std::stof(token);
+                    input.push_back(value);
+                }
+                catch (const std::invalid_argument&) {
+                    warnings << "Warning: Invalid float value '" << token << "' found in input at line " << line_number << "\n";
+                }
+                catch (const std::out_of_range&) {
+                    warnings << "Warning: Float value out of range '" << token << "' found in input at line " << line_number << "\n";
+                }
+            }
+
+            // Check if input is not empty
+            if (input.empty()) {
+                warnings << "Warning: Empty input at line " << line_number << "\n";
+                return;
+            }
+
+            // Assume the last value is the label
+            int label = static_cast<int>(input.back());
+            input.pop_back();
+
+            if (label != 0 && label != 1) {
+                warnings << "Warning: Invalid label " << label << " at line " << line_number << ". Expected 0 or 1." << "\n";
+                return;
+            }
+
+            out.emplace_back(input, label);
+        });
 
     std::cout << "Successfully read " << data.size() << " samples from " << file_path << std::endl;
 
@@ -73,63 +134,93 @@ std::vector<std::pair<std::vector<float>, int>> read_float_data(const std::strin
 
 
 std::vector<std::pair<std::vector<int>, int>> read_data(const std::string& file_path) {
-    std::vector<std::pair<std::vector<int>, int>> data;
-    std::ifstream file(file_path);
-
-    if (!file.is_open()) {
+    TRACE_SCOPE("read_data", "io");
+    std::string text;
+    std::vector<LineSpan> lines;
+    if (!read_lines(file_path, text, lines)) {
         std::cerr << "Error: Unable to open file " << file_path << std::endl;
-        return data;
+        return {};
     }
 
-    std::string line;
-    int line_number = 0;
-    while (std::getline(file, line)) {
-        line_number++;
-        std::stringstream ss(line);
-        std::vector<int> input;
-        int label;
-        std::string token;
-
-        //Read input values
-        if (std::getline(ss, token, ',')) {
-            for (char c : token) {
-                if (std::isdigit(c)) {
-                    input.push_back(c - '0');
+    auto data = parse_lines<std::pair<std::vector<int>, int>>(text, lines,
+        [](const std::string& line, int line_number, std::vector<std::pair<std::vector<int>, int>>& out, std::ostream& warnings) {
+            std::stringstream ss(line);
+            std::vector<int> input;
+            int label;
+            std::string token;
+
+            //Read input values
+            if (std::getline(ss, token, ',')) {
+                for (char c : token) {
+                    if (std::isdigit(c)) {
+                        input.push_back(c - '0');
+                    }
+                    else {
+                        warnings << "Warning: Non-digit character '" << c << "' found in input at line " << line_number << "\n";
+                    }
                 }
-                else {
-                    std::cerr << "Warning: Non-digit character '" << c << "' found in input at line " << line_number << std::endl;
+            }
+            else {
+                warnings << "Error: Invalid format at line " << line_number << "\n";
+                return;
+            }
+
+            //Read label
+            if (ss >> label) {
+                if (label != 0 && label != 1) {
+                    warnings << "Warning: Invalid label " << label << " at line " << line_number << ". Expected 0 or 1." << "\n";
+                    return;
                 }
             }
-        }
-        else {
-            std::cerr << "Error: Invalid format at line " << line_number << std::endl;
-            continue;
-        }
+            else {
+                warnings << "Error: Unable to read label at line " << line_number << "\n";
+                return;
+            }
 
-        //Read label
-        if (ss >> label) {
-            if (label != 0 && label != 1) {
-                std::cerr << "Warning: Invalid label " << label << " at line " << line_number << ". Expected 0 or 1." << std::endl;
-                continue;
+            //Check if input is not empty
+            if (input.empty()) {
+                warnings << "Warning: Empty input at line " << line_number << "\n";
+                return;
             }
-        }
-        else {
-            std::cerr << "Error: Unable to read label at line " << line_number << std::endl;
-            continue;
-        }
 
-        //Check if input is not empty
-        if (input.empty()) {
-            std::cerr << "Warning: Empty input at line " << line_number << std::endl;
-            continue;
-        }
+            out.emplace_back(input, label);
+        });
 
-        data.emplace_back(input, label);
+    std::cout << "Successfully read " << data.size() << " samples from " << file_path << std::endl;
+
+    return data;
+}
+
+//Function to read "number, label" lines into the number and divisibility flag features used by main.cpp
+std::vector<std::pair<std::vector<float>, int>> read_data_from_file(const std::string& file_path) {
+    TRACE_SCOPE("read_data_from_file", "io");
+    std::string text;
+    std::vector<LineSpan> lines;
+    if (!read_lines(file_path, text, lines)) {
+        throw std::runtime_error("Error: Unable to open file " + file_path);
     }
 
-    file.close();
+    auto data = parse_lines<std::pair<std::vector<float>, int>>(text, lines,
+        [](const std::string& line, int, std::vector<std::pair<std::vector<float>, int>>& out, std::ostream& warnings) {
+            std::stringstream ss(line);
+            int number, target;
+            char delimiter;
+            if (ss >> number >> delimiter >> target) {
+                // Create a feature vector with the number and its divisibility flag
+                std::vector<float> features;
+                features.push_back(static_cast<float>(number)); // Original number
+                features.push_back(number % 2 == 0 ? 1.0f : 0.0f); // Divisibility flag
 
-    std::cout << "Successfully read " << data.size() << " samples from " << file_path << std::endl;
+                out.emplace_back(features, target);
+            }
+            else {
+                warnings << "Warning: Invalid line format: " << line << "\n";
+            }
+        });
+
+    if (data.empty()) {
+        std::cerr << "Warning: No data read from file. Check file format and content." << std::endl;
+    }
 
     return data;
 }
@@ -149,6 +240,7 @@ void initialize_weights(std::vector<float>& weights, int num_weights, std::vecto
 }
 
 void save_weights(const std::vector<float>& weights, const std::string& file_path) {
+    TRACE_SCOPE("save_weights", "checkpoint");
     std::ofstream file(file_path);
     if (file.is_open()) {
         for (float weight : weights) {
@@ -160,6 +252,7 @@ void save_weights(const std::vector<float>& weights, const std::string& file_pat
 }
 
 std::vector<float> load_weights(const std::string& file_path) {
+    TRACE_SCOPE("load_weights", "checkpoint");
     std::vector<float> weights;
     std::ifstream file(file_path);
     if (file.is_open()) {
@@ -19,6 +19,9 @@ std::vector<std::pair<std::vector<float>, int>> read_float_data(const std::strin
 //Function to read data from a text file
 std::vector<std::pair<std::vector<int>, int>> read_data(const std::string& file_path);
 
+//Function to read "number, label" lines into [number, divisibility flag] features
+std::vector<std::pair<std::vector<float>, int>> read_data_from_file(const std::string& file_path);
+
 //Function to initialize weights randomly
 void initialize_weights(std::vector<float>& weights, int num_weights, std::vector<float>& biases, int num_biases);
 
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include "activate.h"
 
 // Helper function to check if two floats are approximately equal
@@ -72,12 +73,81 @@ void test_softmax() {
     }
 }
 
+// Test the array versions against double precision references over a dense sweep
+void test_array_functions() {
+    std::cout << "Testing array activation functions..." << std::endl;
+    std::vector<float> inputs;
+    for (float x = -90.0f; x <= 90.0f; x += 0.0137f) {
+        inputs.push_back(x);
+    }
+    std::vector<float> output(inputs.size());
+    bool all_pass = true;
+
+    // exp, relative error inside the documented range
+    double max_exp_error = 0.0;
+    for (float x : inputs) {
+        if (x < -87.0f || x > 88.0f) continue;
+        double exact = std::exp(static_cast<double>(x));
+        max_exp_error = std::max(max_exp_error, std::abs(activate::fast_exp(x) - exact) / exact);
+    }
+
+    activate::sigmoid_n(inputs.data(), output.data(), inputs.size(), activate::Mode::Fast);
+    double max_sigmoid_error = 0.0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        double exact = 1.0 / (1.0 + std::exp(-static_cast<double>(inputs[i])));
+        max_sigmoid_error = std::max(max_sigmoid_error, std::abs(output[i] - exact));
+        // Every lane, including the scalar tail, must match the scalar approximation
+        if (output[i] != activate::fast_sigmoid(inputs[i])) all_pass = false;
+    }
+
+    activate::tanh_n(inputs.data(), output.data(), inputs.size(), activate::Mode::Fast);
+    double max_tanh_error = 0.0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        max_tanh_error = std::max(max_tanh_error, std::abs(output[i] - std::tanh(static_cast<double>(inputs[i]))));
+    }
+
+    std::vector<float> logits = { 1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.5f, 7.0f, -3.0f, 2.5f, 0.0f, 1.5f };
+    std::vector<float> probabilities(logits.size());
+    activate::softmax_n(logits.data(), probabilities.data(), logits.size(), activate::Mode::Fast);
+    double max_softmax_error = 0.0, sum = 0.0, denominator = 0.0;
+    for (float x : logits) denominator += std::exp(static_cast<double>(x));
+    for (size_t i = 0; i < logits.size(); ++i) {
+        max_softmax_error = std::max(max_softmax_error, std::abs(probabilities[i] - std::exp(static_cast<double>(logits[i])) / denominator));
+        sum += probabilities[i];
+    }
+
+    std::vector<float> relu_out(inputs.size()), leaky_out(inputs.size());
+    activate::relu_n(inputs.data(), relu_out.data(), inputs.size());
+    activate::leaky_relu_n(inputs.data(), leaky_out.data(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (relu_out[i] != activate::relu(inputs[i]) || leaky_out[i] != activate::leaky_relu(inputs[i])) all_pass = false;
+    }
+
+    // Exact mode must match the scalar functions bit for bit
+    activate::sigmoid_n(inputs.data(), output.data(), inputs.size(), activate::Mode::Exact);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (output[i] != activate::sigmoid(inputs[i])) all_pass = false;
+    }
+
+    std::cout << "Max errors: exp " << max_exp_error << " (relative), sigmoid " << max_sigmoid_error
+        << ", tanh " << max_tanh_error << ", softmax " << max_softmax_error << std::endl;
+    if (max_exp_error < 2e-7 && max_sigmoid_error < 2e-7 && max_tanh_error < 2e-7 &&
+        max_softmax_error < 2e-7 && std::abs(sum - 1.0) < 1e-6 && all_pass) {
+        std::cout << "PASS: Array activation functions within documented error" << std::endl;
+    }
+    else {
+        std::cout << "FAIL: Array activation functions outside documented error" << std::endl;
+    }
+}
+
 int main() {
     test_relu();
     std::cout << std::endl;
     test_sigmoid();
     std::cout << std::endl;
     test_softmax();
+    std::cout << std::endl;
+    test_array_functions();
 
     return 0;
 }
\ No newline at end of file
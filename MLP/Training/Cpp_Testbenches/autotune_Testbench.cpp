@@ -0,0 +1,119 @@
+// autotune_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the kernel autotuner and the tuning cache.
+
+#include "autotune.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cassert>
+
+static autotune::Shape make_shape(uint32_t inputs, uint32_t outputs, uint32_t batch) {
+    autotune::Shape shape;
+    shape.inputs = inputs;
+    shape.outputs = outputs;
+    shape.batch = batch;
+    return shape;
+}
+
+//Test kernel names round trip and the model hash only depends on the shapes
+void test_names_and_hash() {
+    std::cout << "Testing kernel names and model_hash..." << std::endl;
+    const autotune::Kernel kernels[] = {
+        autotune::Kernel::RowMajor, autotune::Kernel::Packed1, autotune::Kernel::Packed2,
+        autotune::Kernel::Packed4, autotune::Kernel::Packed8
+    };
+    for (autotune::Kernel kernel : kernels) {
+        autotune::Kernel parsed;
+        assert(autotune::parse_kernel(autotune::kernel_name(kernel), parsed) && parsed == kernel);
+    }
+    autotune::Kernel parsed;
+    assert(!autotune::parse_kernel("sparse", parsed));
+    assert(autotune::row_tile(autotune::Kernel::RowMajor) == 0 && autotune::row_tile(autotune::Kernel::Packed4) == 4);
+
+    std::vector<autotune::Shape> a = { make_shape(64, 64, 1), make_shape(64, 1, 1) };
+    std::vector<autotune::Shape> b = { make_shape(64, 64, 8), make_shape(64, 1, 8) };
+    assert(autotune::model_hash(a) == autotune::model_hash(a));
+    assert(autotune::model_hash(a) != autotune::model_hash(b));
+    assert(!autotune::cpu_model().empty());
+    std::cout << "Kernel names and model_hash test passed." << std::endl;
+}
+
+//Test the first tune_model call times and saves every shape and the second one reads them all back
+void test_tune_model() {
+    std::cout << "Testing tune_model..." << std::endl;
+    const std::string path = "autotune_test.txt";
+    std::remove(path.c_str());
+    std::vector<autotune::Shape> layers = { make_shape(64, 64, 1), make_shape(9, 64, 4), make_shape(64, 1, 4) };
+
+    uint32_t tuned = 0;
+    std::vector<autotune::Choice> first = autotune::tune_model(layers, path, &tuned);
+    assert(tuned == layers.size() && first.size() == layers.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        assert(first[i].shape == layers[i] && first[i].ns_per_sample > 0.0);
+    }
+
+    std::vector<autotune::Choice> second = autotune::tune_model(layers, path, &tuned);
+    assert(tuned == 0);
+    for (size_t i = 0; i < second.size(); ++i) {
+        assert(second[i].kernel == first[i].kernel);
+    }
+
+    //A different model on the same cpu ignores the file and overwrites it
+    std::vector<autotune::Shape> other = { make_shape(16, 16, 1) };
+    autotune::tune_model(other, path, &tuned);
+    assert(tuned == 1);
+    autotune::TuningCache cache(autotune::cpu_model(), autotune::model_hash(layers));
+    assert(!cache.load(path));
+    std::remove(path.c_str());
+    std::cout << "tune_model test passed." << std::endl;
+}
+
+//Test the cache rejects files for another cpu and malformed entries
+void test_cache_file() {
+    std::cout << "Testing TuningCache..." << std::endl;
+    const std::string path = "autotune_cache_test.txt";
+    autotune::TuningCache cache("Test CPU [scalar]", 42);
+    autotune::Choice choice;
+    choice.shape = make_shape(8, 4, 2);
+    choice.kernel = autotune::Kernel::Packed2;
+    choice.ns_per_sample = 12.5;
+    cache.set(choice);
+    choice.kernel = autotune::Kernel::Packed4;
+    cache.set(choice);
+    assert(cache.get_choices().size() == 1);
+    assert(cache.save(path));
+
+    autotune::TuningCache same("Test CPU [scalar]", 42);
+    autotune::Choice found;
+    assert(same.load(path) && same.find(make_shape(8, 4, 2), found));
+    assert(found.kernel == autotune::Kernel::Packed4 && !same.find(make_shape(8, 4, 1), found));
+    autotune::TuningCache other_cpu("Other CPU [scalar]", 42);
+    assert(!other_cpu.load(path));
+
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "8 4 3 vectorized 1.0\n";
+    }
+    assert(!same.load(path) && same.get_choices().empty());
+    std::remove(path.c_str());
+    std::cout << "TuningCache test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_names_and_hash();
+        test_tune_model();
+        test_cache_file();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+// cascade_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for cascade inference, the distilled gate's exits against the calibrated agreement, the single and batched paths against each other and MLP::predict, the exit counters, the evaluation report and the argument checks.
+
+#include "cascade.h"
+#include "activate.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+//Inputs of 1 to 9 features spread wide enough that the MLP is sure about most of them, labeled by the MLP's class with
+//every tenth label flipped
+static cascade::Dataset make_data(const MLP& mlp, uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-8.0f, 8.0f);
+    std::uniform_int_distribution<size_t> length(1, INPUT_SIZE);
+    cascade::Dataset data(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        data[i].first.resize(length(rng));
+        for (auto& v : data[i].first) v = value(rng);
+        const int positive = mlp.predict(data[i].first) > 0.5f ? 1 : 0;
+        data[i].second = i % 10 == 0 ? 1 - positive : positive;
+    }
+    return data;
+}
+
+//Test the gate answers a good share of the calibration samples while keeping to the target agreement, and its exits are
+//its own probability while the rest are the MLP's score
+void test_calibration() {
+    std::cout << "Testing cascade calibration..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 21);
+    cascade::Dataset data = make_data(mlp, 4000, 22);
+    for (double target : { 0.99, 0.999, 1.0 }) {
+        cascade::Config config;
+        config.target_agreement = target;
+        cascade::Cascade model(mlp, data, config);
+        assert(std::isfinite(model.get_threshold()));
+        cascade::Report report = model.evaluate(data);
+        assert(report.count == data.size());
+        assert(report.exits > 0 && report.exit_rate > 0.2);
+        //Every disagreement is among the exits
+        assert(1.0 - report.agreement <= (1.0 - target) * report.exit_rate + 1e-12);
+        assert(std::abs(report.accuracy_delta - (report.cascade_accuracy - report.full_accuracy)) < 1e-12);
+        assert(std::abs(report.full_accuracy - 0.9) < 1e-12);
+        for (const auto& sample : data) {
+            std::vector<float> padded(INPUT_SIZE, 0.0f);
+            std::copy(sample.first.begin(), sample.first.end(), padded.begin());
+            float z = model.get_gate_bias();
+            for (uint32_t j = 0; j < INPUT_SIZE; ++j) z += model.get_gate_weights()[j] * padded[j];
+            float expected = std::abs(z) >= model.get_threshold() ? activate::sigmoid(z) : mlp.predict(sample.first);
+            assert(close(model.predict(sample.first), expected));
+        }
+        assert(model.get_predictions() == data.size() && model.get_exits() == report.exits);
+    }
+    std::cout << "Cascade calibration test passed." << std::endl;
+}
+
+//Test the compacted batch path against one at a time on held out data, counters included
+void test_batch() {
+    std::cout << "Testing cascade batches..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 23);
+    cascade::Cascade model(mlp, make_data(mlp, 2000, 24));
+    //Long enough for several full chunks of survivors and a partial one
+    cascade::Dataset held_out = make_data(mlp, 3001, 25);
+    std::vector<float> scores = model.predict_batch(held_out);
+    assert(scores.size() == held_out.size());
+    const uint64_t batch_exits = model.get_exits();
+    assert(model.get_predictions() == held_out.size() && batch_exits > 0 && batch_exits < held_out.size());
+    model.reset_counters();
+    for (size_t i = 0; i < held_out.size(); ++i) {
+        assert(close(scores[i], model.predict(held_out[i].first)));
+    }
+    assert(model.get_exits() == batch_exits);
+    assert(std::abs(model.get_exit_rate() - static_cast<double>(batch_exits) / held_out.size()) < 1e-12);
+    assert(model.predict_batch({}).empty());
+    std::cout << "Cascade batches test passed." << std::endl;
+}
+
+//Test a stricter target never exits more often, and a single calibration sample, which always agrees with itself, exits
+void test_targets() {
+    std::cout << "Testing cascade agreement targets..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 26);
+    cascade::Dataset data = make_data(mlp, 3000, 27);
+    double last_rate = 1.0;
+    for (double target : { 0.9, 0.99, 0.999, 1.0 }) {
+        cascade::Config config;
+        config.target_agreement = target;
+        double rate = cascade::Cascade(mlp, data, config).evaluate(data).exit_rate;
+        assert(rate <= last_rate);
+        last_rate = rate;
+    }
+    cascade::Dataset single = { { { 1.0f }, 1 } };
+    cascade::Config config;
+    config.target_agreement = 1.0;
+    cascade::Report report = cascade::Cascade(mlp, single, config).evaluate(single);
+    assert(report.exits == 1 && report.agreement == 1.0);
+    std::cout << "Cascade agreement targets test passed." << std::endl;
+}
+
+//Test empty calibration, bad targets and inputs predict would refuse throw
+void test_invalid_arguments() {
+    std::cout << "Testing cascade argument checks..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    cascade::Dataset data = make_data(mlp, 100, 28);
+    expect_invalid([&] { cascade::Cascade model(mlp, {}); });
+    for (double target : { 0.0, -0.5, 1.5 }) {
+        cascade::Config config;
+        config.target_agreement = target;
+        expect_invalid([&] { cascade::Cascade model(mlp, data, config); });
+    }
+    expect_invalid([&] { cascade::Cascade model(mlp, { { {}, 0 } }); });
+    cascade::Cascade model(mlp, data);
+    expect_invalid([&] { model.predict(std::vector<float>(11, 1.0f)); });
+    expect_invalid([&] { model.predict_batch({ { { 1.0f }, 0 }, { {}, 1 } }); });
+    assert(model.get_predictions() == 0);
+    expect_invalid([&] { model.evaluate({ { {}, 0 } }); });
+    std::cout << "Cascade argument checks test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_calibration();
+        test_batch();
+        test_targets();
+        test_invalid_arguments();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+// checkpoint_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the checkpoint file format, the background writer and resuming training bit-exactly, with and without optimizer state
+
+#include "checkpoint.h"
+#include "MLP.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+
+//Same per-sample step as main.cpp
+static void train_steps(MLP& mlp, int begin, int end) {
+    for (int number = begin; number < end; ++number) {
+        std::vector<float> features = { static_cast<float>(number % 97), number % 2 == 0 ? 1.0f : 0.0f };
+        mlp.forward(features);
+        float error = mlp.get_output()[0] - static_cast<float>(number % 2);
+        mlp.get_output_layer().update_weights(error, 0.01f);
+        mlp.get_hidden_layer1().update_weights(error, 0.01f);
+        mlp.get_input_layer().update_weights(error, 0.01f);
+    }
+}
+
+//Same steps through the fused optimizer
+static void train_steps(MLP& mlp, optim::Optimizer& optimizer, int begin, int end) {
+    for (int number = begin; number < end; ++number) {
+        std::vector<float> features = { static_cast<float>(number % 97), number % 2 == 0 ? 1.0f : 0.0f };
+        mlp.forward(features);
+        mlp.update_weights(mlp.get_output()[0] - static_cast<float>(number % 2), optimizer);
+    }
+}
+
+//Test the file round trip keeps every parameter and the trainer state
+void test_round_trip() {
+    std::cout << "Testing checkpoint round trip..." << std::endl;
+    MLP mlp(2);
+    TrainerState state;
+    state.epoch = 3;
+    state.sample_index = 17;
+    state.learning_rate = 0.05f;
+    state.epoch_loss = 1.25;
+    state.epoch_correct = 9;
+    state.rng_state = "1 2 3";
+
+    Checkpoint saved;
+    capture_checkpoint(mlp, state, saved);
+    assert(write_checkpoint_file(saved, "checkpoint_testbench.bin"));
+
+    Checkpoint loaded;
+    assert(read_checkpoint_file("checkpoint_testbench.bin", loaded));
+    assert(loaded.state.epoch == 3 && loaded.state.sample_index == 17);
+    assert(loaded.state.learning_rate == 0.05f && loaded.state.epoch_loss == 1.25);
+    assert(loaded.state.epoch_correct == 9 && loaded.state.rng_state == "1 2 3");
+    assert(loaded.layers.size() == saved.layers.size());
+    for (size_t l = 0; l < saved.layers.size(); ++l) {
+        assert(loaded.layers[l].name == saved.layers[l].name);
+        assert(loaded.layers[l].weights == saved.layers[l].weights);
+        assert(loaded.layers[l].biases == saved.layers[l].biases);
+    }
+    std::cout << "Checkpoint round trip test passed." << std::endl;
+}
+
+//Test that a damaged file is rejected instead of being loaded
+void test_corruption() {
+    std::cout << "Testing corrupted checkpoint..." << std::endl;
+    std::fstream file("checkpoint_testbench.bin", std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(64);
+    file.put('\x7f');
+    file.close();
+
+    Checkpoint loaded;
+    assert(!read_checkpoint_file("checkpoint_testbench.bin", loaded));
+    std::remove("checkpoint_testbench.bin");
+    std::cout << "Corrupted checkpoint test passed." << std::endl;
+}
+
+//Test the async writer and that resuming continues exactly like an uninterrupted run
+void test_resume() {
+    std::cout << "Testing resume..." << std::endl;
+    MLP uninterrupted(2);
+    MLP interrupted(2);
+    Checkpoint initial;
+    capture_checkpoint(uninterrupted, TrainerState(), initial);
+    restore_checkpoint(initial, interrupted);
+
+    train_steps(uninterrupted, 0, 200);
+
+    train_steps(interrupted, 0, 120);
+    {
+        CheckpointWriter writer("checkpoint_testbench_async.bin");
+        TrainerState state;
+        state.sample_index = 120;
+        writer.submit(interrupted, state);
+        writer.wait_idle();
+        assert(writer.get_written() == 1);
+    }
+
+    Checkpoint checkpoint;
+    assert(read_checkpoint_file("checkpoint_testbench_async.bin", checkpoint));
+    MLP resumed(2);
+    restore_checkpoint(checkpoint, resumed);
+    train_steps(resumed, static_cast<int>(checkpoint.state.sample_index), 200);
+
+    assert(resumed.get_weights().to_vector() == uninterrupted.get_weights().to_vector());
+    assert(resumed.get_biases().to_vector() == uninterrupted.get_biases().to_vector());
+    std::remove("checkpoint_testbench_async.bin");
+    std::cout << "Resume test passed." << std::endl;
+}
+
+//Test that Adam's moments and bias corrections survive the checkpoint, so a resumed run matches an uninterrupted one
+void test_resume_adam() {
+    std::cout << "Testing resume with Adam..." << std::endl;
+    optim::Config config;
+    config.method = optim::Method::Adam;
+    config.learning_rate = 0.001f;
+    config.clip = 5.0f;
+
+    MLP uninterrupted(2);
+    MLP interrupted(2);
+    Checkpoint initial;
+    capture_checkpoint(uninterrupted, TrainerState(), initial);
+    restore_checkpoint(initial, interrupted);
+    optim::Optimizer uninterrupted_optimizer(config, uninterrupted.get_trainable_parameters().size());
+    optim::Optimizer interrupted_optimizer(config, interrupted.get_trainable_parameters().size());
+
+    train_steps(uninterrupted, uninterrupted_optimizer, 0, 200);
+
+    train_steps(interrupted, interrupted_optimizer, 0, 120);
+    {
+        CheckpointWriter writer("checkpoint_testbench_adam.bin");
+        TrainerState state;
+        state.sample_index = 120;
+        writer.submit(interrupted, state, &interrupted_optimizer);
+        writer.wait_idle();
+        assert(writer.get_written() == 1);
+    }
+
+    Checkpoint checkpoint;
+    assert(read_checkpoint_file("checkpoint_testbench_adam.bin", checkpoint));
+    assert(checkpoint.optimizer.present && checkpoint.optimizer.config.method == optim::Method::Adam);
+    assert(checkpoint.optimizer.steps == 120);
+    MLP resumed(2);
+    restore_checkpoint(checkpoint, resumed);
+    optim::Optimizer resumed_optimizer(checkpoint.optimizer.config, resumed.get_trainable_parameters().size());
+    restore_optimizer(checkpoint, resumed_optimizer);
+    train_steps(resumed, resumed_optimizer, static_cast<int>(checkpoint.state.sample_index), 200);
+
+    assert(resumed.get_weights().to_vector() == uninterrupted.get_weights().to_vector());
+    assert(resumed.get_biases().to_vector() == uninterrupted.get_biases().to_vector());
+    assert(resumed_optimizer.get_steps() == uninterrupted_optimizer.get_steps());
+
+    //A checkpoint without optimizer state, or for another method, is refused
+    optim::Config momentum = config;
+    momentum.method = optim::Method::Momentum;
+    optim::Optimizer other(momentum, resumed.get_trainable_parameters().size());
+    bool refused = false;
+    try {
+        restore_optimizer(checkpoint, other);
+    }
+    catch (const std::runtime_error&) {
+        refused = true;
+    }
+    assert(refused);
+    refused = false;
+    try {
+        restore_optimizer(initial, resumed_optimizer);
+    }
+    catch (const std::runtime_error&) {
+        refused = true;
+    }
+    assert(refused);
+    std::remove("checkpoint_testbench_adam.bin");
+    std::cout << "Resume with Adam test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_round_trip();
+        test_corruption();
+        test_resume();
+        test_resume_adam();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+// distributed_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the data-parallel pieces: fp16 conversion, the ring all-reduce over both transports (ranks as threads), data-parallel training against one process on the same minibatches, and real worker processes started through run_workers.
+// Usage: distributed_Testbench (the worker mode, --rank N --rendezvous name --transport shm|socket --workers N, is started by the test itself)
+
+#include "distributed.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <random>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+static std::string unique_name() {
+    static uint32_t counter = 0;
+    std::random_device random;
+    std::ostringstream name;
+    name << "edgemlp_test_" << std::hex << random() << "_" << counter++;
+    return name.str();
+}
+
+//Runs body(transport) for every rank of a ring on its own thread
+template <typename Body>
+static void run_ring(distributed::Backend backend, uint32_t size, size_t capacity, Body body) {
+    distributed::Endpoint endpoint;
+    endpoint.backend = backend;
+    endpoint.name = unique_name();
+    endpoint.size = size;
+    endpoint.capacity = capacity;
+    distributed::Session session(endpoint);
+    std::vector<std::thread> ranks;
+    std::vector<std::string> errors(size);
+    for (uint32_t r = 0; r < size; ++r) {
+        ranks.emplace_back([&, r]() {
+            try {
+                distributed::Endpoint mine = endpoint;
+                mine.rank = r;
+                std::unique_ptr<distributed::Transport> transport = distributed::connect(mine);
+                body(*transport);
+            }
+            catch (const std::exception& e) {
+                errors[r] = e.what();
+            }
+        });
+    }
+    for (auto& rank : ranks) rank.join();
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error("Ring rank failed: " + error);
+        }
+    }
+}
+
+//Test known fp16 encodings, rounding and that every half survives the round trip
+void test_half() {
+    std::cout << "Testing fp16 conversion..." << std::endl;
+    assert(distributed::to_half(1.0f) == 0x3c00);
+    assert(distributed::to_half(-2.0f) == 0xc000);
+    assert(distributed::to_half(65504.0f) == 0x7bff);
+    assert(distributed::to_half(65520.0f) == 0x7c00);
+    assert(distributed::to_half(std::ldexp(1.0f, -24)) == 0x0001);
+    assert(distributed::to_half(1e-9f) == 0x0000);
+    assert(distributed::to_half(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);                   //Tie rounds to even
+    assert(distributed::to_half(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02);
+    assert(std::isnan(distributed::from_half(distributed::to_half(std::nanf("")))));
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        float value = distributed::from_half(static_cast<uint16_t>(h));
+        if (!std::isnan(value)) {
+            assert(distributed::to_half(value) == h);
+        }
+    }
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    for (int i = 0; i < 10000; ++i) {
+        float value = dist(rng);
+        assert(std::abs(distributed::from_half(distributed::to_half(value)) - value) <= std::abs(value) * 0.0005f);
+    }
+    std::cout << "fp16 conversion test passed." << std::endl;
+}
+
+//Test sums on both transports for ring sizes and lengths that do not split evenly, with pieces bigger than a mailbox
+void test_all_reduce() {
+    std::cout << "Testing ring all-reduce..." << std::endl;
+    const distributed::Backend backends[] = { distributed::Backend::SharedMemory, distributed::Backend::Socket };
+    const uint32_t sizes[] = { 1, 2, 3, 5 };
+    const size_t counts[] = { 1, 7, 130, 5000 };
+    for (distributed::Backend backend : backends) {
+        for (uint32_t size : sizes) {
+            for (size_t count : counts) {
+                for (bool compress : { false, true }) {
+                    std::vector<std::vector<float>> results(size);
+                    run_ring(backend, size, 256, [&](distributed::Transport& transport) {
+                        //Small integers, so the sum is exact whatever order the ring adds in
+                        std::vector<float> values(count);
+                        for (size_t i = 0; i < count; ++i) {
+                            values[i] = static_cast<float>((i * 7 + transport.rank() * 3) % 64) - 20.0f;
+                        }
+                        distributed::all_reduce(transport, Span<float>(values.data(), count), compress);
+                        results[transport.rank()] = values;
+                    });
+                    for (size_t i = 0; i < count; ++i) {
+                        float expected = 0.0f;
+                        for (uint32_t r = 0; r < size; ++r) {
+                            expected += static_cast<float>((i * 7 + r * 3) % 64) - 20.0f;
+                        }
+                        assert(results[0][i] == expected);
+                        for (uint32_t r = 1; r < size; ++r) {
+                            assert(results[r][i] == results[0][i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //Compressed sums of arbitrary values are close and still identical on every rank
+    std::vector<std::vector<float>> results(4);
+    run_ring(distributed::Backend::SharedMemory, 4, 1024, [&](distributed::Transport& transport) {
+        std::mt19937 rng(transport.rank());
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> values(1000);
+        for (auto& v : values) v = dist(rng);
+        std::vector<float> exact = values;
+        distributed::all_reduce(transport, Span<float>(values.data(), values.size()), true);
+        distributed::all_reduce(transport, Span<float>(exact.data(), exact.size()), false);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (std::abs(values[i] - exact[i]) > 0.01f) {
+                throw std::runtime_error("fp16 all-reduce too far off");
+            }
+        }
+        results[transport.rank()] = values;
+    });
+    for (uint32_t r = 1; r < 4; ++r) {
+        assert(results[r] == results[0]);
+    }
+    std::cout << "Ring all-reduce test passed." << std::endl;
+}
+
+//Test two ranks with batch 4 follow one process with batch 8, both step on the same 8 samples
+void test_data_parallel() {
+    std::cout << "Testing data-parallel training..." << std::endl;
+    distributed::Dataset data;
+    for (int i = 0; i < 64; ++i) {
+        float x = static_cast<float>(i) / 64.0f;
+        data.push_back({ { x, static_cast<float>(i % 2) }, i % 2 });
+    }
+    MLP reference(2);
+    optim::Config config;
+    config.learning_rate = 0.1f;
+    distributed::TrainConfig train;
+    train.epochs = 3;
+
+    std::vector<float> single;
+    train.batch_size = 8;
+    run_ring(distributed::Backend::SharedMemory, 1, 4096, [&](distributed::Transport& transport) {
+        MLP mlp(reference);
+        optim::Optimizer optimizer(config, mlp.get_trainable_parameters().size());
+        distributed::train_data_parallel(mlp, transport, data, train, optimizer);
+        single = mlp.get_parameters().to_vector();
+    });
+
+    std::vector<std::vector<float>> ranks(2);
+    std::vector<distributed::EpochStats> stats;
+    train.batch_size = 4;
+    run_ring(distributed::Backend::Socket, 2, 4096, [&](distributed::Transport& transport) {
+        //Rank 1 starts from other weights, the broadcast has to fix that
+        MLP mlp(reference);
+        if (transport.rank() == 1) {
+            Span<float> parameters = mlp.get_parameters();
+            for (auto& p : parameters) p += 1.0f;
+            mlp.mark_parameters_changed();
+        }
+        optim::Optimizer optimizer(config, mlp.get_trainable_parameters().size());
+        auto history = distributed::train_data_parallel(mlp, transport, data, train, optimizer);
+        ranks[transport.rank()] = mlp.get_parameters().to_vector();
+        if (transport.rank() == 0) stats = history;
+    });
+    assert(ranks[0] == ranks[1]);
+    for (size_t i = 0; i < single.size(); ++i) {
+        assert(std::abs(single[i] - ranks[0][i]) < 1e-4f);
+    }
+    assert(stats.size() == 3 && stats[0].samples == data.size());
+    std::cout << "Data-parallel training test passed." << std::endl;
+}
+
+//Worker process mode: all-reduce rank numbers and exit 0 when the sum is right, rank fail exits early with 3
+static int worker_main(int argc, char** argv) {
+    distributed::Endpoint endpoint;
+    int fail_rank = -1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--rank") endpoint.rank = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+        else if (arg == "--workers") endpoint.size = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+        else if (arg == "--rendezvous") endpoint.name = argv[i + 1];
+        else if (arg == "--fail") fail_rank = std::atoi(argv[i + 1]);
+        else if (arg == "--transport" && !distributed::parse_backend(argv[i + 1], endpoint.backend)) return 2;
+    }
+    if (static_cast<int>(endpoint.rank) == fail_rank) {
+        return 3;
+    }
+    try {
+        std::unique_ptr<distributed::Transport> transport = distributed::connect(endpoint);
+        std::vector<float> values(100, static_cast<float>(endpoint.rank + 1));
+        distributed::all_reduce(*transport, Span<float>(values.data(), values.size()));
+        float expected = static_cast<float>(endpoint.size * (endpoint.size + 1) / 2);
+        for (float v : values) {
+            if (v != expected) return 4;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Worker failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+//Test real processes over both transports, and that one failing worker does not leave the others hanging
+void test_workers() {
+    std::cout << "Testing worker processes..." << std::endl;
+    for (const char* transport : { "shm", "socket" }) {
+        for (int fail : { -1, 1 }) {
+            distributed::Endpoint endpoint;
+            distributed::parse_backend(transport, endpoint.backend);
+            endpoint.name = unique_name();
+            endpoint.size = 3;
+            distributed::Session session(endpoint);
+            std::vector<std::vector<std::string>> args;
+            for (uint32_t r = 0; r < endpoint.size; ++r) {
+                args.push_back({ "--rank", std::to_string(r), "--workers", std::to_string(endpoint.size), "--rendezvous",
+                    endpoint.name, "--transport", transport, "--fail", std::to_string(fail) });
+            }
+            uint32_t failed = distributed::run_workers("/proc/self/exe", args);
+            assert(fail < 0 ? failed == 0 : failed >= 1);
+        }
+    }
+    std::cout << "Worker processes test passed." << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--rank") == 0) {
+        return worker_main(argc, argv);
+    }
+    try {
+        test_half();
+        test_all_reduce();
+        test_data_parallel();
+        test_workers();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// embedding_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the digit embedding table, its predictions against MLP::predict on normalize_input's features for every digit count, the batch path, rebuilding after the weights change and the input checks.
+
+#include "embedding.h"
+#include "activate.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+//1 to 9 digits with at least one nonzero, normalize_input divides by the largest
+static std::vector<int> random_digits(std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> length(1, 9);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::vector<int> digits(length(rng));
+    for (auto& d : digits) d = digit(rng);
+    if (*std::max_element(digits.begin(), digits.end()) == 0) {
+        digits.back() = 1 + static_cast<int>(rng() % 9);
+    }
+    return digits;
+}
+
+//Test every digit count, both parities and the 9 digit case that drops the parity feature
+void test_matches_predict() {
+    std::cout << "Testing digit table against MLP::predict..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 5);
+    embedding::DigitTable table(mlp);
+    assert(table.get_positions() == INPUT_SIZE);
+    std::mt19937 rng(9);
+    for (int i = 0; i < 2000; ++i) {
+        std::vector<int> digits = random_digits(rng);
+        assert(close(table.predict(digits), mlp.predict(MLP::normalize_input(digits))));
+    }
+    const std::vector<std::vector<int>> fixed = { { 7 }, { 8 }, { 1, 0, 0 }, { 9, 9, 9, 9, 9, 9, 9, 9, 9 }, { 1, 2, 3, 4, 5, 6, 7, 8, 9 } };
+    for (const auto& digits : fixed) {
+        assert(close(table.predict(digits), mlp.predict(MLP::normalize_input(digits))));
+    }
+    std::cout << "Digit table against MLP::predict test passed." << std::endl;
+}
+
+//Test the batch path gives the per-sample answers and a rebuilt table follows new weights
+void test_batch_and_rebuild() {
+    std::cout << "Testing digit table batches and rebuilds..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 6);
+    std::mt19937 rng(10);
+    std::vector<std::pair<std::vector<int>, int>> samples;
+    for (int i = 0; i < 5000; ++i) {
+        samples.push_back({ random_digits(rng), i % 2 });
+    }
+    embedding::DigitTable table(mlp);
+    std::vector<float> scores = table.predict_batch(samples);
+    assert(scores.size() == samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        assert(scores[i] == table.predict(samples[i].first));
+    }
+
+    seed_parameters(mlp, 7);
+    embedding::DigitTable rebuilt(mlp);
+    bool changed = false;
+    for (size_t i = 0; i < 100; ++i) {
+        float expected = mlp.predict(MLP::normalize_input(samples[i].first));
+        assert(close(rebuilt.predict(samples[i].first), expected));
+        changed = changed || !close(scores[i], expected);
+    }
+    assert(changed);
+    std::cout << "Digit table batches and rebuilds test passed." << std::endl;
+}
+
+//Test empty, too long, out of range and all zero inputs throw
+void test_invalid_inputs() {
+    std::cout << "Testing digit table input checks..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    embedding::DigitTable table(mlp);
+    const std::vector<std::vector<int>> invalid = { {}, std::vector<int>(10, 1), { 1, 10 }, { -1, 3 }, { 0, 0 } };
+    for (const auto& digits : invalid) {
+        bool threw = false;
+        try {
+            table.predict(digits);
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    bool threw = false;
+    try {
+        table.predict_batch({ { { 1, 2 }, 0 }, { {}, 1 } });
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Digit table input checks test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_matches_predict();
+        test_batch_and_rebuild();
+        test_invalid_inputs();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+// evaluation_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the evaluation engine, its histogram metrics against exact sorted ones, thread count independence and the MLP scoring path.
+
+#include "evaluation.h"
+#include "threadpool.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+//Scores that lean towards the label, so the AUCs land somewhere in the middle
+static void make_scores(size_t count, uint32_t seed, std::vector<float>& scores, std::vector<int>& labels) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+    scores.resize(count);
+    labels.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        labels[i] = noise(rng) < 0.3f ? 1 : 0;
+        scores[i] = std::min(0.999f, 0.6f * noise(rng) + (labels[i] ? 0.35f : 0.0f));
+    }
+}
+
+//Mann-Whitney ROC AUC over the sorted scores, ties share their rank
+static double exact_roc_auc(const std::vector<float>& scores, const std::vector<int>& labels) {
+    std::vector<size_t> order(scores.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return scores[a] < scores[b]; });
+    double rank_sum = 0.0;
+    uint64_t positives = 0;
+    for (size_t i = 0; i < order.size();) {
+        size_t j = i;
+        while (j < order.size() && scores[order[j]] == scores[order[i]]) ++j;
+        double rank = 0.5 * static_cast<double>(i + 1 + j);
+        for (size_t k = i; k < j; ++k) {
+            if (labels[order[k]]) {
+                rank_sum += rank;
+                ++positives;
+            }
+        }
+        i = j;
+    }
+    double negatives = static_cast<double>(scores.size() - positives);
+    return (rank_sum - positives * (positives + 1.0) / 2.0) / (positives * negatives);
+}
+
+//Test every metric against a direct computation on the same scores
+void test_metrics() {
+    std::cout << "Testing evaluation metrics..." << std::endl;
+    std::vector<float> scores;
+    std::vector<int> labels;
+    make_scores(50000, 3, scores, labels);
+    evaluation::Config config;
+    config.thresholds = { 0.25f, 0.5f, 0.8f };
+    evaluation::Report report = evaluation::evaluate_scores(scores, labels, config);
+
+    uint64_t positives = 0, correct = 0;
+    double loss = 0.0;
+    for (size_t i = 0; i < scores.size(); ++i) {
+        positives += labels[i];
+        correct += (scores[i] > 0.5f) == (labels[i] != 0) ? 1 : 0;
+        double q = labels[i] ? scores[i] : 1.0 - scores[i];
+        loss -= std::log(std::max(q, 1e-7));
+    }
+    assert(report.count == scores.size() && report.positives == positives);
+    assert(std::abs(report.accuracy - static_cast<double>(correct) / scores.size()) < 1e-12);
+    assert(std::abs(report.log_loss - loss / scores.size()) < 1e-5);
+    double exact = exact_roc_auc(scores, labels);
+    std::cout << "ROC AUC histogram " << report.roc_auc << ", exact " << exact << ", PR AUC " << report.pr_auc << std::endl;
+    assert(std::abs(report.roc_auc - exact) < 1e-3);
+    assert(report.pr_auc > 0.3 && report.pr_auc <= 1.0);
+
+    assert(report.thresholds.size() == 3);
+    for (const auto& t : report.thresholds) {
+        uint64_t tp = 0, fp = 0;
+        for (size_t i = 0; i < scores.size(); ++i) {
+            if (scores[i] >= t.threshold) {
+                (labels[i] ? tp : fp) += 1;
+            }
+        }
+        assert(t.true_positives == tp && t.false_positives == fp);
+        assert(t.true_positives + t.false_negatives == positives);
+        assert(t.true_positives + t.false_positives + t.true_negatives + t.false_negatives == scores.size());
+    }
+
+    uint64_t bucketed = 0;
+    double calibration_error = 0.0;
+    for (const auto& bucket : report.calibration) {
+        bucketed += bucket.count;
+        if (bucket.count > 0) {
+            assert(bucket.mean_score >= bucket.lower - 1e-6 && bucket.mean_score <= bucket.upper + 1e-6);
+        }
+        calibration_error += bucket.count * std::abs(bucket.mean_score - bucket.positive_rate);
+    }
+    assert(report.calibration.size() == 10 && bucketed == scores.size());
+    assert(std::abs(report.calibration_error - calibration_error / scores.size()) < 1e-12);
+    std::cout << "Evaluation metrics test passed." << std::endl;
+}
+
+//Test perfect, reversed and one class scores and a bad config
+void test_edge_cases() {
+    std::cout << "Testing evaluation edge cases..." << std::endl;
+    std::vector<float> scores = { 0.1f, 0.2f, 0.8f, 0.9f };
+    std::vector<int> labels = { 0, 0, 1, 1 };
+    evaluation::Report perfect = evaluation::evaluate_scores(scores, labels);
+    assert(perfect.roc_auc == 1.0 && perfect.pr_auc == 1.0 && perfect.accuracy == 1.0);
+    std::vector<int> reversed = { 1, 1, 0, 0 };
+    evaluation::Report worst = evaluation::evaluate_scores(scores, reversed);
+    assert(worst.roc_auc == 0.0 && worst.accuracy == 0.0);
+    evaluation::Report one_class = evaluation::evaluate_scores(scores, { 1, 1, 1, 1 });
+    assert(std::isnan(one_class.roc_auc) && one_class.positives == 4);
+    evaluation::Report empty = evaluation::evaluate_scores({}, {});
+    assert(empty.count == 0 && empty.accuracy == 0.0);
+
+    bool threw = false;
+    try {
+        evaluation::evaluate_scores(scores, { 0, 1 });
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    evaluation::Config bad;
+    bad.bins = 0;
+    threw = false;
+    try {
+        evaluation::evaluate_scores(scores, labels, bad);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Evaluation edge cases test passed." << std::endl;
+}
+
+//Test the report is bit for bit the same on one and four threads
+void test_threads() {
+    std::cout << "Testing evaluation thread split..." << std::endl;
+    std::vector<float> scores;
+    std::vector<int> labels;
+    make_scores(300000, 8, scores, labels);
+    parallel::set_threads(1);
+    evaluation::Report one = evaluation::evaluate_scores(scores, labels);
+    parallel::set_threads(4);
+    evaluation::Report four = evaluation::evaluate_scores(scores, labels);
+    parallel::set_threads(0);
+    assert(one.log_loss == four.log_loss && one.roc_auc == four.roc_auc && one.pr_auc == four.pr_auc);
+    assert(one.calibration_error == four.calibration_error);
+    for (size_t i = 0; i < one.thresholds.size(); ++i) {
+        assert(one.thresholds[i].true_positives == four.thresholds[i].true_positives);
+        assert(one.thresholds[i].false_positives == four.thresholds[i].false_positives);
+    }
+    std::cout << "Evaluation thread split test passed." << std::endl;
+}
+
+//Test the MLP path scores like predict_batch and refuses inputs predict refuses
+void test_mlp() {
+    std::cout << "Testing MLP evaluation..." << std::endl;
+    MLP mlp(2);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    evaluation::Dataset data;
+    for (int i = 0; i < 10000; ++i) {
+        data.push_back({ { dist(rng), dist(rng) }, i % 2 });
+    }
+    std::vector<float> scores = mlp.predict_batch(data);
+    std::vector<int> labels;
+    for (const auto& sample : data) labels.push_back(sample.second);
+    evaluation::Report direct = evaluation::evaluate_scores(scores, labels);
+    evaluation::Report report = evaluation::evaluate(mlp, data);
+    assert(report.accuracy == direct.accuracy && report.log_loss == direct.log_loss && report.roc_auc == direct.roc_auc);
+
+    data.push_back({ {}, 1 });
+    bool threw = false;
+    try {
+        evaluation::evaluate(mlp, data);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "MLP evaluation test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_metrics();
+        test_edge_cases();
+        test_threads();
+        test_mlp();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+// fused_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the fused dense kernels and the single kernel network (also started from its hidden pre-activations), each is checked against a plain layer by layer reference.
+
+#include "fused.h"
+#include "activate.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cassert>
+
+static std::vector<float> random_vector(size_t size, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(size);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+//Plain row by row reference, sums in a different order so results are compared with a tolerance
+static std::vector<float> reference_dense(const std::vector<float>& input, const std::vector<float>& weights,
+    const std::vector<float>& biases, uint32_t input_size, uint32_t output_size) {
+    std::vector<float> output(output_size);
+    for (uint32_t i = 0; i < output_size; ++i) {
+        double sum = biases[i];
+        for (uint32_t j = 0; j < input_size; ++j) {
+            sum += static_cast<double>(input[j]) * weights[i * input_size + j];
+        }
+        output[i] = static_cast<float>(sum);
+    }
+    return output;
+}
+
+static bool close(float a, float b) {
+    return std::abs(a - b) <= 1e-5f * std::max(1.0f, std::abs(b));
+}
+
+//Test every row/column remainder against the vector width and row block
+void test_dense_kernels() {
+    std::cout << "Testing dense_relu and dense_sigmoid..." << std::endl;
+    std::mt19937 rng(7);
+    const uint32_t sizes[] = { 1, 3, 4, 5, 8, 9, 17, 64, 70 };
+    for (uint32_t input_size : sizes) {
+        for (uint32_t output_size : sizes) {
+            std::vector<float> input = random_vector(input_size, rng);
+            std::vector<float> weights = random_vector(input_size * output_size, rng);
+            std::vector<float> biases = random_vector(output_size, rng);
+            std::vector<float> expected = reference_dense(input, weights, biases, input_size, output_size);
+            std::vector<float> output(output_size);
+
+            fused::dense_relu(input.data(), weights.data(), biases.data(), output.data(), input_size, output_size, -0.5f, 0.5f);
+            for (uint32_t i = 0; i < output_size; ++i) {
+                assert(close(output[i], activate::relu(activate::clip(expected[i], -0.5f, 0.5f))));
+            }
+
+            fused::dense_sigmoid(input.data(), weights.data(), biases.data(), output.data(), input_size, output_size);
+            for (uint32_t i = 0; i < output_size; ++i) {
+                assert(close(output[i], activate::sigmoid(expected[i])));
+            }
+        }
+    }
+    std::cout << "Dense kernel test passed." << std::endl;
+}
+
+//Test the single kernel network with and without the skip connection
+void test_small_network() {
+    std::cout << "Testing SmallNetwork..." << std::endl;
+    std::mt19937 rng(11);
+    const uint32_t input_size = 9;
+    const uint32_t hidden_sizes[] = { 1, 7, 64, 100 };
+    for (uint32_t hidden_size : hidden_sizes) {
+        for (uint32_t output_size = 1; output_size <= fused::SmallNetwork::MAX_OUTPUTS; ++output_size) {
+            std::vector<float> w1 = random_vector(hidden_size * input_size, rng);
+            std::vector<float> b1 = random_vector(hidden_size, rng);
+            std::vector<float> w2 = random_vector(output_size * hidden_size, rng);
+            std::vector<float> b2 = random_vector(output_size, rng);
+            std::vector<float> skip = random_vector(output_size * input_size, rng);
+            std::vector<float> input = random_vector(input_size, rng);
+
+            std::vector<float> hidden = reference_dense(input, w1, b1, input_size, hidden_size);
+            for (auto& h : hidden) h = activate::relu(activate::clip(h, -88.0f, 88.0f));
+            std::vector<float> expected = reference_dense(hidden, w2, b2, hidden_size, output_size);
+
+            fused::SmallNetwork network;
+            std::vector<float> output(output_size);
+            network.pack(w1.data(), b1.data(), w2.data(), b2.data(), nullptr, input_size, hidden_size, output_size);
+            network.forward(input.data(), output.data());
+            for (uint32_t o = 0; o < output_size; ++o) {
+                assert(close(output[o], activate::sigmoid(expected[o])));
+            }
+
+            network.pack(w1.data(), b1.data(), w2.data(), b2.data(), skip.data(), input_size, hidden_size, output_size);
+            network.forward(input.data(), output.data());
+            for (uint32_t o = 0; o < output_size; ++o) {
+                float sum = expected[o];
+                for (uint32_t j = 0; j < input_size; ++j) sum += skip[o * input_size + j] * input[j];
+                assert(close(output[o], activate::sigmoid(sum)));
+            }
+
+            //Starting from the hidden pre-activations gives the same outputs, skip included
+            std::vector<float> pre_activations = reference_dense(input, w1, b1, input_size, hidden_size);
+            pre_activations.resize(network.get_padded_hidden_size(), 0.0f);
+            std::vector<float> skip_sums(output_size, 0.0f);
+            for (uint32_t o = 0; o < output_size; ++o) {
+                for (uint32_t j = 0; j < input_size; ++j) skip_sums[o] += skip[o * input_size + j] * input[j];
+            }
+            std::vector<float> from_hidden(output_size);
+            network.forward_hidden(pre_activations.data(), skip_sums.data(), from_hidden.data());
+            for (uint32_t o = 0; o < output_size; ++o) {
+                assert(close(from_hidden[o], output[o]));
+            }
+        }
+    }
+
+    bool threw = false;
+    try {
+        fused::SmallNetwork network;
+        std::vector<float> w(9 * 5);
+        network.pack(w.data(), w.data(), w.data(), w.data(), nullptr, 9, 1, 5);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "SmallNetwork test passed." << std::endl;
+}
+
+//Test the fused MLP::predict gives the same answer as the layered forward
+void test_mlp_predict() {
+    std::cout << "Testing MLP::predict against MLP::forward..." << std::endl;
+    std::mt19937 rng(3);
+    MLP mlp(INPUT_SIZE);
+    for (int step = 0; step < 200; ++step) {
+        std::uniform_int_distribution<size_t> length(1, 10);
+        std::vector<float> input = random_vector(length(rng), rng);
+        for (auto& v : input) v = std::abs(v);
+
+        mlp.forward(input);
+        float layered = mlp.get_output()[0];
+        float fused_output = mlp.predict(input);
+        assert(close(fused_output, layered));
+
+        //Keep the weights moving so the repacking is exercised
+        mlp.get_output_layer().update_weights(layered - 0.5f, 0.05f);
+        mlp.get_hidden_layer1().update_weights(layered - 0.5f, 0.05f);
+    }
+    std::cout << "MLP::predict test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_dense_kernels();
+        test_small_network();
+        test_mlp_predict();
+        activate::set_mode(activate::Mode::Fast);
+        test_dense_kernels();
+        test_small_network();
+        test_mlp_predict();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
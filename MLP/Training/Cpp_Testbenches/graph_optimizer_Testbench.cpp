@@ -0,0 +1,177 @@
+// graph_optimizer_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the graph optimizer passes and the compact model file, the optimized model has to classify exactly like the graph it came from.
+
+#include "graph_optimizer.h"
+#include "compact_model.h"
+#include "activate.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <cassert>
+
+static std::vector<std::pair<std::vector<float>, int>> random_samples(size_t count, uint32_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<std::pair<std::vector<float>, int>> samples(count);
+    for (auto& sample : samples) {
+        sample.first.resize(size);
+        for (auto& v : sample.first) v = dist(rng);
+        sample.second = static_cast<int>(rng() % 2);
+    }
+    return samples;
+}
+
+//Test the lowered graph computes what MLP::forward computes
+void test_lowering() {
+    std::cout << "Testing lower_mlp..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    graph::LayerGraph lowered = graph::lower_mlp(mlp);
+    assert(lowered.layers.size() == 3);
+    for (const auto& sample : random_samples(100, INPUT_SIZE, 1)) {
+        mlp.forward(sample.first);
+        float expected = mlp.get_output()[0];
+        assert(std::abs(graph::evaluate_graph(lowered, sample.first) - expected) < 1e-5f);
+    }
+    std::cout << "lower_mlp test passed." << std::endl;
+}
+
+//Test the padding pass on the MLP graph, only the nine real inputs are left in each stage
+void test_padding() {
+    std::cout << "Testing eliminate_padding..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    graph::OptimizeReport report;
+    compact::Model model = graph::eliminate_padding(graph::lower_mlp(mlp), report);
+    assert(report.identity_layers_removed == 1);
+    assert(report.macs_before == 2 * HIDDEN_LAYER1_SIZE);
+    assert(model.stages.size() == 2);
+    assert(model.stages[0].sources.size() == INPUT_SIZE);
+    //The output layer reads the hidden neuron plus the inputs the hidden layer did not overwrite
+    assert(model.stages[1].sources.size() == INPUT_SIZE);
+    assert(model.stages[1].sources[0] == INPUT_SIZE);
+    assert(model.mac_count() == 2 * INPUT_SIZE);
+    std::cout << "eliminate_padding test passed." << std::endl;
+}
+
+//Test constant folding and dead neuron removal on a hand built graph
+void test_pruning() {
+    std::cout << "Testing fold_constants and remove_dead_neurons..." << std::endl;
+    graph::LayerGraph g;
+    g.input_size = 2;
+    graph::GraphLayer hidden;
+    hidden.name = "hidden";
+    hidden.input_size = 2;
+    hidden.output_size = 3;
+    hidden.activation = compact::Activation::ClipRelu;
+    //Neuron 0 is live, neuron 1 has no inputs (constant relu(0.25)), neuron 2 is dead for inputs in [0, 1]
+    hidden.weights = { 1.0f, -0.5f,   0.0f, 0.0f,   -1.0f, -1.0f };
+    hidden.biases = { 0.1f, 0.25f, -0.5f };
+    graph::GraphLayer output;
+    output.name = "output";
+    output.input_size = 3;
+    output.output_size = 1;
+    output.activation = compact::Activation::Sigmoid;
+    output.weights = { 2.0f, 4.0f, 3.0f };
+    output.biases = { -1.0f };
+    g.layers = { hidden, output };
+
+    auto calibration = random_samples(200, 2, 2);
+    graph::OptimizeReport report;
+    compact::Model model = graph::optimize(g, calibration, report);
+    assert(report.constants_folded == 1);
+    assert(report.dead_neurons_removed == 1);
+    assert(report.logit_threshold);
+    assert(model.stages.size() == 2);
+    assert(model.stages[0].outputs() == 1);
+    //The constant neuron ended up in the output bias
+    assert(std::abs(model.stages[1].biases[0] - (-1.0f + 4.0f * 0.25f)) < 1e-6f);
+    assert(report.calibration_mismatches == 0);
+    for (const auto& sample : calibration) {
+        float expected = graph::evaluate_graph(g, sample.first);
+        assert(std::abs(activate::sigmoid(model.score(sample.first)) - expected) < 1e-5f);
+    }
+    std::cout << "Pruning test passed." << std::endl;
+}
+
+//Test the whole optimizer on a trained-looking MLP, the file round trip and sharing the model between threads
+void test_optimize_mlp() {
+    std::cout << "Testing optimize on the MLP..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    auto samples = random_samples(500, INPUT_SIZE, 3);
+    for (const auto& sample : samples) {
+        mlp.forward(sample.first);
+        float error = mlp.get_output()[0] - sample.second;
+        mlp.get_output_layer().update_weights(error, 0.01f);
+        mlp.get_hidden_layer1().update_weights(error, 0.01f);
+    }
+
+    graph::LayerGraph lowered = graph::lower_mlp(mlp);
+    graph::OptimizeReport report;
+    compact::Model model = graph::optimize(lowered, samples, report);
+    std::cout << graph::format_report(report) << std::endl;
+    assert(report.calibration_mismatches == 0);
+    assert(report.macs_after < report.macs_before);
+    for (const auto& sample : random_samples(500, INPUT_SIZE, 4)) {
+        assert(model.classify(sample.first) == (mlp.predict(sample.first) > 0.5f));
+    }
+
+    assert(compact::save_model(model, "compact_testbench.txt"));
+    compact::Model loaded;
+    assert(compact::load_model("compact_testbench.txt", loaded));
+    assert(loaded.mac_count() == model.mac_count());
+    for (const auto& sample : samples) {
+        assert(loaded.score(sample.first) == model.score(sample.first));
+    }
+    std::remove("compact_testbench.txt");
+
+    //One model shared by several threads scores like it does alone
+    std::vector<float> expected(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        expected[i] = model.score(samples[i].first);
+    }
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            compact::Workspace workspace;
+            for (int round = 0; round < 20; ++round) {
+                for (size_t i = 0; i < samples.size(); ++i) {
+                    float score = (t % 2 == 0) ? model.score(samples[i].first) : model.score(samples[i].first, workspace);
+                    if (score != expected[i]) ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        assert(count == 0);
+    }
+
+    compact::Model missing;
+    assert(!compact::load_model("does_not_exist.txt", missing));
+    std::cout << "Optimize test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_lowering();
+        test_padding();
+        test_pruning();
+        test_optimize_mlp();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// incremental_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the incremental predictor, its scores against MLP::predict over sparse and dense random walks, the correction and resync counts, the drift a long run builds up, non-finite readings and the input checks.
+
+#include "incremental.h"
+#include "activate.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+//Test one or two features moving per reading, and every feature moving, against full predicts
+void test_matches_predict() {
+    std::cout << "Testing incremental predictor against MLP::predict..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 3);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> reading(-1.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> feature(0, INPUT_SIZE - 1);
+
+    incremental::DeltaPredictor predictor(mlp, 64);
+    assert(close(predictor.get_score(), mlp.predict(std::vector<float>(INPUT_SIZE, 0.0f))));
+    std::vector<float> input(INPUT_SIZE, 0.0f);
+    for (int step = 0; step < 3000; ++step) {
+        const uint32_t changes = step < 2000 ? 1 + step % 2 : INPUT_SIZE;
+        for (uint32_t c = 0; c < changes; ++c) {
+            input[changes == INPUT_SIZE ? c : feature(rng)] = reading(rng);
+        }
+        assert(close(predictor.update(input), mlp.predict(input)));
+    }
+
+    //Single feature updates, and shorter inputs meaning zeros
+    for (int step = 0; step < 500; ++step) {
+        uint32_t j = feature(rng);
+        input[j] = reading(rng);
+        assert(close(predictor.update(j, input[j]), mlp.predict(input)));
+    }
+    std::vector<float> short_input = { 0.5f, -0.25f };
+    assert(close(predictor.update(short_input), mlp.predict(short_input)));
+    std::cout << "Incremental predictor against MLP::predict test passed." << std::endl;
+}
+
+//Test only changed features are corrected and the recompute comes every resync_interval changed readings
+void test_counts() {
+    std::cout << "Testing correction and resync counts..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 5);
+    incremental::DeltaPredictor predictor(mlp, 10);
+    std::vector<float> input(INPUT_SIZE, 0.0f);
+    for (int step = 1; step <= 25; ++step) {
+        input[step % INPUT_SIZE] = static_cast<float>(step);
+        predictor.update(input);
+    }
+    assert(predictor.get_corrections() == 25 && predictor.get_resyncs() == 2);
+    //An unchanged reading is free
+    float before = predictor.get_score();
+    assert(predictor.update(input) == before);
+    assert(predictor.update(3, input[3]) == before);
+    assert(predictor.get_corrections() == 25);
+
+    input.assign(INPUT_SIZE, 1.0f);
+    predictor.update(input);
+    assert(predictor.get_corrections() == 25 + INPUT_SIZE);
+    for (uint32_t j = 0; j < INPUT_SIZE; ++j) {
+        assert(predictor.get_features()[j] == 1.0f);
+    }
+    std::cout << "Correction and resync counts test passed." << std::endl;
+}
+
+//Test drift without resyncs stays small over a long run and a resync removes it
+void test_drift() {
+    std::cout << "Testing drift and resync..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 6);
+    incremental::DeltaPredictor predictor(mlp, 0);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> reading(-100.0f, 100.0f);
+    std::uniform_int_distribution<uint32_t> feature(0, INPUT_SIZE - 1);
+    std::vector<float> input(INPUT_SIZE, 0.0f);
+    for (int step = 0; step < 200000; ++step) {
+        uint32_t j = feature(rng);
+        input[j] = reading(rng);
+        predictor.update(j, input[j]);
+    }
+    assert(predictor.get_resyncs() == 0);
+    float drifted = predictor.get_score();
+    float expected = mlp.predict(input);
+    assert(std::abs(drifted - expected) < 1e-3f);
+    predictor.resync();
+    assert(predictor.update(0, input[0] + 1.0f) == predictor.get_score());
+    input[0] += 1.0f;
+    assert(close(predictor.get_score(), mlp.predict(input)));
+    std::cout << "Drift and resync test passed." << std::endl;
+}
+
+//Test a NaN reading gives NaN and the next finite one recovers
+void test_non_finite() {
+    std::cout << "Testing non-finite readings..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 8);
+    incremental::DeltaPredictor predictor(mlp);
+    std::vector<float> input(INPUT_SIZE, 0.5f);
+    predictor.update(input);
+    assert(std::isnan(predictor.update(2, std::numeric_limits<float>::quiet_NaN())));
+    assert(close(predictor.update(2, 0.5f), mlp.predict(input)));
+    predictor.update(4, std::numeric_limits<float>::infinity());
+    assert(close(predictor.update(4, 0.5f), mlp.predict(input)));
+    std::cout << "Non-finite readings test passed." << std::endl;
+}
+
+//Test the same input checks as MLP::predict
+void test_invalid_inputs() {
+    std::cout << "Testing incremental predictor input checks..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    incremental::DeltaPredictor predictor(mlp);
+    const std::vector<std::vector<float>> invalid = { {}, std::vector<float>(11, 1.0f) };
+    for (const auto& input : invalid) {
+        bool threw = false;
+        try {
+            predictor.update(input);
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    bool threw = false;
+    try {
+        predictor.update(INPUT_SIZE, 1.0f);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Incremental predictor input checks test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_matches_predict();
+        test_counts();
+        test_drift();
+        test_non_finite();
+        test_invalid_inputs();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 
 
 #include "layers.h"
+#include "pipeline.h"
 #include <iostream>
 #include <vector>
 #include <cassert>
@@ -106,11 +107,45 @@ void test_output_layer() {
     std::cout << "OutputLayer test passed." << std::endl;
 }
 
+//Method to test the static pipeline matches the same layers driven through Layer pointers
+void test_static_pipeline() {
+    std::cout << "Testing StaticPipeline..." << std::endl;
+    InputLayer input_a(INPUT_SIZE, HIDDEN_LAYER1_SIZE), input_b(input_a);
+    HiddenLayer hidden_a(HIDDEN_LAYER1_SIZE, OUTPUT_SIZE), hidden_b(hidden_a);
+    OutputLayer output_a, output_b(output_a);
+    pipeline::StaticPipeline<InputLayer, HiddenLayer, OutputLayer> chain(input_a, hidden_a, output_a);
+    Layer* layers[] = { &input_b, &hidden_b, &output_b };
+    assert(&chain.layer<1>() == &hidden_a);
+
+    std::vector<float> input(INPUT_SIZE);
+    for (uint32_t i = 0; i < INPUT_SIZE; ++i) {
+        input[i] = 0.1f * (i + 1);
+    }
+    for (int step = 0; step < 5; ++step) {
+        std::vector<float> scratch_a(HIDDEN_LAYER1_SIZE), scratch_b(HIDDEN_LAYER1_SIZE);
+        float out_a = 0.0f, out_b = 0.0f;
+        chain.forward(input.data(), scratch_a.data(), &out_a);
+        layers[0]->forward(input.data(), scratch_b.data());
+        layers[1]->forward(scratch_b.data(), scratch_b.data());
+        layers[2]->forward(scratch_b.data(), &out_b);
+        assert(out_a == out_b);
+
+        chain.update_weights(out_a - 1.0f, 0.1f);
+        for (int l = 2; l >= 0; --l) {
+            layers[l]->update_weights(out_b - 1.0f, 0.1f);
+        }
+        assert(hidden_a.get_weights().to_vector() == hidden_b.get_weights().to_vector());
+        assert(output_a.get_biases().to_vector() == output_b.get_biases().to_vector());
+    }
+    std::cout << "StaticPipeline test passed." << std::endl;
+}
+
 int main() {
     try {
         test_input_layer();
         test_hidden_layer();
         test_output_layer();
+        test_static_pipeline();
 
         std::cout << "All tests passed successfully!" << std::endl;
     }
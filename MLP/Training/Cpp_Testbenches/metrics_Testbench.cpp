@@ -0,0 +1,136 @@
+// metrics_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the lock-free record queue and the background metrics writer
+
+#include "metrics.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+
+//Test the queue refuses pushes when full and keeps FIFO order
+void test_queue() {
+    std::cout << "Testing RecordQueue..." << std::endl;
+    metrics::RecordQueue queue(4);
+    metrics::MetricRecord record = {};
+    for (uint32_t i = 0; i < 4; ++i) {
+        record.epoch = i;
+        assert(queue.push(record));
+    }
+    assert(!queue.push(record));
+    for (uint32_t i = 0; i < 4; ++i) {
+        assert(queue.pop(record));
+        assert(record.epoch == i);
+    }
+    assert(!queue.pop(record));
+    std::cout << "RecordQueue test passed." << std::endl;
+}
+
+//Test several producers against one consumer, nothing may be lost or duplicated
+void test_queue_threads() {
+    std::cout << "Testing RecordQueue with producers..." << std::endl;
+    metrics::RecordQueue queue(1024);
+    const uint32_t producers = 4, per_producer = 20000;
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            metrics::MetricRecord record = {};
+            record.epoch = p;
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                record.correct = i;
+                while (!queue.push(record)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(producers, 0);
+    uint32_t received = 0;
+    metrics::MetricRecord record;
+    while (received < producers * per_producer) {
+        if (queue.pop(record)) {
+            assert(record.correct == next[record.epoch]);
+            ++next[record.epoch];
+            ++received;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::cout << "RecordQueue producer test passed." << std::endl;
+}
+
+//Test the epoch summary carries the trainer's totals and the queued records only its throughput
+void test_writer() {
+    std::cout << "Testing metrics writer..." << std::endl;
+    metrics::LogLevel level;
+    assert(metrics::parse_log_level("warning", level) && level == metrics::LogLevel::Warning);
+    assert(!metrics::parse_log_level("verbose", level));
+    metrics::set_log_level(metrics::LogLevel::Error);
+    assert(!metrics::should_log(metrics::LogLevel::Info));
+
+    assert(metrics::start("metrics_testbench.jsonl"));
+    for (int i = 0; i < 10; ++i) {
+        metrics::record_sample(0, static_cast<float>(i), 1.0f, 0.75f, 0.5f, i < 7);
+    }
+    metrics::end_epoch(0, 3, 5.0, 7, 10, 10);
+    //A resumed epoch only queues the samples after the checkpoint, and a flood overflows the queue, the totals still hold
+    const int flood = 200000;
+    for (int i = 0; i < flood; ++i) {
+        metrics::record_sample(1, 0.0f, 1.0f, 0.75f, 0.5f, true);
+    }
+    metrics::end_epoch(1, 3, 0.25 * (flood + 40), flood + 30, flood + 40, flood);
+    uint64_t flood_dropped = metrics::get_dropped();
+    metrics::flush();
+    //Drops are reported for the epoch they happened in, not carried into the next one
+    metrics::record_sample(2, 0.0f, 1.0f, 0.75f, 0.5f, true);
+    metrics::end_epoch(2, 3, 0.125, 1, 1, 1);
+    metrics::flush();
+    metrics::stop();
+
+    std::ifstream file("metrics_testbench.jsonl");
+    std::string line;
+    assert(std::getline(file, line));
+    assert(line.find("\"epoch\": 1,") != std::string::npos);
+    assert(line.find("\"samples\": 10") != std::string::npos);
+    assert(line.find("\"loss\": 5") != std::string::npos);
+    assert(line.find("\"accuracy\": 0.7") != std::string::npos);
+    assert(line.find("\"dropped\": 0}") != std::string::npos);
+    assert(std::getline(file, line));
+    assert(line.find("\"epoch\": 2,") != std::string::npos);
+    assert(line.find("\"samples\": 200040") != std::string::npos);
+    assert(line.find("\"loss\": 50010") != std::string::npos);
+    assert(line.find("\"accuracy\": 0.99995") != std::string::npos);
+    assert(line.find("\"samples_per_sec\": 0,") == std::string::npos);
+    assert(line.find("\"dropped\": " + std::to_string(flood_dropped) + "}") != std::string::npos);
+    assert(std::getline(file, line));
+    assert(line.find("\"epoch\": 3,") != std::string::npos);
+    assert(line.find("\"dropped\": 0}") != std::string::npos);
+    assert(!std::getline(file, line));
+    file.close();
+    std::remove("metrics_testbench.jsonl");
+    metrics::set_log_level(metrics::LogLevel::Info);
+    std::cout << "Metrics writer test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_queue();
+        test_queue_threads();
+        test_writer();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
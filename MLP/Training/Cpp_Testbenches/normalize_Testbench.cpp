@@ -0,0 +1,129 @@
+// normalize_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the streaming feature statistics and for folding the normalizer into a compact model.
+
+#include "normalize.h"
+#include "graph_optimizer.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cassert>
+
+static std::vector<std::pair<std::vector<float>, int>> make_data(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> number(500.0f, 120.0f);
+    std::vector<std::pair<std::vector<float>, int>> data(count);
+    for (auto& sample : data) {
+        float value = std::round(number(rng));
+        sample.first = { value, static_cast<float>(static_cast<int>(value) % 2), 3.0f };
+        sample.second = static_cast<int>(value) % 2;
+    }
+    return data;
+}
+
+//Test the parallel Welford pass against a plain two pass computation
+void test_stats() {
+    std::cout << "Testing compute_feature_stats..." << std::endl;
+    auto data = make_data(20000, 1);
+    FeatureStats stats = compute_feature_stats(data, 3, 4);
+    assert(stats.count == data.size());
+    for (uint32_t f = 0; f < 3; ++f) {
+        double sum = 0.0, lo = 1e30, hi = -1e30;
+        for (const auto& sample : data) {
+            sum += sample.first[f];
+            lo = std::min(lo, static_cast<double>(sample.first[f]));
+            hi = std::max(hi, static_cast<double>(sample.first[f]));
+        }
+        double mean = sum / data.size();
+        double squares = 0.0;
+        for (const auto& sample : data) {
+            squares += (sample.first[f] - mean) * (sample.first[f] - mean);
+        }
+        double stddev = std::sqrt(squares / data.size());
+        assert(std::abs(stats.mean[f] - mean) < 1e-9 * std::max(1.0, std::abs(mean)));
+        assert(std::abs(stats.stddev(f) - stddev) < 1e-9 * std::max(1.0, stddev));
+        assert(stats.min[f] == lo && stats.max[f] == hi);
+    }
+
+    //The chunking is fixed, so the thread count must not change a single bit
+    FeatureStats single = compute_feature_stats(data, 3, 1);
+    for (uint32_t f = 0; f < 3; ++f) {
+        assert(single.mean[f] == stats.mean[f] && single.m2[f] == stats.m2[f]);
+    }
+    std::cout << "compute_feature_stats test passed." << std::endl;
+}
+
+//Test both normalizations and the constant feature guard
+void test_normalizer() {
+    std::cout << "Testing Normalizer..." << std::endl;
+    auto data = make_data(5000, 2);
+    FeatureStats stats = compute_feature_stats(data, 3);
+    Normalizer standard = Normalizer::from_stats(stats, NormalizationKind::Standard);
+    FeatureStats after(3);
+    for (const auto& sample : standard.apply_all(data)) {
+        after.add(sample.first);
+    }
+    assert(std::abs(after.mean[0]) < 1e-4 && std::abs(after.stddev(0) - 1.0) < 1e-4);
+    //Feature 2 is constant, it is only shifted to zero
+    assert(standard.scale[2] == 1.0f && after.mean[2] == 0.0 && after.stddev(2) == 0.0);
+
+    Normalizer minmax = Normalizer::from_stats(stats, NormalizationKind::MinMax);
+    FeatureStats ranged(3);
+    for (const auto& sample : minmax.apply_all(data)) {
+        ranged.add(sample.first);
+    }
+    assert(std::abs(ranged.min[0]) < 1e-5 && std::abs(ranged.max[0] - 1.0) < 1e-5);
+
+    NormalizationKind kind;
+    assert(parse_normalization_kind("minmax", kind) && kind == NormalizationKind::MinMax);
+    assert(!parse_normalization_kind("zscore", kind));
+    assert(Normalizer::from_stats(stats, NormalizationKind::None).empty());
+    std::cout << "Normalizer test passed." << std::endl;
+}
+
+//Test an MLP trained on normalized data, exported with the normalizer folded in, scores raw features the same way
+void test_fold() {
+    std::cout << "Testing fold_normalizer..." << std::endl;
+    auto data = make_data(2000, 3);
+    Normalizer normalizer = Normalizer::from_stats(compute_feature_stats(data, 3), NormalizationKind::Standard);
+    auto normalized = normalizer.apply_all(data);
+
+    MLP mlp(INPUT_SIZE);
+    for (const auto& sample : normalized) {
+        mlp.forward(sample.first);
+        float error = mlp.get_output()[0] - sample.second;
+        mlp.get_output_layer().update_weights(error, 0.01f);
+        mlp.get_hidden_layer1().update_weights(error, 0.01f);
+    }
+
+    graph::OptimizeReport report;
+    compact::Model model = graph::optimize(graph::lower_mlp(mlp), normalized, report);
+    compact::Model folded = model;
+    fold_normalizer(folded, normalizer);
+    for (size_t i = 0; i < data.size(); ++i) {
+        float expected = model.score(normalized[i].first);
+        float raw = folded.score(data[i].first);
+        assert(std::abs(raw - expected) < 1e-4f * std::max(1.0f, std::abs(expected)));
+        assert(folded.classify(data[i].first) == (mlp.predict(normalized[i].first) > 0.5f));
+    }
+    std::cout << "fold_normalizer test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_stats();
+        test_normalizer();
+        test_fold();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+// optimizer_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the fused optimizer step (SGD, momentum, Adam, AdamW with clipping and weight decay) and the MLP and Sequential paths that use it.
+
+#include "optimizer.h"
+#include "sequential.h"
+#include "threadpool.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cassert>
+
+static std::vector<float> random_vector(size_t size, float scale, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-scale, scale);
+    std::vector<float> values(size);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+//Textbook update in double precision, one value at a time
+static void reference_step(const optim::Config& c, uint64_t t, std::vector<double>& p, const std::vector<float>& grads,
+    std::vector<double>& m, std::vector<double>& v) {
+    for (size_t i = 0; i < p.size(); ++i) {
+        double g = grads[i];
+        if (c.clip > 0.0f) {
+            g = std::max(std::min(g, static_cast<double>(c.clip)), -static_cast<double>(c.clip));
+        }
+        if (c.method != optim::Method::AdamW) {
+            g += c.weight_decay * p[i];
+        }
+        switch (c.method) {
+        case optim::Method::Sgd:
+            p[i] -= c.learning_rate * g;
+            break;
+        case optim::Method::Momentum:
+            m[i] = c.momentum * m[i] + g;
+            p[i] -= c.learning_rate * m[i];
+            break;
+        default: {
+            m[i] = c.beta1 * m[i] + (1.0 - c.beta1) * g;
+            v[i] = c.beta2 * v[i] + (1.0 - c.beta2) * g * g;
+            double m_hat = m[i] / (1.0 - std::pow(c.beta1, t));
+            double v_hat = v[i] / (1.0 - std::pow(c.beta2, t));
+            if (c.method == optim::Method::AdamW) {
+                p[i] -= c.learning_rate * c.weight_decay * p[i];
+            }
+            p[i] -= c.learning_rate * m_hat / (std::sqrt(v_hat) + c.epsilon);
+            break;
+        }
+        }
+    }
+}
+
+//Test every method against the reference over several steps, on sizes that do and do not fill whole vectors
+void test_methods() {
+    std::cout << "Testing optimizer methods..." << std::endl;
+    std::mt19937 rng(2);
+    const optim::Method methods[] = { optim::Method::Sgd, optim::Method::Momentum, optim::Method::Adam, optim::Method::AdamW };
+    const size_t sizes[] = { 1, 7, 33, 1000 };
+    for (optim::Method method : methods) {
+        for (size_t size : sizes) {
+            optim::Config config;
+            config.method = method;
+            config.learning_rate = 0.01f;
+            config.weight_decay = 0.05f;
+            config.clip = 0.5f;
+            optim::Optimizer optimizer(config, size);
+            std::vector<float> params = random_vector(size, 1.0f, rng);
+            std::vector<double> expected(params.begin(), params.end()), m(size, 0.0), v(size, 0.0);
+            for (uint64_t t = 1; t <= 5; ++t) {
+                std::vector<float> grads = random_vector(size, 1.0f, rng);
+                optimizer.step(Span<float>(params.data(), size), Span<const float>(grads.data(), size));
+                reference_step(config, t, expected, grads, m, v);
+            }
+            assert(optimizer.get_steps() == 5);
+            for (size_t i = 0; i < size; ++i) {
+                assert(std::abs(params[i] - expected[i]) < 1e-5);
+            }
+        }
+    }
+    std::cout << "Optimizer methods test passed." << std::endl;
+}
+
+//Test a bad config is refused, a size mismatch throws and reset clears the moments
+void test_config_and_reset() {
+    std::cout << "Testing optimizer config and reset..." << std::endl;
+    optim::Method method;
+    assert(optim::parse_method("adamw", method) && method == optim::Method::AdamW);
+    assert(!optim::parse_method("rmsprop", method));
+
+    optim::Config bad;
+    bad.learning_rate = 0.0f;
+    bool threw = false;
+    try {
+        optim::Optimizer optimizer(bad, 4);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    optim::Config config;
+    config.method = optim::Method::Adam;
+    optim::Optimizer optimizer(config, 4);
+    std::vector<float> params(4, 1.0f), grads(4, 1.0f);
+    threw = false;
+    try {
+        optimizer.step(Span<float>(params.data(), 3), Span<const float>(grads.data(), 3));
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    optimizer.step(Span<float>(params.data(), 4), Span<const float>(grads.data(), 4));
+    assert(optimizer.get_first_moment()[0] != 0.0f && optimizer.get_second_moment()[0] != 0.0f);
+    optimizer.reset();
+    assert(optimizer.get_steps() == 0 && optimizer.get_first_moment()[0] == 0.0f && optimizer.get_second_moment()[0] == 0.0f);
+    std::cout << "Optimizer config and reset test passed." << std::endl;
+}
+
+//Test a buffer big enough to split gives the same values on one and on four threads
+void test_threads() {
+    std::cout << "Testing optimizer thread split..." << std::endl;
+    const size_t size = 300000;
+    std::mt19937 rng(4);
+    std::vector<float> start = random_vector(size, 1.0f, rng), grads = random_vector(size, 1.0f, rng);
+    optim::Config config;
+    config.method = optim::Method::AdamW;
+    config.weight_decay = 0.01f;
+
+    std::vector<float> serial = start, split = start;
+    parallel::set_threads(1);
+    optim::Optimizer one(config, size);
+    one.step(Span<float>(serial.data(), size), Span<const float>(grads.data(), size));
+    parallel::set_threads(4);
+    optim::Optimizer four(config, size);
+    four.step(Span<float>(split.data(), size), Span<const float>(grads.data(), size));
+    parallel::set_threads(0);
+    assert(serial == split);
+    std::cout << "Optimizer thread split test passed." << std::endl;
+}
+
+//Test MLP gradients through SGD match the per-layer update, and Adam trains a Sequential in fewer epochs than SGD
+void test_training() {
+    std::cout << "Testing optimizer training paths..." << std::endl;
+    MLP layered(2), fused(layered);
+    optim::Config config;
+    config.learning_rate = 0.1f;
+    optim::Optimizer sgd(config, fused.get_trainable_parameters().size());
+    const std::vector<float> input = { 0.25f, 1.0f };
+    for (int step = 0; step < 10; ++step) {
+        layered.forward(input);
+        layered.update_weights(layered.get_output()[0] - 1.0f, 0.1f);
+        fused.forward(input);
+        fused.update_weights(fused.get_output()[0] - 1.0f, sgd);
+    }
+    Span<const float> a = layered.get_parameters(), b = fused.get_parameters();
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(std::abs(a[i] - b[i]) < 1e-5f);
+    }
+    assert(std::abs(fused.predict(input) - layered.predict(input)) < 1e-5f);
+
+    const float inputs[4][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 } };
+    const float targets[4] = { 0, 1, 1, 0 };
+    auto epochs_to_fit = [&](optim::Method method, float learning_rate) {
+        sequential::Sequential network(sequential::Topology::parse("2,8:tanh,1:sigmoid"), 9);
+        optim::Config c;
+        c.method = method;
+        c.learning_rate = learning_rate;
+        optim::Optimizer optimizer(c, network.get_parameters().size());
+        for (int epoch = 1; epoch <= 5000; ++epoch) {
+            network.zero_gradients();
+            float loss = 0.0f;
+            for (int s = 0; s < 4; ++s) {
+                loss += network.accumulate_gradients(inputs[s], &targets[s]);
+            }
+            if (loss / 4 < 0.05f) {
+                return epoch;
+            }
+            network.step(optimizer);
+        }
+        return 5001;
+    };
+    int sgd_epochs = epochs_to_fit(optim::Method::Sgd, 0.5f);
+    int adam_epochs = epochs_to_fit(optim::Method::Adam, 0.05f);
+    std::cout << "XOR epochs to loss < 0.05: sgd " << sgd_epochs << ", adam " << adam_epochs << std::endl;
+    assert(adam_epochs < sgd_epochs && adam_epochs <= 5000);
+    std::cout << "Optimizer training paths test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_methods();
+        test_config_and_reset();
+        test_threads();
+        test_training();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
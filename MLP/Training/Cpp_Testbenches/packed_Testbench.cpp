@@ -0,0 +1,143 @@
+// packed_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the aligned buffers, the panel packing of weight matrices and the fused kernels that read the packed form.
+
+#include "packed.h"
+#include "fused.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
+static std::vector<float> random_vector(size_t size, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(size);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+static bool aligned(const float* pointer) {
+    return reinterpret_cast<uintptr_t>(pointer) % packed::ALIGNMENT == 0;
+}
+
+//Test every panel starts aligned and every value reads back from its packed position
+void test_pack_layout() {
+    std::cout << "Testing PackedMatrix layout..." << std::endl;
+    std::mt19937 rng(3);
+    const uint32_t sizes[] = { 1, 3, 8, 9, 17, 64 };
+    const uint32_t tiles[] = { 1, 2, 4, 8 };
+    for (uint32_t rows : sizes) {
+        for (uint32_t cols : sizes) {
+            for (uint32_t tile : tiles) {
+                std::vector<float> weights = random_vector(rows * cols, rng);
+                packed::PackedMatrix matrix;
+                matrix.pack(weights.data(), rows, cols, tile, false);
+                assert(matrix.rows() == rows && matrix.cols() == cols && matrix.row_tile() == tile);
+                assert(matrix.panels() == (rows + tile - 1) / tile);
+                for (uint32_t p = 0; p < matrix.panels(); ++p) {
+                    assert(aligned(matrix.panel(p)));
+                }
+                for (uint32_t r = 0; r < rows; ++r) {
+                    for (uint32_t c = 0; c < cols; ++c) {
+                        assert(matrix.at(r, c) == weights[r * cols + c]);
+                    }
+                }
+            }
+        }
+    }
+
+    bool threw = false;
+    try {
+        packed::PackedMatrix matrix;
+        std::vector<float> weights(6);
+        matrix.pack(weights.data(), 2, 3, 3);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "PackedMatrix layout test passed." << std::endl;
+}
+
+//Test copies are deep and keep their alignment, and that a large buffer works with or without huge pages
+void test_buffers() {
+    std::cout << "Testing AlignedBuffer..." << std::endl;
+    packed::AlignedBuffer buffer;
+    buffer.allocate(100, false);
+    assert(aligned(buffer.data()) && buffer.size() == 100);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        assert(buffer.data()[i] == 0.0f);
+        buffer.data()[i] = static_cast<float>(i);
+    }
+    packed::AlignedBuffer copy = buffer;
+    buffer.data()[5] = -1.0f;
+    assert(aligned(copy.data()) && copy.data()[5] == 5.0f);
+    packed::AlignedBuffer moved = std::move(copy);
+    assert(moved.size() == 100 && copy.data() == nullptr);
+
+    //Whether the kernel grants huge pages is up to the OS, the memory just has to behave
+    packed::AlignedBuffer large;
+    large.allocate(packed::HUGE_PAGE_SIZE, true);
+    assert(aligned(large.data()));
+    large.data()[large.size() - 1] = 1.0f;
+    assert(large.data()[0] == 0.0f && large.data()[large.size() - 1] == 1.0f);
+    std::cout << "AlignedBuffer test passed (huge pages " << (large.huge_pages() ? "used" : "not available") << ")." << std::endl;
+}
+
+//Test the packed kernels give the same outputs as the row-major kernels for every tile
+void test_packed_kernels() {
+    std::cout << "Testing packed dense kernels..." << std::endl;
+    std::mt19937 rng(11);
+    const uint32_t sizes[] = { 1, 3, 4, 9, 17, 64, 70 };
+    const uint32_t tiles[] = { 1, 2, 4, 8 };
+    for (uint32_t input_size : sizes) {
+        for (uint32_t output_size : sizes) {
+            std::vector<float> input = random_vector(input_size, rng);
+            std::vector<float> weights = random_vector(input_size * output_size, rng);
+            std::vector<float> biases = random_vector(output_size, rng);
+            std::vector<float> expected(output_size), output(output_size);
+            for (uint32_t tile : tiles) {
+                packed::PackedMatrix matrix;
+                matrix.pack(weights.data(), output_size, input_size, tile);
+
+                fused::dense_linear(input.data(), weights.data(), biases.data(), expected.data(), input_size, output_size);
+                fused::dense_linear(input.data(), matrix, biases.data(), output.data());
+                for (uint32_t i = 0; i < output_size; ++i) {
+                    assert(std::abs(output[i] - expected[i]) <= 1e-5f * std::max(1.0f, std::abs(expected[i])));
+                }
+
+                fused::dense_relu(input.data(), weights.data(), biases.data(), expected.data(), input_size, output_size, -0.5f, 0.5f);
+                fused::dense_relu(input.data(), matrix, biases.data(), output.data(), -0.5f, 0.5f);
+                for (uint32_t i = 0; i < output_size; ++i) {
+                    assert(std::abs(output[i] - expected[i]) <= 1e-5f);
+                }
+
+                fused::dense_sigmoid(input.data(), weights.data(), biases.data(), expected.data(), input_size, output_size);
+                fused::dense_sigmoid(input.data(), matrix, biases.data(), output.data());
+                for (uint32_t i = 0; i < output_size; ++i) {
+                    assert(std::abs(output[i] - expected[i]) <= 1e-5f);
+                }
+            }
+        }
+    }
+    std::cout << "Packed dense kernels test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_pack_layout();
+        test_buffers();
+        test_packed_kernels();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+// prediction_cache_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the prediction cache, its scores against MLP::predict with exact and quantized keys, the hit and miss counts, invalidation on weight changes, CLOCK eviction under the memory cap, the batch path, concurrent readers and writers and the argument checks.
+
+#include "prediction_cache.h"
+#include "activate.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+//Test exact keys give MLP::predict's scores, repeats hit and the counters add up
+void test_exact_keys() {
+    std::cout << "Testing exact keys..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 31);
+    cache::PredictionCache cache(mlp);
+    std::mt19937 rng(32);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+    std::vector<std::vector<float>> inputs(200);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i].resize(1 + i % 10);
+        for (auto& v : inputs[i]) v = value(rng);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& input : inputs) {
+            assert(close(cache.predict(input), mlp.predict(input)));
+        }
+    }
+    cache::Stats stats = cache.get_stats();
+    assert(stats.lookups == 600 && stats.hits == 400 && stats.misses == 200);
+    assert(stats.entries == 200 && stats.evictions == 0 && stats.invalidations == 0);
+    assert(std::abs(stats.hit_rate - 400.0 / 600.0) < 1e-12);
+    assert(stats.memory_bytes > 0 && stats.memory_bytes <= cache::Config().memory_cap);
+    assert(stats.miss_nanoseconds > 0.0 && stats.saved_seconds > 0.0);
+    //A different length is a different key even when predict pads it to the same features
+    cache.predict({ 0.5f });
+    cache.predict({ 0.5f, 0.0f });
+    assert(cache.get_stats().hits == 400);
+    std::cout << "Exact keys test passed." << std::endl;
+}
+
+//Test inputs in one quantization cell share an entry scored at the cell's center
+void test_quantized_keys() {
+    std::cout << "Testing quantized keys..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 33);
+    cache::Config config;
+    config.quantum = 0.25f;
+    cache::PredictionCache cache(mlp, config);
+    float first = cache.predict({ 1.05f, -0.49f, 3.0f });
+    assert(close(first, mlp.predict({ 1.0f, -0.5f, 3.0f })));
+    assert(cache.predict({ 0.95f, -0.51f, 3.1f }) == first);
+    assert(cache.get_stats().hits == 1);
+    assert(close(cache.predict({ 1.2f, -0.5f, 3.0f }), mlp.predict({ 1.25f, -0.5f, 3.0f })));
+    //Too large to key, scored as given and counted as a miss
+    const float huge = 1e12f;
+    assert(close(cache.predict({ huge, 1.0f }), mlp.predict({ huge, 1.0f })));
+    assert(std::isnan(cache.predict({ std::numeric_limits<float>::quiet_NaN() })));
+    cache::Stats stats = cache.get_stats();
+    assert(stats.lookups == 5 && stats.misses == 4 && stats.entries == 2);
+    std::cout << "Quantized keys test passed." << std::endl;
+}
+
+//Test a weight change or reload drops every cached score and clear does too
+void test_invalidation() {
+    std::cout << "Testing invalidation on weight changes..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 34);
+    cache::PredictionCache cache(mlp);
+    const std::vector<float> input = { 0.3f, -0.7f, 1.1f };
+    float before = cache.predict(input);
+    assert(cache.predict(input) == before && cache.get_stats().hits == 1);
+
+    seed_parameters(mlp, 35);
+    float after = cache.predict(input);
+    assert(close(after, mlp.predict(input)) && !close(after, before));
+    cache::Stats stats = cache.get_stats();
+    assert(stats.invalidations == 1 && stats.hits == 1 && stats.entries == 1);
+
+    //Reloading the earlier weights is a change too
+    MLP other(INPUT_SIZE);
+    seed_parameters(other, 34);
+    const std::string path = "prediction_cache_test_weights.bin";
+    assert(other.save_parameters(path));
+    assert(mlp.load_parameters(path));
+    std::remove(path.c_str());
+    assert(close(cache.predict(input), before));
+    assert(cache.get_stats().invalidations == 2);
+
+    cache.clear();
+    assert(cache.get_stats().entries == 0);
+    cache.predict(input);
+    assert(cache.get_stats().hits == 1 && cache.get_stats().entries == 1);
+    std::cout << "Invalidation on weight changes test passed." << std::endl;
+}
+
+//Test a cap of one bucket holds 8 entries, evicts the rest, and CLOCK keeps an entry that keeps getting hits
+void test_eviction() {
+    std::cout << "Testing CLOCK eviction under the memory cap..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 36);
+    cache::Config config;
+    config.shards = 1;
+    config.memory_cap = 1;
+    cache::PredictionCache cache(mlp, config);
+    const std::vector<float> hot = { 42.0f };
+    cache.predict(hot);
+    for (int i = 0; i < 100; ++i) {
+        assert(close(cache.predict({ static_cast<float>(i) + 0.5f }), mlp.predict({ static_cast<float>(i) + 0.5f })));
+        uint64_t hits = cache.get_stats().hits;
+        cache.predict(hot);
+        assert(cache.get_stats().hits == hits + 1);
+    }
+    cache::Stats stats = cache.get_stats();
+    assert(stats.entries == 8 && stats.evictions == 101 - 8);
+    assert(stats.memory_bytes < 1024);
+    std::cout << "CLOCK eviction under the memory cap test passed." << std::endl;
+}
+
+//Test the batch path against one at a time, with repeats inside the batch
+void test_batch() {
+    std::cout << "Testing prediction cache batches..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 37);
+    cache::PredictionCache cache(mlp);
+    std::mt19937 rng(38);
+    std::uniform_int_distribution<int> number(1, 300);
+    std::vector<std::pair<std::vector<float>, int>> samples(1000);
+    for (auto& sample : samples) {
+        int n = number(rng);
+        sample.first = { static_cast<float>(n), n % 2 == 0 ? 1.0f : 0.0f };
+    }
+    //Later chunks of the first batch already hit what earlier ones filled, the second batch hits throughout
+    std::vector<float> first = cache.predict_batch(samples);
+    const uint64_t first_hits = cache.get_stats().hits;
+    assert(first_hits > 0 && first_hits < samples.size());
+    std::vector<float> second = cache.predict_batch(samples);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        assert(close(first[i], mlp.predict(samples[i].first)));
+        assert(second[i] == first[i]);
+    }
+    cache::Stats stats = cache.get_stats();
+    assert(stats.lookups == 2000 && stats.hits == first_hits + 1000 && stats.entries <= 300);
+    assert(cache.predict_batch({}).empty());
+    std::cout << "Prediction cache batches test passed." << std::endl;
+}
+
+//Test threads reading and filling a small, constantly evicting cache always get the right score
+void test_concurrent() {
+    std::cout << "Testing concurrent readers and writers..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 39);
+    cache::Config config;
+    config.shards = 4;
+    config.memory_cap = 4096;
+    cache::PredictionCache cache(mlp, config);
+    const int keys = 500;
+    std::vector<float> expected(keys);
+    for (int k = 0; k < keys; ++k) {
+        expected[k] = mlp.predict({ static_cast<float>(k) * 0.01f, 1.0f });
+    }
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng(40 + t);
+            std::uniform_int_distribution<int> key(0, keys - 1);
+            for (int i = 0; i < 20000; ++i) {
+                int k = key(rng) % (i % 2 == 0 ? 20 : keys);
+                if (!close(cache.predict({ static_cast<float>(k) * 0.01f, 1.0f }), expected[k])) {
+                    ++wrong;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(wrong == 0);
+    cache::Stats stats = cache.get_stats();
+    assert(stats.lookups == 80000 && stats.hits > 0 && stats.evictions > 0);
+    std::cout << "Concurrent readers and writers test passed." << std::endl;
+}
+
+//Test no shards, bad quanta and inputs predict would refuse throw
+void test_invalid_arguments() {
+    std::cout << "Testing prediction cache argument checks..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    for (float quantum : { -1.0f, std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity() }) {
+        cache::Config config;
+        config.quantum = quantum;
+        expect_invalid([&] { cache::PredictionCache cache(mlp, config); });
+    }
+    cache::Config config;
+    config.shards = 0;
+    expect_invalid([&] { cache::PredictionCache cache(mlp, config); });
+    cache::PredictionCache cache(mlp);
+    expect_invalid([&] { cache.predict({}); });
+    expect_invalid([&] { cache.predict(std::vector<float>(11, 1.0f)); });
+    expect_invalid([&] { cache.predict_batch({ { { 1.0f }, 0 }, { {}, 1 } }); });
+    assert(cache.get_stats().lookups == 0);
+    std::cout << "Prediction cache argument checks test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_exact_keys();
+        test_quantized_keys();
+        test_invalidation();
+        test_eviction();
+        test_batch();
+        test_concurrent();
+        test_invalid_arguments();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// range_scorer_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the integer range scoring engine, its scores against MLP::predict on the same features, with and without a normalizer, the positives bitmap, thread count independence and the argument checks.
+
+#include "range_scorer.h"
+#include "threadpool.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+//The features read_data_from_file builds for number
+static std::vector<float> features_of(uint64_t number) {
+    return { static_cast<float>(number), number % 2 == 0 ? 1.0f : 0.0f };
+}
+
+//Every score of [begin, end) in order, whatever order the blocks came in
+static std::vector<float> collect(const range::RangeScorer& scorer, uint64_t begin, uint64_t end) {
+    std::vector<float> scores(end - begin, -1.0f);
+    std::mutex lock;
+    uint64_t seen = 0;
+    scorer.score_range(begin, end, [&](uint64_t first, const float* block, uint32_t count) {
+        std::lock_guard<std::mutex> guard(lock);
+        assert(first >= begin && first + count <= end);
+        for (uint32_t i = 0; i < count; ++i) {
+            scores[first - begin + i] = block[i];
+        }
+        seen += count;
+    });
+    assert(seen == end - begin);
+    return scores;
+}
+
+//Test scores match the MLP one number at a time, for ranges that start odd and end mid block
+void test_matches_predict() {
+    std::cout << "Testing range scores against MLP::predict..." << std::endl;
+    MLP mlp(2);
+    seed_parameters(mlp, 7);
+    range::RangeScorer scorer(mlp);
+    const uint64_t ranges[][2] = { { 0, 1 }, { 3, 70 }, { 1001, 1001 + range::BLOCK * 3 + 17 }, { 4000000001ull, 4000000100ull } };
+    for (const auto& r : ranges) {
+        std::vector<float> scores = collect(scorer, r[0], r[1]);
+        for (uint64_t n = r[0]; n < r[1]; ++n) {
+            float expected = mlp.predict(features_of(n));
+            assert(std::abs(scores[n - r[0]] - expected) < 1e-5f);
+        }
+    }
+    std::cout << "Range scores against MLP::predict test passed." << std::endl;
+}
+
+//Test the normalizer is applied to the generated features the same way it was to the training data
+void test_normalizer() {
+    std::cout << "Testing range scores with a normalizer..." << std::endl;
+    MLP mlp(2);
+    seed_parameters(mlp, 7);
+    Normalizer normalizer;
+    normalizer.scale = { 0.002f, 2.0f };
+    normalizer.shift = { -1.0f, -1.0f };
+    range::RangeScorer scorer(mlp, normalizer);
+    std::vector<float> scores = collect(scorer, 5, 1500);
+    std::vector<float> normalized;
+    for (uint64_t n = 5; n < 1500; ++n) {
+        normalizer.apply(features_of(n), normalized);
+        assert(std::abs(scores[n - 5] - mlp.predict(normalized)) < 1e-5f);
+    }
+    std::cout << "Range scores with a normalizer test passed." << std::endl;
+}
+
+//Test the bitmap holds exactly the numbers scoring above the threshold, for several thread counts
+void test_positives() {
+    std::cout << "Testing positives bitmap..." << std::endl;
+    const uint64_t begin = 77;
+    const uint64_t end = begin + range::BLOCK * 5 + 100;
+    //Values mapped onto [-1, 1] so the scores spread out instead of saturating
+    MLP mlp(2);
+    seed_parameters(mlp, 7);
+    Normalizer normalizer;
+    normalizer.scale = { 2.0f / static_cast<float>(end - begin), 1.0f };
+    normalizer.shift = { -1.0f - 2.0f * static_cast<float>(begin) / static_cast<float>(end - begin), 0.0f };
+    range::RangeScorer scorer(mlp, normalizer);
+    std::vector<float> scores = collect(scorer, begin, end);
+    //Threshold in the middle of the scores, so both sides are populated
+    std::vector<float> sorted = scores;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    const float threshold = sorted[sorted.size() / 2];
+
+    range::PositiveBitmap reference;
+    for (unsigned threads : { 1u, 3u, 0u }) {
+        parallel::set_threads(threads);
+        range::PositiveBitmap bitmap = scorer.positives(begin, end, threshold);
+        assert(bitmap.begin == begin && bitmap.end == end);
+        assert(bitmap.words.size() == (end - begin + 63) / 64);
+        uint64_t expected = 0;
+        for (uint64_t n = begin; n < end; ++n) {
+            bool positive = scores[n - begin] > threshold;
+            expected += positive ? 1 : 0;
+            assert(bitmap.test(n) == positive);
+        }
+        assert(bitmap.count() == expected && expected > 0 && expected < end - begin);
+        std::vector<uint64_t> numbers = bitmap.to_numbers();
+        assert(numbers.size() == expected);
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            assert(bitmap.test(numbers[i]) && (i == 0 || numbers[i - 1] < numbers[i]));
+        }
+        assert(!bitmap.test(begin - 1) && !bitmap.test(end));
+        if (threads == 1) reference = bitmap;
+        else assert(bitmap.words == reference.words);
+    }
+    parallel::set_threads(0);
+    std::cout << "Positives bitmap test passed." << std::endl;
+}
+
+//Test empty ranges do nothing and reversed ranges throw
+void test_edges() {
+    std::cout << "Testing range edge cases..." << std::endl;
+    MLP mlp(2);
+    seed_parameters(mlp, 7);
+    range::RangeScorer scorer(mlp);
+    bool called = false;
+    scorer.score_range(10, 10, [&](uint64_t, const float*, uint32_t) { called = true; });
+    assert(!called);
+    range::PositiveBitmap empty = scorer.positives(10, 10);
+    assert(empty.words.empty() && empty.count() == 0);
+
+    bool threw = false;
+    try {
+        scorer.score_range(11, 10, [](uint64_t, const float*, uint32_t) {});
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        scorer.positives(11, 10);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "Range edge cases test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_matches_predict();
+        test_normalizer();
+        test_positives();
+        test_edges();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+// sequential_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the runtime topology network (spec parsing, the arena layout, forward, backprop, training and save/load) and for the MLP's parameter arena views.
+
+#include "sequential.h"
+#include "MLP.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <cassert>
+
+//Test specs round trip and bad specs are rejected
+void test_topology_parse() {
+    std::cout << "Testing Topology parse..." << std::endl;
+    sequential::Topology topology = sequential::Topology::parse("9, 64:relu,32:tanh,8,1:sigmoid");
+    assert(topology.inputs == 9 && topology.layers.size() == 4);
+    assert(topology.layers[1].units == 32 && topology.layers[1].activation == sequential::Activation::Tanh);
+    assert(topology.layers[2].activation == sequential::Activation::Relu);
+    assert(topology.to_string() == "9,64:relu,32:tanh,8:relu,1:sigmoid");
+    assert(sequential::Topology::parse(topology.to_string()) == topology);
+    assert(topology.weight_count() == 9 * 64 + 64 * 32 + 32 * 8 + 8 * 1);
+    assert(topology.bias_count() == 64 + 32 + 8 + 1);
+    assert(topology.widest() == 64);
+
+    const char* bad[] = { "", "9", "9,0:relu", "9,x:relu", "9,4:cube", "9:relu,4" };
+    for (const char* spec : bad) {
+        bool threw = false;
+        try {
+            sequential::Topology::parse(spec);
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    std::cout << "Topology parse test passed." << std::endl;
+}
+
+//Test every layer views the one arena, weights first and then biases, back to back
+void test_arena_layout() {
+    std::cout << "Testing arena layout..." << std::endl;
+    sequential::Sequential network(sequential::Topology::parse("5,7:relu,3:tanh,2:linear"));
+    const float* base = network.get_parameters().data();
+    size_t offset = 0;
+    for (size_t l = 0; l < network.layer_count(); ++l) {
+        assert(network.get_weights(l).data() == base + offset);
+        offset += network.get_weights(l).size();
+    }
+    for (size_t l = 0; l < network.layer_count(); ++l) {
+        assert(network.get_biases(l).data() == base + offset);
+        offset += network.get_biases(l).size();
+    }
+    assert(offset == network.get_parameters().size());
+    assert(network.get_gradients().size() == offset);
+    std::cout << "Arena layout test passed." << std::endl;
+}
+
+//Reference forward pass straight from the views with std:: math
+static std::vector<float> reference_forward(const sequential::Sequential& network, const std::vector<float>& input) {
+    std::vector<float> in = input;
+    for (size_t l = 0; l < network.layer_count(); ++l) {
+        const auto& spec = network.get_topology().layers[l];
+        std::vector<float> out(spec.units);
+        for (uint32_t i = 0; i < spec.units; ++i) {
+            double sum = network.get_biases(l)[i];
+            for (size_t j = 0; j < in.size(); ++j) {
+                sum += network.get_weights(l)[i * in.size() + j] * in[j];
+            }
+            float z = static_cast<float>(sum);
+            switch (spec.activation) {
+            case sequential::Activation::Relu: out[i] = std::max(0.0f, z); break;
+            case sequential::Activation::LeakyRelu: out[i] = z > 0.0f ? z : 0.01f * z; break;
+            case sequential::Activation::Sigmoid: out[i] = 1.0f / (1.0f + std::exp(-z)); break;
+            case sequential::Activation::Tanh: out[i] = std::tanh(z); break;
+            default: out[i] = z; break;
+            }
+        }
+        in = out;
+    }
+    return in;
+}
+
+void test_forward() {
+    std::cout << "Testing Sequential forward..." << std::endl;
+    sequential::Sequential network(sequential::Topology::parse("6,16:relu,12:leaky_relu,8:tanh,3:sigmoid"), 7);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int trial = 0; trial < 50; ++trial) {
+        std::vector<float> input(6);
+        for (auto& v : input) v = dist(rng);
+        std::vector<float> output(3);
+        network.forward(input.data(), output.data());
+        std::vector<float> expected = reference_forward(network, input);
+        for (int i = 0; i < 3; ++i) {
+            assert(std::abs(output[i] - expected[i]) < 1e-5f);
+        }
+        assert(network.predict(input) == output[0]);
+    }
+    std::cout << "Sequential forward test passed." << std::endl;
+}
+
+//Test backprop against central differences of the loss for every parameter
+void test_gradients() {
+    std::cout << "Testing Sequential gradients..." << std::endl;
+    const char* specs[] = { "4,6:tanh,5:sigmoid,2:sigmoid", "3,5:leaky_relu,4:tanh,2:linear" };
+    for (const char* spec : specs) {
+        sequential::Sequential network(sequential::Topology::parse(spec), 11);
+        const std::vector<float> input = { 0.3f, -0.7f, 0.9f, 0.1f };
+        const std::vector<float> target = { 1.0f, 0.0f };
+        network.zero_gradients();
+        network.accumulate_gradients(input.data(), target.data());
+        std::vector<float> analytic = network.get_gradients().to_vector();
+
+        Span<float> params = network.get_parameters();
+        const float h = 1e-2f;
+        for (size_t i = 0; i < params.size(); ++i) {
+            float saved = params[i];
+            params[i] = saved + h;
+            float up = network.accumulate_gradients(input.data(), target.data());
+            params[i] = saved - h;
+            float down = network.accumulate_gradients(input.data(), target.data());
+            params[i] = saved;
+            float numeric = (up - down) / (2.0f * h);
+            assert(std::abs(numeric - analytic[i]) < 2e-3f + 2e-2f * std::abs(numeric));
+        }
+    }
+    std::cout << "Sequential gradients test passed." << std::endl;
+}
+
+//Test a deeper runtime topology learns XOR
+void test_training() {
+    std::cout << "Testing Sequential training..." << std::endl;
+    sequential::Sequential network(sequential::Topology::parse("2,8:tanh,8:relu,1:sigmoid"), 3);
+    const float inputs[4][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 } };
+    const float targets[4] = { 0, 1, 1, 0 };
+    for (int epoch = 0; epoch < 3000; ++epoch) {
+        network.zero_gradients();
+        for (int s = 0; s < 4; ++s) {
+            network.accumulate_gradients(inputs[s], &targets[s]);
+        }
+        network.step(0.5f / 4);
+    }
+    for (int s = 0; s < 4; ++s) {
+        float score = network.predict({ inputs[s][0], inputs[s][1] });
+        assert((score > 0.5f) == (targets[s] > 0.5f));
+    }
+    std::cout << "Sequential training test passed." << std::endl;
+}
+
+//Test save/load round trips the topology and every parameter, and copies do not share the arena
+void test_save_load_copy() {
+    std::cout << "Testing Sequential save/load and copy..." << std::endl;
+    sequential::Sequential network(sequential::Topology::parse("4,10:relu,3:tanh,1:sigmoid"), 5);
+    const std::string path = "sequential_test.bin";
+    assert(network.save(path));
+    std::unique_ptr<sequential::Sequential> loaded = sequential::Sequential::load(path);
+    std::remove(path.c_str());
+    assert(loaded && loaded->get_topology() == network.get_topology());
+    assert(loaded->get_parameters().to_vector() == network.get_parameters().to_vector());
+    assert(!sequential::Sequential::load("missing_network.bin"));
+
+    sequential::Sequential copy(network);
+    assert(copy.get_parameters().data() != network.get_parameters().data());
+    assert(copy.get_weights(1).data() == copy.get_parameters().data() + 4 * 10);
+    const std::vector<float> input = { 0.5f, -0.5f, 0.25f, 1.0f };
+    const float target = 1.0f;
+    float before = network.predict(input);
+    copy.train_step(input.data(), &target, 0.1f);
+    assert(network.predict(input) == before);
+    assert(copy.predict(input) > before);
+    std::cout << "Sequential save/load and copy test passed." << std::endl;
+}
+
+//Test the MLP's spans are zero-copy views of one arena and its parameter file round trips
+void test_mlp_arena() {
+    std::cout << "Testing MLP parameter arena..." << std::endl;
+    MLP mlp(9);
+    Span<const float> weights = mlp.get_weights();
+    Span<const float> biases = mlp.get_biases();
+    Span<float> all = mlp.get_parameters();
+    assert(weights.data() == all.data() && biases.data() == all.data() + weights.size());
+    assert(weights.size() + biases.size() == all.size());
+
+    const std::vector<float> input = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f };
+    const float before = mlp.predict(input);
+    const std::string path = "mlp_parameters_test.bin";
+    assert(mlp.save_parameters(path));
+    for (auto& value : all) value = 0.0f;
+    assert(mlp.load_parameters(path));
+    std::remove(path.c_str());
+    assert(mlp.predict(input) == before);
+
+    MLP copy(mlp);
+    assert(copy.get_parameters().data() != all.data());
+    assert(copy.predict(input) == before);
+    std::cout << "MLP parameter arena test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_topology_parse();
+        test_arena_layout();
+        test_forward();
+        test_gradients();
+        test_training();
+        test_save_load_copy();
+        test_mlp_arena();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
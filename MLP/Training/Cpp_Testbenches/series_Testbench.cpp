@@ -0,0 +1,140 @@
+// series_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the streaming series front end, the windows across ring wraparound, the running window statistics against a recompute, the window scores against MLP::predict and the argument checks.
+
+#include "series.h"
+#include "activate.h"
+#include "MLP.h"
+#include "testbench_helpers.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cassert>
+
+//Test every window reads the right values in order, before and long after the ring wraps
+void test_windows() {
+    std::cout << "Testing series windows across wraparound..." << std::endl;
+    series::RingSeries ring(20, 5);
+    assert(ring.window_count() == 0);
+    for (int n = 0; n < 137; ++n) {
+        ring.push(static_cast<float>(n));
+        const uint64_t oldest = ring.get_pushed() - ring.buffered();
+        assert(ring.buffered() == std::min<uint64_t>(ring.get_pushed(), 20));
+        for (uint32_t k = 0; k < ring.window_count(); ++k) {
+            const float* w = ring.window_values(k);
+            for (uint32_t j = 0; j < 5; ++j) {
+                assert(w[j] == static_cast<float>(oldest + k + j));
+            }
+        }
+    }
+    assert(ring.window_count() == 16);
+    //The batch view of every window is one run
+    const float* all = ring.windows(0, 16);
+    for (uint32_t i = 0; i < 16 + 4; ++i) {
+        assert(all[i] == static_cast<float>(137 - 20 + i));
+    }
+    std::cout << "Series windows across wraparound test passed." << std::endl;
+}
+
+//Test mean, min, max, delta and step against a recompute over the window, including capacity == window
+void test_stats() {
+    std::cout << "Testing running window statistics..." << std::endl;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> reading(-50.0f, 50.0f);
+    for (uint32_t capacity : { 9u, 16u, 100u }) {
+        series::RingSeries ring(capacity, INPUT_SIZE);
+        std::vector<float> history;
+        for (int n = 0; n < 5000; ++n) {
+            //Runs of repeats and monotone stretches exercise the queues' ties and long lives
+            float v = n % 50 < 10 ? 3.0f : (n % 50 < 20 ? static_cast<float>(n % 50) : reading(rng));
+            ring.push(v);
+            history.push_back(v);
+            if (history.size() < INPUT_SIZE) {
+                continue;
+            }
+            const float* window = history.data() + history.size() - INPUT_SIZE;
+            double sum = 0.0;
+            for (uint32_t j = 0; j < INPUT_SIZE; ++j) sum += window[j];
+            const series::WindowStats& stats = ring.stats();
+            assert(std::abs(stats.mean - static_cast<float>(sum / INPUT_SIZE)) <= 1e-4f);
+            assert(stats.min == *std::min_element(window, window + INPUT_SIZE));
+            assert(stats.max == *std::max_element(window, window + INPUT_SIZE));
+            assert(stats.delta == window[INPUT_SIZE - 1] - window[0]);
+            assert(stats.step == window[INPUT_SIZE - 1] - window[INPUT_SIZE - 2]);
+        }
+    }
+    std::cout << "Running window statistics test passed." << std::endl;
+}
+
+//Test the scorer against MLP::predict on copies of the windows, for full and short windows and every batch tail
+void test_scores() {
+    std::cout << "Testing window scores against MLP::predict..." << std::endl;
+    MLP mlp(INPUT_SIZE);
+    seed_parameters(mlp, 12);
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> reading(-1.0f, 1.0f);
+    for (uint32_t window : { static_cast<uint32_t>(INPUT_SIZE), 4u }) {
+        series::RingSeries ring(64, window);
+        series::WindowScorer scorer(mlp, window);
+        for (int n = 0; n < 150; ++n) {
+            ring.push(reading(rng));
+        }
+        std::vector<float> scores = scorer.score_all(ring);
+        assert(scores.size() == 64 - window + 1);
+        for (uint32_t k = 0; k < scores.size(); ++k) {
+            const float* w = ring.window_values(k);
+            assert(close(scores[k], mlp.predict(std::vector<float>(w, w + window))));
+        }
+        //Sub-batches of every length, their tails go one window at a time
+        for (uint32_t count = 1; count <= 19; ++count) {
+            std::vector<float> part(count);
+            scorer.score(ring, 7, count, part.data());
+            for (uint32_t i = 0; i < count; ++i) {
+                assert(close(part[i], scores[7 + i]));
+            }
+        }
+    }
+    std::cout << "Window scores against MLP::predict test passed." << std::endl;
+}
+
+//Test bad windows, reads past the buffered windows, stats too early and mismatched scorers throw
+void test_invalid_arguments() {
+    std::cout << "Testing series argument checks..." << std::endl;
+    expect_throw<std::invalid_argument>([] { series::RingSeries ring(8, 0); });
+    expect_throw<std::invalid_argument>([] { series::RingSeries ring(8, 9); });
+    series::RingSeries ring(16, INPUT_SIZE);
+    expect_throw<std::logic_error>([&] { ring.stats(); });
+    for (int n = 0; n < 12; ++n) {
+        ring.push(static_cast<float>(n));
+    }
+    assert(ring.window_count() == 4);
+    expect_throw<std::out_of_range>([&] { ring.windows(4, 1); });
+    expect_throw<std::out_of_range>([&] { ring.windows(2, 3); });
+    MLP mlp(INPUT_SIZE);
+    expect_throw<std::invalid_argument>([&] { series::WindowScorer scorer(mlp, INPUT_SIZE + 1); });
+    series::WindowScorer short_scorer(mlp, 4);
+    expect_throw<std::invalid_argument>([&] { short_scorer.score_all(ring); });
+    std::cout << "Series argument checks test passed." << std::endl;
+}
+
+int main() {
+    try {
+        activate::set_mode(activate::Mode::Exact);
+        test_windows();
+        test_stats();
+        test_scores();
+        test_invalid_arguments();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+// sweep_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for stacked multi-model training, the grid parser and that every stacked model trains exactly like it would on its own.
+
+#include "sweep.h"
+#include "threadpool.h"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cassert>
+
+static sweep::Dataset make_dataset(uint32_t samples, uint32_t inputs, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    sweep::Dataset data;
+    for (uint32_t i = 0; i < samples; ++i) {
+        std::vector<float> x(inputs);
+        for (auto& v : x) v = dist(rng);
+        //A nonlinear rule a small relu network can learn
+        int label = (x[0] * x[1] > 0.0f) ? 1 : 0;
+        data.emplace_back(x, label);
+    }
+    return data;
+}
+
+//Test the grid expands to every combination and bad grids are refused
+void test_parse_grid() {
+    std::cout << "Testing parse_grid..." << std::endl;
+    std::vector<sweep::ModelSpec> specs = sweep::parse_grid("lr=0.1,0.05 hidden=16,64;seeds=3");
+    assert(specs.size() == 12);
+    assert(specs[0].learning_rate == 0.1f && specs[0].hidden == 16 && specs[0].seed == 42);
+    assert(specs[2].seed == 44 && specs[3].hidden == 64 && specs[11].learning_rate == 0.05f);
+    assert(sweep::parse_grid("").size() == 1);
+    assert(sweep::parse_grid("seed=7,9").size() == 2);
+
+    const char* bad[] = { "lr", "lr=", "depth=3", "hidden=x", "seeds=1,2" };
+    for (const char* grid : bad) {
+        bool threw = false;
+        try {
+            sweep::parse_grid(grid);
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    std::cout << "parse_grid test passed." << std::endl;
+}
+
+//Test every stacked model ends up where the same model trained alone with the same batches ends up
+void test_matches_separate_training() {
+    std::cout << "Testing stacked against separate training..." << std::endl;
+    const uint32_t inputs = 3, batch_size = 8;
+    sweep::Dataset data = make_dataset(100, inputs, 1);
+    std::vector<uint32_t> order(data.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    std::vector<sweep::ModelSpec> specs = sweep::parse_grid("lr=0.3,0.05 hidden=5,12 seeds=2");
+    sweep::StackedTrainer stacked(inputs, specs);
+    std::vector<sequential::Sequential> separate;
+    for (size_t k = 0; k < specs.size(); ++k) {
+        separate.push_back(stacked.to_sequential(k));
+        assert(separate[k].get_parameters().to_vector() == sequential::Sequential(sequential::Topology::parse(
+            std::to_string(inputs) + "," + std::to_string(specs[k].hidden) + ":relu,1:sigmoid"), specs[k].seed).get_parameters().to_vector());
+    }
+
+    for (int epoch = 0; epoch < 3; ++epoch) {
+        stacked.train_epoch(data, order, batch_size);
+        for (size_t k = 0; k < specs.size(); ++k) {
+            for (size_t start = 0; start < data.size(); start += batch_size) {
+                size_t count = std::min<size_t>(batch_size, data.size() - start);
+                separate[k].zero_gradients();
+                for (size_t b = start; b < start + count; ++b) {
+                    float target = static_cast<float>(data[b].second);
+                    separate[k].accumulate_gradients(data[b].first.data(), &target);
+                }
+                separate[k].step(specs[k].learning_rate / count);
+            }
+        }
+    }
+    for (size_t k = 0; k < specs.size(); ++k) {
+        std::vector<float> expected = separate[k].get_parameters().to_vector();
+        std::vector<float> actual = stacked.to_sequential(k).get_parameters().to_vector();
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(std::abs(expected[i] - actual[i]) < 1e-4f);
+        }
+        for (size_t s = 0; s < 10; ++s) {
+            assert(std::abs(stacked.predict(k, data[s].first) - separate[k].predict(data[s].first)) < 1e-4f);
+        }
+    }
+    std::cout << "Stacked against separate training test passed." << std::endl;
+}
+
+//Test the sweep learns, results do not depend on the thread count, and evaluate agrees with predict
+void test_learning_and_threads() {
+    std::cout << "Testing sweep learning and threads..." << std::endl;
+    const uint32_t inputs = 2;
+    sweep::Dataset train = make_dataset(2000, inputs, 2), test = make_dataset(500, inputs, 3);
+    std::vector<uint32_t> order(train.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::vector<sweep::ModelSpec> specs = sweep::parse_grid("lr=0.5,0.2 hidden=32,256 seeds=2");
+
+    parallel::set_threads(1);
+    sweep::StackedTrainer serial(inputs, specs);
+    parallel::set_threads(4);
+    sweep::StackedTrainer split(inputs, specs);
+    for (int epoch = 0; epoch < 30; ++epoch) {
+        parallel::set_threads(1);
+        serial.train_epoch(train, order, 32);
+        parallel::set_threads(4);
+        split.train_epoch(train, order, 32);
+    }
+    parallel::set_threads(0);
+    assert(serial.get_parameters().to_vector() == split.get_parameters().to_vector());
+
+    std::vector<sweep::ModelStats> stats = split.evaluate(test);
+    for (size_t k = 0; k < specs.size(); ++k) {
+        assert(stats[k].accuracy > 0.85);
+        uint32_t correct = 0;
+        for (const auto& sample : test) {
+            correct += (split.predict(k, sample.first) > 0.5f) == (sample.second == 1) ? 1 : 0;
+        }
+        assert(std::abs(static_cast<double>(correct) / test.size() - stats[k].accuracy) < 1e-9);
+    }
+    std::cout << "Sweep learning and threads test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_parse_grid();
+        test_matches_separate_training();
+        test_learning_and_threads();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+// testbench_helpers.h
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: This header holds the small helpers the inference testbenches share: fixed network weights, the float tolerance the scores are compared with and checks that a call throws.
+
+#ifndef TESTBENCH_HELPERS_H
+#define TESTBENCH_HELPERS_H
+
+#include "MLP.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+//The layers start from unseeded random weights, these are fixed so every run sees the same network
+inline void seed_parameters(MLP& mlp, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    Span<float> parameters = mlp.get_parameters();
+    for (auto& p : parameters) p = dist(rng);
+    mlp.mark_parameters_changed();
+}
+
+inline bool close(float a, float b) {
+    return std::abs(a - b) <= 1e-5f;
+}
+
+template <typename Exception, typename Body>
+void expect_throw(Body body) {
+    bool threw = false;
+    try {
+        body();
+    }
+    catch (const Exception&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+template <typename Body>
+void expect_invalid(Body body) {
+    expect_throw<std::invalid_argument>(body);
+}
+
+#endif
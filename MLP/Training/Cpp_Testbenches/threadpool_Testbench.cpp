@@ -0,0 +1,252 @@
+// threadpool_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the work-stealing scheduler (deques, task groups, fork/join), the cost model and the code that splits across it.
+
+#include "threadpool.h"
+#include "fused.h"
+#include "layers.h"
+#include "MLP.h"
+#include "utilities.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <cassert>
+
+//Test the owner pops newest first, thieves take oldest first, and concurrent thieves never get a task twice
+void test_deque() {
+    std::cout << "Testing WorkDeque..." << std::endl;
+    parallel::WorkDeque deque(8);
+    std::vector<parallel::Task> tasks(10);
+    for (int i = 0; i < 8; ++i) {
+        assert(deque.push(&tasks[i]));
+    }
+    assert(!deque.push(&tasks[8]));
+    assert(deque.pop() == &tasks[7]);
+    assert(deque.steal() == &tasks[0]);
+    assert(deque.steal() == &tasks[1]);
+    while (deque.pop() != nullptr) {}
+    assert(deque.steal() == nullptr);
+
+    const int count = 200000;
+    std::vector<parallel::Task> many(count);
+    std::vector<std::atomic<int>> taken(count);
+    parallel::WorkDeque shared(1024);
+    std::atomic<bool> done{ false };
+    auto thief = [&]() {
+        while (!done.load()) {
+            if (parallel::Task* task = shared.steal()) {
+                taken[task - many.data()].fetch_add(1);
+            }
+        }
+        while (parallel::Task* task = shared.steal()) {
+            taken[task - many.data()].fetch_add(1);
+        }
+    };
+    std::thread thieves[2] = { std::thread(thief), std::thread(thief) };
+    for (int i = 0; i < count; ++i) {
+        while (!shared.push(&many[i])) {
+            if (parallel::Task* task = shared.pop()) {
+                taken[task - many.data()].fetch_add(1);
+            }
+        }
+        if (i % 3 == 0) {
+            if (parallel::Task* task = shared.pop()) {
+                taken[task - many.data()].fetch_add(1);
+            }
+        }
+    }
+    while (parallel::Task* task = shared.pop()) {
+        taken[task - many.data()].fetch_add(1);
+    }
+    done.store(true);
+    for (auto& t : thieves) {
+        t.join();
+    }
+    for (auto& hit : taken) {
+        assert(hit.load() == 1);
+    }
+    std::cout << "WorkDeque test passed." << std::endl;
+}
+
+//Recursive fork/join, every level spawns into the deque of whichever thread runs it
+static uint64_t fib(parallel::ThreadPool& pool, uint32_t n) {
+    if (n < 12) {
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    }
+    uint64_t a = 0;
+    parallel::TaskGroup group(pool);
+    group.spawn([&]() { a = fib(pool, n - 1); });
+    uint64_t b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+
+void test_task_group() {
+    std::cout << "Testing TaskGroup and parallel_invoke..." << std::endl;
+    parallel::ThreadPool pool(4, true);
+    assert(fib(pool, 25) == 75025);
+
+    parallel::set_threads(4);
+    int left = 0, right = 0;
+    parallel::parallel_invoke([&]() { left = 1; }, [&]() { right = 2; });
+    assert(left == 1 && right == 2);
+    std::cout << "TaskGroup and parallel_invoke test passed." << std::endl;
+}
+
+//Test every task runs exactly once, for many small jobs in a row and for nested and concurrent callers
+void test_run() {
+    std::cout << "Testing ThreadPool::run..." << std::endl;
+    parallel::ThreadPool pool(4);
+    assert(pool.size() == 4);
+    for (uint32_t tasks = 0; tasks < 200; ++tasks) {
+        std::vector<std::atomic<int>> hits(tasks);
+        pool.run(tasks, [&](uint32_t t) { hits[t].fetch_add(1); });
+        for (auto& hit : hits) {
+            assert(hit.load() == 1);
+        }
+    }
+
+    //A task that forks again gets its inner job run in parallel as well
+    std::atomic<int> inner{ 0 };
+    pool.run(4, [&](uint32_t) {
+        pool.run(3, [&](uint32_t) { inner.fetch_add(1); });
+    });
+    assert(inner.load() == 12);
+
+    //Two threads outside the pool submitting at the same time
+    std::atomic<int> total{ 0 };
+    auto caller = [&]() {
+        for (int i = 0; i < 500; ++i) {
+            pool.run(8, [&](uint32_t) { total.fetch_add(1); });
+        }
+    };
+    std::thread other(caller);
+    caller();
+    other.join();
+    assert(total.load() == 2 * 500 * 8);
+    std::cout << "ThreadPool::run test passed." << std::endl;
+}
+
+//Test the ranges cover every item once and start on the alignment, and that small work stays on one thread
+void test_parallel_for() {
+    std::cout << "Testing parallel_for and plan_threads..." << std::endl;
+    parallel::set_threads(4);
+    assert(parallel::plan_threads(64, 64) == 1);
+    assert(parallel::plan_threads(parallel::MIN_WORK_PER_THREAD * 64, 1) == 1);
+    assert(parallel::plan_threads(parallel::MIN_WORK_PER_THREAD * 64, 64) == 4);
+    assert(parallel::plan_threads(parallel::MIN_WORK_PER_THREAD * 3, 64) == 3);
+
+    const uint32_t counts[] = { 1, 5, 64, 1000, 1027 };
+    for (uint32_t count : counts) {
+        std::vector<std::atomic<int>> hits(count);
+        parallel::parallel_for(count, parallel::MIN_WORK_PER_THREAD, 4, [&](uint32_t begin, uint32_t end) {
+            assert(begin % 4 == 0 && begin < end && end <= count);
+            for (uint32_t i = begin; i < end; ++i) {
+                hits[i].fetch_add(1);
+            }
+        });
+        for (auto& hit : hits) {
+            assert(hit.load() == 1);
+        }
+    }
+    std::cout << "parallel_for and plan_threads test passed." << std::endl;
+}
+
+//Test a layer wide enough to split gives the same results on one and on four threads
+void test_wide_layer() {
+    std::cout << "Testing wide layer split..." << std::endl;
+    const uint32_t width = 1024;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(width), weights(width * width), biases(width);
+    for (auto& v : input) v = dist(rng);
+    for (auto& v : weights) v = dist(rng);
+    for (auto& v : biases) v = dist(rng);
+
+    std::vector<float> serial(width), split(width);
+    parallel::set_threads(1);
+    fused::dense_relu(input.data(), weights.data(), biases.data(), serial.data(), width, width, -88.0f, 88.0f);
+    parallel::set_threads(4);
+    fused::dense_relu(input.data(), weights.data(), biases.data(), split.data(), width, width, -88.0f, 88.0f);
+    for (uint32_t i = 0; i < width; ++i) {
+        assert(serial[i] == split[i]);
+    }
+
+    packed::PackedMatrix matrix;
+    matrix.pack(weights.data(), width, width);
+    fused::dense_relu(input.data(), matrix, biases.data(), split.data(), -88.0f, 88.0f);
+    for (uint32_t i = 0; i < width; ++i) {
+        assert(std::abs(serial[i] - split[i]) <= 1e-4f * std::max(1.0f, std::abs(serial[i])));
+    }
+
+    //update_weights splits its rows too, every row must move by the same amount
+    HiddenLayer hidden(width, width);
+    std::vector<float> before = hidden.get_weights().to_vector();
+    hidden.forward(input.data(), split.data());
+    hidden.update_weights(0.5f, 0.1f);
+    for (uint32_t i = 0; i < width; ++i) {
+        for (uint32_t j = 0; j < width; j += 97) {
+            float expected = before[i * width + j] - 0.1f * 0.5f * input[j];
+            assert(hidden.get_weights()[i * width + j] == expected);
+        }
+    }
+    parallel::set_threads(0);
+    std::cout << "Wide layer split test passed." << std::endl;
+}
+
+//Test the chunked parser gives the same samples, in file order, as there are lines and the batch predict matches predict
+void test_parsing_and_batch() {
+    std::cout << "Testing parallel parsing and predict_batch..." << std::endl;
+    parallel::set_threads(4);
+    const std::string path = "threadpool_parse_test.txt";
+    const int rows = 20000;
+    {
+        std::ofstream file(path);
+        for (int i = 0; i < rows; ++i) {
+            file << i << ", " << (i % 2) << "\n";
+        }
+    }
+    auto data = read_data_from_file(path);
+    std::remove(path.c_str());
+    assert(data.size() == rows);
+    for (int i = 0; i < rows; ++i) {
+        assert(data[i].first[0] == static_cast<float>(i) && data[i].second == i % 2);
+    }
+
+    MLP mlp(2);
+    std::vector<std::pair<std::vector<float>, int>> samples(data.begin(), data.begin() + 5000);
+    for (auto& sample : samples) {
+        sample.first[0] /= static_cast<float>(rows);
+    }
+    std::vector<float> scores = mlp.predict_batch(samples);
+    for (size_t i = 0; i < samples.size(); i += 7) {
+        assert(scores[i] == mlp.predict(samples[i].first));
+    }
+    parallel::set_threads(0);
+    std::cout << "Parallel parsing and predict_batch test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_deque();
+        test_task_group();
+        test_run();
+        test_parallel_for();
+        test_wide_layer();
+        test_parsing_and_batch();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+// trace_Testbench.cpp
+// Author: Coby Cockrell
+// Date: 10/19/2026
+// Purpose: Testbench for the trace rings and the Chrome trace JSON writer
+
+#include "trace.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+//Counts how many times a substring appears in the trace file
+static size_t count_occurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+//Test the ring drops when full and drains in order
+void test_ring() {
+    std::cout << "Testing ThreadRing..." << std::endl;
+    trace::ThreadRing ring(1, 4);
+    for (int i = 0; i < 6; ++i) {
+        ring.push(trace::Event{ "span", "test", i, 1 });
+    }
+    assert(ring.get_dropped() == 2);
+
+    std::vector<int64_t> starts;
+    size_t drained = ring.drain([&](const trace::Event& e) { starts.push_back(e.start_ns); });
+    assert(drained == 4);
+    for (int i = 0; i < 4; ++i) {
+        assert(starts[i] == i);
+    }
+    assert(ring.push(trace::Event{ "span", "test", 10, 1 }));
+    std::cout << "ThreadRing test passed." << std::endl;
+}
+
+//Test spans from several threads and sampling end up in the file
+void test_trace_file() {
+    std::cout << "Testing trace file output..." << std::endl;
+    const std::string path = "trace_testbench.json";
+    assert(trace::start(path, 4));
+    trace::set_thread_name("testbench");
+
+    {
+        TRACE_SCOPE("outer", "test");
+        for (int i = 0; i < 8; ++i) {
+            TRACE_SAMPLE_TICK();
+            TRACE_SCOPE_SAMPLED("sampled", "test");
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([]() {
+            TRACE_SCOPE("worker_span", "test");
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    trace::flush();
+    trace::stop();
+
+    std::string text = read_file(path);
+    assert(text.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0);
+    assert(text.find("]}") != std::string::npos);
+    assert(count_occurrences(text, "\"name\":\"outer\"") == 1);
+    assert(count_occurrences(text, "\"name\":\"sampled\"") == 2);
+    assert(count_occurrences(text, "\"name\":\"worker_span\"") == 2);
+    assert(count_occurrences(text, "\"testbench\"") == 1);
+
+    //Nothing is recorded once tracing is stopped
+    {
+        TRACE_SCOPE("after_stop", "test");
+    }
+    std::remove(path.c_str());
+    std::cout << "Trace file test passed." << std::endl;
+}
+
+//Test thread and span names with quotes, backslashes and control characters are written as valid JSON strings
+void test_escaping() {
+    std::cout << "Testing trace name escaping..." << std::endl;
+    const std::string path = "trace_escape_testbench.json";
+    assert(trace::start(path, 1));
+    std::thread worker([]() {
+        trace::set_thread_name("say \"hi\" C:\\run\n\x01");
+        TRACE_SCOPE("span \"quoted\"", "test");
+    });
+    worker.join();
+    trace::stop();
+
+    std::string text = read_file(path);
+    assert(text.find("\"args\":{\"name\":\"say \\\"hi\\\" C:\\\\run\\n\\u0001\"}") != std::string::npos);
+    assert(text.find("\"name\":\"span \\\"quoted\\\"\"") != std::string::npos);
+    std::remove(path.c_str());
+    std::cout << "Trace name escaping test passed." << std::endl;
+}
+
+int main() {
+    try {
+        test_ring();
+        test_trace_file();
+        test_escaping();
+
+        std::cout << "All tests passed successfully!" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}